@@ -35,6 +35,7 @@ SOURCES += \
 
 DependencySearchPaths+=/usr/lib/x86_64-linux-gnu/ # to fix buggy installation location of libxml2 on ubunut and mint
 INCLUDEPATH+=/usr/include/libxml2/ # to fix buggy installation location of libxml2 on ubunut and mint
+QT += concurrent
 ################################################################################
 #                       DO NOT CHANGE ANYTHING BELOW                           #
 ################################################################################
@@ -234,6 +234,31 @@ tmplConfigurable<FilePath_t>     gConfigs::DTDFilePath(
             enuConfigSource::Arg  |
             enuConfigSource::File));
 
+tmplConfigurable<quint16>     gConfigs::MaxThreads(
+        gConfigs::appConfig("MaxThreads"),
+        "Maximum number of threads used to process files and lines concurrently. 0 means number of CPU cores",
+        0,
+        ReturnTrueCrossValidator(),
+        "j",
+        "MAX_THREADS",
+        "max-threads",
+        (enuConfigSource::Type)(
+            enuConfigSource::Arg  |
+            enuConfigSource::File));
+
+tmplRangedConfigurable<quint32>     gConfigs::BatchSize(
+        gConfigs::appConfig("BatchSize"),
+        "Number of lines of each file read and processed together. Bounds memory used per file",
+        1, 1000000,
+        5000,
+        ReturnTrueCrossValidator(),
+        "b",
+        "BATCH_SIZE",
+        "batch-size",
+        (enuConfigSource::Type)(
+            enuConfigSource::Arg  |
+            enuConfigSource::File));
+
 }}
 /**************************************************************************************************************/
 ENUM_CONFIGURABLE_IMPL(Targoman::Apps::enuAppMode)
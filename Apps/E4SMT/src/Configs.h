@@ -72,6 +72,8 @@ public:
     static Common::Configuration::tmplConfigurable<bool>                NoSpellcorrector;
     static Common::Configuration::tmplConfigurable<bool>                Recursive;
     static Common::Configuration::tmplConfigurable<bool>                BreakLines;
+    static Common::Configuration::tmplConfigurable<quint16>             MaxThreads;
+    static Common::Configuration::tmplRangedConfigurable<quint32>       BatchSize;
 };
 
 }
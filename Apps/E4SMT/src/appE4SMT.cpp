@@ -22,11 +22,13 @@
  * @author S. Mohammad M. Ziabary <ziabary@targoman.com>
  */
 
+#include <QtConcurrent/QtConcurrent>
 #include "appE4SMT.h"
 #include "libTargomanTextProcessor/TextProcessor.h"
 #include "XMLReader.h"
 #include "Configs.h"
 #include <iostream>
+#include <functional>
 
 namespace Targoman {
 namespace Apps {
@@ -35,13 +37,126 @@ using namespace NLPLibs;
 using namespace Common;
 using namespace Common::Configuration;
 
-thread_local static QList<stuIXMLReplacement> SentenceBreakReplacements;
+// Filled once before any worker starts and just read afterwards. Each call to text2IXML works on its own copy.
+static QList<stuIXMLReplacement> SentenceBreakReplacements;
 
+/**
+ * @brief Result of processing one input item (line) of a file on a worker thread. Exceptions can not be passed
+ * through QtConcurrent so their message is stored in Error.
+ */
+struct stuProcessedItem{
+    QString Output;
+    QString Error;
+};
 
+static stuProcessedItem processItem(enuAppMode::Type _mode, const QString& _item)
+{
+    stuProcessedItem Result;
+    bool SpellCorrected;
+    try{
+        switch(_mode){
+        case enuAppMode::Text2IXML:
+            Result.Output = TargomanTextProcessor::instance().text2IXML(
+                        _item,
+                        SpellCorrected,
+                        gConfigs::Language.value(),
+                        0,
+                        false,
+                        (gConfigs::NoSpellcorrector.value() ? false : true),
+                        QList<enuTextTags::Type>(),
+                        SentenceBreakReplacements
+                        );
+            break;
+        case enuAppMode::IXML2Text:
+            Result.Output = TargomanTextProcessor::instance().ixml2Text(
+                        _item,
+                        "",
+                        true,
+                        true,
+                        false);
+            break;
+        case enuAppMode::Tokenize:
+            Result.Output = TargomanTextProcessor::instance().ixml2Text(
+                        TargomanTextProcessor::instance().text2IXML(
+                            _item,
+                            SpellCorrected,
+                            gConfigs::Language.value(),
+                            0,
+                            false,
+                            (gConfigs::NoSpellcorrector.value() ? false : true),
+                            QList<enuTextTags::Type>(),
+                            SentenceBreakReplacements
+                            ),
+                        "",
+                        false,
+                        false,
+                        false);
+            break;
+        case enuAppMode::Normalize:
+            Result.Output = TargomanTextProcessor::instance().normalizeText(
+                        _item,
+                        SpellCorrected,
+                        false,
+                        gConfigs::Language.value());
+            break;
+        default:
+            Result.Error = "Invalid action selected for file items";
+        }
+    }catch(Common::exTargomanBase& e){
+        Result.Error = e.what();
+    }
+    return Result;
+}
+
+/**
+ * @brief Reads items of an input file in batches. Plain text files are streamed line by line while XML files are
+ * parsed at once and then served in batches.
+ */
+class clsFileItemReader{
+public:
+    clsFileItemReader(const QString& _filePath) :
+        NextXMLItem(0)
+    {
+        if (QFileInfo(_filePath).suffix() != "xml" || gConfigs::PlainText.value()){
+            this->File.setFileName(_filePath);
+            this->File.open(QIODevice::ReadOnly);
+            if (this->File.isReadable() == false)
+                throw exAppE4SMT("Unable to open: <" + _filePath + "> for reading");
+            this->Stream.setDevice(&this->File);
+            this->Stream.setCodec("UTF8");
+        }else
+            this->XMLItems = XMLReader::getContext(_filePath, gConfigs::KeepTitles.value());
+    }
+
+    /**
+     * @brief reads at most _maxItems next items of the file.
+     * @return false when there are no more items
+     */
+    bool read(QStringList& _items, int _maxItems){
+        _items.clear();
+        if (this->Stream.device()){
+            while(_items.size() < _maxItems && this->Stream.atEnd() == false)
+                _items.append(this->Stream.readLine());
+        }else{
+            _items = this->XMLItems.mid(this->NextXMLItem, _maxItems);
+            this->NextXMLItem += _items.size();
+        }
+        return _items.size();
+    }
+
+private:
+    QFile       File;
+    QTextStream Stream;
+    QStringList XMLItems;
+    int         NextXMLItem;
+};
 
 void appE4SMT::slotExecute()
 {
     try{
+        if (gConfigs::MaxThreads.value())
+            QThreadPool::globalInstance()->setMaxThreadCount(gConfigs::MaxThreads.value());
+
         if (gConfigs::BreakLines.value())
             SentenceBreakReplacements.append(
                         stuIXMLReplacement(
@@ -100,6 +215,7 @@ void appE4SMT::slotExecute()
                     std::cout<<TargomanTextProcessor::instance().normalizeText(
                                    gConfigs::Input.value(),
                                    SpellCorrected,
+                                   false,
                                    gConfigs::Language.value()).toUtf8().constData()<<std::endl;
                     break;
                 default:
@@ -115,7 +231,9 @@ void appE4SMT::slotExecute()
                                   );
             }else if (gConfigs::InputDir.value().size()){
                 TargomanTextProcessor::instance().init(ConfigManager::instance().configSettings());
-                this->processDir("/./", gConfigs::InputDir.value());
+                FileJobs_t Jobs;
+                this->processDir("/./", gConfigs::InputDir.value(), Jobs);
+                this->processFiles(Jobs);
             }else
                 throw exAppE4SMT("No job defined to be done");
 
@@ -211,7 +329,11 @@ Targoman::Common::Configuration::stuRPCOutput appE4SMT::rpcTokenize(const QVaria
     return stuRPCOutput(Text, Args);
 }
 
-void appE4SMT::processDir(const QString &_relativeDir, const QString& _basePath)
+/**
+ * @brief appE4SMT::processDir collects files to be processed in _jobs as (input, output) pairs. Output directories
+ * are created while walking the tree.
+ */
+void appE4SMT::processDir(const QString &_relativeDir, const QString& _basePath, FileJobs_t& _jobs)
 {
     QDir Dir(_basePath + _relativeDir);
     const QList<QFileInfo>& SelectedFiles = Dir.entryInfoList(
@@ -221,19 +343,51 @@ void appE4SMT::processDir(const QString &_relativeDir, const QString& _basePath)
         if (FileInfo.isDir()){
             if(gConfigs::OutputPath.value().size())
                 QDir().mkpath(gConfigs::OutputPath.value() + '/' + _relativeDir + '/' + FileInfo.fileName());
-            this->processDir(_relativeDir + "/" + FileInfo.fileName(), _basePath);
+            this->processDir(_relativeDir + "/" + FileInfo.fileName(), _basePath, _jobs);
         }else{
             if (gConfigs::IncludePattern.value().pattern().size() &&
                     gConfigs::IncludePattern.value().exactMatch(FileInfo.fileName()) == false)
                 continue;
-            this->processFile(gConfigs::InputDir.value() + '/' + _relativeDir + '/' + FileInfo.fileName(),
-                              (gConfigs::OutputPath.value().isEmpty() ?
-                                  gConfigs::InputDir.value()  : gConfigs::OutputPath.value())
-                              + '/' + _relativeDir + '/' + FileInfo.fileName());
+            _jobs.append(qMakePair(gConfigs::InputDir.value() + '/' + _relativeDir + '/' + FileInfo.fileName(),
+                                   (gConfigs::OutputPath.value().isEmpty() ?
+                                        gConfigs::InputDir.value()  : gConfigs::OutputPath.value())
+                                   + '/' + _relativeDir + '/' + FileInfo.fileName()));
         }
     }
 }
 
+/**
+ * @brief appE4SMT::processFiles processes collected files concurrently when each one is written to its own output
+ * file. When output is standard output or in validation mode (libxml2 error handler is global) files are processed
+ * one after another. Lines of each file are processed concurrently in both cases.
+ */
+void appE4SMT::processFiles(const FileJobs_t &_jobs)
+{
+    if (gConfigs::OutputPath.value().isEmpty() || gConfigs::Mode.value() == enuAppMode::Validate){
+        foreach(const auto& Job, _jobs)
+            this->processFile(Job.first, Job.second);
+        return;
+    }
+
+    QThreadPool FilesPool;
+    FilesPool.setMaxThreadCount(qMax(1, qMin(QThreadPool::globalInstance()->maxThreadCount(), _jobs.size())));
+    QMutex ErrorsLock;
+    QStringList Errors;
+    foreach(const auto& Job, _jobs)
+        QtConcurrent::run(&FilesPool, [this, Job, &ErrorsLock, &Errors](){
+            try{
+                this->processFile(Job.first, Job.second);
+            }catch(Common::exTargomanBase& e){
+                QMutexLocker Locker(&ErrorsLock);
+                Errors.append(e.what());
+            }
+        });
+    FilesPool.waitForDone();
+
+    if (Errors.size())
+        throw exAppE4SMT(Errors.first());
+}
+
 #define OPEN_OUT_STREAM(_extension) \
     if (gConfigs::OutputPath.value().isEmpty()) OutFile.open(stdout, QIODevice::WriteOnly); \
     else{ \
@@ -248,88 +402,61 @@ void appE4SMT::processDir(const QString &_relativeDir, const QString& _basePath)
     } OutStream.setCodec("UTF8");
 
 
+/**
+ * @brief appE4SMT::processFile streams input file in batches of BatchSize items. Each batch is processed on the
+ * global thread pool while the next one is being read and results are written in input order.
+ */
 void appE4SMT::processFile(const QString& _inputFile, const QString &_outFile)
 {
     TargomanDebug(4,"<<<<<<<<<<<<< " + _inputFile);
     QFile OutFile;
     QTextStream OutStream(&OutFile);
 
-    bool SpellCorrected;
-    switch(gConfigs::Mode.value()){
+    enuAppMode::Type Mode = gConfigs::Mode.value();
+    switch(Mode){
     case enuAppMode::Validate:
         XMLReader::isValid(_inputFile);
-        break;
+        TargomanDebug(4,">>>>>>>>>>>>> " << _inputFile);
+        return;
     case enuAppMode::Text2IXML:
         OPEN_OUT_STREAM("ixml");
-        foreach (const QString& Line, this->retrieveFileItems(_inputFile))
-            OutStream<<TargomanTextProcessor::instance().text2IXML(
-                           Line,
-                           SpellCorrected,
-                           gConfigs::Language.value(),
-                           0,
-                           false,
-                           (gConfigs::NoSpellcorrector.value() ? false : true),
-                           QList<enuTextTags::Type>(),
-                           SentenceBreakReplacements
-                           )<<"\n";
         break;
     case enuAppMode::IXML2Text:
         OPEN_OUT_STREAM("txt");
-        foreach (const QString& Line, this->retrieveFileItems(_inputFile))
-            OutStream<<TargomanTextProcessor::instance().ixml2Text(
-                           Line,
-                           "",
-                           true,
-                           true,
-                           false)<<"\n";
         break;
     case enuAppMode::Tokenize:
         OPEN_OUT_STREAM("tokenized");
-        foreach (const QString& Line, this->retrieveFileItems(_inputFile))
-            OutStream<<TargomanTextProcessor::instance().ixml2Text(
-                           TargomanTextProcessor::instance().text2IXML(
-                               Line,
-                               SpellCorrected,
-                               gConfigs::Language.value(),
-                               0,
-                               false,
-                               (gConfigs::NoSpellcorrector.value() ? false : true),
-                               QList<enuTextTags::Type>(),
-                               SentenceBreakReplacements
-                               ),
-                           "",
-                           false,
-                           false,
-                           false)<<"\n";
         break;
     case enuAppMode::Normalize:
         OPEN_OUT_STREAM("normalized");
-        foreach (const QString& Line, this->retrieveFileItems(_inputFile))
-            OutStream<<TargomanTextProcessor::instance().normalizeText(
-                           Line,
-                           SpellCorrected,
-                           gConfigs::Language.value())<<"\n";
         break;
     default:
         throw exAppE4SMT("Invalid action selected for simple input");
     }
-    TargomanDebug(4,">>>>>>>>>>>>> " << OutFile.fileName() );
-}
 
-QStringList appE4SMT::retrieveFileItems(const QString &_filePath)
-{
-    QStringList Lines;
-    if (QFileInfo(_filePath).suffix() != "xml" || gConfigs::PlainText.value()){
-        QFile File(_filePath);
-        File.open(QIODevice::ReadOnly);
-        if (File.isReadable() == false)
-            throw exAppE4SMT("Unable to open: <" + _filePath + "> for reading");
-        QTextStream Stream(&File);
-        Stream.setCodec("UTF8");
-        Lines = Stream.readAll().split("\n");
-    }else
-        Lines = XMLReader::getContext(_filePath, gConfigs::KeepTitles.value());
-    return Lines;
+    std::function<stuProcessedItem(const QString&)> Processor = [Mode](const QString& _item){
+        return processItem(Mode, _item);
+    };
+
+    clsFileItemReader Reader(_inputFile);
+    QStringList Items;
+    Reader.read(Items, gConfigs::BatchSize.value());
+    while(Items.size()){
+        QFuture<stuProcessedItem> Results = QtConcurrent::mapped(Items, Processor);
+        QStringList NextItems;
+        Reader.read(NextItems, gConfigs::BatchSize.value());
+        Results.waitForFinished();
+
+        for (int i = 0; i < Items.size(); ++i){
+            const stuProcessedItem& Result = Results.resultAt(i);
+            if (Result.Error.size())
+                throw exAppE4SMT(QString("%1: %2").arg(_inputFile).arg(Result.Error));
+            OutStream<<Result.Output<<"\n";
+        }
+        Items = NextItems;
+    }
+    OutStream.flush();
+    TargomanDebug(4,">>>>>>>>>>>>> " << OutFile.fileName() );
 }
 
 void appE4SMT::slotPong(QString _ssid, Targoman::Common::stuPong &_pong)
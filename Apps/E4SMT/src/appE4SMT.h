@@ -62,9 +62,11 @@ private slots:
     Common::Configuration::stuRPCOutput rpcTokenize(const QVariantMap&);
 
 private:
-    void processDir(const QString& _dir, const QString &_basePath);
+    typedef QList<QPair<QString, QString> > FileJobs_t;
+
+    void processDir(const QString& _dir, const QString &_basePath, FileJobs_t& _jobs);
+    void processFiles(const FileJobs_t& _jobs);
     void processFile(const QString &_inputFile, const QString& _outFile);
-    QStringList retrieveFileItems(const QString& _filePath);
 };
 
 }
@@ -66,6 +66,13 @@ Common::JSONConversationProtocol::stuResponse TSManager::baseTranslation(const Q
     QString Dir = _args.value("dir").toString();
     qint32  PreferedServerInex = _args.value("pref", -1).toInt();
 
+    // Translation servers are asked to finish in 80% of the time we wait for them, leaving room for completion of
+    // a cut short search and transfer of the results. Tighter budgets requested by client are kept.
+    QVariantMap Args = _args;
+    qint64 TimeBudget = TSManager::MaxTranslationTime.value() * 800;
+    if (Args.value("tmo", 0).toLongLong() <= 0 || Args.value("tmo").toLongLong() > TimeBudget)
+        Args.insert("tmo", TimeBudget);
+
     if (gConfigs::TranslationServers.contains(Dir) == false)
         throw exTSManager("No translation server found for direction: " + Dir);
 
@@ -81,7 +88,7 @@ Common::JSONConversationProtocol::stuResponse TSManager::baseTranslation(const Q
                         Dir,
                         PreferedServerInex,
                         "rpcTranslate",
-                        _args));
+                        Args));
             TargomanLogInfo(4,"Trying to translate using Server: "<<Dir<<":"<<BestServer->configIndex());
             connect(BestServer.data(), &clsTranslationServer::sigReadyForFirstRequest,
                     BestServer.data(), &clsTranslationServer::slotSendPredefinedRequest,
@@ -96,6 +103,9 @@ Common::JSONConversationProtocol::stuResponse TSManager::baseTranslation(const Q
                 QCoreApplication::processEvents();
                 ++ElapsedCentiSeconds;
                 if (ElapsedCentiSeconds > TSManager::MaxTranslationTime.value() * 100){
+                    // Closing connection cancels the translation on server so that it does not keep decoding
+                    BestServer->blockSignals(true);
+                    BestServer->disconnectFromHost();
                     BestServer->deleteLater();
                     throw exTSManager("Translation TimedOut");
                 }
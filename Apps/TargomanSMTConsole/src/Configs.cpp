@@ -111,6 +111,16 @@ tmplConfigurable<quint16>     gConfigs::MaxThreads(
         "MAX_THREADS",
         "max-threads");
 
+tmplRangedConfigurable<quint32>     gConfigs::BatchSize(
+        gConfigs::appConfig("BatchSize"),
+        "Number of input lines translated together sharing phrase candidates",
+        1, 100000,
+        500,
+        ReturnTrueCrossValidator(),
+        "b",
+        "BATCH_SIZE",
+        "batch-size");
+
 }
 }
 
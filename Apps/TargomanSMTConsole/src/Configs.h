@@ -59,6 +59,7 @@ public:
     static Common::Configuration::tmplConfigurable<QString>             InputText;
     static Common::Configuration::tmplConfigurable<QString>             OutputFile;
     static Common::Configuration::tmplConfigurable<quint16>             MaxThreads;
+    static Common::Configuration::tmplRangedConfigurable<quint32>       BatchSize;
 };
 
 }
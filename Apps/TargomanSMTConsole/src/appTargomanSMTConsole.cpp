@@ -65,11 +65,14 @@ void appTargomanSMTConsole::slotExecute()
                 InStream.setCodec("UTF-8");
                 QThreadPool::globalInstance()->setMaxThreadCount(gConfigs::MaxThreads.value());
                 Translator::init(ConfigManager::instance().configSettings());
-                int Index = 0;
+                quint64 Index = 1;
                 while(InStream.atEnd() == false){
-                    QThreadPool::globalInstance()->start(new clsTranslationJob(++Index, InStream.readLine()));
+                    QStringList Batch;
+                    while(InStream.atEnd() == false && (quint32)Batch.size() < gConfigs::BatchSize.value())
+                        Batch.append(InStream.readLine());
+                    clsTranslationJob(Index, Batch).run();
+                    Index += Batch.size();
                 }
-                QThreadPool::globalInstance()->waitForDone();
                 TranslationWriter::instance().finialize();
             }else{
                 TargomanWarn(1,"No job to be done!!!");
@@ -31,17 +31,20 @@ namespace Apps {
 
 using namespace SMT;
 
-clsTranslationJob::clsTranslationJob(quint64 _index, const QString& _sourceString)
+clsTranslationJob::clsTranslationJob(quint64 _firstIndex, const QStringList& _sourceStrings)
 {
-    this->SourceString = _sourceString;
-    this->Index = _index;
+    this->SourceStrings = _sourceStrings;
+    this->FirstIndex = _firstIndex;
 }
 
 void clsTranslationJob::run()
 {
-    TranslationWriter::instance().writeTranslation(
-                this->Index,
-                Translator::translate(this->SourceString, enuOutputFormat::JustBestTranslation).Translations.first());
+    quint64 Index = this->FirstIndex;
+    foreach(const stuTranslationOutput& Output,
+            Translator::translateBatch(this->SourceStrings, enuOutputFormat::JustBestTranslation))
+        TranslationWriter::instance().writeTranslation(
+                    Index++,
+                    Output.Translations.isEmpty() ? QString() : Output.Translations.first());
 }
 
 }
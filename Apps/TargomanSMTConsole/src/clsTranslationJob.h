@@ -25,21 +25,24 @@
 #ifndef TARGOMAN_APPS_CLSTRANSLATIONJOB_H
 #define TARGOMAN_APPS_CLSTRANSLATIONJOB_H
 
-#include <QRunnable>
-#include <QString>
+#include <QStringList>
 
 namespace Targoman {
 namespace Apps {
 
-class clsTranslationJob : public QRunnable
+/**
+ * @brief The clsTranslationJob class translates a batch of input lines at once so that phrase candidates of
+ * repeated phrases are collected just once per batch.
+ */
+class clsTranslationJob
 {
 public:
-    clsTranslationJob(quint64 _index, const QString &_sourceString);
+    clsTranslationJob(quint64 _firstIndex, const QStringList &_sourceStrings);
     void run();
 
 private:
-    quint64 Index;
-    QString SourceString;
+    quint64 FirstIndex;
+    QStringList SourceStrings;
 };
 
 }
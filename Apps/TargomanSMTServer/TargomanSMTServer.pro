@@ -24,14 +24,16 @@ BasePath = "."
 HEADERS += \
     src/Configs.h \
     src/appTargomanSMTServer.h \
-    src/clsTranslationJob.h
+    src/clsTranslationJob.h \
+    src/clsTranslationScheduler.h
 
 # +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-#
 SOURCES += \
     src/main.cpp \
     src/Configs.cpp \
     src/appTargomanSMTServer.cpp \
-    src/clsTranslationJob.cpp
+    src/clsTranslationJob.cpp \
+    src/clsTranslationScheduler.cpp
 
 QT+=concurrent
 
@@ -33,7 +33,7 @@ using namespace Common::Configuration;
 
 tmplRangedConfigurable<quint16>     gConfigs::MaxThreads(
         gConfigs::appConfig("MaxThreads"),
-        "Maximum Concurrent Translations",
+        "Number of decode workers. Set to zero to use number of CPU cores",
         0,255,
         64,
         ReturnTrueCrossValidator(),
@@ -41,5 +41,35 @@ tmplRangedConfigurable<quint16>     gConfigs::MaxThreads(
         "MAX_THREADS",
         "max-threads");
 
+tmplRangedConfigurable<quint32>     gConfigs::MaxCachedTranslations(
+        gConfigs::appConfig("MaxCachedTranslations"),
+        "Maximum number of translated sentences to be cached. Least recently used sentences are dropped when it is "
+        "reached. Set to zero to disable cache",
+        0,10000000,
+        100000,
+        ReturnTrueCrossValidator());
+
+tmplRangedConfigurable<quint32>     gConfigs::MaxQueuedSentences(
+        gConfigs::appConfig("MaxQueuedSentences"),
+        "Maximum number of sentences waiting to be translated. New requests will be rejected when exceeded. Set to zero to disable",
+        0,10000000,
+        10000,
+        ReturnTrueCrossValidator());
+
+tmplRangedConfigurable<quint32>     gConfigs::MaxQueuedWords(
+        gConfigs::appConfig("MaxQueuedWords"),
+        "Maximum number of words waiting to be translated. New requests will be rejected when exceeded. Set to zero to disable",
+        0,100000000,
+        250000,
+        ReturnTrueCrossValidator());
+
+tmplRangedConfigurable<quint16>     gConfigs::MaxRequestPriority(
+        gConfigs::appConfig("MaxRequestPriority"),
+        "Maximum priority which can be requested by clients. Higher priorities are lowered to this value while "
+        "negative priorities are always accepted",
+        0,1000,
+        0,
+        ReturnTrueCrossValidator());
+
 }
 }
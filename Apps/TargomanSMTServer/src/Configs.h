@@ -43,6 +43,10 @@ public:
     }
 
     static Common::Configuration::tmplRangedConfigurable<quint16>           MaxThreads;
+    static Common::Configuration::tmplRangedConfigurable<quint32>           MaxCachedTranslations;
+    static Common::Configuration::tmplRangedConfigurable<quint32>           MaxQueuedSentences;
+    static Common::Configuration::tmplRangedConfigurable<quint32>           MaxQueuedWords;
+    static Common::Configuration::tmplRangedConfigurable<quint16>           MaxRequestPriority;
 };
 
 }
@@ -32,6 +32,7 @@
 #include "libTargomanCommon/SimpleAuthentication.h"
 #include "libTargomanTextProcessor/TextProcessor.h"
 #include "clsTranslationJob.h"
+#include "clsTranslationScheduler.h"
 
 namespace Targoman {
 namespace Apps {
@@ -62,7 +63,8 @@ void appTargomanSMTServer::slotExecute()
         Targoman::SMT::Translator::init(ConfigManager::instance().configSettings());
         Targoman::NLPLibs::TargomanTextProcessor::instance().init(ConfigManager::instance().configSettings());
 
-        QThreadPool::globalInstance()->setMaxThreadCount(gConfigs::MaxThreads.value());
+        clsTranslationScheduler::instance().start(gConfigs::MaxThreads.value());
+        clsTranslationJob::initCache();
         Configuration::ConfigManager::instance().startAdminServer();
 
         /*clsTranslationJob* TRJ = new clsTranslationJob(false, false);
@@ -114,9 +116,9 @@ stuRPCOutput appTargomanSMTServer::rpcGetStatistics(const QVariantMap &)
         Args.insert("L1", qMin(int((float(SysInfo.loads[0])/shiftfloat/get_nprocs()) * 100.), 100));
         Args.insert("L15",qMin(int((float(SysInfo.loads[2])/shiftfloat/get_nprocs()) * 100.), 100));
         Args.insert("FM", qMin(int(double(SysInfo.freeram)/double(SysInfo.totalram) * 100.), 100));
-        Args.insert("TQ", qMin(int(double(QThreadPool::globalInstance()->activeThreadCount()) /
-                                   double(QThreadPool::globalInstance()->maxThreadCount())*100.),100));
     }
+    Args.unite(clsTranslationScheduler::instance().statistics());
+    Args.unite(clsTranslationJob::cacheStatistics());
 
     return stuRPCOutput(1, Args);
 }
@@ -126,16 +128,24 @@ stuRPCOutput appTargomanSMTServer::rpcTranslate(const QVariantMap &_args)
     QString Text  = _args.value("txt").toString();
     if (Text.isEmpty())
         throw exTargomanSMTServer("Obligatory argument 'txt' missing");
+    QString WeightProfile = _args.value("prof").toString();
+    if (WeightProfile.size() && Targoman::SMT::Translator::weightProfiles().contains(WeightProfile) == false)
+        throw exTargomanSMTServer("Unknown weight profile: " + WeightProfile);
 
     QString UUID=QUuid::createUuid().toString();
-    TargomanLogInfo(6,QString("rpcTranslate::start(UUID=%1,brief=%2,keep=%3,txt=%4)").arg(
+    TargomanLogInfo(6,QString("rpcTranslate::start(UUID=%1,brief=%2,keep=%3,tmo=%4,prof=%5,txt=%6)").arg(
                          UUID).arg(
                          _args.value("brief",false).toBool()).arg(
                          _args.value("keep",false).toBool()).arg(
+                         _args.value("tmo",0).toLongLong()).arg(
+                         WeightProfile).arg(
                          _args.value("txt").toString().replace("\n","\\n")));
     QVariantMap Result;
     Result.insert("t",clsTranslationJob(_args.value("brief",false).toBool(),
-                                        _args.value("keep",false).toBool()).doJob(Text));
+                                        _args.value("keep",false).toBool(),
+                                        _args.value("prio",0).toInt(),
+                                        _args.value("tmo",0).toLongLong(),
+                                        WeightProfile).doJob(Text));
 
     TargomanLogInfo(6,QString("rpcTranslate::result(UUID=%1)").arg(UUID));
     return stuRPCOutput(1, Result);
@@ -23,13 +23,16 @@
  */
 
 
+#include <climits>
+#include <algorithm>
 #include "clsTranslationJob.h"
-#include <QtConcurrent/QtConcurrent>
-#include <functional>
 #include "libTargomanTextProcessor/TextProcessor.h"
 #include "libTargomanCommon/Configuration/ConfigManager.h"
+#include "libTargomanCommon/Configuration/intfRPCExporter.hpp"
 #include "libTargomanCommon/Helpers.hpp"
 #include "libTargomanCommon/Types.h"
+#include "Configs.h"
+#include "clsTranslationScheduler.h"
 
 namespace Targoman {
 namespace Apps {
@@ -40,103 +43,205 @@ using namespace Common::Configuration;
 
 QString clsTranslationJob::SourceLanguage;
 QString clsTranslationJob::TargetLanguage;
+Common::tmplBoundedCache<QHash, QString, stuTranslationOutput> clsTranslationJob::TranslationCache;
+QAtomicInt clsTranslationJob::CachedConfigRevision;
+QAtomicInteger<quint64> clsTranslationJob::CacheHits;
+QAtomicInteger<quint64> clsTranslationJob::CacheMisses;
 
-clsTranslationJob::clsTranslationJob(bool _brief, bool _keepAsSource)
+/**
+ * @param _timeout time budget of the job in milliseconds starting from now. Zero means unlimited.
+ * @param _weightProfile name of the weight profile to be used. Empty means default weights.
+ * Job is cancelled when client of the RPC which has created it disconnects.
+ */
+clsTranslationJob::clsTranslationJob(bool _brief,
+                                     bool _keepAsSource,
+                                     qint32 _priority,
+                                     qint64 _timeout,
+                                     const QString& _weightProfile)
 {
     this->Brief = _brief;
     this->KeepAsSource = _keepAsSource;
+    this->Priority = _priority;
+    this->Deadline = stuTranslationDeadline::fromTimeout(_timeout, intfRPCExporter::cancellationFlag());
+    this->WeightProfile = _weightProfile;
     TargomanTextProcessor::instance();
 }
 
-QVariantList clsTranslationJob::doJob(const QString &_inputStr)
+/**
+ * @brief Translates all sentences of all lines of input at once using decode workers of clsTranslationScheduler so
+ * that no thread waits for another thread of the same pool.
+ * @return JSON fragment of response sections which are built line by line
+ */
+QVariant clsTranslationJob::doJob(const QString &_inputStr)
 {
     QStringList Lines = _inputStr.trimmed().split("\n");
-    QVariantList Result = QtConcurrent::blockingMappedReduced<QVariantList>(
-                Lines,
-                std::bind(&clsTranslationJob::mapLineTranslation,this, std::placeholders::_1),
-                std::bind(&clsTranslationJob::reduceLineTranslation,this, std::placeholders::_1, std::placeholders::_2),
-                QtConcurrent::OrderedReduce);
+    QList<stuTranslationOutput> LineResults;
+    QList<int> LineInputsCount;
+    QStringList Inputs;
+    foreach(const QString& Line, Lines){
+        QStringList LineInputs;
+        LineResults.append(this->prepareLineTranslation(Line, LineInputs));
+        LineInputsCount.append(LineInputs.size());
+        Inputs.append(LineInputs);
+    }
 
-    return Result;
+    QList<stuTranslationOutput> Translations = this->cachedTranslate(Inputs);
+
+    int InputIndex = 0;
+    for(int i = 0; i < LineResults.size(); ++i){
+        for(int j = 0; j < LineInputsCount.at(i); ++j)
+            this->reduceSentenceTranslation(LineResults[i], Translations.at(InputIndex++));
+        this->reduceLineTranslation(LineResults.at(i));
+    }
+
+    QString Result = "[" + this->TranslationSection.toFragment().JSON;
+    if (this->Brief == false)
+        Result += "," + this->IndexSection.toFragment().JSON + "," + this->AlignmentSection.toFragment().JSON;
+    return QVariant::fromValue(Common::stuJSONFragment(Result + "]"));
 }
 
-stuTranslationOutput clsTranslationJob::mapLineTranslation(const QString &_line)
+void clsTranslationJob::initCache()
 {
-    if(_line.isEmpty())
-        return stuTranslationOutput();
+    clsTranslationJob::CachedConfigRevision = (int)ConfigManager::instance().revision();
+    clsTranslationJob::TranslationCache.setMaxItems(gConfigs::MaxCachedTranslations.value());
+}
 
-    stuTranslationOutput Result;
-    bool SpellCorrected = false;
-    QString TaggedSource = TargomanTextProcessor::instance().text2IXML(
-                _line,
-                SpellCorrected,
-                clsTranslationJob::SourceLanguage);
+QVariantMap clsTranslationJob::cacheStatistics()
+{
+    QVariantMap Stats;
+    Stats.insert("CH", clsTranslationJob::CacheHits.load());
+    Stats.insert("CM", clsTranslationJob::CacheMisses.load());
+    Stats.insert("CS", clsTranslationJob::TranslationCache.size());
+    return Stats;
+}
+
+/**
+ * @brief Translates inputs using cached results when possible. Inputs not found in cache are queued to be translated
+ * by decode workers.
+ * As cache is shared between all jobs, repeated sentences are translated just once. Cache is flushed whenever
+ * configuration (weights, models, etc.) is changed at runtime.
+ * @return translations in the same order as inputs
+ */
+QList<stuTranslationOutput> clsTranslationJob::cachedTranslate(const QStringList &_inputs)
+{
+    enuOutputFormat::Type OutputFormat = this->Brief ?
+                enuOutputFormat::JustBestTranslation :
+                enuOutputFormat::BestTranslationAndPhraseSuggestions;
 
+    if (gConfigs::MaxCachedTranslations.value() == 0)
+        return clsTranslationScheduler::instance().translate(
+                    _inputs, OutputFormat, this->Priority, this->Deadline, this->WeightProfile);
 
-    if (this->KeepAsSource){
-        Result = Translator::translate(_line, this->Brief ? enuOutputFormat::JustBestTranslation : enuOutputFormat::BestTranslationAndPhraseSuggestions);
-    }else{
+    quint32 ConfigRevision = ConfigManager::instance().revision();
+    if ((quint32)clsTranslationJob::CachedConfigRevision.fetchAndStoreOrdered((int)ConfigRevision) != ConfigRevision){
+        clsTranslationJob::TranslationCache.reset(gConfigs::MaxCachedTranslations.value());
+    }
 
-        QStringList NormalizedSentences = TaggedSource.replace(
-                    " . ", " .\n").split("\n",QString::SkipEmptyParts);
+    QString KeyPrefix = QString("%1>%2:%3:%4:%5:%6:").arg(
+                clsTranslationJob::SourceLanguage).arg(
+                clsTranslationJob::TargetLanguage).arg(
+                OutputFormat).arg(
+                this->KeepAsSource).arg(
+                this->WeightProfile).arg(
+                ConfigRevision);
+
+    QList<stuTranslationOutput> Results;
+    QStringList Keys;
+    QStringList MissedInputs;
+    QHash<QString, int> MissedKeys;
+    foreach(const QString& Input, _inputs){
+        QString Key = KeyPrefix + Input;
+        Keys.append(Key);
+        Results.append(clsTranslationJob::TranslationCache.value(Key));
+        if (Results.last().Translations.size()){
+            clsTranslationJob::CacheHits.ref();
+        }else{
+            clsTranslationJob::CacheMisses.ref();
+            if (MissedKeys.contains(Key) == false){
+                MissedKeys.insert(Key, MissedInputs.size());
+                MissedInputs.append(Input);
+            }
+        }
+    }
+
+    if (MissedInputs.isEmpty())
+        return Results;
 
-        Result = QtConcurrent::blockingMappedReduced<stuTranslationOutput>(
-                    NormalizedSentences,
-                    std::bind(&clsTranslationJob::mapSentenceTranslation,this, std::placeholders::_1),
-                    std::bind(&clsTranslationJob::reduceSentenceTranslation,this, std::placeholders::_1, std::placeholders::_2),
-                    QtConcurrent::OrderedReduce);
+    QList<stuTranslationOutput> Translations =
+            clsTranslationScheduler::instance().translate(
+                MissedInputs, OutputFormat, this->Priority, this->Deadline, this->WeightProfile);
+    for(int i = 0; i < Results.size(); ++i){
+        if (Results.at(i).Translations.size())
+            continue;
+        Results[i] = Translations.at(MissedKeys.value(Keys.at(i)));
     }
+    // Translations cut short by deadline must not be served to requests with enough time budget
+    for(auto MissIter = MissedKeys.constBegin(); MissIter != MissedKeys.constEnd(); ++MissIter)
+        if (Translations.at(MissIter.value()).Translations.size() &&
+            Translations.at(MissIter.value()).Degraded == false)
+            clsTranslationJob::TranslationCache.insert(MissIter.key(), Translations.at(MissIter.value()));
+    return Results;
+}
+
+/**
+ * @brief Converts line to IXML and prepares its translation output with everything except translations.
+ * @param _line input line
+ * @param _inputs will be filled with inputs to be translated for this line
+ */
+stuTranslationOutput clsTranslationJob::prepareLineTranslation(const QString &_line, QStringList& _inputs)
+{
+    stuTranslationOutput Result;
+    Result.Translations.append(QString());
+    if(_line.isEmpty())
+        return Result;
+
+    bool SpellCorrected = false;
+    QList<stuPos> TokenSpans;
+    QString TaggedSource = TargomanTextProcessor::instance().text2IXML(
+                _line,
+                SpellCorrected,
+                clsTranslationJob::SourceLanguage,
+                0,
+                true,
+                true,
+                QList<enuTextTags::Type>(),
+                QList<stuIXMLReplacement>(),
+                this->Brief ? NULL : &TokenSpans);
+
+    if (this->KeepAsSource)
+        _inputs.append(_line);
+    else
+        _inputs = TaggedSource.replace(" . ", " .\n").split("\n",QString::SkipEmptyParts);
 
     Result.TaggedSource = TaggedSource.replace('\n',' ');
     Result.SpellCorrected = SpellCorrected;
     Result.OriginalSource   = _line;
+    Result.SourceTokenSpans = TokenSpans;
     return Result;
 }
 
-stuTranslationOutput clsTranslationJob::mapSentenceTranslation(const QString &_ixml)
-{
-    return Translator::translate(_ixml, this->Brief ? enuOutputFormat::JustBestTranslation : enuOutputFormat::BestTranslationAndPhraseSuggestions);
-}
-
-//TODO this method must be revised and optimized after upgrading WebInterface
-void clsTranslationJob::reduceLineTranslation(QVariantList &_result,
-                                              const stuTranslationOutput &_intermediate)
+/**
+ * @brief Appends translation of a line to response sections. Each section is serialized in place so that cost of
+ * adding a line does not depend on number of lines already added.
+ */
+void clsTranslationJob::reduceLineTranslation(const stuTranslationOutput &_intermediate)
 {
-    if (_result.isEmpty()){
-        _result.insert(0,QVariantList());//TranslationSection
-        if (this->Brief == false){
-            _result.insert(1,QVariantList());//IndexSection
-            _result.insert(2,QVariantList());//AlignmentSection
-        }
-    }
-
-    QVariantList TranslationSection = (_result[0].toList().isEmpty() ? QVariantList() : _result[0].toList());
-    TranslationSection.insert(TranslationSection.size(),
-                              QVariantList()<<
-                              TargomanTextProcessor::instance().ixml2Text(_intermediate.Translations.first())<<
-                              _intermediate.TaggedSource);
-    _result[0] = TranslationSection;
+    this->TranslationSection.append(QVariantList()<<
+                                    TargomanTextProcessor::instance().ixml2Text(_intermediate.Translations.first())<<
+                                    _intermediate.TaggedSource);
 
     if (this->Brief == false){
-        QMap<size_t, QString> PhraseIndexMap;
-        QMap<size_t, QVariantList> AlignInfoMap;
+        // Phrase index and alignment info of each phrase, keyed by position of phrase in translation
+        struct stuPhraseInfo{
+            size_t          TargetPos;
+            QString         Phrase;
+            QVariantList    AlignInfo;
+        };
+        QVector<stuPhraseInfo> PhraseInfos;
+        PhraseInfos.reserve(_intermediate.BestTranslationPhraseAlternatives.size());
         QStringList TranslationWords = _intermediate.Translations.first().split(" ", QString::SkipEmptyParts);
         QStringList SourceWords = _intermediate.TaggedSource.split(' ', QString::SkipEmptyParts);
 
-        QVector<stuPos> Tagged2OrigianlCharMap =
-                Common::getCorrespondence(_intermediate.OriginalSource,
-                                          _intermediate.TaggedSource);
-
-        QList<stuPos>  TaggedWordsCharMap;
-        size_t LastAcceptedChar = 0;
-        for(int i=0; i<SourceWords.size(); ++i){
-            while(_intermediate.TaggedSource.at(LastAcceptedChar) == ' ')
-                ++LastAcceptedChar;
-            TaggedWordsCharMap.append(stuPos(LastAcceptedChar,
-                                             LastAcceptedChar+SourceWords.at(i).size()));
-            LastAcceptedChar+=SourceWords.at(i).size();
-        }
-
         foreach(const stuTranslationOutput::stuPhraseAlternatives& MetaInfo, _intermediate.BestTranslationPhraseAlternatives){
 
             QString TargetPhrase;
@@ -153,10 +258,6 @@ void clsTranslationJob::reduceLineTranslation(QVariantList &_result,
                               "MetaInfo.TargetWordsPos.start()"<<MetaInfo.TargetWordsPos.start())
             }
 
-            PhraseIndexMap.insert(MetaInfo.TargetWordsPos.start(),
-                                   TargomanTextProcessor::instance().ixml2Text(TargetPhrase,
-                                                                               clsTranslationJob::TargetLanguage));
-
             QString SourcePhrase;
             if((size_t)SourceWords.size() > MetaInfo.SourceWordsPos.start()){
                 SourcePhrase = SourceWords.at(MetaInfo.SourceWordsPos.start());
@@ -175,78 +276,77 @@ void clsTranslationJob::reduceLineTranslation(QVariantList &_result,
             QVariantList TranslationOptions;
             bool IsFirstOption = true;
             foreach(const QString& Option, MetaInfo.Alternatives){
-                TranslationOptions.insert(TranslationOptions.size(),
-                                          QVariantList()<<
-                                          TargomanTextProcessor::instance().ixml2Text(Option)<<
-                                          IsFirstOption);
+                TranslationOptions.append(QVariant(QVariantList()<<
+                                                   TargomanTextProcessor::instance().ixml2Text(Option)<<
+                                                   IsFirstOption));
                 if (IsFirstOption)
                     IsFirstOption = false;
             }
 
             QVariantList AlignInfo;
-            AlignInfo.insert(0,SourcePhrase);
-            AlignInfo.insert(1,AlignInfoMap.size());
-            AlignInfo.insert(2,TranslationOptions);
+            AlignInfo.append(SourcePhrase);
+            AlignInfo.append(0); // Will be set to index of phrase in translation
+            AlignInfo.append(QVariant(TranslationOptions));
 
 
             QVariantList CharAlignInfo;
             qint32 FirstChar = INT_MAX;
             qint32 LastChar  = 0;
 
-            if (((size_t)TaggedWordsCharMap.size()) > MetaInfo.SourceWordsPos.start() &&
-                ((size_t)TaggedWordsCharMap.size()) > MetaInfo.SourceWordsPos.end() -1){
-                stuPos TaggedSourceCharRange(TaggedWordsCharMap.at(MetaInfo.SourceWordsPos.start()).start(),
-                                             TaggedWordsCharMap.at(MetaInfo.SourceWordsPos.end() - 1).end());
-
-                for (size_t i=TaggedSourceCharRange.start(); i < TaggedSourceCharRange.end(); ++i){
-                    if (Tagged2OrigianlCharMap.at(i).isValid()){
-                        FirstChar = qMin(Tagged2OrigianlCharMap.at(i).first, FirstChar);
-                        LastChar = qMax(Tagged2OrigianlCharMap.at(i).second, LastChar);
+            if (((size_t)_intermediate.SourceTokenSpans.size()) > MetaInfo.SourceWordsPos.start() &&
+                ((size_t)_intermediate.SourceTokenSpans.size()) > MetaInfo.SourceWordsPos.end() -1){
+                for (size_t i=MetaInfo.SourceWordsPos.start(); i < MetaInfo.SourceWordsPos.end(); ++i){
+                    const stuPos& TokenSpan = _intermediate.SourceTokenSpans.at(i);
+                    if (TokenSpan.isValid()){
+                        FirstChar = qMin(TokenSpan.first, FirstChar);
+                        LastChar = qMax(TokenSpan.second, LastChar);
                     }
                 }
-                while (_intermediate.OriginalSource.size() > FirstChar &&
-                       _intermediate.OriginalSource.at(FirstChar) == ' ') ++FirstChar;
-                while (LastChar > 0 && _intermediate.OriginalSource.at(LastChar - 1) == ' ') --LastChar;
-                CharAlignInfo.insert(CharAlignInfo.size(), QVariantList()<<FirstChar<<LastChar);
+                if (FirstChar > LastChar)
+                    FirstChar = LastChar = 0;
+                CharAlignInfo.append(QVariant(QVariantList()<<FirstChar<<LastChar));
             }else{
                 TargomanDebug(5,"TaggedSourceCharRange Failed"<<
-                              "TaggedWordsCharMap.size()"<<TaggedWordsCharMap.size()<<
+                              "SourceTokenSpans.size()"<<_intermediate.SourceTokenSpans.size()<<
                               "MetaInfo.SourceWordsPos.start()"<<MetaInfo.SourceWordsPos.start()<<
                               "MetaInfo.SourceWordsPos.end() -1"<<MetaInfo.SourceWordsPos.end() -1
                               )
-                CharAlignInfo.insert(CharAlignInfo.size(), QVariantList()<<0<<0);
+                CharAlignInfo.append(QVariant(QVariantList()<<0<<0));
             }
 
-            AlignInfo.insert(3,CharAlignInfo);
-            AlignInfo.insert(4,QVariantList()<<
-                             (quint16)MetaInfo.SourceWordsPos.start()<<(quint16)MetaInfo.SourceWordsPos.end());
+            AlignInfo.append(QVariant(CharAlignInfo));
+            AlignInfo.append(QVariant(QVariantList()<<
+                                      (quint16)MetaInfo.SourceWordsPos.start()<<(quint16)MetaInfo.SourceWordsPos.end()));
 
-            AlignInfoMap.insert(MetaInfo.TargetWordsPos.start(), AlignInfo);
+            PhraseInfos.append(stuPhraseInfo{
+                                   MetaInfo.TargetWordsPos.start(),
+                                   TargomanTextProcessor::instance().ixml2Text(TargetPhrase,
+                                                                               clsTranslationJob::TargetLanguage),
+                                   AlignInfo});
         }
 
-        QVariantList PhraseIndexList;
-        foreach(const QString& Phrase, PhraseIndexMap.values())
-            PhraseIndexList.insert(PhraseIndexList.size(),
-                                   QVariantList()<<
-                                   Phrase<<
-                                   PhraseIndexList.size());
+        // Phrases are normally in target order already. Otherwise sort them and keep the last one of each position.
+        auto isBefore = [](const stuPhraseInfo& _first, const stuPhraseInfo& _second){
+            return _first.TargetPos < _second.TargetPos;
+        };
+        if (std::is_sorted(PhraseInfos.begin(), PhraseInfos.end(), isBefore) == false)
+            std::stable_sort(PhraseInfos.begin(), PhraseInfos.end(), isBefore);
 
+        QVariantList PhraseIndexList;
         QVariantList AlignInfoList;
-        foreach(const QVariantList& Info, AlignInfoMap.values()){
-            QVariantList UpdatedInfo = Info;
-            UpdatedInfo[1] = AlignInfoList.size();
-            AlignInfoList.insert(AlignInfoList.size(),UpdatedInfo);
+        for (int i = 0; i < PhraseInfos.size(); ++i){
+            if (i + 1 < PhraseInfos.size() && PhraseInfos.at(i + 1).TargetPos == PhraseInfos.at(i).TargetPos)
+                continue;
+            PhraseIndexList.append(QVariant(QVariantList()<<
+                                            PhraseInfos.at(i).Phrase<<
+                                            PhraseIndexList.size()));
+            PhraseInfos[i].AlignInfo[1] = AlignInfoList.size();
+            AlignInfoList.append(QVariant(PhraseInfos.at(i).AlignInfo));
         }
 
-        QVariantList IndexSection = _result[1].toList();
-        IndexSection.insert(IndexSection.size(), PhraseIndexList);
-        _result[1] = IndexSection;
-
-        QVariantList AlignSection = _result[2].toList();
-        AlignSection.insert(AlignSection.size(), AlignInfoList);
-        _result[2] = AlignSection;
+        this->IndexSection.append(PhraseIndexList);
+        this->AlignmentSection.append(AlignInfoList);
     }
-    return;
 }
 
 void clsTranslationJob::reduceSentenceTranslation(stuTranslationOutput &_result,
@@ -27,7 +27,10 @@
 #define TARGOMAN_APPS_CLSTRANSLATIONJOB_H
 
 #include <QVariantList>
+#include <QAtomicInteger>
 #include "libTargomanSMT/Translator.h"
+#include "libTargomanCommon/tmplBoundedCache.hpp"
+#include "libTargomanCommon/JSONConversationProtocol.h"
 
 namespace Targoman {
 namespace Apps {
@@ -35,21 +38,41 @@ namespace Apps {
 class clsTranslationJob
 {
 public:
-    clsTranslationJob(bool _brief, bool _keepAsSource);
-    QVariantList doJob(const QString& _inputStr);
+    clsTranslationJob(bool _brief,
+                      bool _keepAsSource,
+                      qint32 _priority = 0,
+                      qint64 _timeout = 0,
+                      const QString& _weightProfile = QString());
+    QVariant doJob(const QString& _inputStr);
+
+    static void initCache();
+    static QVariantMap cacheStatistics();
 
 private:
-    SMT::stuTranslationOutput mapLineTranslation(const QString& _line);
-    SMT::stuTranslationOutput mapSentenceTranslation(const QString& _ixml);
-    void reduceLineTranslation(QVariantList &_result, const SMT::stuTranslationOutput& _intermediate);
+    QList<SMT::stuTranslationOutput> cachedTranslate(const QStringList& _inputs);
+    SMT::stuTranslationOutput prepareLineTranslation(const QString& _line, QStringList& _inputs);
+    void reduceLineTranslation(const SMT::stuTranslationOutput& _intermediate);
     void reduceSentenceTranslation(SMT::stuTranslationOutput& _result, const SMT::stuTranslationOutput& _intermediate);
 private:
     bool Brief;
     bool KeepAsSource;
+    qint32 Priority;
+    SMT::stuTranslationDeadline Deadline;
+    QString WeightProfile;
+    Common::JSONConversationProtocol::clsArrayBuilder TranslationSection;
+    Common::JSONConversationProtocol::clsArrayBuilder IndexSection;
+    Common::JSONConversationProtocol::clsArrayBuilder AlignmentSection;
 
 public:
     static QString SourceLanguage; // Just for speed optimization
     static QString TargetLanguage; // Just for speed optimization
+
+private:
+    /// Translated sentences keyed by direction, output format, weight profile, configuration revision and normalized input
+    static Common::tmplBoundedCache<QHash, QString, SMT::stuTranslationOutput> TranslationCache;
+    static QAtomicInt                CachedConfigRevision;
+    static QAtomicInteger<quint64>   CacheHits;
+    static QAtomicInteger<quint64>   CacheMisses;
 };
 
 }
@@ -0,0 +1,269 @@
+/******************************************************************************
+ * Targoman: A robust Statistical Machine Translation framework               *
+ *                                                                            *
+ * Copyright 2014-2015 by ITRC <http://itrc.ac.ir>                            *
+ *                                                                            *
+ * This file is part of Targoman.                                             *
+ *                                                                            *
+ * Targoman is free software: you can redistribute it and/or modify           *
+ * it under the terms of the GNU Lesser General Public License as published   *
+ * by the Free Software Foundation, either version 3 of the License, or       *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * Targoman is distributed in the hope that it will be useful,                *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * GNU Lesser General Public License for more details.                        *
+ * You should have received a copy of the GNU Lesser General Public License   *
+ * along with Targoman. If not, see <http://www.gnu.org/licenses/>.           *
+ *                                                                            *
+ ******************************************************************************/
+/**
+ * @author S. Mohammad M. Ziabary <ziabary@targoman.com>
+ */
+
+
+#include <QThread>
+#include <climits>
+#include <functional>
+#include "clsTranslationScheduler.h"
+#include "libTargomanCommon/Logger.h"
+#include "Configs.h"
+
+namespace Targoman {
+namespace Apps {
+
+using namespace SMT;
+using namespace Common;
+
+/**
+ * @brief The clsDecodeWorker class is a plain thread running decode loop of the scheduler
+ */
+class clsDecodeWorker : public QThread
+{
+public:
+    clsDecodeWorker(std::function<void()> _loop) :
+        Loop(_loop)
+    {}
+
+protected:
+    void run(){
+        this->Loop();
+    }
+
+private:
+    std::function<void()> Loop;
+};
+
+clsTranslationScheduler::clsTranslationScheduler() :
+    NextSequence(0),
+    QueuedWords(0),
+    WorkersCount(0)
+{
+    this->Clock.start();
+}
+
+/**
+ * @brief Starts decode workers. If zero is provided number of workers will be set to number of CPU cores.
+ */
+void clsTranslationScheduler::start(quint16 _workersCount)
+{
+    QMutexLocker Locker(&this->Lock);
+    if (this->WorkersCount)
+        return;
+
+    this->WorkersCount = _workersCount ? _workersCount : qMax(QThread::idealThreadCount(), 1);
+    for (quint16 i = 0; i < this->WorkersCount; ++i)
+        (new clsDecodeWorker(std::bind(&clsTranslationScheduler::processTasks, this)))->start();
+
+    TargomanLogInfo(5, "Translation scheduler started with " << this->WorkersCount << " decode workers");
+}
+
+/**
+ * @brief Queues inputs to be translated by decode workers and waits for all of them to be translated.
+ * @param _inputs sentences to be translated
+ * @param _outputFormat output format of translations
+ * @param _priority inputs with higher priority are translated first. It is limited to MaxRequestPriority.
+ * @param _deadline time budget of the request. Inputs decoded after deadline are translated in degraded mode. When
+ * its cancellation flag is set, remaining inputs are dropped and an error is thrown.
+ * @param _weightProfile name of the weight profile used to translate all inputs. Empty means default weights.
+ * @exception throws exTargomanSMTServer if server is overloaded or translation of any input fails. Remaining inputs
+ * of a failed request are not translated.
+ * @return translations in the same order as inputs
+ */
+QList<stuTranslationOutput> clsTranslationScheduler::translate(const QStringList &_inputs,
+                                                                enuOutputFormat::Type _outputFormat,
+                                                                qint32 _priority,
+                                                                const stuTranslationDeadline& _deadline,
+                                                                const QString& _weightProfile)
+{
+    if (_inputs.isEmpty())
+        return QList<stuTranslationOutput>();
+
+    quint64 Words = 0;
+    foreach(const QString& Input, _inputs)
+        Words += Input.count(' ') + 1;
+
+    _priority = qMin(_priority, (qint32)gConfigs::MaxRequestPriority.value());
+
+    stuRequest Request;
+    Request.Pending = _inputs.size();
+    Request.OutputFormat = _outputFormat;
+    Request.Deadline = stuTranslationDeadline(_deadline.ExpiresAt, &Request.Cancelled);
+    Request.WeightProfile = _weightProfile;
+    for (int i = 0; i < _inputs.size(); ++i)
+        Request.Results.append(stuTranslationOutput());
+
+    {
+        QMutexLocker Locker(&this->Lock);
+        // Requests are admitted on an idle server regardless of their size so that large requests are not starved
+        if (this->Queue.size() &&
+            ((gConfigs::MaxQueuedSentences.value() &&
+              (quint64)(this->Queue.size() + _inputs.size()) > gConfigs::MaxQueuedSentences.value()) ||
+             (gConfigs::MaxQueuedWords.value() &&
+              this->QueuedWords + Words > gConfigs::MaxQueuedWords.value()))){
+            this->RejectedRequests.ref();
+            throw exTargomanSMTServer("Server is overloaded. Please try again later");
+        }
+
+        qint64 Now = this->Clock.elapsed();
+        for (int i = 0; i < _inputs.size(); ++i){
+            stuTask Task;
+            Task.Request = &Request;
+            Task.Index = i;
+            Task.Input = _inputs.at(i);
+            Task.Words = _inputs.at(i).count(' ') + 1;
+            Task.QueuedAt = Now;
+            this->Queue.insert(qMakePair(-(qint64)_priority, this->NextSequence++), Task);
+        }
+        this->QueuedWords += Words;
+        this->TaskAvailable.wakeAll();
+    }
+
+    QMutexLocker RequestLocker(&Request.Lock);
+    while (Request.Pending){
+        if (_deadline.Cancelled && _deadline.Cancelled->load() && Request.Cancelled.load() == 0){
+            Request.Cancelled.store(1);
+            Request.Pending -= this->removeQueuedTasks(&Request);
+            if (Request.Error.isEmpty())
+                Request.Error = "Translation cancelled by caller";
+            continue;
+        }
+        // Owner of the request may cancel it at any time so its flag is polled
+        Request.Done.wait(&Request.Lock, _deadline.Cancelled ? 100 : ULONG_MAX);
+    }
+
+    if (Request.Error.size())
+        throw exTargomanSMTServer(Request.Error);
+
+    return Request.Results;
+}
+
+QVariantMap clsTranslationScheduler::statistics()
+{
+    QVariantMap Stats;
+    {
+        QMutexLocker Locker(&this->Lock);
+        Stats.insert("QD", this->Queue.size());
+        Stats.insert("QW", this->QueuedWords);
+    }
+    quint64 Processed = this->ProcessedTasks.load();
+    Stats.insert("AW", Processed ? this->TotalWaitTime.load() / Processed : 0);
+    Stats.insert("MW", this->MaxWaitTime.load());
+    Stats.insert("RJ", this->RejectedRequests.load());
+    Stats.insert("TQ", this->WorkersCount ?
+                     qMin(int(double(this->ActiveWorkers.load()) / double(this->WorkersCount) * 100.), 100) : 0);
+    return Stats;
+}
+
+/**
+ * @brief Removes tasks of _request which are still waiting in queue.
+ * @return number of removed tasks
+ */
+int clsTranslationScheduler::removeQueuedTasks(const stuRequest* _request)
+{
+    QMutexLocker Locker(&this->Lock);
+    int Removed = 0;
+    for (auto TaskIter = this->Queue.begin(); TaskIter != this->Queue.end();){
+        if (TaskIter->Request == _request){
+            this->QueuedWords -= TaskIter->Words;
+            TaskIter = this->Queue.erase(TaskIter);
+            ++Removed;
+        }else
+            ++TaskIter;
+    }
+    return Removed;
+}
+
+/**
+ * @brief Decode loop of each worker. Takes tasks with the highest priority and translates them. Sentences of a request
+ * share their phrase candidates, so workers translating them in parallel collect each source phrase once.
+ */
+void clsTranslationScheduler::processTasks()
+{
+    forever{
+        stuTask Task;
+        {
+            QMutexLocker Locker(&this->Lock);
+            while (this->Queue.isEmpty())
+                this->TaskAvailable.wait(&this->Lock);
+            Task = this->Queue.take(this->Queue.firstKey());
+            this->QueuedWords -= Task.Words;
+        }
+
+        quint64 WaitTime = this->Clock.elapsed() - Task.QueuedAt;
+        this->ProcessedTasks.ref();
+        this->TotalWaitTime.fetchAndAddOrdered(WaitTime);
+        quint64 MaxWaitTime = this->MaxWaitTime.load();
+        while (WaitTime > MaxWaitTime && this->MaxWaitTime.testAndSetOrdered(MaxWaitTime, WaitTime) == false)
+            MaxWaitTime = this->MaxWaitTime.load();
+
+        // Sibling of a failed task which has been taken before the request was cancelled
+        if (Task.Request->Cancelled.load()){
+            QMutexLocker RequestLocker(&Task.Request->Lock);
+            if (--Task.Request->Pending == 0)
+                Task.Request->Done.wakeAll();
+            continue;
+        }
+
+        this->ActiveWorkers.ref();
+        stuTranslationOutput Output;
+        QString Error;
+        try{
+            Output = Translator::translate(Task.Input,
+                                           Task.Request->OutputFormat,
+                                           false,
+                                           Task.Request->Deadline,
+                                           Task.Request->WeightProfile,
+                                           Task.Request->Results.size() > 1 ? &Task.Request->Batch : NULL);
+        }catch(exTargomanBase& e){
+            Error = e.what();
+        }catch(std::exception& e){
+            Error = e.what();
+        }catch(...){
+            Error = "Unrecognized exception while translating";
+        }
+        this->ActiveWorkers.deref();
+
+        // Remaining tasks of a failed request are dropped and running ones are cut short as its result is an error
+        int Dropped = 0;
+        if (Error.size()){
+            TargomanLogError(Error);
+            Task.Request->Cancelled.store(1);
+            Dropped = this->removeQueuedTasks(Task.Request);
+        }
+
+        QMutexLocker RequestLocker(&Task.Request->Lock);
+        if (Error.size()){
+            if (Task.Request->Error.isEmpty())
+                Task.Request->Error = Error;
+        }else
+            Task.Request->Results[Task.Index] = Output;
+        Task.Request->Pending -= 1 + Dropped;
+        if (Task.Request->Pending == 0)
+            Task.Request->Done.wakeAll();
+    }
+}
+
+}
+}
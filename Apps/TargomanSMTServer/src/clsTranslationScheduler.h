@@ -0,0 +1,109 @@
+/******************************************************************************
+ * Targoman: A robust Statistical Machine Translation framework               *
+ *                                                                            *
+ * Copyright 2014-2015 by ITRC <http://itrc.ac.ir>                            *
+ *                                                                            *
+ * This file is part of Targoman.                                             *
+ *                                                                            *
+ * Targoman is free software: you can redistribute it and/or modify           *
+ * it under the terms of the GNU Lesser General Public License as published   *
+ * by the Free Software Foundation, either version 3 of the License, or       *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * Targoman is distributed in the hope that it will be useful,                *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * GNU Lesser General Public License for more details.                        *
+ * You should have received a copy of the GNU Lesser General Public License   *
+ * along with Targoman. If not, see <http://www.gnu.org/licenses/>.           *
+ *                                                                            *
+ ******************************************************************************/
+/**
+ * @author S. Mohammad M. Ziabary <ziabary@targoman.com>
+ */
+
+
+#ifndef TARGOMAN_APPS_CLSTRANSLATIONSCHEDULER_H
+#define TARGOMAN_APPS_CLSTRANSLATIONSCHEDULER_H
+
+#include <QMap>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QElapsedTimer>
+#include <QAtomicInteger>
+#include <QVariantMap>
+#include "libTargomanSMT/Translator.h"
+
+namespace Targoman {
+namespace Apps {
+
+/**
+ * @brief The clsTranslationScheduler class runs sentence translations on a fixed set of decode workers which are
+ * separate from RPC threads. Sentences of all requests are queued in a bounded priority queue and new requests are
+ * rejected when queue is full so that server degrades gracefully under load.
+ */
+class clsTranslationScheduler
+{
+public:
+    static clsTranslationScheduler& instance(){
+        static clsTranslationScheduler* Instance = NULL;
+        return *(Q_LIKELY(Instance) ? Instance : (Instance = new clsTranslationScheduler));
+    }
+
+    void start(quint16 _workersCount);
+    QList<SMT::stuTranslationOutput> translate(const QStringList& _inputs,
+                                               SMT::enuOutputFormat::Type _outputFormat,
+                                               qint32 _priority = 0,
+                                               const SMT::stuTranslationDeadline& _deadline = SMT::stuTranslationDeadline(),
+                                               const QString& _weightProfile = QString());
+    QVariantMap statistics();
+
+private:
+    clsTranslationScheduler();
+    Q_DISABLE_COPY(clsTranslationScheduler)
+
+    void processTasks();
+
+private:
+    struct stuRequest{
+        QMutex                              Lock;
+        QWaitCondition                      Done;
+        int                                 Pending;
+        SMT::enuOutputFormat::Type          OutputFormat;
+        SMT::stuTranslationDeadline         Deadline;
+        QString                             WeightProfile;
+        QList<SMT::stuTranslationOutput>    Results;
+        QString                             Error;
+        QAtomicInt                          Cancelled;  /**< Set when a task of the request fails */
+        SMT::clsTranslationBatch            Batch;      /**< Phrase candidates shared between sentences of request */
+    };
+
+    struct stuTask{
+        stuRequest* Request;
+        int         Index;
+        QString     Input;
+        quint32     Words;
+        qint64      QueuedAt;
+    };
+
+    int removeQueuedTasks(const stuRequest* _request);
+
+    /// Tasks ordered by descending priority and then by arrival
+    QMap<QPair<qint64, quint64>, stuTask>   Queue;
+    QMutex                                  Lock;
+    QWaitCondition                          TaskAvailable;
+    QElapsedTimer                           Clock;
+    quint64                                 NextSequence;
+    quint64                                 QueuedWords;
+    quint16                                 WorkersCount;
+    QAtomicInt                              ActiveWorkers;
+    QAtomicInteger<quint64>                 ProcessedTasks;
+    QAtomicInteger<quint64>                 TotalWaitTime;
+    QAtomicInteger<quint64>                 MaxWaitTime;
+    QAtomicInteger<quint64>                 RejectedRequests;
+};
+
+}
+}
+
+#endif // TARGOMAN_APPS_CLSTRANSLATIONSCHEDULER_H
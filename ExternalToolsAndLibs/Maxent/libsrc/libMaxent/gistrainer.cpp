@@ -65,21 +65,13 @@ void GISTrainer::init_trainer() {
         cerr << "calculating heldout accuracy is not supported in GIS trainer yet." << endl;
     }
 
-    m_modifiers.reset(new vector<vector<double> >
-            (m_params->size(), vector<double>(0)) );
-    m_observed_expects.reset(new vector<vector<double> >
-            (m_params->size(), vector<double>(0)) );
+    const size_t n_params = m_param_oids.size();
+    m_observed_expects.reset(new double[n_params]);
+    fill(m_observed_expects.get(), m_observed_expects.get() + n_params, 0.0);
 
     // init all thetas to 0.0
-    for (size_t i = 0; i < m_params->size(); ++i) {
-        std::vector<pair<size_t, size_t> >& param = (*m_params)[i];
-        (*m_modifiers)[i].resize(param.size());
-        (*m_observed_expects)[i].resize(param.size());
-        for (size_t j = 0; j < param.size(); ++j) {
-            m_theta[param[j].second] = 0.0;
-            assert((*m_modifiers)[i][j] == 0.0);
-        }
-    }
+    for (size_t j = 0; j < n_params; ++j)
+        m_theta[m_param_fids[j]] = 0.0;
 
     // determine the correction constant
     // C = max sum_{x,y} f_i(x, y)
@@ -135,15 +127,13 @@ void GISTrainer::init_trainer() {
 
     FeatSumMap::iterator it;
     for (size_t pid = 0; pid < m_params->size(); ++pid) {
-        vector<pair<size_t, size_t> >& param = (*m_params)[pid];
-        vector<double>& observ = (*m_observed_expects)[pid];
-        for (size_t j = 0; j < param.size(); ++j) {
-            it = feat_sum.find(make_pair(pid,param[j].first));
+        for (size_t j = m_param_offsets[pid]; j < m_param_offsets[pid + 1]; ++j) {
+            it = feat_sum.find(make_pair(pid,m_param_oids[j]));
             assert(it != feat_sum.end());
             if (it == feat_sum.end())
                 throw runtime_error("broken training data: some <pid, oid> in params not found in training data");
 
-            observ[j] = it->second; // Ep<f_i> = sum C(f_i)*f_i
+            m_observed_expects[j] = it->second; // Ep<f_i> = sum C(f_i)*f_i
         }
     }
 
@@ -152,12 +142,9 @@ void GISTrainer::init_trainer() {
         // to avoid unnecessary log(*) operation during gis parameter updates
 
         const double LOG_ZERO = log(numeric_limits<double>::min());
-        for (size_t pid = 0; pid < m_params->size(); ++pid) {
-            vector<pair<size_t, size_t> >& param = (*m_params)[pid];
-            vector<double>& observ = (*m_observed_expects)[pid];
-            for (size_t j = 0; j < param.size(); ++j) {
-                observ[j] = (observ[j] == 0.0) ? LOG_ZERO : log(observ[j]);
-            }
+        for (size_t j = 0; j < n_params; ++j) {
+            double& observ = m_observed_expects[j];
+            observ = (observ == 0.0) ? LOG_ZERO : log(observ);
         }
     }
 }
@@ -174,11 +161,17 @@ void GISTrainer::train(size_t iter, double tol) {
     double new_loglikelihood = 0.0;
     double acc;
     size_t correct;
-    size_t best_oid;
-    vector<double> q(m_n_outcomes); // q(y|x)
     boost::timer t;
     size_t niter = 0;
 
+    // every shard of the events accumulates into its own modifiers, which
+    // are summed into the first shard's after each pass
+    const size_t n_params = m_param_oids.size();
+    const size_t shards = n_shards(n_params * sizeof(double));
+    vector<vector<double> > modifiers(shards, vector<double>(n_params, 0.0));
+    vector<double> shard_loglikelihood(shards);
+    vector<size_t> shard_correct(shards);
+
     display("");
     display("Starting GIS iterations...");
     display("Number of Predicates: %d", m_params->size());
@@ -186,6 +179,7 @@ void GISTrainer::train(size_t iter, double tol) {
     display("Number of Parameters: %d", m_n_theta);
     display("Tolerance:            %E", tol);
     display("Gaussian Penalty:     %s", (m_sigma2?"on":"off"));
+    display("Threads:              %d", shards);
 #if defined(NDEBUG)
     display("Optimized version");
 #endif
@@ -193,60 +187,66 @@ void GISTrainer::train(size_t iter, double tol) {
     display("=============================================================");
 
     for (; niter < iter;) {
-        new_loglikelihood = 0.0;
-        correct = 0;
-
         // computer modifiers for all features from training data
-        for (vector<Event>::iterator it = m_es->begin();
-                it != m_es->end(); ++it) {
-            best_oid = eval(it->m_context, it->context_size(), q);
-            if (best_oid == it->m_outcome)
-                correct += it->m_count;
-            // TODO:optimize the code
-            // calculate Eq<f_i> = \sum q(y|x) * Count(f_i) * f_i(x, y) 
-            // (need not being divided by N)
-            for (size_t i = 0; i < it->context_size(); ++i) {
-                size_t pid = it->m_context[i].first;
-                double fval = it->m_context[i].second;
-                vector<pair<size_t, size_t> >& param = (*m_params)[pid];
-                for (size_t j = 0; j < param.size(); ++j) {
-                    size_t oid = param[j].first;
-                    (*m_modifiers)[pid][j] += q[oid] * it->m_count * fval;
-                    // binary case: (*m_modifiers)[pid][j] += q[oid] * it->m_count;
+        for_each_shard(shards, [&](size_t s, vector<Event>::iterator begin,
+                    vector<Event>::iterator end) {
+            vector<double> q(m_n_outcomes); // q(y|x)
+            double* modifier = &modifiers[s][0];
+            double loglikelihood = 0.0;
+            size_t correct = 0;
+            for (vector<Event>::iterator it = begin; it != end; ++it) {
+                size_t best_oid = eval(it->m_context, it->context_size(), q);
+                if (best_oid == it->m_outcome)
+                    correct += it->m_count;
+                // calculate Eq<f_i> = \sum q(y|x) * Count(f_i) * f_i(x, y) 
+                // (need not being divided by N)
+                for (size_t i = 0; i < it->context_size(); ++i) {
+                    size_t pid = it->m_context[i].first;
+                    double fval = it->m_context[i].second;
+                    for (size_t j = m_param_offsets[pid]; j < m_param_offsets[pid + 1]; ++j)
+                        modifier[j] += q[m_param_oids[j]] * it->m_count * fval;
                 }
+                assert(finite(q[it->m_outcome]));
+                double t = log(q[it->m_outcome]);
+                loglikelihood += (finite(t) ? t : LOG_ZERO) * it->m_count;
+                assert(finite(loglikelihood));
+            }
+            shard_loglikelihood[s] = loglikelihood;
+            shard_correct[s] = correct;
+        });
+
+        new_loglikelihood = 0.0;
+        correct = 0;
+        vector<double>& modifier = modifiers[0];
+        for (size_t s = 0; s < shards; ++s) {
+            new_loglikelihood += shard_loglikelihood[s];
+            correct += shard_correct[s];
+            if (s == 0)
+                continue;
+            for (size_t j = 0; j < n_params; ++j) {
+                modifier[j] += modifiers[s][j];
+                modifiers[s][j] = 0.0;
             }
-            assert(finite(q[it->m_outcome]));
-            double t = log(q[it->m_outcome]);
-            new_loglikelihood += (finite(t) ? t : LOG_ZERO) * it->m_count;
-            assert(finite(new_loglikelihood));
         }
         acc = correct/double(m_N);
 
         // compute the new parameter values
         if (m_sigma2) { // applying Gaussian penality
-            for (size_t pid = 0; pid < m_params->size(); ++pid) {
-                vector<pair<size_t, size_t> >& param = (*m_params)[pid];
-                for (size_t i = 0; i < param.size(); ++i) {
-                    size_t fid = param[i].second;
-                    m_theta[fid] += newton((*m_modifiers)[pid][i],
-                            (*m_observed_expects)[pid][i], fid);
-                    (*m_modifiers)[pid][i] = 0.0; // clear modifiers for next iteration
-                }
+            for (size_t j = 0; j < n_params; ++j) {
+                size_t fid = m_param_fids[j];
+                m_theta[fid] += newton(modifier[j], m_observed_expects[j], fid);
+                modifier[j] = 0.0; // clear modifiers for next iteration
             }
         } else {
-            for (size_t pid = 0; pid < m_params->size(); ++pid) {
-                vector<pair<size_t, size_t> >& param = (*m_params)[pid];
-                for (size_t i = 0; i < param.size(); ++i) {
-                    if ((*m_modifiers)[pid][i] != 0.0) { 
-                        m_theta[param[i].second] += 
-                            ((*m_observed_expects)[pid][i] -
-                             log((*m_modifiers)[pid][i])) / m_correct_constant;
-                        (*m_modifiers)[pid][i] = 0.0; // clear modifiers for next iteration
-                    } else {
-                        // E_q == 0 means feature value is 0, which means
-                        // update for this parameter will always be zero,
-                        // hence can be ignored.
-                    }
+            for (size_t j = 0; j < n_params; ++j) {
+                if (modifier[j] != 0.0) { 
+                    m_theta[m_param_fids[j]] += 
+                        (m_observed_expects[j] - log(modifier[j])) / m_correct_constant;
+                    modifier[j] = 0.0; // clear modifiers for next iteration
+                } else {
+                    // E_q == 0 means feature value is 0, which means
+                    // update for this parameter will always be zero,
+                    // hence can be ignored.
                 }
             }
         }
@@ -264,7 +264,6 @@ void GISTrainer::train(size_t iter, double tol) {
         display("Maximum numbers of %d iterations reached in %.2f seconds", iter , t.elapsed());
 
     // kill a bunch of these big objects now that we don't need them
-    m_modifiers.reset();
     m_observed_expects.reset();
 }
 
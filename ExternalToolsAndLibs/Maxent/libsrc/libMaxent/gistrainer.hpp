@@ -62,8 +62,8 @@ namespace maxent{
             };
 
             double m_correct_constant;
-            shared_ptr<vector<vector<double> > > m_modifiers;
-            shared_ptr<vector<vector<double> > > m_observed_expects;
+            // indexed like the flattened parameters (m_param_oids)
+            shared_array<double> m_observed_expects;
     };
 
 } // namespace maxent
@@ -79,14 +79,13 @@ void LBFGSTrainer::init_trainer() {
 
     FeatSumMap::iterator it;
     for (size_t pid = 0; pid < m_params->size(); ++pid) {
-        vector<pair<size_t, size_t> >& param = (*m_params)[pid];
-        for (size_t j = 0; j < param.size(); ++j) {
-            it = feat_sum.find(make_pair(pid,param[j].first));
+        for (size_t j = m_param_offsets[pid]; j < m_param_offsets[pid + 1]; ++j) {
+            it = feat_sum.find(make_pair(pid,m_param_oids[j]));
             assert(it != feat_sum.end());
             if (it == feat_sum.end())
                 throw runtime_error("broken training data: some <pid, oid> in params not found in training data");
 
-            m_observed_expects[param[j].second] = -(it->second);
+            m_observed_expects[m_param_fids[j]] = -(it->second);
         }
     }
 
@@ -114,7 +113,6 @@ void LBFGSTrainer::train(size_t iter, double eps) {
     init_trainer();
 
     const double LOG_ZERO = log(DBL_MIN);
-    vector<double> q(m_n_outcomes); // q(y|x)
     int n = m_n_theta;
     int m = 5;
     boost::scoped_array<double> grad(new double[n]);
@@ -127,6 +125,13 @@ void LBFGSTrainer::train(size_t iter, double eps) {
     double heldout_acc = -1.0;
     boost::timer t;
 
+    // every shard of the events accumulates its own gradient, the shard
+    // gradients are summed into g after each evaluation
+    const size_t shards = n_shards(n * sizeof(double));
+    vector<vector<double> > shard_grad(shards, vector<double>(shards > 1 ? n : 0));
+    vector<double> shard_f(shards);
+    vector<size_t> shard_correct(shards);
+
     lbfgs_t* opt = lbfgs_create(n, m, eps);
     if (!opt)
         throw runtime_error("fail to initlize L-BFGS optimizer");
@@ -139,6 +144,7 @@ void LBFGSTrainer::train(size_t iter, double eps) {
     display("Number of Corrections: %d", m);
     display("Tolerance:             %E", eps);
     display("Gaussian Penalty:      %s", (m_sigma2?"on":"off"));
+    display("Threads:               %d", shards);
 #if defined(NDEBUG)
     display("Optimized version");
 #endif
@@ -148,32 +154,49 @@ void LBFGSTrainer::train(size_t iter, double eps) {
 
     for (;opt->niter < (int)iter;) {
         // calculate loglikehood and gradient
-        correct = 0;
-        f = 0.0;
         std::copy(m_observed_expects.get(), m_observed_expects.get() + n, g);
 
-        for (vector<Event>::iterator it = m_es->begin();
-                it != m_es->end(); ++it) {
-            size_t best_oid = eval(it->m_context,it->context_size(), q);
-            if (best_oid == it->m_outcome)
-                correct += it->m_count;
-            for (size_t i = 0; i < it->context_size(); ++i) {
-                size_t pid = it->m_context[i].first;
-                float fval = it->m_context[i].second;
-                vector<pair<size_t, size_t> >& param = (*m_params)[pid];
-                for (size_t j = 0; j < param.size(); ++j) {
-                    size_t oid = param[j].first;
-                    size_t fid = param[j].second;
-                    g[fid] += it->m_count * q[oid] * fval;
+        for_each_shard(shards, [&](size_t s, vector<Event>::iterator begin,
+                    vector<Event>::iterator end) {
+            vector<double> q(m_n_outcomes); // q(y|x)
+            // a single shard updates g in place
+            double* gradient = shards > 1 ? &shard_grad[s][0] : g;
+            double f = 0.0;
+            size_t correct = 0;
+            for (vector<Event>::iterator it = begin; it != end; ++it) {
+                size_t best_oid = eval(it->m_context,it->context_size(), q);
+                if (best_oid == it->m_outcome)
+                    correct += it->m_count;
+                for (size_t i = 0; i < it->context_size(); ++i) {
+                    size_t pid = it->m_context[i].first;
+                    float fval = it->m_context[i].second;
+                    for (size_t j = m_param_offsets[pid]; j < m_param_offsets[pid + 1]; ++j)
+                        gradient[m_param_fids[j]] += it->m_count * q[m_param_oids[j]] * fval;
                 }
+
+                assert(finite(q[it->m_outcome]));
+                double t = log(q[it->m_outcome]);
+                if (finite(t))
+                    f -= it->m_count * t;
+                else
+                    f -= it->m_count * LOG_ZERO;
             }
+            shard_f[s] = f;
+            shard_correct[s] = correct;
+        });
 
-            assert(finite(q[it->m_outcome]));
-            double t = log(q[it->m_outcome]);
-            if (finite(t))
-                f -= it->m_count * t;
-            else
-                f -= it->m_count * LOG_ZERO;
+        correct = 0;
+        f = 0.0;
+        for (size_t s = 0; s < shards; ++s) {
+            f += shard_f[s];
+            correct += shard_correct[s];
+            if (shards == 1)
+                continue;
+            vector<double>& gradient = shard_grad[s];
+            for (int i = 0; i < n; ++i) {
+                g[i] += gradient[i];
+                gradient[i] = 0.0;
+            }
         }
 
         if (m_sigma2) { // applying Gaussian penality
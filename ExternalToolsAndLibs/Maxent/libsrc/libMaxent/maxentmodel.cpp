@@ -551,9 +551,13 @@ void MaxentModel::save(const string& model, bool binary) const {
  *         convergence when \f$|\frac{Log-likelihood(\theta_2) -
  *         Log-likelihood(\theta_1)}{Log-likelihood(\theta_1)}|<tol\f$.
  *         Default tol = 1-E05
+ *
+ * @param n_threads Number of threads evaluating the training events in each
+ *         iteration. Default is 0, which uses one thread per available core
+ *         unless their private accumulators would exceed 1GB.
  */
 void MaxentModel::train(size_t iter, const std::string& method, 
-        double sigma2, double tol) {
+        double sigma2, double tol, size_t n_threads) {
     if (!m_es)
         throw runtime_error("unable to train an emtpy model");
 
@@ -579,6 +583,7 @@ void MaxentModel::train(size_t iter, const std::string& method,
 
     t->set_training_data(m_es, m_params, m_n_theta,
             m_theta, gaussian, m_outcome_map->size(), m_heldout_es);
+    t->set_threads(n_threads);
     t->train(iter, tol);
 }
 
@@ -137,7 +137,8 @@ class MaxentModel /*: TODO: we need copyable? boost::noncopyable*/  {
 
     void train(size_t iter = 15, const std::string& method = "lbfgs",
             double sigma2 = 0.0, // non-zero enables Gaussian prior smoothing (global variance sigma^2)
-            double tol = 1E-05);
+            double tol = 1E-05,
+            size_t n_threads = 0); // 0 uses one thread per available core
 
      void dump_events(const string& model, bool binary = false) const;
 
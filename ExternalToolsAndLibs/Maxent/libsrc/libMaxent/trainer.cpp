@@ -33,6 +33,7 @@
 #include <cmath>
 #include <limits>
 #include <algorithm>
+#include <thread>
 #include <boost/progress.hpp>
 #include <boost/tokenizer.hpp>
 #include "trainer.hpp"
@@ -145,6 +146,7 @@ void Trainer::load_training_data(const string& events, const string& model) {
     MaxentModelFile f;
     f.load(model);
     f.params(m_params, m_n_theta, m_theta);
+    flatten_params();
 
     m_es = e;
 }
@@ -180,6 +182,61 @@ Trainer::set_training_data(shared_ptr<MEEventSpace> events,
       m_theta      = theta;
       m_sigma2      = sigma2;
       m_n_outcomes = n_outcomes;
+
+      flatten_params();
+}
+
+void Trainer::flatten_params() {
+    m_param_offsets.assign(1, 0);
+    m_param_oids.clear();
+    m_param_fids.clear();
+    if (!m_params)
+        return;
+
+    m_param_offsets.reserve(m_params->size() + 1);
+    for (size_t pid = 0; pid < m_params->size(); ++pid) {
+        vector<pair<size_t, size_t> >& param = (*m_params)[pid];
+        for (size_t j = 0; j < param.size(); ++j) {
+            m_param_oids.push_back(param[j].first);
+            m_param_fids.push_back(param[j].second);
+        }
+        m_param_offsets.push_back(m_param_oids.size());
+    }
+}
+
+// upper bound of memory used by private buffers of automatically created
+// shards, as each of them holds a full copy of the parameter accumulators
+static const size_t MAX_SHARD_MEMORY = size_t(1) << 30;
+
+size_t Trainer::n_shards(size_t shard_bytes) const {
+    size_t n = m_n_threads;
+    if (n == 0) {
+        n = std::thread::hardware_concurrency();
+        if (shard_bytes)
+            n = min<size_t>(n, MAX_SHARD_MEMORY / shard_bytes);
+    }
+    n = max<size_t>(n, 1);
+    return min(n, max<size_t>(m_es->size(), 1));
+}
+
+void Trainer::for_each_shard(size_t n_shards,
+        const boost::function<void (size_t, vector<Event>::iterator,
+            vector<Event>::iterator)>& fn) {
+    size_t shard_size = (m_es->size() + n_shards - 1) / n_shards;
+    if (n_shards == 1) {
+        fn(0, m_es->begin(), m_es->end());
+        return;
+    }
+
+    vector<std::thread> workers;
+    for (size_t s = 0; s < n_shards; ++s) {
+        size_t begin = min(s * shard_size, m_es->size());
+        size_t end = min(begin + shard_size, m_es->size());
+        workers.push_back(std::thread(fn, s, m_es->begin() + begin,
+                    m_es->begin() + end));
+    }
+    for (size_t s = 0; s < workers.size(); ++s)
+        workers[s].join();
 }
 
 // return the oid of best outcome
@@ -194,12 +251,10 @@ Trainer::eval(const Event::context_type* context, size_t len,
     fill(probs.begin(), probs.end(), 0.0);
 
     for (size_t i = 0;i < len; ++i) {
-        vector<pair<size_t, size_t> >& param = (*m_params)[context[i].first];
+        size_t pid = context[i].first;
         float fval = context[i].second;
-        for (size_t j = 0; j < param.size(); ++j) {
-            size_t oid = param[j].first;
-            probs[oid] += m_theta[param[j].second] * fval;
-        }
+        for (size_t j = m_param_offsets[pid]; j < m_param_offsets[pid + 1]; ++j)
+            probs[m_param_oids[j]] += m_theta[m_param_fids[j]] * fval;
     }
 
     
@@ -35,6 +35,7 @@
 #include <boost/utility.hpp>
 #include <boost/shared_ptr.hpp>
 #include <boost/shared_array.hpp>
+#include <boost/function.hpp>
 #include "meevent.hpp"
 
 namespace maxent{
@@ -56,9 +57,15 @@ void save_events_txt(const string& filename, const MEEventSpace& events);
  */
 class Trainer /*: boost::noncopyable*/{
     public:
+        Trainer() : m_n_threads(0) {}
         virtual ~Trainer() {}
         virtual void train(size_t iter = 15, double tol = 1E-05) = 0;
 
+        // number of threads used to evaluate training events, 0 means one
+        // thread per available core as long as private buffers of the
+        // threads fit in MAX_SHARD_MEMORY
+        void set_threads(size_t n_threads) { m_n_threads = n_threads; }
+
         // void save_param(const string& model, bool binary) const;
 
         void load_training_data(const string& events, const string& model);
@@ -84,6 +91,27 @@ class Trainer /*: boost::noncopyable*/{
         shared_array<double>     m_theta;
         shared_array<double>     m_sigma2;
 
+        // Parameters of m_params flattened into contiguous arrays: the
+        // parameters of predicate pid are at positions
+        // [m_param_offsets[pid], m_param_offsets[pid + 1]) of m_param_oids
+        // (outcome id) and m_param_fids (index into m_theta).
+        vector<size_t> m_param_offsets;
+        vector<size_t> m_param_oids;
+        vector<size_t> m_param_fids;
+        size_t         m_n_threads;
+
+        void flatten_params();
+
+        // number of event shards to evaluate concurrently, each shard needs
+        // shard_bytes of private buffers
+        size_t n_shards(size_t shard_bytes) const;
+
+        // run fn(shard, begin, end) for every shard of the training events,
+        // each on its own thread
+        void for_each_shard(size_t n_shards,
+                const boost::function<void (size_t, vector<Event>::iterator,
+                    vector<Event>::iterator)>& fn);
+
         size_t eval(const Event::context_type* context, size_t len,
                 vector<double>& probs) const;
     private:
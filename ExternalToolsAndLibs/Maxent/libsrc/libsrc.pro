@@ -65,6 +65,7 @@ SOURCES += \
 
 CONFIG += staticlib
 CONFIG += warn_off
+CONFIG += thread
 
 #QMAKE_CXXFLAGS_RELEASE -= -O1
 #QMAKE_CXXFLAGS_RELEASE -= -O2
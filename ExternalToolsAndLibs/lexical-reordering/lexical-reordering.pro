@@ -28,6 +28,7 @@ HEADERS += \
 SOURCES += \
     src/score.cpp \
     src/reordering_classes.cpp
+CONFIG += thread
 
 ################################################################################
 #                       DO NOT CHANGE ANYTHING BELOW                           #
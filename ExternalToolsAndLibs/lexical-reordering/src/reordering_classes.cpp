@@ -241,72 +241,70 @@ void ScorerLR::createConstSmoothing(double weight, vector<double>& smoothing) co
   }
 }
 
-void Model::score_fe(const string& f, const string& e)  {
+void Model::append_scores(const vector<double>& counts, const vector<double>& smoothing, string& out) const {
+  vector<double> scores;
+  scorer->score(counts, scores);
+  double sum = 0;
+  for(size_t i=0; i<scores.size(); ++i) {
+    scores[i] += smoothing[i];
+    sum += scores[i];
+  }
+  char buffer[64];
+  for(size_t i=0; i<scores.size(); ++i) {
+    snprintf(buffer, sizeof(buffer), "%f ", scores[i]/sum);
+    out += buffer;
+  }
+}
+
+void Model::score_fe(const string& f, const string& e, const ModelScore& ms, string& out) const {
   if (!fe)    //Make sure we do not do anything if it is not a fe model
     return;
-  fprintf(file,"%s ||| %s ||| ",f.c_str(),e.c_str());
+  out += f;
+  out += " ||| ";
+  out += e;
+  out += " ||| ";
   //condition on the previous phrase
   if (previous) {
-    vector<double> scores;
-    scorer->score(modelscore->get_scores_fe_prev(), scores);
-    double sum = 0;
-    for(int i=0; i<scores.size(); ++i) {
-      scores[i] += smoothing_prev[i];
-      sum += scores[i];
-    }
-    for(int i=0; i<scores.size(); ++i) {
-      fprintf(file,"%f ",scores[i]/sum);
-    }
-    //fprintf(file, "||| ");
+    append_scores(ms.get_scores_fe_prev(), smoothing_prev, out);
   }
   //condition on the next phrase
   if (next) {
-    vector<double> scores;
-    scorer->score(modelscore->get_scores_fe_next(), scores);
-    double sum = 0;
-    for(int i=0; i<scores.size(); ++i) {
-      scores[i] += smoothing_next[i];
-      sum += scores[i];
-    }
-    for(int i=0; i<scores.size(); ++i) {
-      fprintf(file, "%f ", scores[i]/sum);
-    }
+    append_scores(ms.get_scores_fe_next(), smoothing_next, out);
   }
-  fprintf(file,"\n");
+  out += "\n";
 }
 
-void Model::score_f(const string& f) {
+void Model::score_f(const string& f, const ModelScore& ms, string& out) const {
   if (fe)      //Make sure we do not do anything if it is not a f model
     return;
-  fprintf(file, "%s ||| ", f.c_str());
+  out += f;
+  out += " ||| ";
   //condition on the previous phrase
   if (previous) {
-    vector<double> scores;
-    scorer->score(modelscore->get_scores_f_prev(), scores);
-    double sum = 0;
-    for(int i=0; i<scores.size(); ++i) {
-      scores[i] += smoothing_prev[i];
-      sum += scores[i];
-    }
-    for(int i=0; i<scores.size(); ++i) {
-      fprintf(file, "%f ", scores[i]/sum);
-    }
-    //fprintf(file, "||| ");
+    append_scores(ms.get_scores_f_prev(), smoothing_prev, out);
   }
   //condition on the next phrase
   if (next) {
-    vector<double> scores;
-    scorer->score(modelscore->get_scores_f_next(), scores);
-    double sum = 0;
-    for(int i=0; i<scores.size(); ++i) {
-      scores[i] += smoothing_next[i];
-      sum += scores[i];
-    }
-    for(int i=0; i<scores.size(); ++i) {
-      fprintf(file, "%f ", scores[i]/sum);
-    }
+    append_scores(ms.get_scores_f_next(), smoothing_next, out);
   }
-  fprintf(file, "\n");
+  out += "\n";
+}
+
+void Model::score_fe(const string& f, const string& e)  {
+  string out;
+  score_fe(f, e, *modelscore, out);
+  write(out);
+}
+
+void Model::score_f(const string& f) {
+  string out;
+  score_f(f, *modelscore, out);
+  write(out);
+}
+
+void Model::write(const string& lines) {
+  if (!lines.empty())
+    fwrite(lines.data(), 1, lines.size(), file);
 }
 
 Model::Model(ModelScore* ms, Scorer* sc, const string& dir, const string& lang, const string& fn)
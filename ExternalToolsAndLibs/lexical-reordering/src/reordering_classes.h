@@ -30,6 +30,7 @@ class ModelScore {
 
  public:
   ModelScore();
+  virtual ~ModelScore() {}
   void add_example(const std::string& previous, std::string& next);
   void reset_fe();
   void reset_f();
@@ -64,7 +65,7 @@ class ModelScoreMonotonicity : public ModelScore {
 //Class for calculating total counts, and to calculate smoothing
 class Scorer {
  public:
-  ~Scorer() {}
+  virtual ~Scorer() {}
   virtual void score(const std::vector<double>&, std::vector<double>&) const = 0;
   virtual void createSmoothing(const std::vector<double>&, double, std::vector<double>&) const = 0;
   virtual void createConstSmoothing(double, std::vector<double>&) const = 0;
@@ -120,6 +121,8 @@ class Model {
 
   static void split_config(const std::string& config, std::string& dir, 
 			   std::string& lang, std::string& orient);
+  void append_scores(const std::vector<double>& counts,
+		     const std::vector<double>& smoothing, std::string& out) const;
  public:
   Model(ModelScore* ms, Scorer* sc, const std::string& dir, 
 	const std::string& lang, const std::string& fn);
@@ -129,6 +132,11 @@ class Model {
   void createConstSmoothing(double w);
   void score_fe(const std::string& f, const std::string& e);
   void score_f(const std::string& f);
+  //Thread safe variants which score the counts of the given modelscore
+  //and append the table line to out instead of writing it to the file
+  void score_fe(const std::string& f, const std::string& e, const ModelScore& ms, std::string& out) const;
+  void score_f(const std::string& f, const ModelScore& ms, std::string& out) const;
+  void write(const std::string& lines);
   void zipFile();
 };
 
@@ -13,13 +13,28 @@
 #include <sstream>
 #include <cstdlib>
 #include <cstring>
+#include <thread>
+#include <atomic>
+#include <algorithm>
 
 #include "reordering_classes.h"
 
 using namespace std;
 
+//Number of extract lines after which a partition is closed at the next change
+//of the source phrase
+#define PARTITION_SIZE 100000
+
+//Model types are kept in a fixed slot each instead of a map keyed by name
+enum MODEL_TYPE {HIER, PHRASE, WBE, MODEL_TYPES};
+
 void split_line(const string& line, string& foreign, string& english, string& wbe, string& phrase, string& hier);
 void get_orientations(const string& pair, string& previous, string& next);
+void add_examples(ModelScore* const scores[], const string& w, const string& p, const string& h);
+void score_partition(const vector<string>& lines, const vector<string>& modelTypes,
+                     const vector<Model*>& models, const vector<int>& modelSlots,
+                     vector<string>& out);
+int read_partitions(istream& eFile, string& carry, vector<vector<string> >& partitions);
 
 
 int main(int argc, char* argv[])
@@ -44,19 +59,20 @@ int main(int argc, char* argv[])
   }
 
   bool smoothWithCounts = false;
-  map<string,ModelScore*> modelScores;
+  unsigned int threadCount = 0;
+  ModelScore* modelScores[MODEL_TYPES] = {NULL, NULL, NULL};
+  vector<string> modelTypes(MODEL_TYPES);
   vector<Model*> models;
-  bool hier = false;
-  bool phrase = false;
-  bool wbe = false;
+  vector<int> modelSlots;
 
   string e,f,w,p,h;
-  string prev, next;
 
   int i = 4;
   while (i<argc) {
     if (strcmp(argv[i],"--SmoothWithCounts") == 0) {
       smoothWithCounts = true;
+    } else if (strcmp(argv[i],"--Threads") == 0 && i+1 < argc) {
+      threadCount = atoi(argv[++i]);
     } else if (strcmp(argv[i],"--model") == 0) {
       if (i+1 >= argc){
 	cerr << "score: syntax error, no model information provided to the option" << argv[i] << endl;
@@ -65,24 +81,25 @@ int main(int argc, char* argv[])
       istringstream is(argv[++i]);
       string m,t;
       is >> m >> t;
-      modelScores[m] = ModelScore::createModelScore(t);
+      int slot;
       if (m.compare("hier") == 0) {
-	hier = true;
+	slot = HIER;
       } else if (m.compare("phrase") == 0) {
-	phrase = true;
-      } if (m.compare("wbe") == 0) {
-	wbe = true;
-      } 
-
-      if (!hier && !phrase && !wbe) {
+	slot = PHRASE;
+      } else if (m.compare("wbe") == 0) {
+	slot = WBE;
+      } else {
 	cerr << "WARNING: No models specified for lexical reordering. No lexical reordering table will be trained.\n";
 	return 0;
       }
+      modelScores[slot] = ModelScore::createModelScore(t);
+      modelTypes[slot] = t;
 
       string config;
       //Store all models 
       while (is >> config) {
-	models.push_back(Model::createModel(modelScores[m],config,filepath));
+	models.push_back(Model::createModel(modelScores[slot],config,filepath));
+	modelSlots.push_back(slot);
       }
     } else {
       cerr << "illegal option given to lexical reordering model score\n";
@@ -91,28 +108,20 @@ int main(int argc, char* argv[])
     i++;
   }
 
+  if (threadCount == 0)
+    threadCount = max(1u, thread::hardware_concurrency());
+
   ////////////////////////////////////
   //calculate smoothing
   if (smoothWithCounts) {
     string line;
     while (getline(eFile,line)) {
       split_line(line,e,f,w,p,h);
-      if (hier) {
-	get_orientations(h, prev, next);
-	modelScores["hier"]->add_example(prev,next);
-      } 
-      if (phrase) {
-	get_orientations(p, prev, next);
-	modelScores["phrase"]->add_example(prev,next);
-      } 
-      if (wbe) {
-	get_orientations(w, prev, next);
-	modelScores["wbe"]->add_example(prev,next);
-      }
+      add_examples(modelScores,w,p,h);
     }
 
     // calculate smoothing for each model
-    for (int i=0; i<models.size();++i) {
+    for (size_t i=0; i<models.size();++i) {
       models[i]->createSmoothing(smoothingValue);
     }
 
@@ -122,17 +131,107 @@ int main(int argc, char* argv[])
   }
   else {
     //constant smoothing
-    for (int i=0; i<models.size();++i) {
+    for (size_t i=0; i<models.size();++i) {
       models[i]->createConstSmoothing(smoothingValue);
     }
   }
 
   ////////////////////////////////////
   //calculate scores for reordering table
-  string line,f_current,e_current;
+  //The sorted extract file is cut into partitions which never split the
+  //entries of one source phrase, so each partition can be scored on its own.
+  //A batch of partitions is scored by the worker threads while the next batch
+  //is read, and the scored lines are written in the order of the extract file.
+  vector<vector<string> > current(threadCount), pending(threadCount);
+  vector<vector<string> > outputs(threadCount, vector<string>(models.size()));
+  string carry;
+  int count = read_partitions(eFile, carry, current);
+  while (count > 0) {
+    atomic<int> nextPartition(0);
+    vector<thread> workers;
+    for (unsigned int t = 0; t < threadCount; ++t) {
+      workers.push_back(thread([&]() {
+	for (int j = nextPartition++; j < count; j = nextPartition++) {
+	  score_partition(current[j], modelTypes, models, modelSlots, outputs[j]);
+	}
+      }));
+    }
+
+    int nextCount = read_partitions(eFile, carry, pending);
+
+    for (size_t t = 0; t < workers.size(); ++t) {
+      workers[t].join();
+    }
+    for (int j = 0; j < count; ++j) {
+      for (size_t i=0; i<models.size();++i) {
+	models[i]->write(outputs[j][i]);
+      }
+    }
+
+    current.swap(pending);
+    count = nextCount;
+  }
+
+  //Zip all files
+  for (size_t i=0; i<models.size();++i) {
+    models[i]->zipFile();
+  }
+
+  return 0;
+}
+
+//Reads up to partitions.size() partitions of the extract file. The first line
+//of the next partition is kept in carry. Returns the number of partitions read.
+int read_partitions(istream& eFile, string& carry, vector<vector<string> >& partitions) {
+  int count = 0;
+  string line;
+  while (count < (int)partitions.size()) {
+    vector<string>& lines = partitions[count];
+    lines.clear();
+    if (!carry.empty()) {
+      lines.push_back(carry);
+      carry.clear();
+    }
+    while (getline(eFile, line)) {
+      if (lines.size() >= PARTITION_SIZE) {
+	const string& last = lines.back();
+	size_t lastEnd = last.find(" ||| ");
+	size_t end = line.find(" ||| ");
+	if (end != lastEnd || line.compare(0, end, last, 0, lastEnd) != 0) {
+	  carry = line;
+	  break;
+	}
+      }
+      lines.push_back(line);
+    }
+    if (lines.empty())
+      break;
+    ++count;
+    if (carry.empty())
+      break;
+  }
+  return count;
+}
+
+//Scores a run of extract lines which holds all entries of its source phrases.
+//The counts are accumulated in modelscores private to the calling thread.
+void score_partition(const vector<string>& lines, const vector<string>& modelTypes,
+                     const vector<Model*>& models, const vector<int>& modelSlots,
+                     vector<string>& out) {
+  ModelScore* modelScores[MODEL_TYPES] = {NULL, NULL, NULL};
+  for (int m = 0; m < MODEL_TYPES; ++m) {
+    if (!modelTypes[m].empty())
+      modelScores[m] = ModelScore::createModelScore(modelTypes[m]);
+  }
+  for (size_t i=0; i<models.size();++i) {
+    out[i].clear();
+  }
+
+  string f,e,w,p,h;
+  string f_current,e_current;
   bool first = true;
-  while (getline(eFile, line)) {
-    split_line(line,f,e,w,p,h);
+  for (size_t l = 0; l < lines.size(); ++l) {
+    split_line(lines[l],f,e,w,p,h);
 
     if (first) {
       f_current = f;
@@ -140,56 +239,62 @@ int main(int argc, char* argv[])
       first = false;
     } else if (f.compare(f_current) != 0 || e.compare(e_current) != 0) {
       //fe - score
-      for (int i=0; i<models.size();++i) {
-	models[i]->score_fe(f_current,e_current);
+      for (size_t i=0; i<models.size();++i) {
+	models[i]->score_fe(f_current,e_current,*modelScores[modelSlots[i]],out[i]);
       }
       //reset
-      for(map<string,ModelScore*>::const_iterator it = modelScores.begin(); it != modelScores.end(); ++it) {
-	it->second->reset_fe();
+      for (int m = 0; m < MODEL_TYPES; ++m) {
+	if (modelScores[m])
+	  modelScores[m]->reset_fe();
       }
-      
+
       if (f.compare(f_current) != 0) {
 	//f - score
-	for (int i=0; i<models.size();++i) {
-	  models[i]->score_f(f_current);
+	for (size_t i=0; i<models.size();++i) {
+	  models[i]->score_f(f_current,*modelScores[modelSlots[i]],out[i]);
 	}
-      //reset
-	for(map<string,ModelScore*>::const_iterator it = modelScores.begin(); it != modelScores.end(); ++it) {
-	  it->second->reset_f();
+	//reset
+	for (int m = 0; m < MODEL_TYPES; ++m) {
+	  if (modelScores[m])
+	    modelScores[m]->reset_f();
 	}
       }
       f_current = f;
       e_current = e;
     }
-     
-    // uppdate counts
-    if (hier) {
-      get_orientations(h, prev, next);
-      modelScores["hier"]->add_example(prev,next);
-    } 
-    if (phrase) {
-      get_orientations(p, prev, next);
-      modelScores["phrase"]->add_example(prev,next);
-    } 
-    if (wbe) {
-      get_orientations(w, prev, next);
-      modelScores["wbe"]->add_example(prev,next);
-    }
+
+    // update counts
+    add_examples(modelScores,w,p,h);
   }
   //Score the last phrases
-  for (int i=0; i<models.size();++i) {
-    models[i]->score_fe(f,e);
-  }
-  for (int i=0; i<models.size();++i) {
-    models[i]->score_f(f);
+  if (!first) {
+    for (size_t i=0; i<models.size();++i) {
+      models[i]->score_fe(f,e,*modelScores[modelSlots[i]],out[i]);
+    }
+    for (size_t i=0; i<models.size();++i) {
+      models[i]->score_f(f,*modelScores[modelSlots[i]],out[i]);
+    }
   }
 
-  //Zip all files
-  for (int i=0; i<models.size();++i) {
-    models[i]->zipFile();
+  for (int m = 0; m < MODEL_TYPES; ++m) {
+    delete modelScores[m];
   }
+}
 
-  return 0;
+void add_examples(ModelScore* const scores[], const string& w, const string& p, const string& h) {
+  string prev, next;
+  if (scores[HIER]) {
+    get_orientations(h, prev, next);
+    scores[HIER]->add_example(prev,next);
+  }
+  if (scores[PHRASE]) {
+    get_orientations(p, prev, next);
+    scores[PHRASE]->add_example(prev,next);
+  }
+  if (scores[WBE]) {
+    get_orientations(w, prev, next);
+    scores[WBE]->add_example(prev,next);
+  }
 }
   
 
@@ -217,6 +322,11 @@ void split_line(const string& line, string& foreign, string& english, string& wb
 }
 
 void get_orientations(const string& pair, string& previous, string& next) {
-  istringstream is(pair);
-  is >> previous >> next;
+  static const char* spaces = " \t";
+  size_t begin = pair.find_first_not_of(spaces);
+  size_t end = pair.find_first_of(spaces, begin);
+  previous = begin == string::npos ? string() : pair.substr(begin, end - begin);
+  begin = pair.find_first_not_of(spaces, end);
+  end = pair.find_first_of(spaces, begin);
+  next = begin == string::npos ? string() : pair.substr(begin, end - begin);
 }
@@ -25,9 +25,10 @@ BasePath = ".."
 
 TEMPLATE = subdirs
 
-SUBDIRS += score consolidate extract
+SUBDIRS += score consolidate extract train_phrases
 CONFIG += ordered
 
 score.file = ./score.pro
 consolidate.file = ./consolidate.pro
-extract.file = ./extract.pro
\ No newline at end of file
+extract.file = ./extract.pro
+train_phrases.file = ./train-phrases.pro
\ No newline at end of file
@@ -0,0 +1,927 @@
+/*
+ * train-phrases.cpp
+ *
+ * Integrated phrase-extraction, sorting and scoring pipeline. Produces the
+ * same consolidated phrase table as running extract, sort, score (direct and
+ * inverse), sort and consolidate one after the other, but without the huge
+ * intermediate text files:
+ *
+ *   1. The corpus is read in blocks of sentences which are processed by
+ *      several worker threads (a first pass collects the vocabularies so word
+ *      ids are stable and follow the lexicographic order of the words).
+ *   2. Each worker extracts phrase pairs into compact binary records, which
+ *      are sorted, aggregated and spilled to disk as sorted runs (ordered by
+ *      source and by target phrase) whenever its sort buffer gets full.
+ *   3. Runs are k-way merged and scored in direct and inverse direction
+ *      concurrently, the inverse scores are re-sorted on the fly.
+ *   4. Both score streams are joined into a Moses phrase table which can be
+ *      fed to clsMosesPlainRuleTable or converted using MakeBinary.
+ *
+ * Only phrase-based (non-hierarchical) extraction without reordering models
+ * is supported. Use extract for orientation/reordering graph information.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <stdint.h>
+#include <unistd.h>
+
+#include "SentenceAlignment.h"
+#include "tables-core.h"
+
+using namespace std;
+
+#define SENTENCE_BLOCK_SIZE 2000
+#define MAX_OPEN_RUNS 128
+
+const WORD_ID NO_WORD   = 0xFFFFFFFF;
+const WORD_ID NULL_WORD = 0xFFFFFFFE;
+
+/*******************************************************************************
+ * Binary records
+ *
+ * A record is a sequence of 32 bit words:
+ *   header | source ids | target ids | alignment points | payload
+ * header holds the source length (8 bits), target length (8 bits), number of
+ * alignment points (12 bits) and payload length (4 bits). Alignment points are
+ * stored as (targetPos << 16 | sourcePos) sorted ascending, so they are
+ * grouped by target position. Extracted records carry the count as payload,
+ * scored records carry probability, lexical score and marginal count as three
+ * doubles.
+ ******************************************************************************/
+inline uint32_t makeHeader(size_t _src, size_t _tgt, size_t _align, size_t _payload) {
+  return (uint32_t)(_src | (_tgt << 8) | (_align << 16) | (_payload << 28));
+}
+inline size_t sourceLength(const uint32_t* _r) { return _r[0] & 0xFF; }
+inline size_t targetLength(const uint32_t* _r) { return (_r[0] >> 8) & 0xFF; }
+inline size_t alignmentCount(const uint32_t* _r) { return (_r[0] >> 16) & 0xFFF; }
+inline size_t payloadLength(const uint32_t* _r) { return _r[0] >> 28; }
+inline size_t recordLength(const uint32_t* _r) {
+  return 1 + sourceLength(_r) + targetLength(_r) + alignmentCount(_r) + payloadLength(_r);
+}
+inline const uint32_t* sourceIds(const uint32_t* _r) { return _r + 1; }
+inline const uint32_t* targetIds(const uint32_t* _r) { return _r + 1 + sourceLength(_r); }
+inline const uint32_t* alignmentPoints(const uint32_t* _r) {
+  return _r + 1 + sourceLength(_r) + targetLength(_r);
+}
+inline uint32_t* payload(uint32_t* _r) {
+  return _r + 1 + sourceLength(_r) + targetLength(_r) + alignmentCount(_r);
+}
+inline const uint32_t* payload(const uint32_t* _r) {
+  return _r + 1 + sourceLength(_r) + targetLength(_r) + alignmentCount(_r);
+}
+
+inline void appendDouble(vector<uint32_t>& _record, double _value) {
+  uint32_t words[2];
+  memcpy(words, &_value, sizeof(double));
+  _record.push_back(words[0]);
+  _record.push_back(words[1]);
+}
+inline double readDouble(const uint32_t* _words) {
+  double value;
+  memcpy(&value, _words, sizeof(double));
+  return value;
+}
+
+enum SortOrder { BY_SOURCE, BY_TARGET };
+
+inline int compareIds(const uint32_t* _a, size_t _lenA, const uint32_t* _b, size_t _lenB) {
+  size_t len = min(_lenA, _lenB);
+  for (size_t i = 0; i < len; ++i)
+    if (_a[i] != _b[i])
+      return _a[i] < _b[i] ? -1 : 1;
+  return _lenA == _lenB ? 0 : (_lenA < _lenB ? -1 : 1);
+}
+
+// compares the phrase a record is grouped on (source or target phrase)
+inline int compareGroup(const uint32_t* _a, const uint32_t* _b, SortOrder _order) {
+  if (_order == BY_SOURCE)
+    return compareIds(sourceIds(_a), sourceLength(_a), sourceIds(_b), sourceLength(_b));
+  return compareIds(targetIds(_a), targetLength(_a), targetIds(_b), targetLength(_b));
+}
+
+inline int comparePair(const uint32_t* _a, const uint32_t* _b, SortOrder _order) {
+  int result = compareGroup(_a, _b, _order);
+  if (result != 0)
+    return result;
+  if (_order == BY_SOURCE)
+    return compareIds(targetIds(_a), targetLength(_a), targetIds(_b), targetLength(_b));
+  return compareIds(sourceIds(_a), sourceLength(_a), sourceIds(_b), sourceLength(_b));
+}
+
+inline int compareRecords(const uint32_t* _a, const uint32_t* _b, SortOrder _order) {
+  int result = comparePair(_a, _b, _order);
+  if (result != 0)
+    return result;
+  return compareIds(alignmentPoints(_a), alignmentCount(_a), alignmentPoints(_b), alignmentCount(_b));
+}
+
+/*******************************************************************************
+ * Sorted runs
+ ******************************************************************************/
+class RunWriter
+{
+public:
+  RunWriter(const string& _path) {
+    out.open(_path.c_str(), ios::binary);
+    if (out.fail()) {
+      cerr << "ERROR: could not open temporary file " << _path << endl;
+      exit(1);
+    }
+  }
+  inline void write(const uint32_t* _record) {
+    out.write((const char*)_record, recordLength(_record) * sizeof(uint32_t));
+  }
+  void close() { out.close(); }
+
+private:
+  ofstream out;
+};
+
+class RunReader
+{
+public:
+  RunReader(const string& _path) {
+    in.open(_path.c_str(), ios::binary);
+    if (in.fail()) {
+      cerr << "ERROR: could not open temporary file " << _path << endl;
+      exit(1);
+    }
+  }
+  bool next() {
+    uint32_t header;
+    if (!in.read((char*)&header, sizeof(uint32_t)))
+      return false;
+    record.resize(recordLength(&header));
+    record[0] = header;
+    if (record.size() > 1 &&
+        !in.read((char*)&record[1], (record.size() - 1) * sizeof(uint32_t))) {
+      cerr << "ERROR: truncated temporary file" << endl;
+      exit(1);
+    }
+    return true;
+  }
+  inline const uint32_t* current() const { return record.data(); }
+
+private:
+  ifstream in;
+  vector<uint32_t> record;
+};
+
+// k-way merge of sorted runs
+class RunMerger
+{
+public:
+  RunMerger(const vector<string>& _runs, SortOrder _order)
+    : order(_order), last(-1) {
+    for (size_t i = 0; i < _runs.size(); ++i) {
+      readers.push_back(new RunReader(_runs[i]));
+      if (readers.back()->next())
+        heap.push_back(i);
+    }
+    make_heap(heap.begin(), heap.end(), Greater(this));
+  }
+  ~RunMerger() {
+    for (size_t i = 0; i < readers.size(); ++i)
+      delete readers[i];
+  }
+  bool next() {
+    if (last >= 0 && readers[last]->next()) {
+      heap.push_back(last);
+      push_heap(heap.begin(), heap.end(), Greater(this));
+    }
+    if (heap.empty())
+      return false;
+    pop_heap(heap.begin(), heap.end(), Greater(this));
+    last = heap.back();
+    heap.pop_back();
+    return true;
+  }
+  inline const uint32_t* current() const { return readers[last]->current(); }
+
+private:
+  struct Greater {
+    const RunMerger* merger;
+    Greater(const RunMerger* _merger) : merger(_merger) {}
+    bool operator()(int _a, int _b) const {
+      int result = compareRecords(merger->readers[_a]->current(),
+                                  merger->readers[_b]->current(), merger->order);
+      return result != 0 ? result > 0 : _a > _b;
+    }
+  };
+
+  SortOrder order;
+  vector<RunReader*> readers;
+  vector<int> heap;
+  int last;
+};
+
+class SortBuffer
+{
+public:
+  void add(const uint32_t* _record) {
+    offsets.push_back(data.size());
+    data.insert(data.end(), _record, _record + recordLength(_record));
+  }
+  inline size_t size() const { return data.size(); }
+  inline bool empty() const { return offsets.empty(); }
+  void sort(SortOrder _order) {
+    std::sort(offsets.begin(), offsets.end(), [this, _order](size_t _a, size_t _b) {
+      return compareRecords(&data[_a], &data[_b], _order) < 0;
+    });
+  }
+  // collapses identical consecutive records adding up their counts
+  void aggregate(SortOrder _order) {
+    size_t kept = 0;
+    for (size_t i = 0; i < offsets.size(); ++i) {
+      if (kept > 0 && compareRecords(&data[offsets[kept - 1]], &data[offsets[i]], _order) == 0)
+        payload(&data[offsets[kept - 1]])[0] += payload(&data[offsets[i]])[0];
+      else
+        offsets[kept++] = offsets[i];
+    }
+    offsets.resize(kept);
+  }
+  void write(const string& _path) {
+    RunWriter writer(_path);
+    for (size_t i = 0; i < offsets.size(); ++i)
+      writer.write(&data[offsets[i]]);
+    writer.close();
+  }
+  void clear() {
+    data.clear();
+    offsets.clear();
+  }
+
+private:
+  vector<uint32_t> data;
+  vector<size_t> offsets;
+};
+
+/*******************************************************************************
+ * Vocabulary and lexical tables (read-only once built, hence shared by threads)
+ ******************************************************************************/
+class SortedVocabulary
+{
+public:
+  void build(const unordered_set<string>& _words) {
+    words.assign(_words.begin(), _words.end());
+    std::sort(words.begin(), words.end());
+    lookup.reserve(words.size());
+    for (size_t i = 0; i < words.size(); ++i)
+      lookup[words[i]] = (WORD_ID)i;
+  }
+  inline WORD_ID getWordID(const string& _word) const {
+    unordered_map<string, WORD_ID>::const_iterator item = lookup.find(_word);
+    return item == lookup.end() ? NO_WORD : item->second;
+  }
+  inline WORD_ID getNullID() const {
+    WORD_ID id = getWordID("NULL");
+    return id == NO_WORD ? NULL_WORD : id;
+  }
+  inline const string& getWord(WORD_ID _id) const { return words[_id]; }
+  inline size_t size() const { return words.size(); }
+
+private:
+  unordered_map<string, WORD_ID> lookup;
+  vector<string> words;
+};
+
+class LexicalTable
+{
+public:
+  // lines are "wordT wordS p(wordT|wordS)"
+  void load(const string& _fileName, const SortedVocabulary& _vcbS, const SortedVocabulary& _vcbT) {
+    ifstream inFile(_fileName.c_str());
+    if (inFile.fail()) {
+      cerr << "ERROR: could not open lexical translation table " << _fileName << endl;
+      exit(1);
+    }
+    string line;
+    int i = 0;
+    while (getline(inFile, line)) {
+      ++i;
+      vector<string> token = tokenize(line.c_str());
+      if (token.size() != 3) {
+        cerr << "line " << i << " in " << _fileName
+             << " has wrong number of tokens, skipping:\n" << line << endl;
+        continue;
+      }
+      WORD_ID wordT = _vcbT.getWordID(token[0]);
+      WORD_ID wordS = token[1] == "NULL" ? _vcbS.getNullID() : _vcbS.getWordID(token[1]);
+      // words not seen in the corpus will never be looked up
+      if (wordT == NO_WORD || wordS == NO_WORD)
+        continue;
+      table[key(wordS, wordT)] = atof(token[2].c_str());
+    }
+  }
+  inline double permissiveLookup(WORD_ID _wordS, WORD_ID _wordT) const {
+    unordered_map<uint64_t, double>::const_iterator item = table.find(key(_wordS, _wordT));
+    return item == table.end() ? 1.0 : item->second;
+  }
+
+private:
+  static inline uint64_t key(WORD_ID _wordS, WORD_ID _wordT) {
+    return ((uint64_t)_wordS << 32) | _wordT;
+  }
+  unordered_map<uint64_t, double> table;
+};
+
+/*******************************************************************************
+ * Corpus reader shared by worker threads
+ ******************************************************************************/
+class CorpusReader
+{
+public:
+  void open(const char* _fileNameE, const char* _fileNameF, const char* _fileNameA) {
+    eFile.close(); fFile.close(); aFile.close();
+    eFile.clear(); fFile.clear(); aFile.clear();
+    eFile.open(_fileNameE);
+    fFile.open(_fileNameF);
+    aFile.open(_fileNameA);
+    if (eFile.fail() || fFile.fail() || aFile.fail()) {
+      cerr << "ERROR: could not open corpus files" << endl;
+      exit(1);
+    }
+    lastID = 0;
+  }
+  bool readBlock(vector<string>& _e, vector<string>& _f, vector<string>& _a, int& _firstID) {
+    lock_guard<mutex> guard(lock);
+    _e.resize(SENTENCE_BLOCK_SIZE);
+    _f.resize(SENTENCE_BLOCK_SIZE);
+    _a.resize(SENTENCE_BLOCK_SIZE);
+    size_t count = 0;
+    while (count < SENTENCE_BLOCK_SIZE && getline(eFile, _e[count])) {
+      getline(fFile, _f[count]);
+      getline(aFile, _a[count]);
+      ++count;
+    }
+    _e.resize(count);
+    _f.resize(count);
+    _a.resize(count);
+    _firstID = lastID + 1;
+    lastID += count;
+    if (lastID / 10000 != (lastID - (int)count) / 10000)
+      cerr << "." << flush;
+    return count > 0;
+  }
+
+private:
+  ifstream eFile, fFile, aFile;
+  mutex lock;
+  int lastID;
+};
+
+/*******************************************************************************
+ * Globals
+ ******************************************************************************/
+int maxPhraseLength;
+unsigned int threadCount = 0;
+size_t sortBufferWords = 0;
+bool logProbFlag = false;
+int negLogProb = 1;
+bool lexFlag = true;
+bool wordAlignmentFlag = false;
+string tempPrefix;
+
+CorpusReader corpus;
+SortedVocabulary vcbE;
+SortedVocabulary vcbF;
+LexicalTable lexTableF2E;
+LexicalTable lexTableE2F;
+
+mutex runsLock;
+vector<string> sourceSortedRuns;
+vector<string> targetSortedRuns;
+vector<string> inverseScoreRuns;
+atomic<unsigned int> runCounter(0);
+
+string newRunName(const char* _tag) {
+  ostringstream name;
+  name << tempPrefix << "." << _tag << "." << runCounter++;
+  return name.str();
+}
+
+void runWorkers(function<void()> _worker) {
+  vector<thread> workers;
+  for (unsigned int i = 0; i < threadCount; ++i)
+    workers.push_back(thread(_worker));
+  for (size_t i = 0; i < workers.size(); ++i)
+    workers[i].join();
+}
+
+/*******************************************************************************
+ * Pass 1: vocabulary collection
+ ******************************************************************************/
+void collectVocabulary(unordered_set<string>& _wordsE, unordered_set<string>& _wordsF, mutex& _lock) {
+  unordered_set<string> localE, localF;
+  vector<string> e, f, a;
+  int firstID;
+  while (corpus.readBlock(e, f, a, firstID)) {
+    for (size_t i = 0; i < e.size(); ++i) {
+      vector<string> tokens = tokenize(e[i].c_str());
+      localE.insert(tokens.begin(), tokens.end());
+      tokens = tokenize(f[i].c_str());
+      localF.insert(tokens.begin(), tokens.end());
+    }
+  }
+  lock_guard<mutex> guard(_lock);
+  _wordsE.insert(localE.begin(), localE.end());
+  _wordsF.insert(localF.begin(), localF.end());
+}
+
+/*******************************************************************************
+ * Pass 2: phrase extraction into sorted runs
+ ******************************************************************************/
+void flushExtractedPhrases(SortBuffer& _buffer) {
+  if (_buffer.empty())
+    return;
+  string sourceRun = newRunName("src");
+  string targetRun = newRunName("tgt");
+  _buffer.sort(BY_SOURCE);
+  _buffer.aggregate(BY_SOURCE);
+  _buffer.write(sourceRun);
+  _buffer.sort(BY_TARGET);
+  _buffer.write(targetRun);
+  _buffer.clear();
+
+  lock_guard<mutex> guard(runsLock);
+  sourceSortedRuns.push_back(sourceRun);
+  targetSortedRuns.push_back(targetRun);
+}
+
+// same phrase pairs as extract() in extract.cpp, without orientation info
+void extractSentence(SentenceAlignment& _sentence, SortBuffer& _buffer) {
+  int countE = _sentence.target.size();
+  int countF = _sentence.source.size();
+
+  vector<WORD_ID> idsE(countE), idsF(countF);
+  for (int ei = 0; ei < countE; ++ei)
+    idsE[ei] = vcbE.getWordID(_sentence.target[ei]);
+  for (int fi = 0; fi < countF; ++fi)
+    idsF[fi] = vcbF.getWordID(_sentence.source[fi]);
+
+  vector<uint32_t> record, points;
+  for (int startE = 0; startE < countE; startE++) {
+    for (int endE = startE; (endE < countE && endE < startE + maxPhraseLength); endE++) {
+      int minF = 9999;
+      int maxF = -1;
+      vector<int> usedF = _sentence.alignedCountS;
+      for (int ei = startE; ei <= endE; ei++) {
+        for (size_t i = 0; i < _sentence.alignedToT[ei].size(); i++) {
+          int fi = _sentence.alignedToT[ei][i];
+          if (fi < minF) { minF = fi; }
+          if (fi > maxF) { maxF = fi; }
+          usedF[fi]--;
+        }
+      }
+
+      if (maxF < 0 || maxF - minF >= maxPhraseLength)
+        continue;
+
+      // check if source words are aligned to out of bound target words
+      bool outOfBounds = false;
+      for (int fi = minF; fi <= maxF && !outOfBounds; fi++)
+        if (usedF[fi] > 0)
+          outOfBounds = true;
+      if (outOfBounds)
+        continue;
+
+      // start point of source phrase may retreat over unaligned
+      for (int startF = minF;
+           (startF >= 0 &&
+            startF > maxF - maxPhraseLength &&
+            (startF == minF || _sentence.alignedCountS[startF] == 0));
+           startF--) {
+        // end point of source phrase may advance over unaligned
+        for (int endF = maxF;
+             (endF < countF &&
+              endF < startF + maxPhraseLength &&
+              (endF == maxF || _sentence.alignedCountS[endF] == 0));
+             endF++) {
+          points.clear();
+          for (int ei = startE; ei <= endE; ei++)
+            for (size_t i = 0; i < _sentence.alignedToT[ei].size(); i++)
+              points.push_back(((uint32_t)(ei - startE) << 16) | (uint32_t)(_sentence.alignedToT[ei][i] - startF));
+          std::sort(points.begin(), points.end());
+          points.erase(unique(points.begin(), points.end()), points.end());
+
+          record.clear();
+          record.push_back(makeHeader(endF - startF + 1, endE - startE + 1, points.size(), 1));
+          record.insert(record.end(), idsF.begin() + startF, idsF.begin() + endF + 1);
+          record.insert(record.end(), idsE.begin() + startE, idsE.begin() + endE + 1);
+          record.insert(record.end(), points.begin(), points.end());
+          record.push_back(1);
+          _buffer.add(record.data());
+        }
+      }
+    }
+  }
+}
+
+void extractPhrases() {
+  SortBuffer buffer;
+  size_t bufferLimit = max<size_t>(sortBufferWords / threadCount, 1 << 16);
+  vector<string> e, f, a;
+  int firstID;
+  while (corpus.readBlock(e, f, a, firstID)) {
+    for (size_t i = 0; i < e.size(); ++i) {
+      SentenceAlignment sentence;
+      if (sentence.create(&e[i][0], &f[i][0], &a[i][0], firstID + i))
+        extractSentence(sentence, buffer);
+      if (buffer.size() >= bufferLimit)
+        flushExtractedPhrases(buffer);
+    }
+  }
+  flushExtractedPhrases(buffer);
+}
+
+// merges runs until they can all be opened at once
+void reduceRuns(vector<string>& _runs, SortOrder _order, const char* _tag) {
+  while (_runs.size() > MAX_OPEN_RUNS) {
+    vector<string> merged;
+    for (size_t start = 0; start < _runs.size(); start += MAX_OPEN_RUNS) {
+      vector<string> chunk(_runs.begin() + start,
+                           _runs.begin() + min(_runs.size(), start + MAX_OPEN_RUNS));
+      string output = newRunName(_tag);
+      {
+        RunMerger merger(chunk, _order);
+        RunWriter writer(output);
+        while (merger.next())
+          writer.write(merger.current());
+      }
+      for (size_t i = 0; i < chunk.size(); ++i)
+        remove(chunk[i].c_str());
+      merged.push_back(output);
+    }
+    _runs.swap(merged);
+  }
+}
+
+/*******************************************************************************
+ * Pass 3: scoring
+ ******************************************************************************/
+// lexical translation probability explaining every target word (see score.cpp)
+double computeDirectLexicalScore(const uint32_t* _record) {
+  const uint32_t* src = sourceIds(_record);
+  const uint32_t* tgt = targetIds(_record);
+  const uint32_t* points = alignmentPoints(_record);
+  size_t count = alignmentCount(_record);
+  WORD_ID nullF = vcbF.getNullID();
+
+  double lexScore = 1.0;
+  size_t p = 0;
+  for (size_t ti = 0; ti < targetLength(_record); ++ti) {
+    double thisWordScore = 0;
+    size_t aligned = 0;
+    for (; p < count && (points[p] >> 16) == ti; ++p, ++aligned)
+      thisWordScore += lexTableF2E.permissiveLookup(src[points[p] & 0xFFFF], tgt[ti]);
+    lexScore *= aligned ? thisWordScore / (double)aligned : lexTableF2E.permissiveLookup(nullF, tgt[ti]);
+  }
+  return lexScore;
+}
+
+// lexical translation probability explaining every source word
+double computeInverseLexicalScore(const uint32_t* _record) {
+  const uint32_t* src = sourceIds(_record);
+  const uint32_t* tgt = targetIds(_record);
+  const uint32_t* points = alignmentPoints(_record);
+  size_t count = alignmentCount(_record);
+  WORD_ID nullE = vcbE.getNullID();
+
+  double lexScore = 1.0;
+  for (size_t si = 0; si < sourceLength(_record); ++si) {
+    double thisWordScore = 0;
+    size_t aligned = 0;
+    for (size_t p = 0; p < count; ++p)
+      if ((points[p] & 0xFFFF) == si) {
+        thisWordScore += lexTableE2F.permissiveLookup(tgt[points[p] >> 16], src[si]);
+        ++aligned;
+      }
+    lexScore *= aligned ? thisWordScore / (double)aligned : lexTableE2F.permissiveLookup(nullE, src[si]);
+  }
+  return lexScore;
+}
+
+// alignment points as printed by extract into extract (source-target) or
+// extract.inv (target-source) files
+string alignmentText(const uint32_t* _record, SortOrder _order) {
+  ostringstream text;
+  const uint32_t* points = alignmentPoints(_record);
+  for (size_t p = 0; p < alignmentCount(_record); ++p) {
+    if (_order == BY_SOURCE)
+      text << " " << (points[p] & 0xFFFF) << "-" << (points[p] >> 16);
+    else
+      text << " " << (points[p] >> 16) << "-" << (points[p] & 0xFFFF);
+  }
+  return text.str();
+}
+
+/**
+ * Streams merged extraction runs grouped by source (direct) or target (inverse)
+ * phrase. Identical phrase pairs are summed up and the most frequent alignment
+ * is kept for the lexical score, as done by score.cpp. score.cpp reads extract
+ * files sorted with LC_ALL=C and keeps the first of equally frequent
+ * alignments, so ties are broken in favor of the alignment whose text sorts
+ * first. Points are printed in ascending order here, which is what extract
+ * prints unless the alignment file lists the source words of a target word
+ * out of order. Scored pairs are handed to _sink.
+ */
+void scorePhrasePairs(const vector<string>& _runs, SortOrder _order,
+                      function<void(const uint32_t*)> _sink) {
+  RunMerger merger(_runs, _order);
+
+  vector<uint32_t> variant, best, groupData, scored;
+  vector<pair<size_t, double> > group;
+  double variantCount = 0, pairCount = 0, bestCount = -1;
+  bool hasVariant = false;
+
+  auto closeVariant = [&]() {
+    pairCount += variantCount;
+    if (variantCount > bestCount ||
+        (variantCount == bestCount &&
+         alignmentText(variant.data(), _order) < alignmentText(best.data(), _order))) {
+      best = variant;
+      bestCount = variantCount;
+    }
+  };
+  auto closePair = [&]() {
+    group.push_back(make_pair(groupData.size(), pairCount));
+    groupData.insert(groupData.end(), best.begin(), best.end());
+    pairCount = 0;
+    bestCount = -1;
+  };
+  auto closeGroup = [&]() {
+    double total = 0;
+    for (size_t i = 0; i < group.size(); ++i)
+      total += group[i].second;
+    for (size_t i = 0; i < group.size(); ++i) {
+      const uint32_t* record = &groupData[group[i].first];
+      bool keepAlignment = _order == BY_SOURCE && wordAlignmentFlag;
+      scored.clear();
+      scored.push_back(makeHeader(sourceLength(record), targetLength(record),
+                                  keepAlignment ? alignmentCount(record) : 0, 6));
+      scored.insert(scored.end(), sourceIds(record), sourceIds(record) + sourceLength(record));
+      scored.insert(scored.end(), targetIds(record), targetIds(record) + targetLength(record));
+      if (keepAlignment)
+        scored.insert(scored.end(), alignmentPoints(record), alignmentPoints(record) + alignmentCount(record));
+      appendDouble(scored, group[i].second / total);
+      appendDouble(scored, lexFlag ? (_order == BY_SOURCE ? computeDirectLexicalScore(record)
+                                                         : computeInverseLexicalScore(record))
+                                   : 1.0);
+      appendDouble(scored, total);
+      _sink(scored.data());
+    }
+    group.clear();
+    groupData.clear();
+  };
+
+  while (merger.next()) {
+    const uint32_t* record = merger.current();
+    double count = payload(record)[0];
+    if (hasVariant) {
+      if (compareRecords(variant.data(), record, _order) == 0) {
+        variantCount += count;
+        continue;
+      }
+      closeVariant();
+      if (comparePair(variant.data(), record, _order) != 0) {
+        closePair();
+        if (compareGroup(variant.data(), record, _order) != 0)
+          closeGroup();
+      }
+    }
+    variant.assign(record, record + recordLength(record));
+    variantCount = count;
+    hasVariant = true;
+  }
+  if (hasVariant) {
+    closeVariant();
+    closePair();
+    closeGroup();
+  }
+}
+
+void scoreDirect(const string& _outputPath) {
+  RunWriter writer(_outputPath);
+  scorePhrasePairs(sourceSortedRuns, BY_SOURCE, [&writer](const uint32_t* _scored) {
+    writer.write(_scored);
+  });
+  writer.close();
+}
+
+// inverse scores come ordered by target phrase and are re-sorted by source phrase
+void scoreInverse() {
+  SortBuffer buffer;
+  size_t bufferLimit = max<size_t>(sortBufferWords / 2, 1 << 16);
+  auto flush = [&buffer]() {
+    if (buffer.empty())
+      return;
+    string run = newRunName("inv");
+    buffer.sort(BY_SOURCE);
+    buffer.write(run);
+    buffer.clear();
+    inverseScoreRuns.push_back(run);
+  };
+  scorePhrasePairs(targetSortedRuns, BY_TARGET, [&](const uint32_t* _scored) {
+    buffer.add(_scored);
+    if (buffer.size() >= bufferLimit)
+      flush();
+  });
+  flush();
+}
+
+/*******************************************************************************
+ * Pass 4: consolidation
+ ******************************************************************************/
+inline double outputScore(double _score) {
+  return logProbFlag ? negLogProb * log(_score) : _score;
+}
+
+void consolidate(const string& _directPath, const string& _fileNamePhraseTable) {
+  ofstream phraseTableFile(_fileNamePhraseTable.c_str());
+  if (phraseTableFile.fail()) {
+    cerr << "ERROR: could not open file phrase table file " << _fileNamePhraseTable << endl;
+    exit(1);
+  }
+
+  RunReader direct(_directPath);
+  RunMerger inverse(inverseScoreRuns, BY_SOURCE);
+  size_t i = 0;
+  while (direct.next()) {
+    if (++i % 100000 == 0) cerr << "." << flush;
+    const uint32_t* recordDirect = direct.current();
+    if (!inverse.next() || comparePair(recordDirect, inverse.current(), BY_SOURCE) != 0) {
+      cerr << "ERROR: direct and inverse scores do not match at phrase pair " << i << endl;
+      exit(1);
+    }
+    const uint32_t* scoresDirect = payload(recordDirect);
+    const uint32_t* scoresInverse = payload(inverse.current());
+
+    const uint32_t* src = sourceIds(recordDirect);
+    for (size_t j = 0; j < sourceLength(recordDirect); ++j)
+      phraseTableFile << (j ? " " : "") << vcbF.getWord(src[j]);
+    phraseTableFile << " ||| ";
+    const uint32_t* tgt = targetIds(recordDirect);
+    for (size_t j = 0; j < targetLength(recordDirect); ++j)
+      phraseTableFile << (j ? " " : "") << vcbE.getWord(tgt[j]);
+
+    // probs: indirect, direct and phrase count feature
+    phraseTableFile << " ||| " << outputScore(readDouble(scoresInverse));
+    if (lexFlag)
+      phraseTableFile << " " << outputScore(readDouble(scoresInverse + 2));
+    phraseTableFile << " " << outputScore(readDouble(scoresDirect));
+    if (lexFlag)
+      phraseTableFile << " " << outputScore(readDouble(scoresDirect + 2));
+    phraseTableFile << " " << (logProbFlag ? 1 : 2.718);
+
+    // alignment
+    phraseTableFile << " ||| ";
+    const uint32_t* points = alignmentPoints(recordDirect);
+    for (size_t j = 0; j < alignmentCount(recordDirect); ++j)
+      phraseTableFile << (points[j] & 0xFFFF) << "-" << (points[j] >> 16) << " ";
+
+    // counts, for debugging
+    phraseTableFile << "||| " << readDouble(scoresInverse + 4) << " " << readDouble(scoresDirect + 4);
+    phraseTableFile << "\n";
+  }
+  phraseTableFile.close();
+}
+
+void removeRuns(const vector<string>& _runs) {
+  for (size_t i = 0; i < _runs.size(); ++i)
+    remove(_runs[i].c_str());
+}
+
+int main(int argc, char* argv[])
+{
+  cerr << "TrainPhrases v1.0\n"
+       << "integrated phrase extraction, sorting and scoring\n";
+
+  if (argc < 8) {
+    cerr << "syntax: train-phrases en de align lex.f2e lex.e2f phrase-table max-length "
+         << "[--Threads n] [--SortBufferSize MB] [--TempDir dir] [--WordAlignment] [--NoLex] [--LogProb] [--NegLogProb]\n";
+    exit(1);
+  }
+  char* fileNameE = argv[1];
+  char* fileNameF = argv[2];
+  char* fileNameA = argv[3];
+  string fileNameLexF2E = argv[4];
+  string fileNameLexE2F = argv[5];
+  string fileNamePhraseTable = argv[6];
+  maxPhraseLength = atoi(argv[7]);
+  size_t sortBufferSizeMB = 1024;
+  string tempDir;
+
+  if (maxPhraseLength < 1 || maxPhraseLength > 63) {
+    cerr << "ERROR: max-length must be between 1 and 63" << endl;
+    exit(1);
+  }
+
+  for (int i = 8; i < argc; i++) {
+    if (strcmp(argv[i], "--Threads") == 0 && i + 1 < argc) {
+      threadCount = atoi(argv[++i]);
+    }
+    else if (strcmp(argv[i], "--SortBufferSize") == 0 && i + 1 < argc) {
+      sortBufferSizeMB = atoi(argv[++i]);
+    }
+    else if (strcmp(argv[i], "--TempDir") == 0 && i + 1 < argc) {
+      tempDir = argv[++i];
+    }
+    else if (strcmp(argv[i], "--WordAlignment") == 0) {
+      wordAlignmentFlag = true;
+      cerr << "outputing word alignment" << endl;
+    }
+    else if (strcmp(argv[i], "--NoLex") == 0) {
+      lexFlag = false;
+      cerr << "not computing lexical translation score\n";
+    }
+    else if (strcmp(argv[i], "--LogProb") == 0) {
+      logProbFlag = true;
+      cerr << "using log-probabilities\n";
+    }
+    else if (strcmp(argv[i], "--NegLogProb") == 0) {
+      logProbFlag = true;
+      negLogProb = -1;
+      cerr << "using negative log-probabilities\n";
+    }
+    else {
+      cerr << "ERROR: unknown option " << argv[i] << endl;
+      exit(1);
+    }
+  }
+
+  if (threadCount == 0)
+    threadCount = max(1u, thread::hardware_concurrency());
+  sortBufferWords = max<size_t>(sortBufferSizeMB, 1) * 1024 * 1024 / sizeof(uint32_t);
+
+  ostringstream prefix;
+  if (tempDir.empty())
+    prefix << fileNamePhraseTable;
+  else
+    prefix << tempDir << "/" << fileNamePhraseTable.substr(fileNamePhraseTable.rfind('/') + 1);
+  prefix << ".tmp" << getpid();
+  tempPrefix = prefix.str();
+
+  cerr << "collecting vocabularies using " << threadCount << " threads";
+  {
+    unordered_set<string> wordsE, wordsF;
+    mutex lock;
+    corpus.open(fileNameE, fileNameF, fileNameA);
+    runWorkers([&]() { collectVocabulary(wordsE, wordsF, lock); });
+    vcbE.build(wordsE);
+    vcbF.build(wordsF);
+  }
+  cerr << "\n" << vcbF.size() << " source and " << vcbE.size() << " target words\n";
+
+  // lexical tables are not needed before scoring, so they load meanwhile
+  thread lexLoaderF2E, lexLoaderE2F;
+  if (lexFlag) {
+    lexLoaderF2E = thread([&]() { lexTableF2E.load(fileNameLexF2E, vcbF, vcbE); });
+    lexLoaderE2F = thread([&]() { lexTableE2F.load(fileNameLexE2F, vcbE, vcbF); });
+  }
+
+  cerr << "extracting phrases";
+  corpus.open(fileNameE, fileNameF, fileNameA);
+  runWorkers(extractPhrases);
+  cerr << "\n" << sourceSortedRuns.size() << " sorted runs\n";
+
+  if (lexFlag) {
+    lexLoaderF2E.join();
+    lexLoaderE2F.join();
+  }
+
+  cerr << "scoring phrase pairs\n";
+  thread reduceSource([]() { reduceRuns(sourceSortedRuns, BY_SOURCE, "src"); });
+  reduceRuns(targetSortedRuns, BY_TARGET, "tgt");
+  reduceSource.join();
+
+  string directScores = tempPrefix + ".dir";
+  thread directScorer(scoreDirect, directScores);
+  scoreInverse();
+  directScorer.join();
+  removeRuns(sourceSortedRuns);
+  removeRuns(targetSortedRuns);
+  reduceRuns(inverseScoreRuns, BY_SOURCE, "inv");
+
+  cerr << "writing phrase table";
+  consolidate(directScores, fileNamePhraseTable);
+  cerr << endl;
+
+  remove(directScores.c_str());
+  removeRuns(inverseScoreRuns);
+  return 0;
+}
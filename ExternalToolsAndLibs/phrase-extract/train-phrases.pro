@@ -0,0 +1,43 @@
+################################################################################
+#   Targoman: A robust Statistical Machine Translation framework
+#
+#   Copyright 2014-2015 by ITRC <http://itrc.ac.ir>
+#
+#   This file is part of Targoman.
+#
+#   Targoman is free software: you can redistribute it and/or modify
+#   it under the terms of the GNU Lesser General Public License as published by
+#   the Free Software Foundation, either version 3 of the License, or
+#   (at your option) any later version.
+#
+#   Targoman is distributed in the hope that it will be useful,
+#   but WITHOUT ANY WARRANTY; without even the implied warranty of
+#   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#   GNU Lesser General Public License for more details.
+#
+#   You should have received a copy of the GNU Lesser General Public License
+#   along with Targoman. If not, see <http://www.gnu.org/licenses/>.
+################################################################################
+
+include(common.pri)
+ProjectName="train-phrases"
+SOURCES += \
+    src/train-phrases.cpp
+CONFIG += thread
+
+################################################################################
+#                       DO NOT CHANGE ANYTHING BELOW                           #
+################################################################################
+ConfigFile = $$BasePath/Configs.pri
+!exists($$ConfigFile){
+error("**** train-phrases: Unable to find Configuration file $$ConfigFile ****")
+}
+include ($$ConfigFile)
+
+TEMPLATE = app
+TARGET = $$ProjectName
+DESTDIR = $$BaseBinFolder
+OBJECTS_DIR = $$BaseBuildFolder/obj
+MOC_DIR = $$BaseBuildFolder/moc
+INCLUDEPATH += $$BasePath/libsrc
+QMAKE_LIBDIR += $$BaseLibraryFolder
\ No newline at end of file
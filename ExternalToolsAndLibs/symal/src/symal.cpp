@@ -11,6 +11,8 @@
 #include <set>
 #include <algorithm>
 #include <cstring>
+#include <thread>
+#include <atomic>
 #include "cmd.h"
 
 using namespace std;
@@ -18,6 +20,7 @@ using namespace std;
 #define MAX_WORD 1000  //maximum lengthsource/target strings 
 #define MAX_M 200     //maximum length of source strings
 #define MAX_N 200     //maximum length of target strings 
+#define BLOCK_SIZE 20000 //number of sentences read and aligned per block
 
 #define UNION                      1
 #define INTERSECT                  2
@@ -57,17 +60,39 @@ static Enum_T BoolEnum [] = {
 
 // global variables and constants
 
-int* fa; //counters of covered foreign positions
-int* ea; //counters of covered english positions
-int** A; //alignment matrix with information symmetric/direct/inverse alignments
-
 int verbose=0;
 
+//one sentence pair of the input with its direct and inverse alignments
+
+struct Sentence {
+  int m, n;
+  vector<int> a;
+  vector<int> b;
+};
+
+//per thread buffers used by grow alignment. The alignment matrix is kept flat
+//with a row stride of m+1 so that it is cleared with one contiguous fill
+
+struct Workspace {
+  vector<int> fa; //counters of covered foreign positions
+  vector<int> ea; //counters of covered english positions
+  vector<signed char> A; //alignment matrix with information symmetric/direct/inverse alignments
+  int stride;
+
+  void reset(int m, int n) {
+    stride = m + 1;
+    fa.assign(m + 1, 0);
+    ea.assign(n + 1, 0);
+    A.assign((size_t)(n + 1) * stride, 0);
+  }
+  signed char& at(int i, int j) { return A[(size_t)i * stride + j]; }
+};
+
 //read an alignment pair from the input stream. 
 
 int lc = 0;
 
-int getals(fstream& inp,int& m, int *a,int& n, int *b)
+int getals(fstream& inp,int& m, vector<int>& a,int& n, vector<int>& b)
 {
   char w[MAX_WORD], dummy[10];
   int i,j,freq;
@@ -75,6 +100,7 @@ int getals(fstream& inp,int& m, int *a,int& n, int *b)
     ++lc;
     //target sentence
     inp >> n; assert(n<MAX_N);
+    b.resize(n+1);
     for (i=1;i<=n;i++){ 
       inp >> setw(MAX_WORD) >> w;
       if (strlen(w)>=MAX_WORD-1) {
@@ -90,6 +116,7 @@ int getals(fstream& inp,int& m, int *a,int& n, int *b)
 
     //source sentence
     inp >> m; assert(m<MAX_M);
+    a.resize(m+1);
     for (j=1;j<=m;j++){
       inp >> setw(MAX_WORD) >> w;
       if (strlen(w)>=MAX_WORD-1) {
@@ -120,7 +147,7 @@ int getals(fstream& inp,int& m, int *a,int& n, int *b)
 
 
 //compute union alignment
-int prunionalignment(fstream& out,int m,int *a,int n,int* b){
+int prunionalignment(ostream& out,int m,int *a,int n,int* b){
   
   ostringstream sout;
   
@@ -140,7 +167,6 @@ int prunionalignment(fstream& out,int m,int *a,int n,int* b){
     str.replace(str.length()-1,1,"\n");
 
   out << str;
-         out.flush();
  
 	return 1;
 }
@@ -148,7 +174,7 @@ int prunionalignment(fstream& out,int m,int *a,int n,int* b){
 
 //Compute intersection alignment
 
-int printersect(fstream& out,int m,int *a,int n,int* b){
+int printersect(ostream& out,int m,int *a,int n,int* b){
 
   ostringstream sout;
 
@@ -164,14 +190,13 @@ int printersect(fstream& out,int m,int *a,int n,int* b){
     str.replace(str.length()-1,1,"\n");
 
   out << str;
-         out.flush();
 
         return 1;
 }
 
 //Compute target-to-source alignment
 
-int printtgttosrc(fstream& out,int m,int *a,int n,int* b){
+int printtgttosrc(ostream& out,int m,int *a,int n,int* b){
   
   ostringstream sout;
 
@@ -187,14 +212,13 @@ int printtgttosrc(fstream& out,int m,int *a,int n,int* b){
     str.replace(str.length()-1,1,"\n");
 
   out << str;
-         out.flush();
 
 	return 1;
 }
 
 //Compute source-to-target alignment
 
-int printsrctotgt(fstream& out,int m,int *a,int n,int* b){
+int printsrctotgt(ostream& out,int m,int *a,int n,int* b){
 
   ostringstream sout;
 
@@ -210,7 +234,6 @@ int printsrctotgt(fstream& out,int m,int *a,int n,int* b){
     str.replace(str.length()-1,1,"\n");
 
   out << str;
-         out.flush();
 
         return 1;
 }
@@ -221,7 +244,7 @@ int printsrctotgt(fstream& out,int m,int *a,int n,int* b){
 //to represent the grow alignment as the unionalignment of a
 //directed and inverted alignment
 
-int printgrow(fstream& out,int m,int *a,int n,int* b, bool diagonal=false,bool final=false,bool bothuncovered=false){
+int printgrow(ostream& out,Workspace& w,int m,int *a,int n,int* b, bool diagonal=false,bool final=false,bool bothuncovered=false){
    
    ostringstream sout;
    
@@ -248,13 +271,13 @@ int printgrow(fstream& out,int m,int *a,int n,int* b, bool diagonal=false,bool f
    
    //covered foreign and english positions 
    
-    memset(fa,0,(m+1)*sizeof(int));
-    memset(ea,0,(n+1)*sizeof(int));
+   w.reset(m,n);
+   vector<int>& fa=w.fa;
+   vector<int>& ea=w.ea;
    
    //matrix to quickly check if one point is in the symmetric
-   //alignment (value=2), direct alignment (=1) and inverse alignment   
- 
-   for (int i=1;i<=n;i++) memset(A[i],0,(m+1)*sizeof(int));
+   //alignment (value=2), direct alignment (=1) and inverse alignment
+   //is kept in w.A
    
    set <pair <int,int> > currentpoints; //symmetric alignment
    set <pair <int,int> > unionalignment; //union alignment
@@ -268,18 +291,18 @@ int printgrow(fstream& out,int m,int *a,int n,int* b, bool diagonal=false,bool f
          unionalignment.insert(make_pair(a[j],j));
          if (b[a[j]]==j){ 
             fa[j]=1;ea[a[j]]=1;
-            A[a[j]][j]=2;   
+            w.at(a[j],j)=2;   
             currentpoints.insert(make_pair(a[j],j));
          }         
          else 
-            A[a[j]][j]=-1;
+            w.at(a[j],j)=-1;
       }
    }
    
    for (i=1;i<=n;i++) 
       if (b[i] && a[b[i]]!=i){ //not intersection
          unionalignment.insert(make_pair(i,b[i])); 
-         A[i][b[i]]=1;
+         w.at(i,b[i])=1;
       } 
          
              
@@ -305,7 +328,7 @@ int printgrow(fstream& out,int m,int *a,int n,int* b, bool diagonal=false,bool f
                   {
                      //insert point in currentpoints!
                      currentpoints.insert(point);
-                     A[point.first][point.second]=2;
+                     w.at(point.first,point.second)=2;
                      ea[point.first]=1; fa[point.second]=1;
                      added=1;
                      //cout << "added grow: " << point.second-1 << "-" << point.first-1 << "\n";cout.flush();
@@ -317,7 +340,7 @@ int printgrow(fstream& out,int m,int *a,int n,int* b, bool diagonal=false,bool f
       
       if (final){
          for (k=unionalignment.begin();k!=unionalignment.end();k++)
-            if (A[k->first][k->second]==1)
+            if (w.at(k->first,k->second)==1)
             {            
                point.first=k->first;point.second=k->second;
                //one of the two words is not covered yet
@@ -327,7 +350,7 @@ int printgrow(fstream& out,int m,int *a,int n,int* b, bool diagonal=false,bool f
                {
                   //add it!
                   currentpoints.insert(point);
-                  A[point.first][point.second]=2;
+                  w.at(point.first,point.second)=2;
                   //keep track of new covered positions                
                   ea[point.first]=1;fa[point.second]=1;
                   
@@ -337,7 +360,7 @@ int printgrow(fstream& out,int m,int *a,int n,int* b, bool diagonal=false,bool f
             }
                
                for (k=unionalignment.begin();k!=unionalignment.end();k++)
-                  if (A[k->first][k->second]==-1)
+                  if (w.at(k->first,k->second)==-1)
                   {            
                      point.first=k->first;point.second=k->second;
                      //one of the two words is not covered yet
@@ -347,7 +370,7 @@ int printgrow(fstream& out,int m,int *a,int n,int* b, bool diagonal=false,bool f
                      {
                         //add it!
                         currentpoints.insert(point);
-                        A[point.first][point.second]=2;
+                        w.at(point.first,point.second)=2;
                         //keep track of new covered positions                
                         ea[point.first]=1;fa[point.second]=1;
                         
@@ -370,7 +393,6 @@ int printgrow(fstream& out,int m,int *a,int n,int* b, bool diagonal=false,bool f
 	   str.replace(str.length()-1,1,"\n");
          
          out << str;
-         out.flush();
          return 1;
          
          return 1;
@@ -378,6 +400,39 @@ int printgrow(fstream& out,int m,int *a,int n,int* b, bool diagonal=false,bool f
 
 
 
+//symmetrize one sentence pair with the selected heuristic
+
+void symmetrize(ostream& out,Workspace& w,Sentence& s,int alignment,bool diagonal,bool final,bool bothuncovered){
+  switch (alignment){
+    case UNION:
+      prunionalignment(out,s.m,&s.a[0],s.n,&s.b[0]);
+      break;
+    case INTERSECT:
+      printersect(out,s.m,&s.a[0],s.n,&s.b[0]);
+      break;
+    case GROW:
+      printgrow(out,w,s.m,&s.a[0],s.n,&s.b[0],diagonal,final,bothuncovered);
+      break;
+    case TGTTOSRC:
+      printtgttosrc(out,s.m,&s.a[0],s.n,&s.b[0]);
+      break;
+    case SRCTOTGT:
+      printsrctotgt(out,s.m,&s.a[0],s.n,&s.b[0]);
+      break;
+  }
+}
+
+//read up to block.size() sentence pairs, returns the number of pairs read
+
+int readblock(fstream& inp,vector<Sentence>& block){
+  int count=0;
+  while (count<(int)block.size() &&
+         getals(inp,block[count].m,block[count].a,block[count].n,block[count].b))
+    count++;
+  return count;
+}
+
+
 //Main file here
 
 
@@ -389,6 +444,7 @@ char* output="/dev/stdout";
 int diagonal=false;
 int final=false;
 int bothuncovered=false;
+int threads=0;
 
 	
 	DeclareParams("a", CMDENUMTYPE,  &alignment, AlignEnum,
@@ -403,13 +459,15 @@ int bothuncovered=false;
                  "o", CMDSTRINGTYPE, &output,
                  "v", CMDENUMTYPE,  &verbose, BoolEnum,
                  "verbose", CMDENUMTYPE,  &verbose, BoolEnum,
+                 "t", CMDINTTYPE,  &threads,
+                 "threads", CMDINTTYPE,  &threads,
 
                  (char *)NULL);
   
 	GetParams(&argc, &argv, (char*) NULL);
    
    if (alignment==0){
-      cerr << "usage: symal [-i=<inputfile>] [-o=<outputfile>] -a=[u|i|g] -d=[yes|no] -b=[yes|no] -f=[yes|no] \n"
+      cerr << "usage: symal [-i=<inputfile>] [-o=<outputfile>] -a=[u|i|g] -d=[yes|no] -b=[yes|no] -f=[yes|no] [-t=<threads>] \n"
       << "Input file or std must be in .bal format (see script giza2bal.pl).\n";
          
       exit(1);
@@ -430,66 +488,68 @@ int bothuncovered=false;
 	}
    
 
-  int a[MAX_M],b[MAX_N],m,n;
-  fa=new int[MAX_M+1];
-  ea=new int[MAX_N+1];
- 
-      
-  int sents = 0;
-  A=new int *[MAX_N+1]; 
-  for (int i=1;i<=MAX_N;i++) A[i]=new int[MAX_M+1];
-      
 	switch (alignment){
 		case UNION:
          cerr << "symal: computing union alignment\n";
-			while(getals(inp,m,a,n,b)) {
-                          prunionalignment(out,m,a,n,b);
-                          sents++;
-                        }
-                        cerr << "Sents: " << sents << endl;
 			break;
 		case INTERSECT:
           cerr << "symal: computing intersect alignment\n";
-			while(getals(inp,m,a,n,b)) {
-                          printersect(out,m,a,n,b);
-                          sents++;
-                        }
-                        cerr << "Sents: " << sents << endl;
 			break;
       case GROW:
      cerr << "symal: computing grow alignment: diagonal ("
          << diagonal << ") final ("<< final << ")" 
          <<  "both-uncovered (" << bothuncovered <<")\n"; 
-         
-         while(getals(inp,m,a,n,b)) 
-               printgrow(out,m,a,n,b,diagonal,final,bothuncovered);
-         
          break;
       case TGTTOSRC:
         cerr << "symal: computing target-to-source alignment\n";
-                                     
-         while(getals(inp,m,a,n,b)){ 
-                  printtgttosrc(out,m,a,n,b);
-                  sents++;           
-               }                     
-               cerr << "Sents: " << sents << endl;
           break;                     
       case SRCTOTGT:
         cerr << "symal: computing source-to-target alignment\n";
-         
-         while(getals(inp,m,a,n,b)){
-                  printsrctotgt(out,m,a,n,b);
-                  sents++;
-               }
-               cerr << "Sents: " << sents << endl;
           break;
 		default:
 			exit(1);
 	}
-   
-   delete [] fa; delete [] ea; 
-   for (int i=1;i<=MAX_N;i++) delete [] A[i];
-   delete [] A;
+
+  if (threads<=0)
+    threads=max(1u,thread::hardware_concurrency());
+  if (verbose)
+    cerr << "symal: using " << threads << " threads\n";
+
+  //sentences are aligned in blocks by a pool of workers while the next block
+  //is read, results are buffered per sentence and written in input order
+
+  vector<Sentence> current(BLOCK_SIZE), pending(BLOCK_SIZE);
+  vector<string> results(BLOCK_SIZE);
+  vector<Workspace> workspaces(threads);
+
+  int sents = 0;
+  int count = readblock(inp,current);
+  while (count>0){
+    atomic<int> nextSentence(0);
+    vector<thread> workers;
+    for (int t=0;t<threads;t++)
+      workers.push_back(thread([&,t]() {
+        ostringstream sout;
+        for (int i=nextSentence++;i<count;i=nextSentence++){
+          sout.str("");
+          symmetrize(sout,workspaces[t],current[i],alignment,diagonal,final,bothuncovered);
+          results[i]=sout.str();
+        }
+      }));
+
+    int nextCount=readblock(inp,pending);
+
+    for (size_t t=0;t<workers.size();t++)
+      workers[t].join();
+    for (int i=0;i<count;i++)
+      out << results[i];
+
+    sents+=count;
+    current.swap(pending);
+    count=nextCount;
+  }
+  out.flush();
+  cerr << "Sents: " << sents << endl;
    
    exit(0);
 }
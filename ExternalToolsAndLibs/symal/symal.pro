@@ -28,6 +28,7 @@ HEADERS += \
 SOURCES += \
     src/cmd.c \
     src/symal.cpp
+CONFIG += thread
 
 ################################################################################
 #                       DO NOT CHANGE ANYTHING BELOW                           #
@@ -21,6 +21,8 @@
 ProjectName="TargomanLM"
 VERSION=0.1.0
 
+QT+=concurrent
+
 ProjectDependencies+=TargomanCommon
 
 ################################################################################
@@ -28,6 +28,9 @@
 #include <QString>
 #include <QStringList>
 #include <QVector>
+#include <QFuture>
+#include <QtConcurrent/QtConcurrentMap>
+#include <QtConcurrent/QtConcurrentRun>
 
 #include <fstream>
 #include <sstream>
@@ -49,6 +52,20 @@ TARGOMAN_DEFINE_ENHANCED_ENUM(enuParseState,
                               NGram
                               );
 
+/// Number of n-gram lines parsed and inserted together. Large enough to keep all cores busy and small enough to bound
+/// memory usage
+static const int ARPA_CHUNK_SIZE = 100000;
+
+/**
+ * @brief The stuARPALine struct holds an n-gram line of ARPA file and the n-gram parsed from it.
+ */
+struct stuARPALine{
+    std::string     Text;
+    quint32         LineNo;
+    stuARPANGram    NGram;
+    QString         Error;          /**< Loading fails with this message */
+};
+
 ARPAManager* ARPAManager::Instance = NULL;
 
 ARPAManager::ARPAManager()
@@ -57,6 +74,10 @@ ARPAManager::ARPAManager()
 /**
  * @brief Loads     language model _file to _model.
  *
+ * File is read on the calling thread in chunks of n-gram lines. Each chunk is parsed and inserted to the model by all
+ * cores while the next chunk is being read. Chunks are inserted one after another so all unigrams are inserted before
+ * any higher order n-gram.
+ *
  * This is a sample of a ARPA language model:
  *
  * # Language models start with this tag.
@@ -113,17 +134,53 @@ quint8 ARPAManager::load(const QString &_file, intfBaseModel& _model, bool _just
 
     quint8        NGramOrder = 0, MaxGram = 0;
     quint32       LineNo = 0, Count = 0;
-    float         Prob, Backoff;
     bool          IsOK;
     enuParseState::Type ParseState = enuParseState::Looking4Start;
     QVector<quint32> NGramCounts;
-    size_t Dummy;
-    size_t Pos;
 
-    const char* StartOfNGram, *EndOfNGram, *StartOfBackoff;
     Common::clsCmdProgressBar ProgressBar;
     bool UnkExists = false;
 
+    QVector<stuARPALine> Chunk;
+    QVector<stuARPALine> InsertingChunk;
+    QFuture<QString>     Insertion;
+    bool                 InsertionPending = false;
+
+    // Chunk being inserted must outlive its insertion task even if loading fails
+    struct stuInsertionGuard{
+        QFuture<QString>&   Insertion;
+        bool&               Pending;
+        ~stuInsertionGuard(){
+            if (this->Pending)
+                this->Insertion.waitForFinished();
+        }
+    } InsertionGuard = {Insertion, InsertionPending};
+
+    auto waitForInsertion = [&] () {
+        if (InsertionPending == false)
+            return;
+        Insertion.waitForFinished();
+        InsertionPending = false;
+        InsertingChunk.clear();
+        if (Insertion.result().size())
+            throw exARPAManager(Insertion.result());
+    };
+
+    // Chunk is handed to the global thread pool and reading continues while it is being inserted. Previous chunk
+    // must be inserted completely before next one is started.
+    auto queueChunk = [&] () {
+        waitForInsertion();
+        if (Chunk.isEmpty())
+            return;
+        InsertingChunk.swap(Chunk);
+        Chunk.reserve(ARPA_CHUNK_SIZE);
+        quint8 ChunkOrder = NGramOrder;
+        Insertion = QtConcurrent::run([&InsertingChunk, &_model, &UnkExists, ChunkOrder] () {
+            return ARPAManager::insertChunk(InsertingChunk, ChunkOrder, _model, UnkExists);
+        });
+        InsertionPending = true;
+    };
+
     while (std::getline(File, LineString)) {
         ++LineNo;
 
@@ -186,6 +243,7 @@ quint8 ARPAManager::load(const QString &_file, intfBaseModel& _model, bool _just
                     ProgressBar.reset("Loading 1-Gram Items",NGramCounts.value(1));
                 ParseState = enuParseState::NGram;
                 Count = 0;
+                Chunk.reserve(ARPA_CHUNK_SIZE);
 
             }else
                 throw exARPAManager(QString("Invalid Identifier at line: %1").arg(LineNo));
@@ -194,11 +252,14 @@ quint8 ARPAManager::load(const QString &_file, intfBaseModel& _model, bool _just
         case enuParseState::NGram:
             if (LineString.at(0) == '\\'){
                 QString Line = QString::fromStdString(LineString);
+                queueChunk();
                 if (Line.endsWith("-grams:")){
                     if (Count < NGramCounts.value(NGramOrder))
                         throw exARPAManager(QString("There are less Items specified for Ngram=%1 than specified: %2").arg(
                                                 NGramOrder).arg(NGramCounts.value(NGramOrder)));
 
+                    // N-grams of next order are parsed using vocabulary of the model
+                    waitForInsertion();
                     NGramOrder = Line.split("-").first().remove(0,1).toInt(&IsOK);
                     if (!IsOK || NGramOrder < 2)
                         throw exARPAManager(QString("Invalid ARPA file as invalid gram section is found at line: %1").arg(LineNo));
@@ -211,6 +272,7 @@ quint8 ARPAManager::load(const QString &_file, intfBaseModel& _model, bool _just
                     }else
                         ProgressBar.reset(QString("Loading %1-Gram Items").arg(NGramOrder),NGramCounts.value(NGramOrder));
                 }else if (Line == "\\end\\"){
+                    waitForInsertion();
                     if (Count < NGramCounts.value(NGramOrder))
                         throw exARPAManager(QString("There are less Items specified for Ngram=%1 than specified: %2").arg(
                                                 NGramOrder).arg(NGramCounts.value(NGramOrder)));
@@ -230,39 +292,13 @@ quint8 ARPAManager::load(const QString &_file, intfBaseModel& _model, bool _just
                 if (Count > NGramCounts.value(NGramOrder))
                     throw exARPAManager(QString("There are more Items specified for Ngram=%1 than specified: %2 vs %3").arg(
                                             NGramOrder).arg(Count).arg(NGramCounts.value(NGramOrder)));
-                Prob = Common::fastASCII2Float(LineString.c_str(), Pos);
-                if (Prob > 0)
-                    throw exARPAManager(QString("Invalid positive probaility at line : %1").arg(LineNo));
-
-                EndOfNGram = LineString.c_str() + Pos;
-                Common::fastSkip2NonSpace(EndOfNGram);
-                StartOfNGram = EndOfNGram;
-                if (!*EndOfNGram)
-                    throw exARPAManager(QString("Invalid count of Tokens 1 vs 0"));
-                Common::fastSkip2Space(EndOfNGram);
-                for (int i=1; i<NGramOrder; ++i){
-                    Common::fastSkip2NonSpace(++EndOfNGram);
-                    if (!*EndOfNGram)
-                        throw exARPAManager(QString("Invalid count of Tokens %1 vs %2 at line: %3").arg(
-                                                i).arg(
-                                                NGramOrder).arg(
-                                                LineNo));
-                    Common::fastSkip2Space(EndOfNGram);
-                }
-                *((char*)EndOfNGram) = '\0';
 
-                if (EndOfNGram - LineString.c_str() < (qint64)LineString.size()){
-                    StartOfBackoff = EndOfNGram+1;
-                    Common::fastSkip2NonSpace(StartOfBackoff);
-                    Backoff = Common::fastASCII2Float(StartOfBackoff, Dummy);
-                }else
-                    Backoff = 0;
-                if (Prob >=0)
-                    throw exARPAManager(QString("Invalid Positive backoff at line: %1").arg(LineNo));
+                Chunk.append(stuARPALine());
+                Chunk.last().Text.swap(LineString);
+                Chunk.last().LineNo = LineNo;
+                if (Chunk.size() == ARPA_CHUNK_SIZE)
+                    queueChunk();
 
-                _model.insert(StartOfNGram, NGramOrder, Prob, Backoff);
-                if(NGramOrder == 1 && strcmp(StartOfNGram, LM_UNKNOWN_WORD) == 0)
-                    UnkExists = true;
                 ++Count;
                 ProgressBar.setValue(Count);
             }
@@ -271,6 +307,8 @@ quint8 ARPAManager::load(const QString &_file, intfBaseModel& _model, bool _just
         }
     }
 
+    queueChunk();
+    waitForInsertion();
 
     if (Count < NGramCounts.value(NGramOrder))
         throw exARPAManager(QString("There are less Items specified for Ngram=%1 than specified: %2").arg(
@@ -285,6 +323,91 @@ quint8 ARPAManager::load(const QString &_file, intfBaseModel& _model, bool _just
     return MaxGram;
 }
 
+/**
+ * @brief Parses an n-gram line in place. N-gram string is null terminated inside the line.
+ * @note It is called by multiple threads for lines of the same chunk so it must not modify anything but its input.
+ */
+void ARPAManager::parseNGramLine(stuARPALine &_line, quint8 _order)
+{
+    size_t Dummy;
+    size_t Pos;
+    const char* StartOfNGram, *EndOfNGram, *StartOfBackoff;
+    const char* LineStr = _line.Text.c_str();
+
+    _line.NGram.Prob = Common::fastASCII2Float(LineStr, Pos);
+    if (_line.NGram.Prob > 0){
+        _line.Error = QString("Invalid positive probaility at line : %1").arg(_line.LineNo);
+        return;
+    }
+
+    EndOfNGram = LineStr + Pos;
+    Common::fastSkip2NonSpace(EndOfNGram);
+    StartOfNGram = EndOfNGram;
+    if (!*EndOfNGram){
+        _line.Error = QString("Invalid count of Tokens 1 vs 0");
+        return;
+    }
+    Common::fastSkip2Space(EndOfNGram);
+    for (int i=1; i<_order; ++i){
+        Common::fastSkip2NonSpace(++EndOfNGram);
+        if (!*EndOfNGram){
+            _line.Error = QString("Invalid count of Tokens %1 vs %2 at line: %3").arg(
+                              i).arg(
+                              _order).arg(
+                              _line.LineNo);
+            return;
+        }
+        Common::fastSkip2Space(EndOfNGram);
+    }
+    bool HasBackoff = EndOfNGram - LineStr < (qint64)_line.Text.size();
+    *((char*)EndOfNGram) = '\0';
+
+    if (HasBackoff){
+        StartOfBackoff = EndOfNGram+1;
+        Common::fastSkip2NonSpace(StartOfBackoff);
+        _line.NGram.Backoff = Common::fastASCII2Float(StartOfBackoff, Dummy);
+    }else
+        _line.NGram.Backoff = 0;
+    if (_line.NGram.Prob >=0){
+        _line.Error = QString("Invalid Positive backoff at line: %1").arg(_line.LineNo);
+        return;
+    }
+
+    _line.NGram.NGram = StartOfNGram;
+}
+
+/**
+ * @brief Parses lines of a chunk in parallel and inserts them to the model.
+ * @param[out] _unkExists   will be set if chunk contains unknown word unigram
+ * @return error message or an empty string if all of the n-grams were inserted
+ */
+QString ARPAManager::insertChunk(QVector<stuARPALine> &_chunk, quint8 _order, intfBaseModel &_model, bool& _unkExists)
+{
+    try{
+        QtConcurrent::blockingMap(_chunk, [_order] (stuARPALine& _line) {
+            ARPAManager::parseNGramLine(_line, _order);
+        });
+
+        QVector<stuARPANGram> NGrams;
+        NGrams.reserve(_chunk.size());
+        for (int i = 0; i < _chunk.size(); ++i){
+            const stuARPALine& Line = _chunk.at(i);
+            if (Line.Error.size())
+                return Line.Error;
+            if(_order == 1 && strcmp(Line.NGram.NGram, LM_UNKNOWN_WORD) == 0)
+                _unkExists = true;
+            NGrams.append(Line.NGram);
+        }
+
+        _model.insertBatch(NGrams, _order);
+    }catch(Common::exTargomanBase& e){
+        return QString::fromUtf8(e.what());
+    }catch(std::exception& e){
+        return QString::fromUtf8(e.what());
+    }
+    return QString();
+}
+
 
 }
 }
@@ -36,6 +36,8 @@ namespace Private {
 
 TARGOMAN_ADD_EXCEPTION_HANDLER(exARPAManager, exLanguageModel);
 
+struct stuARPALine;
+
 /**
  * @brief Main functionality of this class is for loading language model ARPA files.
  */
@@ -50,6 +52,9 @@ private:
     ARPAManager();
     Q_DISABLE_COPY(ARPAManager)
 
+    static void parseNGramLine(stuARPALine& _line, quint8 _order);
+    static QString insertChunk(QVector<stuARPALine>& _chunk, quint8 _order, intfBaseModel& _model, bool& _unkExists);
+
 private:
     static ARPAManager* Instance; /**< A static pointer member of this class.*/
 };
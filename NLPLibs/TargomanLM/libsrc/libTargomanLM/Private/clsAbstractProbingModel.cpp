@@ -25,6 +25,7 @@
  */
 
 #include <stdlib.h>
+#include <QtConcurrent/QtConcurrentMap>
 #include "libTargomanCommon/Constants.h"
 #include "libTargomanCommon/HashFunctions.hpp"
 #include "libTargomanCommon/FastOperations.hpp"
@@ -131,6 +132,191 @@ void clsAbstractProbingModel::insert(const char* _ngram, quint8 _order, LogP_t _
                                  stuProbAndBackoffWeights(this->RemainingHashes.size() + this->HashTableSize, _prob,_backoff));
 }
 
+/**
+ * @brief Inserts a batch of n-grams of the same order in parallel.
+ *
+ * Keys of all n-grams are prepared before any of them is inserted as index based models look up unigrams in
+ * #NGramHashTable to prepare keys. Then n-grams are inserted one hash level at a time: all of the n-grams not yet
+ * stored probe their cell of the level concurrently, occupied cells get their continue flag and an empty cell is given
+ * to the n-gram which comes first in input among those probing it. So placement of n-grams, and hence the model, does
+ * not depend on number of threads or their timing. N-grams which find no place are added to #RemainingHashes and
+ * statistics and vocabulary are updated afterwards in input order.
+ *
+ * @note Unigrams must be inserted in batches prior to any other order as in insert().
+ * @param _ngrams   n-grams of the same order
+ * @param _order    order of n-grams
+ */
+void clsAbstractProbingModel::insertBatch(const QVector<stuARPANGram> &_ngrams, quint8 _order)
+{
+    QVector<stuNGramInsertion> Insertions(_ngrams.size());
+    for (int i = 0; i < _ngrams.size(); ++i){
+        Insertions[i].NGram = &_ngrams.at(i);
+        // Low byte is kept free for continue flag which may be set while cell is reserved
+        Insertions[i].Reservation = static_cast<quint64>(i + 1) << 8;
+    }
+
+    QtConcurrent::blockingMap(Insertions, [this, _order] (stuNGramInsertion& _insertion) {
+        _insertion.Key = this->prepareKey(_insertion.NGram->NGram, _order, _insertion.Error);
+        _insertion.Location = (_insertion.Key.hash(0) % this->HashTableSize) + 1;
+    });
+    foreach(const stuNGramInsertion& Insertion, Insertions)
+        if (Insertion.Error.size())
+            throw exLanguageModel(Insertion.Error);
+
+    QVector<stuNGramInsertion*> Pending;
+    Pending.reserve(Insertions.size());
+    for (int i = 0; i < Insertions.size(); ++i){
+        stuNGramInsertion& Insertion = Insertions[i];
+        if (_order == 1 && Insertion.Key.String == LM_UNKNOWN_WORD){
+            this->setUnknownWordDefaults(Insertion.NGram->Prob, Insertion.NGram->Backoff);
+            this->NGramHashTable[LM_UNKNOWN_WINDEX].Prob      = Insertion.NGram->Prob;
+            this->NGramHashTable[LM_UNKNOWN_WINDEX].Backoff   = Insertion.NGram->Backoff;
+        }else
+            Pending.append(&Insertion);
+    }
+
+    for (quint8 HashLevel = 1; HashLevel < MAX_HASH_LEVEL && Pending.size(); ++HashLevel){
+        // Probes cells without storing anything but continue flags so all n-grams see the same occupied cells
+        QtConcurrent::blockingMap(Pending, [this, HashLevel] (stuNGramInsertion* _insertion) {
+            Hash_t HashValue = _insertion->Key.hash(HashLevel);
+            _insertion->HashValueLevel = this->getHashValue(HashValue) + HashLevel-1 +
+                    (_insertion->Key.isMultiIndex() ? 0x80 : 0);
+            _insertion->NextLocation = (HashValue % this->HashTableSize) + 1;
+
+            stuNGramHash& Cell = this->NGramHashTable[_insertion->Location];
+            quint64 Occupant = Cell.atomicHashValueLevel().loadAcquire();
+            _insertion->Claiming = (Occupant == 0);
+            if (_insertion->Claiming)
+                return;
+            if ((Occupant & HASHVALUE_CONTAINER) == this->getHashValue(HashValue) &&
+                    (Occupant & 0x3F) == HashLevel-1u)
+                _insertion->Error = QString("Fatal Collision found on: %1 (%2, %3, %4)").arg(
+                                        _insertion->Key.remainingHashesKey()).arg(
+                                        _insertion->Location).arg(
+                                        Occupant & HASHVALUE_CONTAINER).arg(
+                                        HashLevel);
+            else
+                Cell.atomicHashValueLevel().fetchAndOrOrdered(0x40);
+        });
+
+        // Each empty cell is reserved for the first n-gram in input which has probed it
+        QtConcurrent::blockingMap(Pending, [this] (stuNGramInsertion* _insertion) {
+            if (_insertion->Claiming == false)
+                return;
+            QAtomicInteger<quint64>& Cell = this->NGramHashTable[_insertion->Location].atomicHashValueLevel();
+            while (true){
+                quint64 Reserved = Cell.loadAcquire();
+                if ((Reserved && Reserved <= _insertion->Reservation) ||
+                        Cell.testAndSetOrdered(Reserved, _insertion->Reservation))
+                    break;
+            }
+        });
+
+        // Losers find out the winner before it replaces its reservation and check for collision with it
+        QtConcurrent::blockingMap(Pending, [this, &Insertions, HashLevel] (stuNGramInsertion* _insertion) {
+            if (_insertion->Claiming == false)
+                return;
+            quint64 Reserved = this->NGramHashTable[_insertion->Location].atomicHashValueLevel().loadAcquire();
+            if (Reserved == _insertion->Reservation)
+                return;
+            _insertion->Claiming = false;
+            const stuNGramInsertion& Winner = Insertions.at(static_cast<int>(Reserved >> 8) - 1);
+            if ((Winner.HashValueLevel & HASHVALUE_CONTAINER) == (_insertion->HashValueLevel & HASHVALUE_CONTAINER))
+                _insertion->Error = QString("Fatal Collision found on: %1 (%2, %3, %4)").arg(
+                                        _insertion->Key.remainingHashesKey()).arg(
+                                        _insertion->Location).arg(
+                                        Winner.HashValueLevel & HASHVALUE_CONTAINER).arg(
+                                        HashLevel);
+        });
+
+        QtConcurrent::blockingMap(Pending, [this, HashLevel] (stuNGramInsertion* _insertion) {
+            if (_insertion->Error.size())
+                return;
+            stuNGramHash& Cell = this->NGramHashTable[_insertion->Location];
+            if (_insertion->Claiming == false){
+                Cell.atomicHashValueLevel().fetchAndOrOrdered(0x40);
+                _insertion->Location = _insertion->NextLocation;
+                return;
+            }
+            Cell.Prob      = _insertion->NGram->Prob;
+            Cell.Backoff   = _insertion->NGram->Backoff;
+            while (true){
+                quint64 Reserved = Cell.atomicHashValueLevel().loadAcquire();
+                if (Cell.atomicHashValueLevel().testAndSetOrdered(
+                        Reserved, _insertion->HashValueLevel | (Reserved & 0x40)))
+                    break;
+            }
+            _insertion->Level = HashLevel;
+        });
+
+        int Remaining = 0;
+        foreach(stuNGramInsertion* Insertion, Pending)
+            if (Insertion->Level == 0 && Insertion->Error.isEmpty())
+                Pending[Remaining++] = Insertion;
+        Pending.resize(Remaining);
+    }
+
+    foreach(const stuNGramInsertion& Insertion, Insertions)
+        if (Insertion.Error.size())
+            throw exLanguageModel(Insertion.Error);
+
+    foreach(const stuNGramInsertion* Insertion, Pending)
+        this->RemainingHashes.insert(Insertion->Key.remainingHashesKey(),
+                                     stuProbAndBackoffWeights(this->RemainingHashes.size() + this->HashTableSize,
+                                                              Insertion->NGram->Prob,
+                                                              Insertion->NGram->Backoff));
+
+    foreach(const stuNGramInsertion& Insertion, Insertions){
+        if (Insertion.Level == 0)
+            continue;
+        this->MaxLevel = qMax(this->MaxLevel, Insertion.Level);
+        this->SumLevels += Insertion.Level;
+        ++this->StoredInHashTable;
+        if (_order == 1)
+            this->Vocab.insert(Insertion.Location, QString::fromUtf8(Insertion.NGram->NGram));
+    }
+}
+
+/**
+ * @brief Prepares key of an n-gram to be inserted by insertBatch(). String based models use n-gram string as key.
+ * @note It is called by multiple threads so it must not modify anything but its output.
+ * @param[out] _error   will be filled if key can not be prepared
+ */
+clsAbstractProbingModel::stuNGramKey clsAbstractProbingModel::prepareKey(const char *_ngram,
+                                                                         quint8 _order,
+                                                                         QString &_error) const
+{
+    Q_UNUSED(_order)
+    Q_UNUSED(_error)
+    stuNGramKey Key;
+    Key.String = QByteArray(_ngram);
+    return Key;
+}
+
+/**
+ * @brief Computes the same hash values as insert() methods of string based and index based models.
+ */
+Hash_t clsAbstractProbingModel::stuNGramKey::hash(int _level) const
+{
+    if (this->isMultiIndex())
+        return HashFunctions::murmurHash64(this->Indexes, _level);
+    return HashFunctions::murmurHash64(this->String.constData(), this->String.size(), _level);
+}
+
+/**
+ * @brief Key of n-gram in #RemainingHashes which is the same as keys used by insert() methods.
+ */
+QString clsAbstractProbingModel::stuNGramKey::remainingHashesKey() const
+{
+    if (this->isMultiIndex() == false)
+        return QString::fromUtf8(this->String);
+
+    QString NGramStr;
+    foreach (WordIndex_t WIndex, this->Indexes)
+        NGramStr+=QString::number(WIndex) + " ";
+    return NGramStr.trimmed();
+}
+
 /**
  * @brief Initializes and allocates sufficient space for Hash table based on maximum oredr of NGram.
  * @param _maxNGramCount maximum order of NGram.
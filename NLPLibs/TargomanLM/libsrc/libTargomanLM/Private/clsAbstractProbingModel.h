@@ -32,6 +32,7 @@
 #include "../Definitions.h"
 
 #include <QHash>
+#include <QAtomicInteger>
 
 namespace Targoman {
 namespace NLPLibs {
@@ -82,10 +83,53 @@ protected:
         /** @brief Sets continue flag of cell in #HashValueLevel. */
         inline void    setMultiIndex(){ this->HashValueLevel |= 0x80; }
 
+        /** @brief Atomic view of #HashValueLevel which is used while n-grams are inserted concurrently. */
+        inline QAtomicInteger<quint64>& atomicHashValueLevel(){
+            return *reinterpret_cast<QAtomicInteger<quint64>*>(&this->HashValueLevel);
+        }
+
         stuNGramHash(){
             this->HashValueLevel = 0;
         }
     };
+
+    /**
+     * @struct Key of an n-gram which is hashed to find its place in #NGramHashTable. String based n-grams are hashed
+     * as they are and index based n-grams are hashed as list of their word indexes.
+     */
+    struct stuNGramKey{
+        QByteArray                  String;
+        QList<Common::WordIndex_t>  Indexes;
+
+        inline bool isMultiIndex() const { return this->Indexes.size(); }
+        Hash_t hash(int _level) const;
+        QString remainingHashesKey() const;
+    };
+
+    /**
+     * @struct State of an n-gram during concurrent insertion.
+     */
+    struct stuNGramInsertion{
+        const stuARPANGram*     NGram;
+        stuNGramKey             Key;
+        quint64                 Reservation;    /**< Claim on an empty cell, lower values are earlier in input */
+        Hash_t                  Location;       /**< Cell of #NGramHashTable being probed and finally where n-gram is stored */
+        Hash_t                  NextLocation;   /**< Cell to be probed on next hash level */
+        quint64                 HashValueLevel; /**< Value of #stuNGramHash::HashValueLevel on current hash level */
+        quint8                  Level;          /**< Hash level used to store n-gram, zero if not stored in #NGramHashTable */
+        bool                    Claiming;       /**< Probed cell is empty and n-gram competes to store there */
+        QString                 Error;
+
+        stuNGramInsertion() :
+            NGram(NULL),
+            Reservation(0),
+            Location(0),
+            NextLocation(0),
+            HashValueLevel(0),
+            Level(0),
+            Claiming(false)
+        {}
+    };
 protected:
     inline Hash_t getHashValue(Hash_t _hash) const{
         return Q_LIKELY(_hash & HASHVALUE_CONTAINER) ? (_hash & HASHVALUE_CONTAINER) : HASHVALUE_CONTAINER;
@@ -97,6 +141,7 @@ public:
 
     void setUnknownWordDefaults(Targoman::Common::LogP_t _prob, Targoman::Common::LogP_t _backoff);
     virtual void insert(const char *_ngram, quint8 _order, Common::LogP_t _prob, Common::LogP_t _backoff = 0);
+    void insertBatch(const QVector<stuARPANGram>& _ngrams, quint8 _order);
     void init(quint32 _maxNGramCount);
     inline quint64 getID(const char *_word) const {
         return this->getNGramWeights(_word).ID;
@@ -127,6 +172,7 @@ public:
 
 protected:
     stuProbAndBackoffWeights getNGramWeights(const char* _ngram, bool _justSingle = false) const;
+    virtual stuNGramKey prepareKey(const char* _ngram, quint8 _order, QString& _error) const;
 
 protected:
     quint32                     HashTableSize;                  /**< Size of hash table. */
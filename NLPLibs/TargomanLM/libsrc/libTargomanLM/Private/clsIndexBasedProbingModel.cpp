@@ -75,6 +75,36 @@ void clsIndexBasedProbingModel::insert(const char* _ngram, quint8 _order, LogP_t
     }
 }
 
+/**
+ * @brief Prepares key of an n-gram to be inserted by insertBatch(). Unigrams are keyed by their string and higher
+ * order n-grams by word indexes of their words, the same as insert().
+ * @note It is called by multiple threads so it must not modify anything but its output.
+ * @param[out] _error   will be filled if any of the words is not found in vocab
+ */
+clsAbstractProbingModel::stuNGramKey clsIndexBasedProbingModel::prepareKey(const char *_ngram,
+                                                                           quint8 _order,
+                                                                           QString &_error) const
+{
+    if (_order == 1)
+        return clsAbstractProbingModel::prepareKey(_ngram, _order, _error);
+
+    stuNGramKey Key;
+    const char* NGramStrBegin = _ngram;
+    while(*NGramStrBegin){
+        const char* NGramStrEnd = NGramStrBegin;
+        Common::fastSkip2Space(NGramStrEnd);
+        QByteArray Word(NGramStrBegin, NGramStrEnd - NGramStrBegin);
+        WordIndex_t WordIndex = this->getID(Word.constData());
+        if (WordIndex == 0 && Word != LM_UNKNOWN_WORD){
+            _error = QString::fromUtf8(Word) + " Not Found in vocab";
+            return Key;
+        }
+        Key.Indexes.append(WordIndex);
+        NGramStrBegin = Common::fastSkip2NonSpace(NGramStrEnd);
+    }
+    return Key;
+}
+
 /**
  * @brief returns probablity of input NGram and maximum order of founded NGram.
  *
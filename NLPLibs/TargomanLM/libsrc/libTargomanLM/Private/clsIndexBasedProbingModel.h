@@ -47,6 +47,9 @@ public:
     Targoman::Common::LogP_t lookupNGram(const QStringList &_ngram, quint8& _foundedGram) const;
     inline QString modelHeaderSuffix() {return "-Probing-v1.0-IndexBased";}
 
+protected:
+    stuNGramKey prepareKey(const char* _ngram, quint8 _order, QString& _error) const;
+
 private:
     void insert(QList<Common::WordIndex_t> _ngram, Common::LogP_t _prob, Common::LogP_t _backoff);
     stuProbAndBackoffWeights getNGramWeights(QList<Common::WordIndex_t> _ngram) const;
@@ -27,6 +27,7 @@
 #ifndef TARGOMAN_NLPLIBS_LANGUAGEMODEL_PRIVATE_INTFBASEMODEL_HPP
 #define TARGOMAN_NLPLIBS_LANGUAGEMODEL_PRIVATE_INTFBASEMODEL_HPP
 
+#include <QVector>
 #include "../Definitions.h"
 
 namespace Targoman {
@@ -34,6 +35,15 @@ namespace NLPLibs {
 namespace TargomanLM {
 namespace Private {
 
+/**
+ * @brief An n-gram parsed from an ARPA file. NGram is a null terminated string owned by the ARPA loader.
+ */
+struct stuARPANGram{
+    const char*                 NGram;
+    Targoman::Common::LogP_t    Prob;
+    Targoman::Common::LogP_t    Backoff;
+};
+
 class intfBaseModel
 {
 public:
@@ -43,6 +53,14 @@ public:
     virtual void init(quint32 _maxNGramCount) = 0;
     virtual void setUnknownWordDefaults(Targoman::Common::LogP_t _prob, Targoman::Common::LogP_t _backoff)=0;
     virtual void insert(const char* _ngram, quint8 _order, float _prob, float _backoff) = 0;
+    /**
+     * @brief Inserts a batch of n-grams of the same order. Models which can insert n-grams concurrently override this
+     * method, default implementation inserts them one by one.
+     */
+    virtual void insertBatch(const QVector<stuARPANGram>& _ngrams, quint8 _order){
+        foreach(const stuARPANGram& NGram, _ngrams)
+            this->insert(NGram.NGram, _order, NGram.Prob, NGram.Backoff);
+    }
     virtual Targoman::Common::LogP_t lookupNGram(const QStringList &_ngram, quint8& _foundedGram) const = 0;
     virtual Targoman::Common::LogP_t lookupNGram(const QList<Common::WordIndex_t> &_ngram, quint8& _foundedGram) const = 0;
     virtual QString getStatsStr() const = 0;
@@ -24,6 +24,7 @@
  * @author Saeed Torabzadeh <saeed.torabzadeh@targoman.com>
  */
 
+#include <cstring>
 #include "clsLMSentenceScorer.h"
 #include "Private/clsLMSentenceScorer_p.h"
 
@@ -126,6 +127,44 @@ void clsLMSentenceScorer::initHistory(const clsLMSentenceScorer &_oldScorer)
 {
     this->pPrivate->StringBasedHistory = _oldScorer.pPrivate->StringBasedHistory;
     this->pPrivate->IndexBasedHistory = _oldScorer.pPrivate->IndexBasedHistory;
+    this->pPrivate->FoundedGram = _oldScorer.pPrivate->FoundedGram;
+}
+
+/**
+ * @brief Size of history snapshot: founded gram, number of stored words and at most order - 1 word indices.
+ */
+size_t clsLMSentenceScorer::historySize() const
+{
+    return 2 + (this->pPrivate->LM.order() - 1) * sizeof(WordIndex_t);
+}
+
+/**
+ * @brief Writes index based history to a buffer of historySize() bytes. String based history is not kept.
+ */
+void clsLMSentenceScorer::saveHistory(char* _buffer) const
+{
+    const QList<WordIndex_t>& History = this->pPrivate->IndexBasedHistory;
+    quint8 Count = qMin(History.size(), this->pPrivate->LM.order() - 1);
+    _buffer[0] = this->pPrivate->FoundedGram;
+    _buffer[1] = Count;
+    for (int i = 0; i < Count; ++i)
+        memcpy(_buffer + 2 + i * sizeof(WordIndex_t), &History.at(History.size() - Count + i), sizeof(WordIndex_t));
+}
+
+/**
+ * @brief Replaces history with a snapshot written by saveHistory.
+ */
+void clsLMSentenceScorer::restoreHistory(const char* _buffer)
+{
+    this->pPrivate->StringBasedHistory.clear();
+    this->pPrivate->IndexBasedHistory.clear();
+    this->pPrivate->FoundedGram = (quint8)_buffer[0];
+    quint8 Count = (quint8)_buffer[1];
+    for (int i = 0; i < Count; ++i){
+        WordIndex_t WordIndex;
+        memcpy(&WordIndex, _buffer + 2 + i * sizeof(WordIndex_t), sizeof(WordIndex_t));
+        this->pPrivate->IndexBasedHistory.append(WordIndex);
+    }
 }
 
 /**
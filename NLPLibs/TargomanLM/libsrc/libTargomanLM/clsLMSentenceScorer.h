@@ -54,6 +54,9 @@ public:
     Common::LogP_t endOfSentenceProb(quint8 &_foundedGram);
     Common::WordIndex_t wordIndex(const QString& _word);
     void initHistory(const clsLMSentenceScorer& _oldScorer);
+    size_t historySize() const;
+    void saveHistory(char* _buffer) const;
+    void restoreHistory(const char* _buffer);
     bool haveSameHistoryAs(const clsLMSentenceScorer& _oldScorer);
 
 private:
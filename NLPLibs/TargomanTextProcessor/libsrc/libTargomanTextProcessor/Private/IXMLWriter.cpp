@@ -32,7 +32,10 @@ namespace NLPLibs {
 namespace TargomanTP{
 namespace Private {
 
+using namespace Common;
+
 #define TGMN_SUFFIXES "t|ll|ve|s|m|re|d" //these terms can come after apostrofe
+#define TGMN_MAX_TOKEN_SKIP 64 //maximum characters to look ahead for tokens changed after normalization
 
 IXMLWriter::IXMLWriter() :
     NormalizerInstance(Normalizer::instance()),
@@ -73,6 +76,8 @@ void IXMLWriter::init(const QString &_configFile)
  * @param _lineNo line number
  * @param _interactive argument of spellCorrector and normalizer. can SpellCorrector or Normalizer class be done interactively or not.
  * @param _useSpellCorrector use spell corrector or not.
+ * @param _tokenSpans if provided will be filled with span of each output token in the input string. Invalid spans
+ * are used for tokens which can not be located in the input.
  * @return returns converted ixml text.
  */
 
@@ -81,7 +86,8 @@ QString IXMLWriter::convert2IXML(const QString &_inStr,
                                  const QString& _lang,
                                  quint32 _lineNo,
                                  bool _interactive,
-                                 bool _useSpellCorrector)
+                                 bool _useSpellCorrector,
+                                 QList<stuPos>* _tokenSpans)
 {
     // Email detection
     thread_local static QRegExp RxEmail = QRegExp("([A-Za-z0-9._%+-][A-Za-z0-9._%+-]*@[A-Za-z0-9.-][A-Za-z0-9.-]*\\.[A-Za-z]{2,4})");
@@ -166,6 +172,9 @@ QString IXMLWriter::convert2IXML(const QString &_inStr,
     thread_local static QRegExp RxPersianNumber = QRegExp(QStringLiteral("([\u0600-\u06ff])(\\d+)"));
 
 
+    if (_tokenSpans)
+        _tokenSpans->clear();
+
     if(_inStr.trimmed().isEmpty())
         return "";
     QString InputPhrase, OutputPhrase;
@@ -177,16 +186,21 @@ QString IXMLWriter::convert2IXML(const QString &_inStr,
     OutputPhrase.clear();
     OutputPhrase.append(" "); // prepend a space before string.
 
-    //normalize input text.
+    //normalize input text. Normalizer works char by char so offset of each normalized char is kept if requested
+    QVector<qint32> NormalizedOffsets;
     for (int i=0; i<InputPhrase.size(); i++){
-        OutputPhrase.append(this->NormalizerInstance.normalize(
+        QString NormalizedChar = this->NormalizerInstance.normalize(
                     InputPhrase.at(i),
                     ((i + 1) < InputPhrase.size() ? InputPhrase.at(i+1) : QChar('\n')),
                     _interactive,
                     _lineNo,
                     InputPhrase,
-                    i));
+                    i);
+        OutputPhrase.append(NormalizedChar);
+        if (_tokenSpans)
+            NormalizedOffsets.insert(NormalizedOffsets.size(), NormalizedChar.size(), i);
     }
+    QString NormalizedPhrase = _tokenSpans ? OutputPhrase.mid(1) : QString();
     OutputPhrase+=" ."; //append a space and a dot to the end of string for some bug fixings.
 
     QStringList LstURL;             //list of found URLs
@@ -350,6 +364,9 @@ QString IXMLWriter::convert2IXML(const QString &_inStr,
     OutputPhrase = this->NormalizerInstance.fullTrim(OutputPhrase.replace("  "," ").replace("  "," "));
     TargomanDebug(7,"[ALL-TAGS] |"<<OutputPhrase<<"|");
 
+    if (_tokenSpans)
+        *_tokenSpans = this->locateTokens(OutputPhrase, NormalizedPhrase, NormalizedOffsets);
+
     return OutputPhrase;
 }
 
@@ -358,6 +375,90 @@ QString IXMLWriter::supportedSuffixes() const
     return TGMN_SUFFIXES;
 }
 
+/**
+ * @brief Matches surface form of an output token against normalized text starting at _pos. Escaped XML chars and
+ * multi-dots are matched against their original form, zero width non-joiners removed by trimming are skipped and a zero
+ * width non-joiner of the output matches spaces of normalized text as spell corrector joins words with it.
+ * @return end position of the match in normalized text or -1 if surface does not match.
+ */
+static int matchSurface(const QString& _normalized, int _pos, const QString& _surface)
+{
+    for (int i = 0; i < _surface.size(); ++i){
+        const QChar& Char = _surface.at(i);
+        while (_pos < _normalized.size() && _normalized.at(_pos) == ARABIC_ZWNJ && Char != ARABIC_ZWNJ)
+            ++_pos;
+        if (_pos >= _normalized.size())
+            return -1;
+
+        QString Escaped = Char == '<' ? "&lt;" : Char == '>' ? "&gt;" : Char == '&' ? "&amp;" : QString();
+        if (Escaped.size() && _normalized.midRef(_pos).startsWith(Escaped)){
+            _pos += Escaped.size();
+        }else if (_normalized.at(_pos) == Char){
+            ++_pos;
+        }else if (Char == ARABIC_ZWNJ && _normalized.at(_pos).isSpace()){
+            while (_pos < _normalized.size() && (_normalized.at(_pos).isSpace() || _normalized.at(_pos) == ARABIC_ZWNJ))
+                ++_pos;
+        }else if (Char == MULTI_DOT.at(0) && _normalized.at(_pos) == '.'){
+            while (_pos < _normalized.size() && _normalized.at(_pos) == '.')
+                ++_pos;
+        }else
+            return -1;
+    }
+    return _pos;
+}
+
+/**
+ * @brief Locates each token of the final ixml in the normalized text and maps it back to input characters. As all
+ * the steps after normalization just insert spaces or replace a text with its tagged form, tokens are located with
+ * a single forward scan. Tokens which do not match at the scan position, e.g. those modified by spell corrector, are
+ * searched for in a short window and if not found there are given an invalid span rather than a guessed one.
+ * @param _ixml final ixml text
+ * @param _normalized normalized input text
+ * @param _normalizedOffsets offset of each char of normalized text in the input text
+ * @return span of each ixml token in the input text
+ */
+QList<stuPos> IXMLWriter::locateTokens(const QString &_ixml,
+                                       const QString &_normalized,
+                                       const QVector<qint32> &_normalizedOffsets) const
+{
+    QList<stuPos> Spans;
+    int Cursor = 0;
+    foreach(const QString& Token, _ixml.split(" ", QString::SkipEmptyParts)){
+        QString Surface = Token;
+        if (Surface.startsWith('<') && Surface.endsWith('>')){
+            int ContentStart = Surface.indexOf('>') + 1;
+            int ContentEnd = Surface.lastIndexOf('<');
+            if (ContentEnd > ContentStart)
+                Surface = Surface.mid(ContentStart, ContentEnd - ContentStart);
+        }
+        Surface.replace("&lt;", "<").replace("&gt;", ">").replace("&amp;", "&");
+
+        while (Cursor < _normalized.size() && (_normalized.at(Cursor).isSpace() || _normalized.at(Cursor) == ARABIC_ZWNJ))
+            ++Cursor;
+
+        int Start = Cursor;
+        int End = matchSurface(_normalized, Cursor, Surface);
+        if (End < 0){
+            int Found = _normalized.indexOf(Surface, Cursor);
+            if (Found >= 0 && Found - Cursor <= TGMN_MAX_TOKEN_SKIP){
+                Start = Found;
+                End = Found + Surface.size();
+            }else{
+                TargomanDebug(5, "Unable to locate token <" << Token << "> in input, its span is left invalid");
+                Spans.append(stuPos());
+                continue;
+            }
+        }
+
+        if (End > Start){
+            Spans.append(stuPos(_normalizedOffsets.at(Start), _normalizedOffsets.at(End - 1) + 1));
+            Cursor = End;
+        }else
+            Spans.append(stuPos());
+    }
+    return Spans;
+}
+
 /**
  * @brief Finds a RegExp in input _phrase and if found, replaces that with a _mark and adds that to _listOfMaches.
  * @param _phrase input phrase.
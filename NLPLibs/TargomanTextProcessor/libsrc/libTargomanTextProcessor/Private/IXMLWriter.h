@@ -74,11 +74,14 @@ public:
                          const QString& _lang = "",
                          quint32 _lineNo = 0,
                          bool _interactive = false,
-                         bool _useSpellCorrector = true);
+                         bool _useSpellCorrector = true,
+                         OUTPUT QList<Common::stuPos>* _tokenSpans = NULL);
     QString supportedSuffixes() const;
 
 private:
-
+    QList<Common::stuPos> locateTokens(const QString& _ixml,
+                                       const QString& _normalized,
+                                       const QVector<qint32>& _normalizedOffsets) const;
 
 
     QString markByRegex(const QString &_phrase,
@@ -42,6 +42,9 @@ namespace NLPLibs {
 namespace TargomanTP{
 namespace Private {
 
+/// Last character in normalization process. It is kept per thread so that concurrent normalizations do not interfere.
+thread_local static QChar LastChar;
+
 Normalizer::Normalizer()
 {
     initUnicodeNormalizers();
@@ -87,53 +90,53 @@ QString Normalizer::normalize(const QChar &_char,
     // //////////////////////////////////////////////////////////////////////////
     // Remove extra non-breaking space after non-joinable characters and before space
     if (Char == ARABIC_ZWNJ && (
-                this->LastChar.joining() == QChar::Right ||         //character that join just from their right side. like: د,ر,ا
-                this->LastChar.joining() == QChar::OtherJoining ||
-                this->LastChar.isSpace() ||
-                this->LastChar.isSymbol() ||
-                this->LastChar.isDigit()||
-                this->LastChar.isPunct() ||
-                this->LastChar.isNull() ||
+                LastChar.joining() == QChar::Right ||         //character that join just from their right side. like: د,ر,ا
+                LastChar.joining() == QChar::OtherJoining ||
+                LastChar.isSpace() ||
+                LastChar.isSymbol() ||
+                LastChar.isDigit()||
+                LastChar.isPunct() ||
+                LastChar.isNull() ||
                 NextCharIsNotLeftJoinable)){
         return "";
     }
 
     //Temporarily accept [POP DIRECTIONAL FORMATTING] character as it maybe used for ZWNJ
     if (Char == POP_DIRECTIONAL_FORMATTING){
-        this->LastChar = Char;
+        LastChar = Char;
         return "";
     }
 
     //Convert wrong tatweels to dash.
-    if(Char == ARABIC_TATWEEL && !(_nextChar.script() == QChar::Script_Arabic && this->LastChar.script() == QChar::Script_Arabic))
-            return this->LastChar = '-';
+    if(Char == ARABIC_TATWEEL && !(_nextChar.script() == QChar::Script_Arabic && LastChar.script() == QChar::Script_Arabic))
+            return LastChar = '-';
 
     //Convert special ZWNJ to ZWNJ
     if (Char == RIGHT_TO_LEFT_EMBEDDING && LastChar == POP_DIRECTIONAL_FORMATTING)
-        return this->normalize(this->LastChar = ARABIC_ZWNJ, _nextChar, false, _line, _phrase, _charPos);
+        return this->normalize(LastChar = ARABIC_ZWNJ, _nextChar, false, _line, _phrase, _charPos);
 
     //Convert thousand separators to comma //zhnDebug: Arabic Thousand Seperator is same glyph as comma in some fonts like Tahoma. we can handle it.
     if (LastChar.isDigit() && _nextChar.isDigit() && (
                 Char == ARABIC_THOUSAND_SEPERATOR ||
                 Char == WEIRD_THOUSAND_SEPERATOR))
-        return this->LastChar = ',';
+        return LastChar = ',';
 
     //Convert special decimal point
     if (LastChar.isDigit() && _nextChar.isDigit() && (
                 Char == WEIRD_DECIMAL_POINT ||
                 Char == ARABIC_DECIMAL_POINT
                 ))
-        return this->LastChar = '.';
+        return LastChar = '.';
 
     //convert ye hamze, if it is in its isolated or last form, to ye hamze.
     if (Char == ARABIC_YE_HAMZA && (
                 NextCharIsNotLeftJoinable))
-        return this->LastChar = ARABIC_YE;
+        return LastChar = ARABIC_YE;
 
     //convert alef hamza down or alef hamza up, if it is in its isolated or last form, to alef.
     if ((Char == ARABIC_ALEF_HAMZA_DOWN || Char == ARABIC_ALEF_HAMZA_UP) && (
                 NextCharIsNotLeftJoinable))
-        return this->LastChar = ARABIC_ALEF;
+        return LastChar = ARABIC_ALEF;
 
     // //////////////////////////////////////////////////////////////////////////
     // //                        Using Binary Table                           ///
@@ -154,7 +157,7 @@ QString Normalizer::normalize(const QChar &_char,
         if (Normalized.size()){
 
             if (_skipRecheck) {
-                this->LastChar = Normalized.at(Normalized.size() - 1);
+                LastChar = Normalized.at(Normalized.size() - 1);
                 return Normalized;
             }
             else {
@@ -170,7 +173,7 @@ QString Normalizer::normalize(const QChar &_char,
                                                              true
                                                              );
                     if(NormalizedChar.size())
-                        Normalized.append(this->LastChar =  NormalizedChar[0]);
+                        Normalized.append(LastChar =  NormalizedChar[0]);
                 }
                 return Normalized;
             }
@@ -191,7 +194,7 @@ QString Normalizer::normalize(const QChar &_char,
 
     //Digits must be converted to ascii
     if (Char.isDigit())
-        return this->LastChar = QChar(Char.digitValue() + '0');
+        return LastChar = QChar(Char.digitValue() + '0');
 
     //Convert TitleCase to UpperCase
     if (Char.isTitleCase())
@@ -200,11 +203,11 @@ QString Normalizer::normalize(const QChar &_char,
     //Convert all special forms of quote and dquote to ASCII
     if (Char.category() == QChar::Punctuation_InitialQuote ||
             Char.category() == QChar::Punctuation_FinalQuote)
-        return this->LastChar = '"';
+        return LastChar = '"';
 
     //Accept characters defined as white
     if (this->WhiteList.contains (Char))
-        return this->LastChar = Char;
+        return LastChar = Char;
 
     //Remove characters defined in config file
     if (this->RemovingList.contains(Char)){
@@ -213,20 +216,20 @@ QString Normalizer::normalize(const QChar &_char,
 
     //Convert to normal Space characters marked as space
     if (this->SpaceCharList.contains(Char))
-        return this->LastChar = ' ';
+        return LastChar = ' ';
 
     //Convert to ZWNJ characters marked as ZWNJ
     if (this->ZeroWidthSpaceCharList.contains(Char))
-        return this->normalize(this->LastChar = ARABIC_ZWNJ, _nextChar, false, _line, _phrase, _charPos);
+        return this->normalize(LastChar = ARABIC_ZWNJ, _nextChar, false, _line, _phrase, _charPos);
 
     //Convert characters based on Normalization table
     if (this->ReplacingTable.contains(Char)){
         QString Buff = this->ReplacingTable.value(Char);
         if (Buff.size() > 1){
-            this->LastChar = *(Buff.end() - 1);
+            LastChar = *(Buff.end() - 1);
             return Buff;
         }else
-            return this->LastChar = Buff.at(0);
+            return LastChar = Buff.at(0);
     }
 
     //Remove all special control characters and character modifiers
@@ -240,10 +243,10 @@ QString Normalizer::normalize(const QChar &_char,
     if (Char.category() == QChar::Other_NotAssigned ||
             Char.category() == QChar::Other_PrivateUse ||
             Char.category() == QChar::Other_Surrogate)
-        return this->LastChar = SYMBOL_REMOVED;
+        return LastChar = SYMBOL_REMOVED;
 
     if (_skipRecheck)
-        return this->LastChar = Char;
+        return LastChar = Char;
 
 
     //Check if there are sepcial normalizers
@@ -261,7 +264,7 @@ QString Normalizer::normalize(const QChar &_char,
                                                      true
                                                      );
             if(NormalizedChar.size())
-                Normalized.append(this->LastChar =  NormalizedChar[0]);
+                Normalized.append(LastChar =  NormalizedChar[0]);
         }
         return Normalized;
     }
@@ -270,7 +273,7 @@ QString Normalizer::normalize(const QChar &_char,
     if (Char.category() == QChar::Symbol_Currency ||
             Char.category() == QChar::Symbol_Math ||
             Char.category() == QChar::Symbol_Other)
-        return this->LastChar = Char;
+        return LastChar = Char;
 
     //Change not resolved characrters interactively by user input.
     if(_interactive){
@@ -357,7 +360,7 @@ QString Normalizer::normalize(const QChar &_char,
 QString Normalizer::normalize(const QString &_string, qint32 _line, bool _interactive)
 {
     QString Normalized;
-    this->LastChar = QChar();
+    LastChar = QChar();
     for (int i=0; i<_string.size(); i++){
         QString normalizedCharString = this->normalize(_string.at(i),
                                                        ((i + 1) < _string.size() ? _string.at(i+1) : QChar('\n')),
@@ -119,7 +119,6 @@ private:
     QSet<QChar>             ZeroWidthSpaceCharList;     /** < A Set to contain all kind of zero width spaces chars. Content of this variable will be added using Normalization config file. */
     QString                 ConfigFileName;                 /** < Configuration file address */
     bool                    BinaryMode;                 /** < If Normalization data is in binary mode this variable will be true.*/
-    QChar                   LastChar;                   /** < Last character in normalization process.*/
 };
 
 }
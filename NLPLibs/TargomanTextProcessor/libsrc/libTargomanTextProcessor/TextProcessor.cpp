@@ -96,6 +96,8 @@ bool TargomanTextProcessor::init(QSharedPointer<QSettings> _configSettings)
  * @param _interactive
  * @param _useSpellCorrector
  * @param _removingTags
+ * @param _tokenSpans if provided will be filled with character span of each output token in the input string.
+ * It will be left empty if replacements change number of tokens.
  * @return
  */
 QString TargomanTextProcessor::text2IXML(const QString &_inStr,
@@ -105,7 +107,8 @@ QString TargomanTextProcessor::text2IXML(const QString &_inStr,
                                          bool _interactive,
                                          bool _useSpellCorrector,
                                          QList<enuTextTags::Type> _removingTags,
-                                         QList<stuIXMLReplacement> _replacements) const
+                                         QList<stuIXMLReplacement> _replacements,
+                                         QList<Common::stuPos>* _tokenSpans) const
 {
     if (!Initialized)
         throw exTextProcessor("Text Processor has not been initialized");
@@ -119,11 +122,15 @@ QString TargomanTextProcessor::text2IXML(const QString &_inStr,
                 LangCode ? LangCode : "",
                 _lineNo,
                 _interactive,
-                _useSpellCorrector);
+                _useSpellCorrector,
+                _tokenSpans);
 
     foreach(const stuIXMLReplacement& Replacement, _replacements)
         IXML.replace(Replacement.SearchRegExp, Replacement.AfterString);
 
+    if (_tokenSpans && _replacements.size() && IXML.split(" ", QString::SkipEmptyParts).size() != _tokenSpans->size())
+        _tokenSpans->clear();
+
     foreach(enuTextTags::Type Tag, _removingTags)
         IXML.remove(
                     QString("<%1>").arg(enuTextTags::toStr(Tag))).remove(
@@ -89,7 +89,8 @@ public:
                       bool _interactive = true,
                       bool _useSpellCorrector = true,
                       QList<enuTextTags::Type> _removingTags = QList<enuTextTags::Type>(),
-                      QList<stuIXMLReplacement> _replacements = QList<stuIXMLReplacement>()) const;
+                      QList<stuIXMLReplacement> _replacements = QList<stuIXMLReplacement>(),
+                      OUTPUT QList<Common::stuPos>* _tokenSpans = NULL) const;
 
     QString ixml2Text(const QString& _ixml,
                       const QString& _lang = "",
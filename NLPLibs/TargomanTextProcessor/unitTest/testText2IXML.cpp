@@ -29,6 +29,28 @@
 #define VERIFY_TXT2IXML(_lang, _check, _desired) \
     Targoman::NLPLibs::TargomanTextProcessor::instance().text2IXML(QStringLiteral(_check), SpellCorrected, _lang, 0, false) == \
         QStringLiteral(_desired)
+#define VERIFY_TXT2IXML_SPANS(_lang, _check, _desired) \
+    tokenSpans(_lang, QStringLiteral(_check)) == QStringLiteral(_desired)
+
+using Targoman::Common::stuPos;
+
+/**
+ * @brief returns input text covered by span of each ixml token separated by '|', invalid spans are shown by '?'
+ */
+static QString tokenSpans(const QString& _lang, const QString& _input)
+{
+    bool SpellCorrected;
+    QList<stuPos> Spans;
+    Targoman::NLPLibs::TargomanTextProcessor::instance().text2IXML(
+                _input, SpellCorrected, _lang, 0, false, true,
+                QList<Targoman::NLPLibs::enuTextTags::Type>(),
+                QList<Targoman::NLPLibs::stuIXMLReplacement>(),
+                &Spans);
+    QStringList Result;
+    foreach(const stuPos& Span, Spans)
+        Result.append(Span.isValid() ? _input.mid(Span.first, Span.second - Span.first) : QString("?"));
+    return Result.join("|");
+}
 
 void UnitTest::text2IXML()
 {
@@ -135,5 +157,15 @@ void UnitTest::text2IXML()
     QVERIFY(VERIFY_TXT2IXML("fa",
                             "کرد.مشهورترین",
                             "کرد . مشهورترین"));
+
+    //token spans
+    QVERIFY(VERIFY_TXT2IXML_SPANS("en","this is just  a test.", "this|is|just|a|test|."));
+    QVERIFY(VERIFY_TXT2IXML_SPANS("en","a 12.5. asd", "a|12.5.|asd"));
+    QVERIFY(VERIFY_TXT2IXML_SPANS("en","__http://bit.ly/BBCKookFB", "_|_|http://bit.ly/BBCKookFB"));
+    QVERIFY(VERIFY_TXT2IXML_SPANS("en","(Is<this>a (vulnerability)?)", "(|Is|<|this|>|a|(|vulnerability|)|?|)"));
+    QVERIFY(VERIFY_TXT2IXML_SPANS("en","Senior&lt;/url&gt; Hamas", "Senior|&lt;|/|url|&gt;|Hamas"));
+    QVERIFY(VERIFY_TXT2IXML_SPANS("en","a & b", "a|&|b"));
+    QVERIFY(VERIFY_TXT2IXML_SPANS("en","wait... what", "wait|...|what"));
+    QVERIFY(VERIFY_TXT2IXML_SPANS("fa","می گفت \"پاتک\"", "می گفت|\"|پاتک|\""));
 }
 
@@ -29,6 +29,7 @@
 #include <QFileInfo>
 #include <QSet>
 #include <QDir>
+#include <QReadWriteLock>
 #include <iostream>
 #include <functional>
 #include "ConfigManager.h"
@@ -565,11 +566,32 @@ void ConfigManager::setValue(const QString &_path, const QVariant &_value) const
 
     intfConfigurable* Item= this->pPrivate->Configs.value(_path);
     if (Item){
+        QWriteLocker Locker(&this->pPrivate->RuntimeUpdateLock);
         Item->setFromVariant(_value);
         Item->setIsConfigured();
+        this->pPrivate->Revision.ref();
     }
 }
 
+/**
+ * @brief Revision of runtime configuration. It changes whenever a configurable is set after initialization either
+ * locally or over network.
+ */
+quint32 ConfigManager::revision() const
+{
+    return (quint32)this->pPrivate->Revision.load();
+}
+
+/**
+ * @brief Calls _reader while no configurable is being changed at runtime so that values read by _reader are all from
+ * the same revision. Must not be used on hot paths as it blocks runtime updates.
+ */
+void ConfigManager::readConsistently(const std::function<void ()> &_reader) const
+{
+    QReadLocker Locker(&this->pPrivate->RuntimeUpdateLock);
+    _reader();
+}
+
 /**
  * @brief gives instantiator function of a module.
  * @param _name     Name of module.
@@ -782,6 +804,16 @@ void intfRPCExporter::exportMyRPCs(){
         Private::RPCRegistry::instance().registerRPC(this,this->metaObject()->method(i));
 }
 
+static thread_local const QAtomicInt* RPCCancellationFlag = NULL;
+
+const QAtomicInt* intfRPCExporter::cancellationFlag(){
+    return RPCCancellationFlag;
+}
+
+void intfRPCExporter::setCancellationFlag(const QAtomicInt* _flag){
+    RPCCancellationFlag = _flag;
+}
+
 }
 }
 }
@@ -78,6 +78,8 @@ public:
     QStringList registeredModules(const QString& _moduleRoot);
     QVariant getConfig(const QString& _path, const QVariant &_default = QVariant()) const;
     void setValue(const QString& _path, const QVariant &_value) const;
+    quint32 revision() const;
+    void readConsistently(const std::function<void ()>& _reader) const;
     fpModuleInstantiator_t getInstantiator(const QString& _name) const;
     void getInstantiator(const QString& _name,
                          fpModuleInstantiator_t& _instantoiator,
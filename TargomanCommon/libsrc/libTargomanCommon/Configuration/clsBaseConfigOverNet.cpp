@@ -195,6 +195,7 @@ QVariant clsBaseConfigOverNet::set(const QString& _path, const QVariant& _newVal
                 throw exInvalidUpdateSource(_path);
 
             QString ErrorMessage;
+            QWriteLocker Locker(&this->ConfigManagerPrivate.RuntimeUpdateLock);
             QVariant OldValue = ConfigItem->toVariant();
             try{
                 ConfigItem->setFromVariant(_newValue);
@@ -202,6 +203,7 @@ QVariant clsBaseConfigOverNet::set(const QString& _path, const QVariant& _newVal
                     ConfigItem->setFromVariant(OldValue);
                     throw exInvalidData(ErrorMessage + " On: " + _path);
                 }else{
+                    this->ConfigManagerPrivate.Revision.ref();
                     TargomanLogInfo(5, QString("User: %1 Changed value of %2 to %4").arg(
                                         this->ActorName).arg(
                                         _path).arg(
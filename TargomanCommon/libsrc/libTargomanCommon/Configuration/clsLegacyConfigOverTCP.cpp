@@ -29,6 +29,7 @@
 #include "JSONConversationProtocol.h"
 #include "intfRPCExporter.hpp"
 #include "Private/RPCRegistry.hpp"
+#include "Configuration/Validators.hpp"
 
 namespace Targoman {
 namespace Common {
@@ -44,10 +45,84 @@ clsLegacyConfigOverTCP::~clsLegacyConfigOverTCP()
     //Just to suppress compiler error using QScopedPointer
 }
 
+tmplRangedConfigurable<quint8> clsLegacyConfigOverTCPServer::IOThreadsCount(
+        ConfigManager::moduleName() + "/Admin/IOThreads",
+        "Number of event loop threads serving administration connections",
+        1,64,
+        2,
+        ReturnTrueCrossValidator(),
+        "",
+        "COUNT",
+        "admin-io-threads",
+        (enuConfigSource::Type)(enuConfigSource::Arg | enuConfigSource::File),
+        false
+        );
+
+tmplConfigurable<quint16> clsLegacyConfigOverTCPServer::MaxConcurrentRPCs(
+        ConfigManager::moduleName() + "/Admin/MaxConcurrentRPCs",
+        "Max number of RPCs executed concurrently over all connections. RPCs such as translation block their worker "
+        "until their result is ready, so workers beyond what backend can process just wait. Further RPCs are queued "
+        "up to Admin/MaxQueuedRPCs without holding a thread. 0 means twice the number of CPU cores",
+        0,
+        ReturnTrueCrossValidator(),
+        "",
+        "MAX_ALLOWED",
+        "admin-max-concurrent-rpcs",
+        (enuConfigSource::Type)(enuConfigSource::Arg | enuConfigSource::File),
+        false
+        );
+
+tmplConfigurable<quint16> clsLegacyConfigOverTCPServer::MaxQueuedRPCs(
+        ConfigManager::moduleName() + "/Admin/MaxQueuedRPCs",
+        "Max number of RPCs waiting for a free worker over all connections. Further RPCs are rejected",
+        100,
+        ReturnTrueCrossValidator(),
+        "",
+        "MAX_ALLOWED",
+        "admin-max-queued-rpcs",
+        (enuConfigSource::Type)(enuConfigSource::Arg | enuConfigSource::File),
+        false
+        );
+
+tmplConfigurable<quint32> clsLegacyConfigOverTCPServer::MaxRequestSize(
+        ConfigManager::moduleName() + "/Admin/MaxRequestSize",
+        "Max size of a single request in bytes. Connections sending larger requests are closed",
+        10 * 1024 * 1024,
+        ReturnTrueCrossValidator(),
+        "",
+        "BYTES",
+        "admin-max-request-size",
+        (enuConfigSource::Type)(enuConfigSource::Arg | enuConfigSource::File),
+        false
+        );
+
 clsLegacyConfigOverTCPServer::clsLegacyConfigOverTCPServer(clsConfigManagerPrivate &_configManager) :
     ConfigManagerPrivate(_configManager),
-    ConnectedClients(0)
-{}
+    ConnectedClients(0),
+    NextIOThread(0),
+    RPCsInPool(0)
+{
+    // Twice the cores keeps decoders fed by a second set of requests while a set is being decoded and leaves room
+    // for cheap RPCs such as statistics, without a blocked thread per connection
+    this->RPCPool.setMaxThreadCount(clsLegacyConfigOverTCPServer::MaxConcurrentRPCs.value() ?
+                                        clsLegacyConfigOverTCPServer::MaxConcurrentRPCs.value() :
+                                        2 * qMax(QThread::idealThreadCount(), 1));
+
+    for(quint8 i = 0; i < clsLegacyConfigOverTCPServer::IOThreadsCount.value(); ++i){
+        QThread* IOThread = new QThread(this);
+        IOThread->start();
+        this->IOThreads.append(IOThread);
+    }
+}
+
+clsLegacyConfigOverTCPServer::~clsLegacyConfigOverTCPServer()
+{
+    foreach(QThread* IOThread, this->IOThreads){
+        IOThread->quit();
+        IOThread->wait();
+    }
+    this->RPCPool.waitForDone();
+}
 
 void clsLegacyConfigOverTCPServer::incomingConnection(qintptr _socketDescriptor)
 {
@@ -65,278 +140,362 @@ void clsLegacyConfigOverTCPServer::incomingConnection(qintptr _socketDescriptor)
         return;
     }
 
-    clsClientThread* CLT = new clsClientThread(_socketDescriptor,
-                                               this->ConfigManagerPrivate,
-                                               this);
+    clsClientConnection* Connection = new clsClientConnection(_socketDescriptor,
+                                                              this->ConfigManagerPrivate,
+                                                              this->RPCPool,
+                                                              this->RPCsInPool);
+    Connection->moveToThread(this->IOThreads.at(this->NextIOThread));
+    this->NextIOThread = (this->NextIOThread + 1) % this->IOThreads.size();
 
-    connect(CLT, &clsClientThread::finished,
+    connect(Connection, &clsClientConnection::sigClosed,
             this, &clsLegacyConfigOverTCPServer::slotClientDisconnected);
+    QMetaObject::invokeMethod(Connection, "slotStart", Qt::QueuedConnection);
 
-    CLT->start();
     ++this->ConnectedClients;
 }
 
 void clsLegacyConfigOverTCPServer::slotClientDisconnected()
 {
-    clsClientThread* CLT = qobject_cast<clsClientThread*>(this->sender());
-    CLT->deleteLater();
     --this->ConnectedClients;
 }
 
 /******************************************************************************/
 
-clsClientThread::clsClientThread(qintptr _socketDescriptor,
-                                 clsConfigManagerPrivate &_configManager,
-                                 QObject* _parent):
-    QThread(_parent),
+clsClientConnection::clsClientConnection(qintptr _socketDescriptor,
+                                         clsConfigManagerPrivate &_configManager,
+                                         QThreadPool &_rpcPool,
+                                         QAtomicInt &_rpcsInPool):
     clsBaseConfigOverNet(_configManager),
-    SocketDescriptor(_socketDescriptor)
+    SocketDescriptor(_socketDescriptor),
+    Socket(NULL),
+    RPCPool(_rpcPool),
+    RPCsInPool(_rpcsInPool),
+    ScannedBytes(0),
+    NestingDepth(0),
+    InString(false),
+    Escaped(false),
+    PendingRPCs(0),
+    Disconnected(false),
+    ClientGone(0)
 {
     this->AllowedToChange = false;
     this->AllowedToView   = false;
 }
 
-void clsClientThread::slotReadyRead()
+void clsClientConnection::slotStart()
 {
-    try
-    {
-        if (this->Socket->bytesAvailable() < 3)
-            return;
+    this->Socket = new QTcpSocket(this);
+    if(!this->Socket->setSocketDescriptor(this->SocketDescriptor)){
+        TargomanLogWarn(5, QString("Unable to serve client with id=%1: %2").arg(
+                            this->SocketDescriptor).arg(this->Socket->errorString()));
+        this->Disconnected = true;
+        return this->closeIfIdle();
+    }
 
-        if (this->Socket->bytesAvailable() > 20000)
-            this->sendError(enuReturnType::InvalidStream,"Stream Data is too long");
+    this->Socket->setReadBufferSize(clsLegacyConfigOverTCPServer::MaxRequestSize.value());
+    connect(this->Socket, &QTcpSocket::readyRead,
+            this,         &clsClientConnection::slotReadyRead);
+    connect(this->Socket, &QTcpSocket::disconnected,
+            this,         &clsClientConnection::slotDisconnected);
 
-        QByteArray ReceivedBytes =this->Socket->readLine().trimmed();
-        TargomanDebug(9,"Received["<<
-                      this->ActorName<<"@"<<
-                      this->Socket->peerAddress().toString()<<":"<<
-                      this->Socket->peerPort()<<"]: "<<ReceivedBytes);
+    TargomanLogInfo(5, QString("New Configuration Admin from %1:%2 with id=%3 connected").arg(
+                        this->Socket->peerAddress().toString()).arg(
+                        this->Socket->peerPort()).arg(this->SocketDescriptor));
+}
 
-        if(ReceivedBytes.isEmpty())
+/**
+ * @brief Appends received data to the read buffer and processes every complete JSON message in it. Messages are
+ * delimited by matching their outermost brackets (strings and escapes are respected) so clients may send requests
+ * back to back with or without separating new lines. Connection is closed when an incomplete message exceeds
+ * #MaxRequestSize.
+ */
+void clsClientConnection::slotReadyRead()
+{
+    try{
+        if (this->Socket->state() != QAbstractSocket::ConnectedState)
             return;
 
-        JSONConversationProtocol::stuRequest Request =
-                JSONConversationProtocol::parseRequest(ReceivedBytes);
+        this->ReadBuffer.append(this->Socket->readAll());
+
+        int MessageStart = 0;
+        const char* Data = this->ReadBuffer.constData();
+        for (int i = this->ScannedBytes; i < this->ReadBuffer.size(); ++i){
+            char Ch = Data[i];
+            if (this->InString){
+                if (this->Escaped)
+                    this->Escaped = false;
+                else if (Ch == '\\')
+                    this->Escaped = true;
+                else if (Ch == '"')
+                    this->InString = false;
+                continue;
+            }
+
+            switch(Ch){
+            case '"':
+                this->InString = true;
+                break;
+            case '{':
+            case '[':
+                if (this->NestingDepth == 0)
+                    MessageStart = i;
+                ++this->NestingDepth;
+                break;
+            case '}':
+            case ']':
+                if (this->NestingDepth == 0)
+                    throw exConfigOverNet("Unbalanced JSON message");
+                if (--this->NestingDepth == 0){
+                    this->processRequest(this->ReadBuffer.mid(MessageStart, i - MessageStart + 1));
+                    if (this->Socket->state() != QAbstractSocket::ConnectedState)
+                        return;
+                    MessageStart = i + 1;
+                }
+                break;
+            default:
+                if (this->NestingDepth == 0 && QChar(Ch).isSpace() == false)
+                    throw exConfigOverNet("Invalid character out of JSON message");
+            }
+        }
+
+        if (this->NestingDepth == 0)
+            MessageStart = this->ReadBuffer.size();
+        this->ReadBuffer.remove(0, MessageStart);
+        this->ScannedBytes = this->ReadBuffer.size();
+
+        if ((quint32)this->ReadBuffer.size() > clsLegacyConfigOverTCPServer::MaxRequestSize.value())
+            throw exConfigOverNet(QString("Request is larger than %1 bytes").arg(
+                                      clsLegacyConfigOverTCPServer::MaxRequestSize.value()));
+    }catch(exTargomanBase &e){
+        this->sendError(enuReturnType::InvalidStream,e.what());
+    }catch(...){
+        this->sendError(enuReturnType::Unknown,"FATAL unknown error");
+    }
+}
+
+/**
+ * @brief Processes a single request. Session related requests (ping, login and configuration access) are cheap and
+ * answered in place while RPCs are handed over to the RPC worker pool.
+ */
+void clsClientConnection::processRequest(const QByteArray& _request)
+{
+    TargomanDebug(9,"Received["<<
+                  this->ActorName<<"@"<<
+                  this->Socket->peerAddress().toString()<<":"<<
+                  this->Socket->peerPort()<<"]: "<<_request);
+
+    JSONConversationProtocol::stuRequest Request =
+            JSONConversationProtocol::parseRequest(_request);
+    try{
+        if (Request.Name == "simplePing")
+            return this->sendResult(JSONConversationProtocol::preparePong());
+
+        if (Request.Name == "ssidPing"){
+            return this->sendResult(
+                        JSONConversationProtocol::preparePong(
+                            this->ssidPing(Request.Args.value("ssid").toString())));
+        }
+        /************************************************************/
+        if (Request.Name == "login"){
+            QString Pass;
+            if (Request.Args.contains("l")){
+                this->ActorName = Request.Args.value("l").toString();
+                Pass =      Request.Args.value("p").toString();
+            }else if (Request.Args.contains("ssid"))
+                this->ActorName = "$SSID$" + Request.Args.value("ssid").toString();
+
+            if (this->ActorName.isEmpty())
+                this->ActorName = "UNKNOWN";
+            emit this->ConfigManagerPrivate.Parent.sigValidateAgent(
+                        this->ActorName,
+                        Pass,
+                        this->Socket->peerAddress().toString(),
+                        this->AllowedToView,
+                        this->AllowedToChange);
+
+            if (this->AllowedToView) {
+                TargomanLogInfo(5, QString("User <%1> Logged in with %2 Access").arg(
+                                    this->ActorName).arg(
+                                    this->AllowedToChange ? "ReadWrite" : "ReadOnly"));
+
+                if (this->AllowedToChange)
+                    return this->sendResult(JSONConversationProtocol::prepareResult(
+                                                Request.CallBack,
+                                                Request.CallUID,
+                                                3));
+                else
+                    return this->sendResult(JSONConversationProtocol::prepareResult(
+                                                Request.CallBack,
+                                                Request.CallUID,
+                                                1));
+            } else if (this->ActorName.isEmpty()) {
+                TargomanLogWarn(6, "Attemp to login from <"<<
+                                this->Socket->peerAddress().toString()<<":"<<
+                                this->Socket->peerPort()<<"> Failed");
+                return this->sendError(enuReturnType::InvalidLogin,
+                                       "Invalid User/Password");
+            } else {
+                TargomanLogWarn(6,
+                                QString("User: %1 attemped to Login but not enough access").arg(
+                                    this->ActorName));
+                return this->sendError(enuReturnType::InvalidLogin,
+                                       QString("Not enough access"));
+            }
+        }
+        /************************************************************/
+        if (this->AllowedToView == false)
+            return this->sendError(enuReturnType::InvalidLogin,
+                                   QString("Invalid Request. Please login first"));
+        /************************************************************/
         try{
-            if (Request.Name == "simplePing")
-                return this->sendResult(JSONConversationProtocol::preparePong());
+            if (Request.Name == "walk")
+            {
+                QVariantList Table = clsBaseConfigOverNet::walk(
+                            Request.Args.value("dt", false).toBool());
+                QVariantMap ReturnVals;
+                ReturnVals.insert("t", Table);
 
-            if (Request.Name == "ssidPing"){
                 return this->sendResult(
-                            JSONConversationProtocol::preparePong(
-                                this->ssidPing(Request.Args.value("ssid").toString())));
+                            JSONConversationProtocol::prepareResult(
+                                Request.CallBack,
+                                Request.CallUID,
+                                Table.size(),
+                                ReturnVals));
             }
             /************************************************************/
-            if (Request.Name == "login"){
-                QString Pass;
-                if (Request.Args.contains("l")){
-                    this->ActorName = Request.Args.value("l").toString();
-                    Pass =      Request.Args.value("p").toString();
-                }else if (Request.Args.contains("ssid"))
-                    this->ActorName = "$SSID$" + Request.Args.value("ssid").toString();
-
-                if (this->ActorName.isEmpty())
-                    this->ActorName = "UNKNOWN";
-                emit this->ConfigManagerPrivate.Parent.sigValidateAgent(
-                            this->ActorName,
-                            Pass,
-                            this->Socket->peerAddress().toString(),
-                            this->AllowedToView,
-                            this->AllowedToChange);
-
-                if (this->AllowedToView) {
-                    TargomanLogInfo(5, QString("User <%1> Logged in with %2 Access").arg(
-                                        this->ActorName).arg(
-                                        this->AllowedToChange ? "ReadWrite" : "ReadOnly"));
-
-                    if (this->AllowedToChange)
-                        return this->sendResult(JSONConversationProtocol::prepareResult(
-                                                    Request.CallBack,
-                                                    Request.CallUID,
-                                                    3));
-                    else
-                        return this->sendResult(JSONConversationProtocol::prepareResult(
-                                                    Request.CallBack,
-                                                    Request.CallUID,
-                                                    1));
-                } else if (this->ActorName.isEmpty()) {
-                    TargomanLogWarn(6, "Attemp to login from <"<<
-                                    this->Socket->peerAddress().toString()<<":"<<
-                                    this->Socket->peerPort()<<"> Failed");
-                    return this->sendError(enuReturnType::InvalidLogin,
-                                           "Invalid User/Password");
-                } else {
-                    TargomanLogWarn(6,
-                                    QString("User: %1 attemped to Login but not enough access").arg(
-                                        this->ActorName));
-                    return this->sendError(enuReturnType::InvalidLogin,
-                                           QString("Not enough access"));
-                }
+            if (Request.Name == "query") {
+                return this->sendResult(
+                            JSONConversationProtocol::prepareResult(
+                                Request.CallBack,
+                                Request.CallUID,
+                                clsBaseConfigOverNet::query(
+                                    Request.Args.value("p").toString()).toString()));
             }
             /************************************************************/
-            if (this->AllowedToView == false)
-                return this->sendError(enuReturnType::InvalidLogin,
-                                       QString("Invalid Request. Please login first"));
-            /************************************************************/
-            try{
-                if (Request.Name == "walk")
-                {
-                    QVariantList Table = clsBaseConfigOverNet::walk(
-                                Request.Args.value("dt", false).toBool());
-                    QVariantMap ReturnVals;
-                    ReturnVals.insert("t", Table);
-
-                    return this->sendResult(
-                                JSONConversationProtocol::prepareResult(
-                                    Request.CallBack,
-                                    Request.CallUID,
-                                    Table.size(),
-                                    ReturnVals));
-                }
-                /************************************************************/
-                if (Request.Name == "query") {
-                    return this->sendResult(
-                                JSONConversationProtocol::prepareResult(
-                                    Request.CallBack,
-                                    Request.CallUID,
-                                    clsBaseConfigOverNet::query(
-                                        Request.Args.value("p").toString()).toString()));
-                }
-                /************************************************************/
-                if (Request.Name == "bulkQuery"){
-                    QVariantList Table = clsBaseConfigOverNet::bulkQuery(
-                                Request.Args.value("p").toString(),
-                                Request.Args.value("rx",false).toBool(),
-                                Request.Args.value("dt",false).toBool(),
-                                Request.Args.value("up", -2).toInt(),
-                                Request.Args.value("tp").toString(),
-                                Request.Args.value("ss").toString());
-
-                    QVariantMap ReturnVals;
-                    ReturnVals.insert("t", Table);
-
-                    return this->sendResult(
-                                JSONConversationProtocol::prepareResult(
-                                    Request.CallBack,
-                                    Request.CallUID,
-                                    Table.size(),
-                                    ReturnVals));
+            if (Request.Name == "bulkQuery"){
+                QVariantList Table = clsBaseConfigOverNet::bulkQuery(
+                            Request.Args.value("p").toString(),
+                            Request.Args.value("rx",false).toBool(),
+                            Request.Args.value("dt",false).toBool(),
+                            Request.Args.value("up", -2).toInt(),
+                            Request.Args.value("tp").toString(),
+                            Request.Args.value("ss").toString());
+
+                QVariantMap ReturnVals;
+                ReturnVals.insert("t", Table);
 
-                } //if (Request.Name == "bulkQuery")
-
-                /************************************************************/
-                if (Request.Name == "set") {
-                    return this->sendResult(
-                                JSONConversationProtocol::prepareResult(
-                                    Request.CallBack,
-                                    Request.CallUID,
-                                    clsBaseConfigOverNet::set(Request.Args.value("p").toString(),
-                                                              Request.Args.value("vl")).toString()));
-                }// if (Request.Name == "set")
-            }catch(exObjectNotFound &e){
                 return this->sendResult(
-                            JSONConversationProtocol::prepareError(
+                            JSONConversationProtocol::prepareResult(
                                 Request.CallBack,
                                 Request.CallUID,
-                                enuReturnType::ObjectNotFound,
-                                e.what().mid(0, e.what().indexOf(">;"))));
-            }catch(exInvalidAction &e){
-                return this->sendResult(JSONConversationProtocol::prepareError(
-                                            Request.CallBack,
-                                            Request.CallUID,
-                                            enuReturnType::InvalidAction,
-                                            e.what().mid(0, e.what().indexOf(">;"))));
-            }catch(exInvalidUpdateSource &e){
-                return this->sendResult(JSONConversationProtocol::prepareError(
-                                            Request.CallBack,
-                                            Request.CallUID,
-                                            enuReturnType::InvalidUpdateSource,
-                                            e.what().mid(0, e.what().indexOf(">;"))));
-            }catch(exInvalidData &e){
-                return this->sendResult(JSONConversationProtocol::prepareError(
-                                            Request.CallBack,
-                                            Request.CallUID,
-                                            enuReturnType::InvalidData,
-                                            e.what().mid(0, e.what().indexOf(">;"))));
-            }
-
+                                Table.size(),
+                                ReturnVals));
 
-            /************************************************************/
-            if (Request.Name.startsWith("rpc")) {
-                try{
-                    stuRPCOutput Return =
-                            RPCRegistry::instance().getRPCObject(Request.Name).invoke(Request.Args);
-
-                    return this->sendResult(JSONConversationProtocol::prepareResult(
-                                                Request.CallBack,
-                                                Request.CallUID,
-                                                Return.DirectResult.toString(),
-                                                Return.IndirectResult));
-                }catch(exRPCReg &e){
-                    return this->sendResult(JSONConversationProtocol::prepareError(
-                                                Request.CallBack,
-                                                Request.CallUID,
-                                                enuReturnType::ObjectNotFound,
-                                                e.what()));
-                }catch(exTargomanBase &e){
-                    return this->sendResult(JSONConversationProtocol::prepareError(
-                                                Request.CallBack,
-                                                Request.CallUID,
-                                                enuReturnType::InvalidData,
-                                                e.what()));
-                }
-            }//if (Request.Name == "rpc")
+            } //if (Request.Name == "bulkQuery")
 
             /************************************************************/
-            //Finally seems that request name is invalid
+            if (Request.Name == "set") {
+                return this->sendResult(
+                            JSONConversationProtocol::prepareResult(
+                                Request.CallBack,
+                                Request.CallUID,
+                                clsBaseConfigOverNet::set(Request.Args.value("p").toString(),
+                                                          Request.Args.value("vl")).toString()));
+            }// if (Request.Name == "set")
+        }catch(exObjectNotFound &e){
+            return this->sendResult(
+                        JSONConversationProtocol::prepareError(
+                            Request.CallBack,
+                            Request.CallUID,
+                            enuReturnType::ObjectNotFound,
+                            e.what().mid(0, e.what().indexOf(">;"))));
+        }catch(exInvalidAction &e){
             return this->sendResult(JSONConversationProtocol::prepareError(
                                         Request.CallBack,
                                         Request.CallUID,
                                         enuReturnType::InvalidAction,
-                                        "Invalid request " + Request.Name));
-        } catch (exTargomanBase &e) {
-            this->sendResult(JSONConversationProtocol::prepareError(
-                                 Request.CallBack,
-                                 Request.CallUID,
-                                 enuReturnType::Undefined,
-                                 e.what()));
+                                        e.what().mid(0, e.what().indexOf(">;"))));
+        }catch(exInvalidUpdateSource &e){
+            return this->sendResult(JSONConversationProtocol::prepareError(
+                                        Request.CallBack,
+                                        Request.CallUID,
+                                        enuReturnType::InvalidUpdateSource,
+                                        e.what().mid(0, e.what().indexOf(">;"))));
+        }catch(exInvalidData &e){
+            return this->sendResult(JSONConversationProtocol::prepareError(
+                                        Request.CallBack,
+                                        Request.CallUID,
+                                        enuReturnType::InvalidData,
+                                        e.what().mid(0, e.what().indexOf(">;"))));
         }
-    }catch(exTargomanBase &e){
-        this->sendError(enuReturnType::InvalidStream,e.what());
-    }catch(...){
-        this->sendError(enuReturnType::Unknown,"FATAL unknown error");
+
+
+        /************************************************************/
+        if (Request.Name.startsWith("rpc")) {
+            // Waiting RPCs are bounded so that overload is reported to clients instead of queueing without limit
+            if (this->RPCsInPool.fetchAndAddOrdered(1) >=
+                    this->RPCPool.maxThreadCount() + clsLegacyConfigOverTCPServer::MaxQueuedRPCs.value()){
+                this->RPCsInPool.deref();
+                TargomanLogWarn(5, "Rejecting " + Request.Name + " as RPC queue is full");
+                return this->sendResult(JSONConversationProtocol::prepareError(
+                                            Request.CallBack,
+                                            Request.CallUID,
+                                            enuReturnType::InvalidAction,
+                                            "Server is busy. Try again later"));
+            }
+            ++this->PendingRPCs;
+            this->RPCPool.start(new clsRPCTask(this, Request, this->RPCsInPool));
+            return;
+        }//if (Request.Name == "rpc")
+
+        /************************************************************/
+        //Finally seems that request name is invalid
+        return this->sendResult(JSONConversationProtocol::prepareError(
+                                    Request.CallBack,
+                                    Request.CallUID,
+                                    enuReturnType::InvalidAction,
+                                    "Invalid request " + Request.Name));
+    } catch (exTargomanBase &e) {
+        this->sendResult(JSONConversationProtocol::prepareError(
+                             Request.CallBack,
+                             Request.CallUID,
+                             enuReturnType::Undefined,
+                             e.what()));
     }
 }
 
-void clsClientThread::slotDisconnected()
+/**
+ * @brief Called on connection thread when an RPC handed to worker pool has finished.
+ */
+void clsClientConnection::slotRPCFinished(const QString &_response)
+{
+    --this->PendingRPCs;
+    if (this->Disconnected == false)
+        this->sendResult(_response);
+    this->closeIfIdle();
+}
+
+void clsClientConnection::slotDisconnected()
 {
     TargomanLogInfo(5, QString("Client with id=%3 disconnected").arg(
                         this->SocketDescriptor));
-    this->Socket->deleteLater();
-    exit(0);
+    this->Disconnected = true;
+    this->ClientGone.store(1);
+    this->closeIfIdle();
 }
 
-void clsClientThread::run()
+/**
+ * @brief Connection is deleted only after all of its pending RPCs have reported back as they hold a pointer to it.
+ */
+void clsClientConnection::closeIfIdle()
 {
-    this->Socket = new QTcpSocket;
-    if(!this->Socket->setSocketDescriptor(this->SocketDescriptor)){
-        emit error(this->Socket->error());
+    if (this->Disconnected == false || this->PendingRPCs)
         return;
-    }
-
-    connect(this->Socket, &QTcpSocket::readyRead,
-            this,         &clsClientThread::slotReadyRead, Qt::DirectConnection);
-    connect(this->Socket, &QTcpSocket::disconnected,
-            this, &clsClientThread::slotDisconnected);
-
-    TargomanLogInfo(5, QString("New Configuration Admin from %1:%2 with id=%3 connected").arg(
-                        this->Socket->peerAddress().toString()).arg(
-                        this->Socket->peerPort()).arg(this->SocketDescriptor));
-
-    this->exec();
+    emit this->sigClosed();
+    this->deleteLater();
 }
 
-void clsClientThread::sendError(enuReturnType::Type _type, const QString& _message)
+void clsClientConnection::sendError(enuReturnType::Type _type, const QString& _message)
 {
     QString Message =
             JSONConversationProtocol::prepareError("", "", _type, _message);
@@ -346,11 +505,14 @@ void clsClientThread::sendError(enuReturnType::Type _type, const QString& _messa
                   this->ActorName<<"@"<<
                   this->Socket->peerAddress().toString()<<":"<<
                   this->Socket->peerPort()<<"]: "<<Message);
+    this->ReadBuffer.clear();
+    this->ScannedBytes = 0;
+    this->NestingDepth = 0;
+    this->InString = false;
     this->Socket->disconnectFromHost();
-    this->Socket->waitForDisconnected();
 }
 
-void clsClientThread::sendResult(const QString &_data)
+void clsClientConnection::sendResult(const QString &_data)
 {
     this->Socket->write(_data.toUtf8());
     TargomanDebug(9, "SentTo["<<
@@ -359,6 +521,44 @@ void clsClientThread::sendResult(const QString &_data)
                   this->Socket->peerPort()<<"]: "<<_data);
 }
 
+/******************************************************************************/
+
+void clsRPCTask::run()
+{
+    QString Response;
+    // Connection is kept alive until this task reports back so its flag outlives the RPC
+    intfRPCExporter::setCancellationFlag(&this->Connection->ClientGone);
+    try{
+        stuRPCOutput Return =
+                RPCRegistry::instance().getRPCObject(this->Request.Name).invoke(this->Request.Args);
+
+        Response = JSONConversationProtocol::prepareResult(this->Request.CallBack,
+                                                           this->Request.CallUID,
+                                                           Return.DirectResult.toString(),
+                                                           Return.IndirectResult);
+    }catch(exRPCReg &e){
+        Response = JSONConversationProtocol::prepareError(this->Request.CallBack,
+                                                          this->Request.CallUID,
+                                                          enuReturnType::ObjectNotFound,
+                                                          e.what());
+    }catch(exTargomanBase &e){
+        Response = JSONConversationProtocol::prepareError(this->Request.CallBack,
+                                                          this->Request.CallUID,
+                                                          enuReturnType::InvalidData,
+                                                          e.what());
+    }catch(...){
+        Response = JSONConversationProtocol::prepareError(this->Request.CallBack,
+                                                          this->Request.CallUID,
+                                                          enuReturnType::Unknown,
+                                                          "FATAL unknown error");
+    }
+
+    intfRPCExporter::setCancellationFlag(NULL);
+    this->RPCsInPool.deref();
+    QMetaObject::invokeMethod(this->Connection, "slotRPCFinished", Qt::QueuedConnection,
+                              Q_ARG(QString, Response));
+}
+
 }
 }
 }
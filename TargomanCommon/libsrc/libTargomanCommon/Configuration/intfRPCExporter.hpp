@@ -27,6 +27,7 @@
 
 #include <QObject>
 #include <QVariantMap>
+#include <QAtomicInt>
 #include "libTargomanCommon/Types.h"
 
 namespace Targoman {
@@ -66,6 +67,13 @@ public:
      * This method must be called in subclasses constructor
      */
     void exportMyRPCs();
+
+    /**
+     * @brief cancellationFlag returns a flag which is set when client of the RPC running on current thread
+     * disconnects, so that long running RPCs can abandon their work. It is NULL when there is no such client.
+     */
+    static const QAtomicInt* cancellationFlag();
+    static void setCancellationFlag(const QAtomicInt* _flag);
 };
 
 }
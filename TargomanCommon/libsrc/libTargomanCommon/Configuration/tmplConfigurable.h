@@ -146,7 +146,11 @@ public:
         return this->CrossValidator(*this, _errorMessage);
     }
 
-    inline itmplType_t  value() const{ /*TODO Thread Safe*/ return this->Value;}
+    /**
+     * @brief Value may be changed at runtime while it is read. Values which must be consistent with each other must be
+     * read through ConfigManager::readConsistently()
+     */
+    inline itmplType_t  value() const{ return this->Value;}
 
     virtual QString typeString() const{
         return getTypeStr(this->Value);
@@ -31,50 +31,6 @@
 namespace Targoman {
 namespace Common{
 
-QString JSONConversationProtocol::variantMap2JSONObject(const QVariantMap& _map)
-{
-    QString JSONObject = "{";
-
-    for (QVariantMap::ConstIterator MapIter = _map.constBegin();
-         MapIter != _map.constEnd();
-         MapIter++)
-    {
-        if (MapIter.value().type() == QVariant::Map)
-            JSONObject+= "\"" + MapIter.key() + "\":" + variantMap2JSONObject(MapIter.value().toMap());
-        else if (MapIter.value().type() == QVariant::List)
-            JSONObject+="\"" + MapIter.key() + "\":" + variantList2JSONArray(MapIter.value().toList());
-        else
-            JSONObject+="\"" + MapIter.key() + "\":" + variant2Json(MapIter.value());
-
-        if (MapIter + 1 != _map.constEnd())
-            JSONObject+=",";
-    }
-
-    return JSONObject + "}";
-}
-
-QString JSONConversationProtocol::variantList2JSONArray(const QVariantList& _list)
-{
-    QString JSONArray = "[";
-
-    for (QVariantList::ConstIterator ListIter = _list.constBegin();
-         ListIter != _list.constEnd();
-         ListIter++)
-    {
-        if (ListIter->type() == QVariant::Map)
-            JSONArray += variantMap2JSONObject(ListIter->toMap());
-        if (ListIter->type() == QVariant::List)
-            JSONArray += variantList2JSONArray(ListIter->toList());
-        else
-            JSONArray += variant2Json(*ListIter);
-
-        if (ListIter + 1 != _list.constEnd())
-            JSONArray+=",";
-    }
-
-    return JSONArray + "]";
-}
-
 QString JSONConversationProtocol::prepareError(const QString& _callBack,
                                                const QString& _callString,
                                                enuReturnType::Type _type,
@@ -153,7 +109,7 @@ QString JSONConversationProtocol::prepareResult(const QString &_callBack,
 
     ReturnStr+="\"r\":[";
 
-    ReturnStr += variant2Json(_result);
+    appendJSON(ReturnStr, _result);
 
     if (_args.size())
     {
@@ -164,7 +120,7 @@ QString JSONConversationProtocol::prepareResult(const QString &_callBack,
              )
         {
             ReturnStr += "\"" + ArgIter.key() + "\":";
-            ReturnStr += variant2Json(ArgIter.value());
+            appendJSON(ReturnStr, ArgIter.value());
             ReturnStr += ((ArgIter + 1 != _args.constEnd()) ? "," : "");
         }
         ReturnStr+="}";
@@ -309,22 +265,56 @@ JSONConversationProtocol::stuResponse JSONConversationProtocol::parseResponse(co
 
 QString JSONConversationProtocol::variant2Json(const QVariant& _var)
 {
+    QString JSON;
+    appendJSON(JSON, _var);
+    return JSON;
+}
+
+/**
+ * @brief JSONConversationProtocol::appendJSONString appends _str as a quoted JSON string to _json
+ */
+void JSONConversationProtocol::appendJSONString(QString &_json, const QString &_str)
+{
+    _json.reserve(_json.size() + _str.size() + 2);
+    _json.append('"');
+    foreach(const QChar& Char, _str){
+        if (Char == '"')
+            _json.append("\\\"");
+        else if (Char == '\n')
+            _json.append("\\n");
+        else
+            _json.append(Char);
+    }
+    _json.append('"');
+}
+
+/**
+ * @brief JSONConversationProtocol::appendJSON serializes _var at the end of _json. Nested lists and maps are
+ * serialized in place so no intermediate string is built for them.
+ */
+void JSONConversationProtocol::appendJSON(QString &_json, const QVariant &_var)
+{
+    if (_var.userType() == qMetaTypeId<stuJSONFragment>()){
+        _json.append(_var.value<stuJSONFragment>().JSON);
+        return;
+    }
+
     switch(_var.type())
     {
     case QVariant::Bool:
     case QVariant::Int:
     case QVariant::LongLong:
-        return QString::number(_var.toLongLong());
-        break;
+        _json.append(QString::number(_var.toLongLong()));
+        return;
 
     case QVariant::Double:
-        return QString::number(_var.toReal());
-        break;
+        _json.append(QString::number(_var.toReal()));
+        return;
 
     case QVariant::UInt:
     case QVariant::ULongLong:
-        return QString::number(_var.toULongLong());
-        break;
+        _json.append(QString::number(_var.toULongLong()));
+        return;
 
     case QVariant::String:
     case QVariant::Char:
@@ -332,22 +322,42 @@ QString JSONConversationProtocol::variant2Json(const QVariant& _var)
     case QVariant::DateTime:
     case QVariant::Time:
     case QVariant::Url:
-        return "\"" + _var.toString().replace("\"", "\\\"").replace("\n","\\n") + "\"";
-        break;
-
-    case QVariant::List:
-        return variantList2JSONArray(_var.toList());
-        break;
-
-    case QVariant::Map:
-        return variantMap2JSONObject(_var.toMap());
-        break;
+        appendJSONString(_json, _var.toString());
+        return;
+
+    case QVariant::List:{
+        const QVariantList List = _var.toList();
+        _json.append('[');
+        for (QVariantList::ConstIterator ListIter = List.constBegin();
+             ListIter != List.constEnd();
+             ListIter++){
+            if (ListIter != List.constBegin())
+                _json.append(',');
+            appendJSON(_json, *ListIter);
+        }
+        _json.append(']');
+        return;
+    }
 
+    case QVariant::Map:{
+        const QVariantMap Map = _var.toMap();
+        _json.append('{');
+        for (QVariantMap::ConstIterator MapIter = Map.constBegin();
+             MapIter != Map.constEnd();
+             MapIter++){
+            if (MapIter != Map.constBegin())
+                _json.append(',');
+            _json.append('"').append(MapIter.key()).append("\":");
+            appendJSON(_json, MapIter.value());
+        }
+        _json.append('}');
+        return;
+    }
 
     default:
         Q_ASSERT_X(false, "Formating Response to JSON", "Invalid Object Item unconvertible to String");
     }
-    return "!!!!ERROR!!!!";
+    _json.append("!!!!ERROR!!!!");
 }
 }
 }
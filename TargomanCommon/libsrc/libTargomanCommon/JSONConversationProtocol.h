@@ -36,9 +36,41 @@ namespace Common{
 
 TARGOMAN_ADD_EXCEPTION_HANDLER(exJSONConversationProtocol, Targoman::Common::exTargomanBase);
 
+/**
+ * @brief A value already serialized to JSON. When stored in a QVariant it is written to the wire as is, so large
+ * results can be built incrementally instead of going through nested QVariantLists.
+ */
+struct stuJSONFragment{
+    QString JSON;
+    stuJSONFragment(const QString& _json = "null") : JSON(_json) {}
+};
+
 class JSONConversationProtocol
 {
 public:
+    /**
+     * @brief Builds a JSON array by serializing each item in place as it is appended.
+     */
+    class clsArrayBuilder{
+    public:
+        clsArrayBuilder() : ItemsCount(0) {
+            this->JSON = "[";
+        }
+
+        inline void append(const QVariant& _item){
+            if (this->ItemsCount++)
+                this->JSON.append(',');
+            JSONConversationProtocol::appendJSON(this->JSON, _item);
+        }
+
+        inline int size() const {return this->ItemsCount;}
+        inline stuJSONFragment toFragment() const {return stuJSONFragment(this->JSON + ']');}
+
+    private:
+        QString JSON;
+        int     ItemsCount;
+    };
+
     struct stuRequest
     {
         QString      Name;
@@ -106,13 +138,17 @@ public:
     static stuRequest parseRequest(const QByteArray &_request);
     static stuResponse parseResponse(const QByteArray &_request);
 
+    static void appendJSON(QString& _json, const QVariant& _var);
+    static void appendJSONString(QString& _json, const QString& _str);
+
 protected:
-    static QString variantMap2JSONObject(const QVariantMap& _map);
-    static QString variantList2JSONArray(const QVariantList& _map);
     static QString variant2Json(const QVariant& _var);
 };
 
 
 }
 }
+
+Q_DECLARE_METATYPE(Targoman::Common::stuJSONFragment)
+
 #endif // TARGOMAN_COMMON_JSONCONVERSATIONPROTOCOL_H
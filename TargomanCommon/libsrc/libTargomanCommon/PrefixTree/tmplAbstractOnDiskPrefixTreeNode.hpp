@@ -101,11 +101,11 @@ public:
      * @return        returns node of child if it is already loaded else loads it  from file .
      */
     virtual pNode_t follow(itmplKey_t _key) {
-        auto Iterator = this->Data->Children.find(_key);
-        if(Iterator == this->Data->Children.end())
+        pNode_t Child = this->Data->Children.value(_key);
+        if(Child.data() == NULL)
             return loadChildFromDisk(_key);
         else
-            return *Iterator;
+            return Child;
     }
 
     itmplData_t& getData() {
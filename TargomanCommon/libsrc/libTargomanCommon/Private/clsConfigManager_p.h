@@ -27,6 +27,8 @@
 #define TARGOMAN_COMMON_CONFIGURATION_PRIVATE_CLSCONFIGURATION_P_H
 
 #include <QHash>
+#include <QAtomicInt>
+#include <QReadWriteLock>
 #include <QVariant>
 #include "Configuration/ConfigManager.h"
 #include "intfConfigManagerOverNet.hpp"
@@ -108,6 +110,18 @@ public:
 
     bool SetPathsRelativeToConfigPath;
 
+    /**
+     * @brief Incremented each time a configurable is changed at runtime so that cached results depending on
+     * configuration can be invalidated.
+     */
+    QAtomicInt Revision;
+
+    /**
+     * @brief Held for writing while a configurable is changed at runtime and for reading by
+     * ConfigManager::readConsistently()
+     */
+    QReadWriteLock RuntimeUpdateLock;
+
     ConfigManager& Parent;
     QScopedPointer<intfConfigManagerOverNet> ConfigOverNetServer;
     static Common::Configuration::tmplConfigurable<enuConfigOverNetMode::Type>    ConfigOverNetMode;
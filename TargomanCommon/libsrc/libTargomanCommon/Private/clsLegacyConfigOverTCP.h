@@ -26,10 +26,13 @@
 #define TARGOMAN_COMMON_CONFIGURATION_PRIVATE_CLSLEGACYCONFIGOVERTCP_H
 
 #include <QThread>
+#include <QThreadPool>
+#include <QRunnable>
 #include <QtNetwork/QTcpServer>
 #include <QtNetwork/QTcpSocket>
 #include <QTime>
 #include "Configuration/tmplConfigurable.h"
+#include "JSONConversationProtocol.h"
 #include "clsConfigManager_p.h"
 #include "clsBaseConfigOverNet.h"
 #include "intfConfigManagerOverNet.hpp"
@@ -50,11 +53,17 @@ public:
 };
 
 /******************************************************************************/
+/**
+ * @brief The clsLegacyConfigOverTCPServer class accepts connections and distributes them over a small number of
+ * event loop threads. Each connection is served by a clsClientConnection living on one of these threads while RPCs
+ * are executed on a shared worker pool so slow RPCs neither block other connections nor pin a thread per client.
+ */
 class clsLegacyConfigOverTCPServer : public QTcpServer
 {
     Q_OBJECT
 public:
     clsLegacyConfigOverTCPServer(clsConfigManagerPrivate& _configManager);
+    ~clsLegacyConfigOverTCPServer();
 
 private:
     void incomingConnection(qintptr _socketDescriptor);
@@ -65,32 +74,89 @@ private slots:
 private:
     clsConfigManagerPrivate&          ConfigManagerPrivate;
     quint16                           ConnectedClients;
+    QList<QThread*>                   IOThreads;
+    int                               NextIOThread;
+    QThreadPool                       RPCPool;
+    QAtomicInt                        RPCsInPool;       /**< RPCs queued or running on #RPCPool */
+
+public:
+    static tmplRangedConfigurable<quint8>  IOThreadsCount;
+    static tmplConfigurable<quint16>       MaxConcurrentRPCs;
+    static tmplConfigurable<quint16>       MaxQueuedRPCs;
+    static tmplConfigurable<quint32>       MaxRequestSize;
 };
 
 /******************************************************************************/
-class clsClientThread : public QThread, public clsBaseConfigOverNet
+/**
+ * @brief The clsClientConnection class serves a single client socket on an event loop thread. Incoming data is
+ * buffered and split in complete JSON messages so requests can be of any size and several requests can be in flight
+ * on a connection. Responses of RPCs are sent as soon as they are ready and are matched by clients using call ID.
+ */
+class clsClientConnection : public QObject, public clsBaseConfigOverNet
 {
   Q_OBJECT
 public:
-  clsClientThread(qintptr _socketDescriptor,
-                  clsConfigManagerPrivate& _configManager,
-                  QObject* _parent);
+  clsClientConnection(qintptr _socketDescriptor,
+                      clsConfigManagerPrivate& _configManager,
+                      QThreadPool& _rpcPool,
+                      QAtomicInt& _rpcsInPool);
 
 private:
-  void run();
+  void processRequest(const QByteArray& _request);
   void sendError(enuReturnType::Type _type, const QString& _message);
   void sendResult(const QString &_data);
+  void closeIfIdle();
+
+public slots:
+  void slotStart();
+  void slotRPCFinished(const QString& _response);
 
 private slots:
   void slotReadyRead();
   void slotDisconnected();
 
 signals:
-  void error(QTcpSocket::SocketError socketerror);
+  void sigClosed();
 
 private:
   qintptr                    SocketDescriptor;
   QTcpSocket*                Socket;
+  QThreadPool&               RPCPool;
+  QAtomicInt&                RPCsInPool;
+  QByteArray                 ReadBuffer;        /**< Received bytes not yet consumed as a complete request */
+  int                        ScannedBytes;      /**< Bytes of ReadBuffer already scanned for message boundary */
+  int                        NestingDepth;
+  bool                       InString;
+  bool                       Escaped;
+  quint32                    PendingRPCs;
+  bool                       Disconnected;
+  QAtomicInt                 ClientGone;        /**< Set on disconnection to cancel RPCs running on worker pool */
+
+  friend class clsRPCTask;
+};
+
+/******************************************************************************/
+/**
+ * @brief The clsRPCTask class executes an RPC on the worker pool and hands its response back to the connection
+ * thread.
+ */
+class clsRPCTask : public QRunnable
+{
+public:
+  clsRPCTask(clsClientConnection* _connection,
+             const JSONConversationProtocol::stuRequest& _request,
+             QAtomicInt& _rpcsInPool) :
+      Connection(_connection),
+      Request(_request),
+      RPCsInPool(_rpcsInPool)
+  {}
+
+  void run();
+
+private:
+  clsClientConnection*                  Connection;
+  JSONConversationProtocol::stuRequest  Request;
+  QAtomicInt&                           RPCsInPool;
 };
 
 }
@@ -28,8 +28,8 @@
 #define TARGOMAN_COMMON_TMPLEXPIRABLECACHE_H
 
 #include <QHash>
-#include <QTime>
 #include <QMutex>
+#include <list>
 #include "libTargomanCommon/exTargomanBase.h"
 
 namespace Targoman {
@@ -38,12 +38,19 @@ namespace Common {
 template <template <class itmplKey, class itmplVal> class BaseContainer_t, class itmplKey, class itmplVal, quint32 itmplMaxItems = 10000>
     /**
      * @brief The tmplBoundedCache template is a derivation of Map or Hash class (depending on BaseContainer_t) and
-     *        it is augmented with QHash for AccessDate.
+     *        it is augmented with a least recently used list of keys.
      *
-     * This class removes old items of Cache when itmlMaxItems is reached except when itmplMaxItems is set to zero.
+     * This class removes least recently used items of Cache when itmlMaxItems is reached except when itmplMaxItems is
+     * set to zero. Keys are kept in a linked list ordered by their last access and a QHash points to position of each
+     * key in that list, so accessing and expiring an item are both done in constant time. Base container is inherited
+     * privately so that all accesses go through locked methods which keep access order up to date.
      */
-    class tmplBoundedCache : public BaseContainer_t <itmplKey, itmplVal>
+    class tmplBoundedCache : private BaseContainer_t <itmplKey, itmplVal>
     {
+    private:
+        typedef std::list<itmplKey>                     AccessOrder_t;
+        typedef typename AccessOrder_t::iterator        AccessOrderIterator_t;
+
     public:
 
         tmplBoundedCache(){
@@ -54,55 +61,38 @@ template <template <class itmplKey, class itmplVal> class BaseContainer_t, class
 
         tmplBoundedCache(const tmplBoundedCache& _other):
             BaseContainer_t<itmplKey, itmplVal>(_other),
-            Lock(_other.Lock),
-            KeyAccessDateTime(_other.KeyAccessDateTime),
+            AccessOrder(_other.AccessOrder),
             MaxItems(_other.MaxItems)
-        {}
-
-        typedef typename BaseContainer_t<itmplKey, itmplVal>::iterator   Iterator_t;
+        {
+            for(AccessOrderIterator_t Iter = this->AccessOrder.begin(); Iter != this->AccessOrder.end(); ++Iter)
+                this->AccessPosition.insert(*Iter, Iter);
+        }
 
-        inline Iterator_t insert(itmplKey _key, itmplVal _val){
+        inline void insert(itmplKey _key, itmplVal _val){
             QMutexLocker Locker(&this->Lock);
-            if(this->MaxItems && BaseContainer_t<itmplKey, itmplVal>::size() >= (int)this->MaxItems){
-                QList<QTime> Values = this->KeyAccessDateTime.values();
-                std::nth_element(Values.begin(), Values.begin() + this->MaxItems / 2, Values.end());
-                QList<itmplKey> ExpiredKeys;
-                for(quint32 Index = 0; Index < this->MaxItems / 2; ++Index)
-                        ExpiredKeys.append(this->KeyAccessDateTime.keys(Values.at(Index)));
-
-                foreach(itmplKey Key, ExpiredKeys){
-                    // Do not use this->remove here as it will cause a deadlock
-                    this->KeyAccessDateTime.remove(Key);
-                    BaseContainer_t<itmplKey, itmplVal>::remove(Key);
-                }
-            }
-
-            this->KeyAccessDateTime.insert(_key, QTime::currentTime());
-            return BaseContainer_t<itmplKey, itmplVal>::insert(_key, _val);
+            if (BaseContainer_t<itmplKey, itmplVal>::contains(_key) == false)
+                this->expireFor(1);
+            this->touch(_key);
+            BaseContainer_t<itmplKey, itmplVal>::insert(_key, _val);
         }
 
-        inline Iterator_t insertMulti(itmplKey _key, itmplVal _val){
-            if(this->MaxItems && BaseContainer_t<itmplKey, itmplVal>::size() >= this->MaxItems){
-                QList<QTime> Values = this->KeyAccessDateTime.values();
-                QTime Oldest = Values.first();
-                for(int i = 0; i < Values.size(); ++i)
-                    if(Values.at(i) < Oldest)
-                        Oldest = Values.at(i);
-                QList<itmplKey> ExpiredKeys = this->KeyAccessDateTime.keys(Oldest);
-
-                foreach(itmplKey Key, ExpiredKeys){
-                    this->remove(Key);
-                }
-            }
+        inline void insertMulti(itmplKey _key, itmplVal _val){
+            QMutexLocker Locker(&this->Lock);
+            this->expireFor(1);
+            this->touch(_key);
+            BaseContainer_t<itmplKey, itmplVal>::insertMulti(_key, _val);
+        }
 
-            this->KeyAccessDateTime.insertMulti(_key, QTime::currentTime());
-            return BaseContainer_t<itmplKey, itmplVal>::insertMulti(_key, _val);
+        inline bool contains(const itmplKey& _key){
+            QMutexLocker Locker(&this->Lock);
+            return BaseContainer_t<itmplKey, itmplVal>::contains(_key);
         }
 
         inline void clear(){
             QMutexLocker Locker(&this->Lock);
             BaseContainer_t<itmplKey, itmplVal>::clear();
-            this->KeyAccessDateTime.clear();
+            this->AccessOrder.clear();
+            this->AccessPosition.clear();
         }
 
         inline itmplVal value(const itmplKey& _key,
@@ -113,52 +103,104 @@ template <template <class itmplKey, class itmplVal> class BaseContainer_t, class
                 return _defaultValue;
 
             if (_updateAccessTime)
-                this->KeyAccessDateTime.insert(_key, QTime::currentTime());
+                this->touch(_key);
             return BaseContainer_t<itmplKey, itmplVal>::value(_key);
         }
 
         inline QList<itmplVal> values(const itmplKey& _key,
-                              bool _updateAccessTime = true,
-                              const itmplVal& _defaultValue = itmplVal()){
+                              bool _updateAccessTime = true){
+            QMutexLocker Locker(&this->Lock);
             if (BaseContainer_t<itmplKey, itmplVal>::contains(_key) == false)
-                return _defaultValue;
-
+                return QList<itmplVal>();
 
-            if (_updateAccessTime) {
-                auto Iter = this->KeyAccessDateTime.find(_key);
-                QTime Time = QTime::currentTime();
-                while(Iter != this->KeyAccessDateTime.end() && Iter.key() == _key) {
-                    Iter.value() = Time;
-                    ++Iter;
-                }
-            }
+            if (_updateAccessTime)
+                this->touch(_key);
             return BaseContainer_t<itmplKey, itmplVal>::values(_key);
         }
 
+        /**
+         * @note Items inserted by this operator are tracked but do not cause expiration of other items, as returned
+         * reference must stay valid.
+         */
         inline itmplVal& operator[] ( const itmplKey & _key){
             QMutexLocker Locker(&this->Lock);
-            if (BaseContainer_t<itmplKey, itmplVal>::contains(_key) == false)
-                return  BaseContainer_t<itmplKey, itmplVal>::operator [] (_key);
-
-            QTime AccessTime = QTime::currentTime();
-            this->KeyAccessDateTime.insert(_key, AccessTime);
-
+            this->touch(_key);
             return BaseContainer_t<itmplKey, itmplVal>::operator [] (_key);
         }
 
         inline int remove(const itmplKey& _key){
             QMutexLocker Locker(&this->Lock);
-            this->KeyAccessDateTime.remove(_key);
+            this->forget(_key);
             return BaseContainer_t<itmplKey, itmplVal>::remove(_key);
         }
 
-        void setMaxItems(quint32 _maxItems){ this->MaxItems = _maxItems; }
+        void setMaxItems(quint32 _maxItems){
+            QMutexLocker Locker(&this->Lock);
+            this->MaxItems = _maxItems;
+            this->expireFor(0);
+        }
 
         quint32 maxItems(){ return this->MaxItems; }
 
+        inline int size(){
+            QMutexLocker Locker(&this->Lock);
+            return BaseContainer_t<itmplKey, itmplVal>::size();
+        }
+
+        /**
+         * @brief removes all of the items and sets maximum number of items at once so that no item is inserted
+         * with previous bound in between.
+         */
+        void reset(quint32 _maxItems){
+            QMutexLocker Locker(&this->Lock);
+            BaseContainer_t<itmplKey, itmplVal>::clear();
+            this->AccessOrder.clear();
+            this->AccessPosition.clear();
+            this->MaxItems = _maxItems;
+        }
+
+    private:
+        /**
+         * @brief moves _key to the most recently used end of #AccessOrder. Lock must be held by caller.
+         */
+        inline void touch(const itmplKey& _key){
+            auto PositionIter = this->AccessPosition.find(_key);
+            if (PositionIter == this->AccessPosition.end()){
+                this->AccessOrder.push_back(_key);
+                this->AccessPosition.insert(_key, --this->AccessOrder.end());
+            }else
+                this->AccessOrder.splice(this->AccessOrder.end(), this->AccessOrder, PositionIter.value());
+        }
+
+        inline void forget(const itmplKey& _key){
+            auto PositionIter = this->AccessPosition.find(_key);
+            if (PositionIter == this->AccessPosition.end())
+                return;
+            this->AccessOrder.erase(PositionIter.value());
+            this->AccessPosition.erase(PositionIter);
+        }
+
+        /**
+         * @brief removes least recently used keys until _count new items can be added without exceeding #MaxItems.
+         * Lock must be held by caller.
+         */
+        inline void expireFor(quint32 _count){
+            if (this->MaxItems == 0)
+                return;
+            while (this->AccessOrder.empty() == false &&
+                   (quint32)BaseContainer_t<itmplKey, itmplVal>::size() + _count > this->MaxItems){
+                const itmplKey& Key = this->AccessOrder.front();
+                // Do not use this->remove here as it will cause a deadlock
+                BaseContainer_t<itmplKey, itmplVal>::remove(Key);
+                this->AccessPosition.remove(Key);
+                this->AccessOrder.pop_front();
+            }
+        }
+
     private:
-        QMutex                       Lock;
-        QHash<itmplKey, QTime >      KeyAccessDateTime;
+        QMutex                                      Lock;
+        AccessOrder_t                               AccessOrder;        /**< Keys ordered from least to most recently used */
+        QHash<itmplKey, AccessOrderIterator_t>      AccessPosition;     /**< Position of each key in #AccessOrder */
 
         quint32 MaxItems;
     };
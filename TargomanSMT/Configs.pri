@@ -26,6 +26,8 @@ if($$ProjectName) {
 message("===========================>$$ProjectName<===========================")
 VERSION=0.1.0
 
+QT+=concurrent
+
 # +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-#
 ProjectDependencies+=TargomanCommon \
                      TargomanTextProcessor \
@@ -0,0 +1,119 @@
+/******************************************************************************
+ * Targoman: A robust Statistical Machine Translation framework               *
+ *                                                                            *
+ * Copyright 2014-2015 by ITRC <http://itrc.ac.ir>                            *
+ *                                                                            *
+ * This file is part of Targoman.                                             *
+ *                                                                            *
+ * Targoman is free software: you can redistribute it and/or modify           *
+ * it under the terms of the GNU Lesser General Public License as published   *
+ * by the Free Software Foundation, either version 3 of the License, or       *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * Targoman is distributed in the hope that it will be useful,                *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * GNU Lesser General Public License for more details.                        *
+ * You should have received a copy of the GNU Lesser General Public License   *
+ * along with Targoman. If not, see <http://www.gnu.org/licenses/>.           *
+ *                                                                            *
+ ******************************************************************************/
+/**
+ * @author S. Mohammad M. Ziabary <ziabary@targoman.com>
+ * @author Behrooz Vedadian <vedadian@targoman.com>
+ * @author Saeed Torabzadeh <saeed.torabzadeh@targoman.com>
+ */
+
+#include <cmath>
+#include "DecoderSettings.h"
+#include "libTargomanCommon/Configuration/ConfigManager.h"
+#include "SearchGraphBuilder/clsSearchGraph.h"
+#include "SearchGraphBuilder/clsCardinality.h"
+#include "SearchGraphBuilder/clsLexicalHypothesis.h"
+#include "N-BestFinder/NBestPaths.h"
+#include "N-BestFinder/NBestSuggestions.h"
+#include "FeatureFunctions/WeightProfiles.h"
+
+namespace Targoman {
+namespace SMT {
+namespace Private {
+
+using namespace Common::Configuration;
+using namespace SearchGraphBuilder;
+using namespace NBestFinder;
+using namespace FeatureFunction;
+
+QSharedPointer<const stuDecoderSettings> DecoderSettings::Published;
+QMutex DecoderSettings::PublishLock;
+thread_local const stuDecoderSettings* DecoderSettings::Active = NULL;
+
+/**
+ * @brief DecoderSettings::capture returns snapshot of current configuration revision. Snapshot is built just once
+ * per revision, while runtime configuration updates are blocked, and is shared by all of the threads.
+ */
+QSharedPointer<const stuDecoderSettings> DecoderSettings::capture()
+{
+    quint32 Revision = ConfigManager::instance().revision();
+    QMutexLocker Locker(&DecoderSettings::PublishLock);
+    if (DecoderSettings::Published.isNull() == false && DecoderSettings::Published->Revision == Revision)
+        return DecoderSettings::Published;
+
+    QSharedPointer<stuDecoderSettings> Settings(new stuDecoderSettings);
+    ConfigManager::instance().readConsistently([&Settings] () {
+        Settings->Revision = ConfigManager::instance().revision();
+
+        Settings->WorkingMode = gConfigs.WorkingMode.value();
+        Settings->ProfiledWeights = WeightProfiles::resolveWeights();
+
+        Settings->HardReorderingJumpLimit = clsSearchGraph::HardReorderingJumpLimit.value();
+        Settings->ReorderingConstraintMaximumRuns = clsSearchGraph::ReorderingConstraintMaximumRuns.value();
+        Settings->DoComputePositionSpecificRestCosts = clsSearchGraph::DoComputePositionSpecificRestCosts.value();
+        Settings->DoPrunePreInsertion = clsSearchGraph::DoPrunePreInsertion.value();
+        Settings->UseCubePruning = (clsSearchGraph::SearchMode.value() == enuSearchMode::CubePruning);
+        Settings->CubePruningPopLimit = clsSearchGraph::CubePruningPopLimit.value();
+        Settings->MaxTargetPhraseCount = clsPhraseCandidateCollectionData::MaxTargetPhraseCount.value();
+
+        Settings->MaxCardinalityContainerSize = clsCardinalityHypothesisContainer::MaxCardinalityContainerSize.value();
+        Settings->PrimaryCoverageShare = clsCardinalityHypothesisContainer::PrimaryCoverageShare.value();
+        Settings->LogSearchBeamWidth = log(clsCardinalityHypothesisContainer::SearchBeamWidth.value());
+        Settings->KeepRecombined = clsLexicalHypothesisContainer::KeepRecombined.value();
+
+        Settings->NBestPathCount = NBestPaths::NBestPathCount.value();
+        Settings->OnlyDistinctPaths = NBestPaths::OnlyDistinctPaths.value();
+        Settings->NBestExpansionFactor = NBestPaths::NBestExpansionFactor.value();
+        Settings->MaxSuggestions = NBestSuggestions::MaxSuggestions.value();
+    });
+
+    Settings->MaxCardinalitySizeLazyPruning = 2 * Settings->MaxCardinalityContainerSize - 1;
+    if (Settings->PrimaryCoverageShare != 0)
+        Settings->MaxCardinalitySizeLazyPruning +=
+                static_cast<size_t>(Settings->PrimaryCoverageShare) << Settings->HardReorderingJumpLimit;
+
+    DecoderSettings::Published = Settings;
+    return DecoderSettings::Published;
+}
+
+/**
+ * @brief DecoderSettings::invalidate forces next capture to build a new snapshot. It must be called when
+ * configurables are set directly instead of through ConfigManager, as done in unit tests.
+ */
+void DecoderSettings::invalidate()
+{
+    QMutexLocker Locker(&DecoderSettings::PublishLock);
+    DecoderSettings::Published.clear();
+}
+
+/**
+ * @brief DecoderSettings::latest is used when decoder is called out of a clsDecoderSettingsScope, so it captures
+ * settings on each call. Returned reference is valid until next call on the same thread.
+ */
+const stuDecoderSettings& DecoderSettings::latest()
+{
+    static thread_local QSharedPointer<const stuDecoderSettings> Latest;
+    Latest = DecoderSettings::capture();
+    return *Latest;
+}
+
+}
+}
+}
@@ -0,0 +1,127 @@
+/******************************************************************************
+ * Targoman: A robust Statistical Machine Translation framework               *
+ *                                                                            *
+ * Copyright 2014-2015 by ITRC <http://itrc.ac.ir>                            *
+ *                                                                            *
+ * This file is part of Targoman.                                             *
+ *                                                                            *
+ * Targoman is free software: you can redistribute it and/or modify           *
+ * it under the terms of the GNU Lesser General Public License as published   *
+ * by the Free Software Foundation, either version 3 of the License, or       *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * Targoman is distributed in the hope that it will be useful,                *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * GNU Lesser General Public License for more details.                        *
+ * You should have received a copy of the GNU Lesser General Public License   *
+ * along with Targoman. If not, see <http://www.gnu.org/licenses/>.           *
+ *                                                                            *
+ ******************************************************************************/
+/**
+ * @author S. Mohammad M. Ziabary <ziabary@targoman.com>
+ * @author Behrooz Vedadian <vedadian@targoman.com>
+ * @author Saeed Torabzadeh <saeed.torabzadeh@targoman.com>
+ */
+
+#ifndef TARGOMAN_CORE_PRIVATE_DECODERSETTINGS_H
+#define TARGOMAN_CORE_PRIVATE_DECODERSETTINGS_H
+
+#include <QSharedPointer>
+#include <QMutex>
+#include <QVector>
+#include "libTargomanCommon/Types.h"
+#include "Private/GlobalConfigs.h"
+
+namespace Targoman {
+namespace SMT {
+namespace Private {
+
+/**
+ * @brief Values of configurables read by the decoder while searching. All of them are taken from the same
+ * configuration revision and are never changed after the snapshot is published. Switches which define layout of
+ * loaded models, such as LexicalReordering/IsBidirectional, are not part of snapshot as they must not be changed
+ * after models are loaded.
+ */
+struct stuDecoderSettings{
+    quint32 Revision;
+
+    enuWorkingModes::Type       WorkingMode;
+    QVector<QVector<double>>    ProfiledWeights;    /**< Value of each clsProfiledWeight on each weight profile */
+
+    quint8  HardReorderingJumpLimit;
+    quint8  ReorderingConstraintMaximumRuns;
+    bool    DoComputePositionSpecificRestCosts;
+    bool    DoPrunePreInsertion;
+    bool    UseCubePruning;
+    quint32 CubePruningPopLimit;
+    quint8  MaxTargetPhraseCount;
+
+    quint16 MaxCardinalityContainerSize;
+    quint8  PrimaryCoverageShare;
+    double  LogSearchBeamWidth;
+    size_t  MaxCardinalitySizeLazyPruning;
+    bool    KeepRecombined;
+
+    int     NBestPathCount;
+    bool    OnlyDistinctPaths;
+    int     NBestExpansionFactor;
+    quint8  MaxSuggestions;
+};
+
+/**
+ * @brief The DecoderSettings class publishes snapshots of decoder settings so that search does not read
+ * configurables which may be changed at runtime by ConfigManager::setValue() or over network. A new snapshot is built
+ * on first capture after configuration revision is changed. Active snapshot is kept per thread and set by
+ * clsDecoderSettingsScope.
+ */
+class DecoderSettings
+{
+public:
+    static QSharedPointer<const stuDecoderSettings> capture();
+    static void invalidate();
+
+    /**
+     * @return Active snapshot of current thread or latest snapshot if no snapshot is activated on this thread.
+     */
+    static inline const stuDecoderSettings& current() {
+        return Q_LIKELY(DecoderSettings::Active) ? *DecoderSettings::Active : DecoderSettings::latest();
+    }
+
+private:
+    static const stuDecoderSettings& latest();
+
+private:
+    static QSharedPointer<const stuDecoderSettings>         Published;
+    static QMutex                                           PublishLock;
+    static thread_local const stuDecoderSettings*           Active;
+
+    friend class clsDecoderSettingsScope;
+};
+
+/**
+ * @brief Captures decoder settings and activates them on current thread for lifetime of this object.
+ */
+class clsDecoderSettingsScope
+{
+public:
+    clsDecoderSettingsScope() :
+        Settings(DecoderSettings::capture()),
+        Previous(DecoderSettings::Active) {
+        DecoderSettings::Active = this->Settings.data();
+    }
+    ~clsDecoderSettingsScope(){
+        DecoderSettings::Active = this->Previous;
+    }
+
+private:
+    QSharedPointer<const stuDecoderSettings>    Settings;
+    const stuDecoderSettings*                   Previous;
+    Q_DISABLE_COPY(clsDecoderSettingsScope)
+};
+
+}
+}
+}
+
+#endif // TARGOMAN_CORE_PRIVATE_DECODERSETTINGS_H
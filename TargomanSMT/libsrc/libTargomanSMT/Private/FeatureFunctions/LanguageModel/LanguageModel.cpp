@@ -45,6 +45,8 @@ Common::Configuration::tmplConfigurable<double>  LanguageModel::ScalingFactor(
         "Scaling factor for language model feature.",
         1.0);
 
+clsProfiledWeight LanguageModel::ProfiledScalingFactor(LanguageModel::ScalingFactor);
+
 /**
  * @brief The clsLanguageModelFeatureData class is a derviation of intfFeatureFunctionData class to store specific
  * data correspond to language model feature funciton. In addition to CostElements data memeber this overloaded class
@@ -74,6 +76,27 @@ public:
     QScopedPointer<intfLMSentenceScorer> SentenceScorer;        /**< An instance of intfLMSentenceScorer to track previous seen words */
 };
 
+/**
+ * @brief The clsLMPhraseCache class stores context independent language model data of a target phrase on its target
+ * rule. Words placed at or after position order - 1 of the phrase have all of their n-gram inside the phrase so their
+ * probabilities and the LM state after the phrase do not depend on the history. Only the first order - 1 words
+ * (the left boundary) must be scored against the history of previous hypothesis. The state after the phrase is kept
+ * as a fixed size history snapshot of the LM proxy instead of a whole sentence scorer.
+ */
+class clsLMPhraseCache : public intfTargetRuleCache {
+public:
+    clsLMPhraseCache() :
+        BoundaryProb(0),
+        InternalProb(0),
+        BoundarySize(0)
+    {}
+
+    LogP_t BoundaryProb;                                        /**< Probability of left boundary words without history */
+    LogP_t InternalProb;                                        /**< Probability of words after the left boundary */
+    size_t BoundarySize;                                        /**< Number of words in left boundary */
+    QByteArray RightHistory;                                    /**< LM history after the phrase, empty when phrase is not longer than boundary */
+};
+
 /**
  * @brief This function computes cost of language model with the help of previous node LM history.
  * @return Returns score of language model for this search graph node.
@@ -90,19 +113,24 @@ Common::Cost_t LanguageModel::scoreSearchGraphNodeAndUpdateFutureHash(clsSearchG
     Data->SentenceScorer->initHistory(*PrevNodeData->SentenceScorer);
     Cost_t Cost = 0.0;
     const clsTargetRule& TargetRule = _newHypothesisNode.targetRule();
-    for(size_t i = 0; i < TargetRule.size(); ++i)
+    const clsLMPhraseCache& PhraseCache = this->phraseCache(TargetRule);
+    for(size_t i = 0; i < PhraseCache.BoundarySize; ++i)
         Cost -= Data->SentenceScorer->wordProb(TargetRule.at(i));
+    if (PhraseCache.RightHistory.isEmpty() == false){
+        Cost -= PhraseCache.InternalProb;
+        Data->SentenceScorer->restoreHistory(PhraseCache.RightHistory.constData());
+    }
 
     if (_newHypothesisNode.isFinal())
         Cost -= Data->SentenceScorer->endOfSentenceProb();
 
     Data->SentenceScorer->updateFutureStateHash(_hash);
 
-    if(gConfigs.WorkingMode.value() != enuWorkingModes::Decode)
+    if(DecoderSettings::current().WorkingMode != enuWorkingModes::Decode)
         Data->CostElements[0] = Cost;
 
     // For compatiblity reasons
-    return Cost * log(10) * LanguageModel::ScalingFactor.value();
+    return Cost * log(10) * LanguageModel::ProfiledScalingFactor.value();
 }
 
 Cost_t LanguageModel::getApproximateCost(unsigned _sourceStart, unsigned _sourceEnd, const InputDecomposer::Sentence_t& _input, const clsTargetRule &_targetRule) const
@@ -110,11 +138,16 @@ Cost_t LanguageModel::getApproximateCost(unsigned _sourceStart, unsigned _source
     Q_UNUSED(_sourceStart)
     Q_UNUSED(_sourceEnd)
     Q_UNUSED(_input)
-    return this->getLanguageModelCost(_targetRule);
+    const clsLMPhraseCache& PhraseCache = this->phraseCache(_targetRule);
+    Cost_t Cost = -(PhraseCache.BoundaryProb + PhraseCache.InternalProb);
+
+    // For compatiblity reasons
+    return Cost * log(10) * LanguageModel::ProfiledScalingFactor.value();
 }
 
 /**
- * @brief Computes language model score for the given target rule
+ * @brief Computes language model score for the given target rule. It is used while loading rule tables so it does not
+ * fill the phrase cache of the rule, which is only worth keeping for rules used in decoding.
  */
 Cost_t LanguageModel::getLanguageModelCost(const RuleTable::clsTargetRule &_targetRule) const
 {
@@ -125,7 +158,34 @@ Cost_t LanguageModel::getLanguageModelCost(const RuleTable::clsTargetRule &_targ
         Cost -= SentenceScorer->wordProb(_targetRule.at(i));
 
     // For compatiblity reasons
-    return Cost * log(10) * LanguageModel::ScalingFactor.value();
+    return Cost * log(10) * LanguageModel::ProfiledScalingFactor.value();
+}
+
+/**
+ * @brief Returns context independent LM data of the target rule, computing and storing it on the rule on first use.
+ */
+const clsLMPhraseCache& LanguageModel::phraseCache(const clsTargetRule &_targetRule) const
+{
+    const intfTargetRuleCache* Cache = _targetRule.cache(this->CacheIndex);
+    if (Q_LIKELY(Cache != NULL))
+        return *static_cast<const clsLMPhraseCache*>(Cache);
+
+    clsLMPhraseCache* PhraseCache = new clsLMPhraseCache;
+    QScopedPointer<intfLMSentenceScorer> SentenceScorer(gConfigs.LM.getInstance<intfLMSentenceScorer>());
+    SentenceScorer->reset(false);
+    PhraseCache->BoundarySize = qMin(_targetRule.size(), (size_t)qMax(SentenceScorer->order() - 1, 0));
+    for(size_t i = 0; i < _targetRule.size(); ++i)
+        if (i < PhraseCache->BoundarySize)
+            PhraseCache->BoundaryProb += SentenceScorer->wordProb(_targetRule.at(i));
+        else
+            PhraseCache->InternalProb += SentenceScorer->wordProb(_targetRule.at(i));
+
+    if (_targetRule.size() > PhraseCache->BoundarySize){
+        PhraseCache->RightHistory.resize(SentenceScorer->historySize());
+        SentenceScorer->saveHistory(PhraseCache->RightHistory.data());
+    }
+
+    return *static_cast<const clsLMPhraseCache*>(_targetRule.setCache(this->CacheIndex, PhraseCache));
 }
 
 /**
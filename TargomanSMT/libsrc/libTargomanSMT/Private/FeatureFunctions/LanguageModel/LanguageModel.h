@@ -36,6 +36,8 @@ namespace FeatureFunction{
 
 TARGOMAN_ADD_EXCEPTION_HANDLER(exLanguageModel, exFeatureFunction);
 
+class clsLMPhraseCache;
+
 
 class LanguageModel : public intfFeatureFunction
 {
@@ -72,8 +74,12 @@ public:
 public:
     Common::Cost_t getLanguageModelCost(const RuleTable::clsTargetRule& _targetRule) const;
 
+private:
+    const clsLMPhraseCache& phraseCache(const RuleTable::clsTargetRule& _targetRule) const;
+
 private:
     static Common::Configuration::tmplConfigurable<double> ScalingFactor;
+    static clsProfiledWeight ProfiledScalingFactor;
 
     TARGOMAN_SMT_DEFINE_FEATUREFUNCTION(LanguageModel, false)
 };
@@ -72,6 +72,15 @@ tmplConfigurable<double>    LexicalReordering::ScalingFactors[] = {
     1)
 };
 
+clsProfiledWeight LexicalReordering::ProfiledScalingFactors[] = {
+    {LexicalReordering::ScalingFactors[0]},
+    {LexicalReordering::ScalingFactors[1]},
+    {LexicalReordering::ScalingFactors[2]},
+    {LexicalReordering::ScalingFactors[3]},
+    {LexicalReordering::ScalingFactors[4]},
+    {LexicalReordering::ScalingFactors[5]}
+};
+
 
 /**
  * @brief The clsLexicalReorderingFeatureData class is a derviation of intfFeatureFunctionData class.
@@ -142,9 +151,9 @@ Common::Cost_t LexicalReordering::scoreSearchGraphNodeAndUpdateFutureHash(
     enuLexicalReorderingFields::Type Orientation = this->getForwardOreientation(_newHypothesisNode);
     Cost_t Cost =
             _newHypothesisNode.prevNode().targetRule().field(this->FieldIndexes.at(Orientation)) *
-            this->ScalingFactors[Orientation].value();
+            this->ProfiledScalingFactors[Orientation].value();
 
-    if(gConfigs.WorkingMode.value() != enuWorkingModes::Decode) {
+    if(DecoderSettings::current().WorkingMode != enuWorkingModes::Decode) {
         Data->CostElements[Orientation] =
                 _newHypothesisNode.prevNode().targetRule().field(this->FieldIndexes.at(Orientation));
     }
@@ -153,8 +162,8 @@ Common::Cost_t LexicalReordering::scoreSearchGraphNodeAndUpdateFutureHash(
         Orientation = getBackwardOreientation(_newHypothesisNode);
         Cost +=
                 _newHypothesisNode.targetRule().field(this->FieldIndexes.at(Orientation)) *
-                this->ScalingFactors[Orientation].value();
-        if(gConfigs.WorkingMode.value() != enuWorkingModes::Decode) {
+                this->ProfiledScalingFactors[Orientation].value();
+        if(DecoderSettings::current().WorkingMode != enuWorkingModes::Decode) {
             Data->CostElements[Orientation] =
                     _newHypothesisNode.targetRule().field(this->FieldIndexes.at(Orientation));
         }
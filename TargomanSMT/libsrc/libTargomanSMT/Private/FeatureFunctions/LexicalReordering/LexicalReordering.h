@@ -89,6 +89,7 @@ private:
 private:
     static Common::Configuration::tmplConfigurable<bool>      IsBidirectional;      /**< Whether our lexical reordering is biderctional or not.*/
     static Common::Configuration::tmplConfigurable<double>    ScalingFactors[6];    /**< Scale factor of lrm costs.*/
+    static clsProfiledWeight                                  ProfiledScalingFactors[6];
 
     TARGOMAN_SMT_DEFINE_FEATUREFUNCTION(LexicalReordering, false)
 };
@@ -41,6 +41,14 @@ tmplConfigurable<double>    OperationSequenceModel::ScalingFactors[] = {
     1)
 };
 
+clsProfiledWeight OperationSequenceModel::ProfiledScalingFactors[] = {
+    {OperationSequenceModel::ScalingFactors[0]},
+    {OperationSequenceModel::ScalingFactors[1]},
+    {OperationSequenceModel::ScalingFactors[2]},
+    {OperationSequenceModel::ScalingFactors[3]},
+    {OperationSequenceModel::ScalingFactors[4]}
+};
+
 tmplConfigurable<FilePath_t> OperationSequenceModel::FilePath(
         MAKE_CONFIG_PATH("FilePath"),
         "OSM model file path. Relative to config file path if not specified as absolute.",
@@ -130,7 +138,7 @@ Common::Cost_t OperationSequenceModel::getApproximateCost(unsigned _sourceStart,
 
     Cost_t Cost = 0;
     for(int i = 0; i < NumberOfFeatures; i++){
-        Cost += (Scores[i] * ScalingFactors[i].value());
+        Cost += (Scores[i] * ProfiledScalingFactors[i].value());
     }
 
     return Cost;
@@ -183,7 +191,7 @@ Common::Cost_t OperationSequenceModel::scoreSearchGraphNodeAndUpdateFutureHash(S
 
     Cost_t Cost = 0;
     for(int i = 0; i < NumberOfFeatures; i++){
-        Cost += (Scores[i] * ScalingFactors[i].value());
+        Cost += (Scores[i] * ProfiledScalingFactors[i].value());
     }
 
     Data->setCostElements(QVector<Cost_t>::fromList(Scores));
@@ -68,10 +68,10 @@ public:
 
     inline QList<double> getScalingFactors() const{
         QList<double> res;
-        res.push_back(this->ScalingFactors[0].value());
+        res.push_back(this->ProfiledScalingFactors[0].value());
         if(this->JustUseOSMProbability.value())
             for(int i = 1; i < 5; i++)
-                res.push_back(this->ScalingFactors[i].value());
+                res.push_back(this->ProfiledScalingFactors[i].value());
         return res;
     }
 
@@ -121,6 +121,7 @@ private:
                                                                                            feature or all the 5 OSM related features:
                                                                                            gapCount, gapWidth, openGapCount, deletionCount.*/
     static Common::Configuration::tmplConfigurable<double>    ScalingFactors[5];       /**< Scale factor of OSM costs.*/
+    static clsProfiledWeight                                  ProfiledScalingFactors[5];
 
     TARGOMAN_SMT_DEFINE_FEATUREFUNCTION(OperationSequenceModel, false)
 
@@ -77,19 +77,31 @@ void PhraseTable::initialize(QSharedPointer<QSettings> _configSettings)
 
     _configSettings->beginGroup(PhraseTable::ScalingFactorsConfigSection.configPath());
 
+    this->ScalingFactors.fill(QList<double>(), WeightProfiles::count());
     foreach(const QString& ColumnName, this->ColumnNames){
         if (_configSettings->value(ColumnName).isValid()){
             bool Ok;
             double ScalingFactor = _configSettings->value(ColumnName).toDouble(&Ok);
             if (!Ok)
                 throw exPhraseTable("Invalid scaling factor defined for column: "+ ColumnName);
-            this->ScalingFactors.append(ScalingFactor);
+            QVector<double> ProfileValues = WeightProfiles::weights(
+                        PhraseTable::ScalingFactorsConfigSection.configPath() + "/" + ColumnName,
+                        ScalingFactor);
+            for (int Profile = 0; Profile < ProfileValues.size(); ++Profile)
+                this->ScalingFactors[Profile].append(ProfileValues.at(Profile));
             this->FieldIndexes.append(
                         RuleTable::clsTargetRule::getColumnIndex(ColumnName, this->moduleName()));
         }else
             throw exPhraseTable("No scaling factor found for column: "+ ColumnName);
     }
     _configSettings->endGroup();
+
+    // Weighted costs are cached on target rules separately for each weight profile. Default profile uses the slot
+    // allocated by base class. This must be done before loading rule table as rules are created with final size.
+    this->PrecomputedIndexes.clear();
+    this->PrecomputedIndexes.append(this->PrecomputedIndex);
+    for (quint16 Profile = 1; Profile < WeightProfiles::count(); ++Profile)
+        this->PrecomputedIndexes.append(RuleTable::clsTargetRule::allocatePrecomputedValue());
 }
 
 /**
@@ -100,7 +112,7 @@ Cost_t PhraseTable::scoreSearchGraphNodeAndUpdateFutureHash(clsSearchGraphNode &
 {
     Q_UNUSED(_hash);
     Q_UNUSED(_input)
-    if(gConfigs.WorkingMode.value() != enuWorkingModes::Decode) {
+    if(DecoderSettings::current().WorkingMode != enuWorkingModes::Decode) {
         clsPhraseTableFeatureData* Data = new clsPhraseTableFeatureData(this->ColumnNames.size());
         _newHypothesisNode.setFeatureFunctionData(this->DataIndex, Data);
         for(int i = 0; i < this->ColumnNames.size(); ++i)
@@ -111,22 +123,42 @@ Cost_t PhraseTable::scoreSearchGraphNodeAndUpdateFutureHash(clsSearchGraphNode &
 }
 
 /**
- * @brief PhraseTable::getPhraseCost Computes target rule cost.
- * This function computes an inner product of target rule costs, corresponding to this feature function, with scale factors of phrase table.
- * This function also stores Computed cost to precomputedValue data of target rule.
+ * @brief PhraseTable::getPhraseCost Returns target rule cost for active weight profile which is precomputed when the
+ * target rule was loaded.
  * @param _targetRule input target rule.
  * @return returns cost of this target rule for this feature (rule table).
  */
 Cost_t PhraseTable::getPhraseCost(const clsTargetRule &_targetRule) const
 {
-    Cost_t Cost = _targetRule.precomputedValue(this->PrecomputedIndex);
-    if (Cost == -INFINITY){
-        Cost = 0;
-        for(int i=0; i< this->FieldIndexes.size(); ++i)
-            Cost += _targetRule.field(this->FieldIndexes.at(i)) * this->ScalingFactors.at(i);
-        static_cast<RuleTable::clsTargetRule>(_targetRule).setPrecomputedValue(
-                this->PrecomputedIndex, Cost);
-    }
+    quint16 Profile = WeightProfiles::active();
+    Cost_t Cost = _targetRule.precomputedValue(this->PrecomputedIndexes.at(Profile));
+    // Target rules are shared between decoder threads so rules which are not precomputed (e.g. the invalid rule)
+    // are scored on the fly and never updated here.
+    if (Q_UNLIKELY(Cost == -INFINITY))
+        return this->computePhraseCost(_targetRule, Profile);
+    return Cost;
+}
+
+/**
+ * @brief PhraseTable::precomputeTargetRule stores cost of the target rule for all of the weight profiles.
+ */
+void PhraseTable::precomputeTargetRule(clsTargetRule &_targetRule) const
+{
+    for (int Profile = 0; Profile < this->PrecomputedIndexes.size(); ++Profile)
+        _targetRule.setPrecomputedValue(this->PrecomputedIndexes.at(Profile),
+                                        this->computePhraseCost(_targetRule, Profile));
+}
+
+/**
+ * @brief PhraseTable::computePhraseCost computes an inner product of target rule costs, corresponding to this feature
+ * function, with scale factors of the weight profile.
+ */
+Cost_t PhraseTable::computePhraseCost(const clsTargetRule &_targetRule, quint16 _profile) const
+{
+    const QList<double>& ProfileScalingFactors = this->ScalingFactors.at(_profile);
+    Cost_t Cost = 0;
+    for(int i=0; i< this->FieldIndexes.size(); ++i)
+        Cost += _targetRule.field(this->FieldIndexes.at(i)) * ProfileScalingFactors.at(i);
     return Cost;
 }
 
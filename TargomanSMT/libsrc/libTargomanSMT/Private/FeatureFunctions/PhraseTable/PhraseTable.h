@@ -71,12 +71,16 @@ public:
         PhraseTable::ColumnNames = _columnNames;}
 
     Common::Cost_t getPhraseCost(const RuleTable::clsTargetRule& _targetRule) const;
+    void precomputeTargetRule(RuleTable::clsTargetRule& _targetRule) const;
 
     void initRootNode(SearchGraphBuilder::clsSearchGraphNode &_rootNode);
 
 private:
+    Common::Cost_t computePhraseCost(const RuleTable::clsTargetRule& _targetRule, quint16 _profile) const;
 
-    QList<double> ScalingFactors;
+private:
+    QVector<QList<double>> ScalingFactors;          /**< Scaling factors of each weight profile */
+    QVector<size_t>        PrecomputedIndexes;      /**< Index of precomputed cost of each weight profile */
     static QStringList   ColumnNames;
 
 private:
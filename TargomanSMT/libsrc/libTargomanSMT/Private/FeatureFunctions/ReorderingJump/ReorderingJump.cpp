@@ -44,6 +44,8 @@ Common::Configuration::tmplRangedConfigurable<double>  ReorderingJump::ScalingFa
         0.00001,100,
         1.0);
 
+clsProfiledWeight ReorderingJump::ProfiledScalingFactor(ReorderingJump::ScalingFactor);
+
 Common::Configuration::tmplRangedConfigurable<quint8>  ReorderingJump::MaximumJumpWidth(
         MAKE_CONFIG_PATH("MaximumJumpWidth"),
         "Maximum jump width.",
@@ -88,10 +90,10 @@ Common::Cost_t ReorderingJump::scoreSearchGraphNodeAndUpdateFutureHash(
 
     Cost_t Cost = ReorderingJump::getJumpCost(JumpWidth);
 
-    if(gConfigs.WorkingMode.value() != enuWorkingModes::Decode)
+    if(DecoderSettings::current().WorkingMode != enuWorkingModes::Decode)
         Data->CostElements[0] = Cost;
 
-    return Cost * ReorderingJump::ScalingFactor.value();
+    return Cost * ReorderingJump::ProfiledScalingFactor.value();
 }
 
 /**
@@ -104,33 +106,34 @@ Common::Cost_t ReorderingJump::scoreSearchGraphNodeAndUpdateFutureHash(
  */
 Cost_t ReorderingJump::getRestCostForPosition(const Coverage_t& _coverage, size_t _beginPos, size_t endPos) const
 {
+    return this->getRestCostForPositionWithGaps(_coverage, coverageGaps(_coverage), _beginPos, endPos);
+}
+
+/**
+ * @brief ReorderingJump::getRestCostForPositionWithGaps same as above but uses precomputed uncovered ranges of coverage.
+ * @param _coverage
+ * @param _gaps uncovered ranges of _coverage
+ * @param _beginPos
+ * @param _endPos
+ * @return
+ */
+Cost_t ReorderingJump::getRestCostForPositionWithGaps(const Coverage_t& _coverage,
+                                                      const CoverageGaps_t& _gaps,
+                                                      size_t _beginPos,
+                                                      size_t _endPos) const
+{
+    Q_UNUSED(_coverage)
     Q_UNUSED(_beginPos)
-    size_t LastPos = endPos - 1;
+    size_t LastPos = _endPos - 1;
 
     Cost_t SumJumpCost = 0.0;
-    bool CurrentPositionCovered = false;
-    bool NextPositionCovered = _coverage.at(0);
-    size_t InputSentenceSize = _coverage.size();
-    size_t JumpWidth = 0;
-
-    size_t Position = 0;
-    for(; Position < InputSentenceSize; ++Position)
-    {
-        bool LastPositionCovered = CurrentPositionCovered;
-        CurrentPositionCovered = NextPositionCovered;
-        NextPositionCovered = (Position + 1 == InputSentenceSize || _coverage.at(Position + 1));
-
-        if( (Position == 0 || LastPositionCovered) && CurrentPositionCovered == 0 ) // finds first zero after a series of ones.
-        {
-            JumpWidth = std::abs((int)(LastPos - Position));
-            SumJumpCost += ReorderingJump::getJumpCost(JumpWidth);
-        }
-
-        if(Position > 0 && CurrentPositionCovered == 0 && NextPositionCovered ) // finds first one after a series of zeros.
-            LastPos = Position + 1;
+    foreach(const stuPos& Gap, _gaps){
+        SumJumpCost += ReorderingJump::getJumpCost(std::abs((int)(LastPos - Gap.start())));
+        if(Gap.end() > 1) // jumps are computed from the first covered position after a series of zeros.
+            LastPos = Gap.end();
     }
     Q_ASSERT(SumJumpCost >= 0);
-    return SumJumpCost * ReorderingJump::ScalingFactor.value();
+    return SumJumpCost * ReorderingJump::ProfiledScalingFactor.value();
 }
 
 
@@ -50,6 +50,10 @@ public:
             QCryptographicHash& _hash) const;
 
     Common::Cost_t getRestCostForPosition(const Coverage_t& _coverage, size_t _beginPos, size_t endPos) const;
+    Common::Cost_t getRestCostForPositionWithGaps(const Coverage_t& _coverage,
+                                                  const CoverageGaps_t& _gaps,
+                                                  size_t _beginPos,
+                                                  size_t _endPos) const;
 
     inline Common::Cost_t getApproximateCost(unsigned _sourceStart,
                                              unsigned _sourceEnd,
@@ -78,6 +82,7 @@ private:
 
 private:
     static Common::Configuration::tmplRangedConfigurable<double> ScalingFactor;
+    static clsProfiledWeight ProfiledScalingFactor;
     //TODO: change name.
     static Common::Configuration::tmplRangedConfigurable<quint8> MaximumJumpWidth;
 
@@ -43,6 +43,8 @@ Common::Configuration::tmplConfigurable<double>  UnknownWordPenalty::ScalingFact
         "Scaling factor for unknown word penalty feature.",
         1.0);
 
+clsProfiledWeight UnknownWordPenalty::ProfiledScalingFactor(UnknownWordPenalty::ScalingFactor);
+
 /**
  * @brief The clsReorderingJumpFeatureData class is a derviation of intfFeatureFunctionData class.
  */
@@ -84,10 +86,10 @@ Common::Cost_t UnknownWordPenalty::scoreSearchGraphNodeAndUpdateFutureHash(clsSe
     if(_newHypothesisNode.targetRule().isUnknownWord())
         Cost = 100;
 
-    if(gConfigs.WorkingMode.value() != enuWorkingModes::Decode)
+    if(DecoderSettings::current().WorkingMode != enuWorkingModes::Decode)
         Data->CostElements[0] = Cost;
 
-    return Cost * UnknownWordPenalty::ScalingFactor.value();
+    return Cost * UnknownWordPenalty::ProfiledScalingFactor.value();
 }
 
 
@@ -75,11 +75,12 @@ public:
         Common::Cost_t Cost = 0;
         if(_targetRule.isUnknownWord())
             Cost = 100;
-        return Cost * UnknownWordPenalty::ScalingFactor.value();
+        return Cost * UnknownWordPenalty::ProfiledScalingFactor.value();
     }
 
 private:
     static Common::Configuration::tmplConfigurable<double> ScalingFactor;
+    static clsProfiledWeight ProfiledScalingFactor;
 
     TARGOMAN_SMT_DEFINE_FEATUREFUNCTION(UnknownWordPenalty, false)
 };
@@ -0,0 +1,167 @@
+/******************************************************************************
+ * Targoman: A robust Statistical Machine Translation framework               *
+ *                                                                            *
+ * Copyright 2014-2015 by ITRC <http://itrc.ac.ir>                            *
+ *                                                                            *
+ * This file is part of Targoman.                                             *
+ *                                                                            *
+ * Targoman is free software: you can redistribute it and/or modify           *
+ * it under the terms of the GNU Lesser General Public License as published   *
+ * by the Free Software Foundation, either version 3 of the License, or       *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * Targoman is distributed in the hope that it will be useful,                *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * GNU Lesser General Public License for more details.                        *
+ * You should have received a copy of the GNU Lesser General Public License   *
+ * along with Targoman. If not, see <http://www.gnu.org/licenses/>.           *
+ *                                                                            *
+ ******************************************************************************/
+/**
+ * @author S. Mohammad M. Ziabary <ziabary@targoman.com>
+ * @author Behrooz Vedadian <vedadian@targoman.com>
+ * @author Saeed Torabzadeh <saeed.torabzadeh@targoman.com>
+ */
+
+#include "WeightProfiles.h"
+
+namespace Targoman {
+namespace SMT {
+namespace Private {
+namespace FeatureFunction{
+
+QList<QPair<QString, QHash<QString, double>>> WeightProfiles::Profiles;
+thread_local quint16 WeightProfiles::Active = 0;
+
+/**
+ * @brief Registry of profiled weights. It is a function static as weights are registered during static
+ * initialization.
+ */
+static QList<clsProfiledWeight*>& registeredWeights(){
+    static QList<clsProfiledWeight*> Weights;
+    return Weights;
+}
+
+static inline QString normalizedPath(const QString& _path){
+    QString Path = _path;
+    while(Path.startsWith('/'))
+        Path.remove(0, 1);
+    return Path;
+}
+
+clsProfiledWeight::clsProfiledWeight(const Common::Configuration::tmplConfigurable<double> &_config) :
+    Config(_config),
+    Index(registeredWeights().size())
+{
+    registeredWeights().append(this);
+}
+
+/**
+ * @brief Loads weight profiles and resolves registered weights against them. Must be called before initialization of
+ * feature functions.
+ * @exception throws exWeightProfiles if a profile defines a weight which is not a registered profiled weight.
+ */
+void WeightProfiles::init(QSharedPointer<QSettings> _configSettings)
+{
+    WeightProfiles::Profiles.clear();
+
+    if (_configSettings.isNull() == false){
+        _configSettings->beginGroup("WeightProfiles");
+        foreach(const QString& ProfileName, _configSettings->childGroups()){
+            _configSettings->beginGroup(ProfileName);
+            QHash<QString, double> Weights;
+            foreach(const QString& Key, _configSettings->allKeys()){
+                bool Ok;
+                double Value = _configSettings->value(Key).toDouble(&Ok);
+                if (!Ok)
+                    throw exWeightProfiles(QString("Invalid weight defined for <%1> in profile <%2>").arg(
+                                               Key).arg(ProfileName));
+                Weights.insert(normalizedPath(Key), Value);
+            }
+            _configSettings->endGroup();
+
+            if (WeightProfiles::Profiles.size() >= 0xFFFE)
+                throw exWeightProfiles("Too many weight profiles defined");
+            WeightProfiles::Profiles.append(qMakePair(ProfileName, Weights));
+            TargomanLogInfo(5, QString("Weight profile <%1> loaded with %2 weights").arg(
+                                ProfileName).arg(Weights.size()));
+        }
+        _configSettings->endGroup();
+    }
+
+    QSet<QString> RegisteredPaths;
+    foreach(clsProfiledWeight* Weight, registeredWeights()){
+        QString Path = normalizedPath(Weight->Config.configPath());
+        RegisteredPaths.insert(Path);
+        Weight->ProfileValues.fill(0, WeightProfiles::count());
+        Weight->Overridden.fill(false, WeightProfiles::count());
+        for(int i = 0; i < WeightProfiles::Profiles.size(); ++i){
+            auto WeightIter = WeightProfiles::Profiles.at(i).second.constFind(Path);
+            if (WeightIter != WeightProfiles::Profiles.at(i).second.constEnd()){
+                Weight->ProfileValues[i + 1] = WeightIter.value();
+                Weight->Overridden.setBit(i + 1);
+            }
+        }
+    }
+
+    // Keys consumed by no weight are most probably misspelled paths which would silently use process wide values
+    for(int i = 0; i < WeightProfiles::Profiles.size(); ++i)
+        foreach(const QString& Key, WeightProfiles::Profiles.at(i).second.keys())
+            if (RegisteredPaths.contains(Key) == false)
+                throw exWeightProfiles(QString("Weight <%1> in profile <%2> does not match any profiled weight").arg(
+                                           Key).arg(WeightProfiles::Profiles.at(i).first));
+
+    // Snapshots built before must be rebuilt as they do not cover new profiles
+    DecoderSettings::invalidate();
+}
+
+quint16 WeightProfiles::indexOf(const QString &_name)
+{
+    if (_name.isEmpty())
+        return 0;
+    for(int i = 0; i < WeightProfiles::Profiles.size(); ++i)
+        if (WeightProfiles::Profiles.at(i).first == _name)
+            return i + 1;
+    throw exWeightProfiles("Weight profile <" + _name + "> is not defined");
+}
+
+QStringList WeightProfiles::names()
+{
+    QStringList Names;
+    for(int i = 0; i < WeightProfiles::Profiles.size(); ++i)
+        Names.append(WeightProfiles::Profiles.at(i).first);
+    return Names;
+}
+
+/**
+ * @brief Resolves value of each registered weight on each profile. It is called while building decoder settings
+ * snapshot.
+ */
+QVector<QVector<double>> WeightProfiles::resolveWeights()
+{
+    QVector<QVector<double>> Weights;
+    Weights.reserve(registeredWeights().size());
+    foreach(const clsProfiledWeight* Weight, registeredWeights()){
+        QVector<double> Values(WeightProfiles::count(), Weight->Config.value());
+        for(int Profile = 1; Profile < Weight->Overridden.size() && Profile < Values.size(); ++Profile)
+            if (Weight->Overridden.testBit(Profile))
+                Values[Profile] = Weight->ProfileValues.at(Profile);
+        Weights.append(Values);
+    }
+    return Weights;
+}
+
+QVector<double> WeightProfiles::weights(const QString &_configPath, double _defaultValue)
+{
+    QString Path = normalizedPath(_configPath);
+    QVector<double> Values(WeightProfiles::count(), _defaultValue);
+    for(int i = 0; i < WeightProfiles::Profiles.size(); ++i)
+        Values[i + 1] = WeightProfiles::Profiles.at(i).second.value(Path, _defaultValue);
+    return Values;
+}
+
+}
+}
+}
+}
@@ -0,0 +1,135 @@
+/******************************************************************************
+ * Targoman: A robust Statistical Machine Translation framework               *
+ *                                                                            *
+ * Copyright 2014-2015 by ITRC <http://itrc.ac.ir>                            *
+ *                                                                            *
+ * This file is part of Targoman.                                             *
+ *                                                                            *
+ * Targoman is free software: you can redistribute it and/or modify           *
+ * it under the terms of the GNU Lesser General Public License as published   *
+ * by the Free Software Foundation, either version 3 of the License, or       *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * Targoman is distributed in the hope that it will be useful,                *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * GNU Lesser General Public License for more details.                        *
+ * You should have received a copy of the GNU Lesser General Public License   *
+ * along with Targoman. If not, see <http://www.gnu.org/licenses/>.           *
+ *                                                                            *
+ ******************************************************************************/
+/**
+ * @author S. Mohammad M. Ziabary <ziabary@targoman.com>
+ * @author Behrooz Vedadian <vedadian@targoman.com>
+ * @author Saeed Torabzadeh <saeed.torabzadeh@targoman.com>
+ */
+
+#ifndef TARGOMAN_CORE_PRIVATE_FEATUREFUNCTIONS_WEIGHTPROFILES_H
+#define TARGOMAN_CORE_PRIVATE_FEATUREFUNCTIONS_WEIGHTPROFILES_H
+
+#include <QSettings>
+#include <QVector>
+#include <QBitArray>
+#include <QSet>
+#include "libTargomanCommon/Configuration/tmplConfigurable.h"
+#include "libTargomanSMT/Types.h"
+#include "Private/DecoderSettings.h"
+
+namespace Targoman {
+namespace SMT {
+namespace Private {
+namespace FeatureFunction{
+
+TARGOMAN_ADD_EXCEPTION_HANDLER(exWeightProfiles, exTargomanCore);
+
+/**
+ * @brief The WeightProfiles class holds named sets of feature function weights which can be selected per translation
+ * request so that a single set of loaded models serves differently tuned configurations. Profiles are defined in
+ * config file as:
+ * @code
+ * [WeightProfiles]
+ * <ProfileName>\<ConfigPath of scaling factor>=<Value>
+ * @endcode
+ * Each key must be config path of a profiled scaling factor, otherwise init() fails. Weights not mentioned in a
+ * profile fall back to the process wide value. Profile 0 is the default profile which always reflects process wide
+ * configuration. Active profile is kept per thread and set by clsWeightProfileScope.
+ */
+class WeightProfiles
+{
+public:
+    static void init(QSharedPointer<QSettings> _configSettings);
+
+    /**
+     * @return index of the named profile. Empty name means default profile.
+     * @exception throws exWeightProfiles if profile is not defined
+     */
+    static quint16 indexOf(const QString& _name);
+    static QStringList names();
+    static inline quint16 count() { return WeightProfiles::Profiles.size() + 1; }
+    static inline quint16 active() { return WeightProfiles::Active; }
+
+    /**
+     * @return Value of the weight on each profile. Value of index 0 (default profile) is _defaultValue.
+     */
+    static QVector<double> weights(const QString& _configPath, double _defaultValue);
+
+private:
+    static QVector<QVector<double>> resolveWeights();
+
+private:
+    static QList<QPair<QString, QHash<QString, double>>>    Profiles;
+    static thread_local quint16                             Active;
+
+    friend class clsWeightProfileScope;
+    friend class Private::DecoderSettings;
+};
+
+/**
+ * @brief Activates a weight profile on current thread for lifetime of this object.
+ */
+class clsWeightProfileScope
+{
+public:
+    clsWeightProfileScope(quint16 _profile) :
+        Previous(WeightProfiles::Active) {
+        WeightProfiles::Active = _profile;
+    }
+    ~clsWeightProfileScope(){
+        WeightProfiles::Active = this->Previous;
+    }
+
+private:
+    quint16 Previous;
+    Q_DISABLE_COPY(clsWeightProfileScope)
+};
+
+/**
+ * @brief A scaling factor configurable resolved against the active weight profile. Values are read from the active
+ * decoder settings snapshot, where weights not overridden by a profile follow the configurable so that updates over
+ * network keep taking effect.
+ */
+class clsProfiledWeight
+{
+public:
+    clsProfiledWeight(const Common::Configuration::tmplConfigurable<double>& _config);
+
+    inline double value() const {
+        return DecoderSettings::current().ProfiledWeights.at(this->Index).at(WeightProfiles::active());
+    }
+
+private:
+    const Common::Configuration::tmplConfigurable<double>&  Config;
+    int                                                     Index;          /**< Index in decoder settings */
+    QVector<double>                                         ProfileValues;
+    QBitArray                                               Overridden;     /**< Profiles which define this weight */
+
+    friend class WeightProfiles;
+    Q_DISABLE_COPY(clsProfiledWeight)
+};
+
+}
+}
+}
+}
+
+#endif // TARGOMAN_CORE_PRIVATE_FEATUREFUNCTIONS_WEIGHTPROFILES_H
@@ -43,6 +43,8 @@ Common::Configuration::tmplConfigurable<double>  WordPenalty::ScalingFactor(
         "Scaling factor for word penalty feature.",
         1.0);
 
+clsProfiledWeight WordPenalty::ProfiledScalingFactor(WordPenalty::ScalingFactor);
+
 /**
  * @brief The clsReorderingJumpFeatureData class is a derviation of intfFeatureFunctionData class.
  */
@@ -79,10 +81,10 @@ Common::Cost_t WordPenalty::scoreSearchGraphNodeAndUpdateFutureHash(clsSearchGra
 
     Cost_t Cost = (Cost_t)_newHypothesisNode.targetRule().size();
 
-    if(gConfigs.WorkingMode.value() != enuWorkingModes::Decode)
+    if(DecoderSettings::current().WorkingMode != enuWorkingModes::Decode)
         Data->CostElements[0] = Cost;
 
-    return Cost * WordPenalty::ScalingFactor.value();
+    return Cost * WordPenalty::ProfiledScalingFactor.value();
 }
 
 
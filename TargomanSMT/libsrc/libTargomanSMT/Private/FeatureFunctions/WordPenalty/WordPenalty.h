@@ -72,11 +72,12 @@ public:
 
 public:
     inline Common::Cost_t getWordPenaltyCost(const RuleTable::clsTargetRule& _targetRule) const {
-        return _targetRule.size() * WordPenalty::ScalingFactor.value();
+        return _targetRule.size() * WordPenalty::ProfiledScalingFactor.value();
     }
 
 private:
     static Common::Configuration::tmplConfigurable<double> ScalingFactor;
+    static clsProfiledWeight ProfiledScalingFactor;
 
     TARGOMAN_SMT_DEFINE_FEATUREFUNCTION(WordPenalty, false)
 };
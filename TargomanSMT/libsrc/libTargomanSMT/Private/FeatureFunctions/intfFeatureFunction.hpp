@@ -31,6 +31,7 @@
 #include "libTargomanCommon/Configuration/intfConfigurableModule.hpp"
 #include "libTargomanSMT/Types.h"
 #include "Private/SearchGraphBuilder/clsSearchGraphNode.h"
+#include "Private/FeatureFunctions/WeightProfiles.h"
 
 namespace Targoman{
 namespace SMT {
@@ -64,6 +65,7 @@ public:
         this->Name = _moduleName.split("/").back();
         this->CanComputePositionSpecificRestCost = _canComputePositionSpecificRestCost;
         this->PrecomputedIndex = RuleTable::clsTargetRule::allocatePrecomputedValue();
+        this->CacheIndex = RuleTable::clsTargetRule::allocateCache();
         this->DataIndex =  SearchGraphBuilder::clsSearchGraphNode::allocateFeatureFunctionData();
     }
 
@@ -125,6 +127,18 @@ public:
      */
     virtual Common::Cost_t getRestCostForPosition(const Coverage_t& _coverage, size_t _beginPos, size_t endPos) const = 0;
 
+    /**
+     * @brief Same as getRestCostForPosition() but uncovered ranges of the coverage are also provided so feature
+     * functions which depend on them do not need to rescan the coverage. Default implementation ignores them.
+     */
+    virtual Common::Cost_t getRestCostForPositionWithGaps(const Coverage_t& _coverage,
+                                                          const CoverageGaps_t& _gaps,
+                                                          size_t _beginPos,
+                                                          size_t _endPos) const {
+        Q_UNUSED(_gaps)
+        return this->getRestCostForPosition(_coverage, _beginPos, _endPos);
+    }
+
      /**
       * @brief Computes approximate cost to the future cost heuristic
       * @note Either getRestCostForPosition or this function must return 0
@@ -141,6 +155,29 @@ public:
      */
     virtual void initRootNode(SearchGraphBuilder::clsSearchGraphNode &_rootNode) = 0;
 
+    /**
+     * @brief Stores values which this feature function needs on every use of a target rule in precomputed values of
+     * the target rule. It is called once for each target rule before the rule is shared with decoders so that target
+     * rules are read-only while decoding. Default implementation does nothing.
+     */
+    virtual void precomputeTargetRule(RuleTable::clsTargetRule& _targetRule) const {
+        Q_UNUSED(_targetRule)
+    }
+
+    /**
+     * @brief Calls precomputeTargetRule() of all active feature functions on the target rule.
+     * @note Target rule must not be used by any other thread meanwhile.
+     */
+    static void precomputeForAllFeatures(RuleTable::clsTargetRule& _targetRule){
+        foreach (intfFeatureFunction* FF, gConfigs.ActiveFeatureFunctions)
+            FF->precomputeTargetRule(_targetRule);
+    }
+
+    static void precomputeForAllFeatures(RuleTable::TargetRulesContainer_t& _targetRules){
+        for (RuleTable::clsTargetRule& TargetRule : _targetRules)
+            intfFeatureFunction::precomputeForAllFeatures(TargetRule);
+    }
+
     /**
      * @return Returns string list of features' names.
      */
@@ -163,6 +200,7 @@ protected:
     bool                    CanComputePositionSpecificRestCost;         /**<  Whether this feature function can compute rest cost based on position or not.*/
     QVector<size_t>         FieldIndexes;                               /**<  List of indices correspond to this feature function in rule table.*/
     size_t                  PrecomputedIndex;                           /**<  Precomputed values of this feature function should be stored in this index of precomputedValues of targetRule.*/
+    size_t                  CacheIndex;                                 /**<  Per rule data cached by this feature function should be stored in this slot of caches of targetRule.*/
     size_t                  DataIndex;                                  /**<  Each feature function has a field in FeatureFunctionsData data of clsSearchGraphNode class. Index of This feature is stored in this data member. */
 };
 
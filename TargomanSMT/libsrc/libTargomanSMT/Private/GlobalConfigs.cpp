@@ -115,7 +115,7 @@ tmplModuleConfig<RuleTable::intfRuleTable>         stuGlobalConfigs::RuleTable(
 QScopedPointer<Targoman::SMT::Private::Proxies::LanguageModel::intfLMSentenceScorer>
     stuGlobalConfigs::EmptyLMScorer;
 
-QHash<QString, Common::WordIndex_t>
+clsSourceVocab
     stuGlobalConfigs::SourceVocab;
 
 QSet<QString>
@@ -33,6 +33,7 @@
 #include "Translator.h"
 #include "libTargomanCommon/Types.h"
 #include "Private/PrivateTypes.h"
+#include "Private/clsSourceVocab.h"
 
 namespace Targoman {
 namespace SMT {
@@ -73,7 +74,7 @@ struct stuGlobalConfigs{
 
     static QScopedPointer<SMT::Private::Proxies::LanguageModel::intfLMSentenceScorer>      EmptyLMScorer;
 // There is no transliteration for anything but Statistical Machine Translation!
-    static QHash<QString, Common::WordIndex_t>                              SourceVocab;
+    static clsSourceVocab                                                   SourceVocab;
     static QSet<QString>                                                    VocabWithoutSingleWordRule;
     static QMap<QString, FeatureFunction::intfFeatureFunction*>             ActiveFeatureFunctions;
     static QString moduleName(){return "Common";}
@@ -89,7 +89,10 @@ clsInput::clsInput(const QString &_inputStr, bool _isIXML)
         NER->tagNamedEntities(this->TokenInfoList);
     }
 #endif
+    OOVHandler::instance().prepareForSentence(this->TokenInfoList);
     this->makeSentence();
+    if (this->TokenSpans.size() != this->Tokens.size())
+        this->TokenSpans.clear();
 }
 /**
  * @brief clsInput::init This function inserts userdefined and default tags to #SpecialTags.
@@ -128,7 +131,11 @@ void clsInput::parsePlain(const QString &_inputStr)
     this->parseRichIXML(
                 TargomanTextProcessor::instance().text2IXML(_inputStr,
                                                             SpellCorrectorChanges,
-                                                            gConfigs.SourceLanguage.value(), 0, false), false);
+                                                            gConfigs.SourceLanguage.value(), 0, false,
+                                                            true,
+                                                            QList<Targoman::NLPLibs::enuTextTags::Type>(),
+                                                            QList<Targoman::NLPLibs::stuIXMLReplacement>(),
+                                                            &this->TokenSpans), false);
 }
 
 
@@ -363,7 +370,7 @@ void clsInput::makeSentence()
         if (WordIndexes.isEmpty()){
             WordIndex_t WordIndex = gConfigs.SourceVocab.value(
                         TokenInfo.Str, Constants::SrcVocabUnkWordIndex);
-            if (WordIndex == Constants::SrcVocabUnkWordIndex || gConfigs.VocabWithoutSingleWordRule.contains(TokenInfo.Str)){
+            if (OOVHandler::isOOV(TokenInfo.Str, WordIndex)){
                 WordIndexes = OOVHandler::instance().getWordIndexOptions(TokenInfo.Str, TokenInfo.Attrs);
 
                 bool wordIdxFound = false, repeatedWordIdx = false;
@@ -371,15 +378,11 @@ void clsInput::makeSentence()
                     if(w == WordIndex)
                         repeatedWordIdx = true;
                     if(gConfigs.VocabWithoutSingleWordRule.contains(
-                                gConfigs.SourceVocab.key(w)))
+                                gConfigs.SourceVocab.word(w)))
                         wordIdxFound = true;
                 }
                 if (WordIndexes.isEmpty() || wordIdxFound){
-                    RuleTable::TargetRulesContainer_t TargetRules = OOVHandler::instance().gatherTemporaryTargetRules(TokenInfo.Str, TokenInfo.Attrs);
-                    if (TargetRules.size()){
-                        TokenInfo.TemporaryRuleNode.detachInvalidData();
-                        TokenInfo.TemporaryRuleNode.targetRules().append(TargetRules);
-                    }
+                    TokenInfo.TemporaryRuleNode = OOVHandler::instance().getTemporaryRuleNode(TokenInfo.Str, TokenInfo.Attrs);
                     if (TokenInfo.Attrs.value(enuDefaultAttrs::toStr(enuDefaultAttrs::NoDecode)).isValid())
                         return; // OOVHandler says that I must ignore this word when decoding
                 }
@@ -76,6 +76,7 @@ public:
 public:
     inline const Sentence_t& tokens() const {return this->Tokens;}
     inline const QString& normalizedString() const {return this->NormalizedString;}
+    inline const QList<stuPos>& tokenSpans() const {return this->TokenSpans;}
 
 
 private:
@@ -96,6 +97,7 @@ private:
     QList<clsToken::stuInfo>     TokenInfoList;
     static QSet<QString>    SpecialTags;                                                /**< List of valid tags. */
     QString                 NormalizedString;                                           /**< Normalized String when using plain text */
+    QList<stuPos>           TokenSpans;                                                 /**< Span of each token in input string when using plain text */
 
     //Configuration
     static Targoman::Common::Configuration::tmplConfigurable<QString> UserDefinedTags;  /**< Users can add their defined iXML tags to list of valid tags (#SpecialTags). */
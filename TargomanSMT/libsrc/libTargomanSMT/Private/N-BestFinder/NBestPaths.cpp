@@ -158,9 +158,9 @@ NBestPaths::Container_t NBestPaths::retrieve(const SearchGraphBuilder::clsSearch
 
     NBestPaths::Container_t Storage;
 
-    int N = NBestPaths::NBestPathCount.value();
-    bool OnlyDistinct = NBestPaths::OnlyDistinctPaths.value();
-    int ExpansionFactor = NBestPaths::NBestExpansionFactor.value();    /// nbest-factor defines stopping point for distinct n-best list if too many candidates identical
+    int N = DecoderSettings::current().NBestPathCount;
+    bool OnlyDistinct = DecoderSettings::current().OnlyDistinctPaths;
+    int ExpansionFactor = DecoderSettings::current().NBestExpansionFactor;    /// nbest-factor defines stopping point for distinct n-best list if too many candidates identical
 
     if (ExpansionFactor == 0)
         ExpansionFactor = 1000; /// 0 = unlimited
@@ -182,6 +182,9 @@ NBestPaths::Container_t NBestPaths::retrieve(const SearchGraphBuilder::clsSearch
 
     int Iteration = 0;
     while(BestPathsCollection.getSize() > 0 && Storage.size() < N && (Iteration < N * ExpansionFactor)) {
+        // Out of time budget: return what has been found so far
+        if (Storage.size() && _searchGraph.deadline().isExpired())
+            break;
         clsTrellisPath Path = BestPathsCollection.pop();
         if(OnlyDistinct) {
             QString t = _outputComposer.pathTranslation(Path.getNodes());
@@ -163,6 +163,7 @@ private:
     }
 
     friend class UnitTestNameSpace::clsUnitTest;
+    friend class Targoman::SMT::Private::DecoderSettings;
 };
 
 inline Common::Cost_t clsTrellisPath::getTotalCost() const{
@@ -87,7 +87,7 @@ size_t NBestSuggestions::fillBestOptions(NBestSuggestions::Container_t& _storage
             if (Node.targetRule().isSame(_currNode.targetRule()) == false)
                 TargetRules.append(Node.targetRule());
 
-        if (TargetRules.size() >= NBestSuggestions::MaxSuggestions.value())
+        if (TargetRules.size() >= DecoderSettings::current().MaxSuggestions)
             break;
     }
 
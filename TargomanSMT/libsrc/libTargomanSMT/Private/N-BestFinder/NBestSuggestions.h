@@ -70,6 +70,7 @@ private:
 private:
     static Common::Configuration::tmplRangedConfigurable<quint8> MaxSuggestions;
     friend class UnitTestNameSpace::clsUnitTest;
+    friend class Targoman::SMT::Private::DecoderSettings;
 
 };
 
@@ -60,6 +60,7 @@ stuTranslationOutput clsOutputComposer::justBestTranslation()
 {
     stuTranslationOutput Output;
     Output.TaggedSource = this->InputDecomposerRef.normalizedString();
+    Output.SourceTokenSpans = this->InputDecomposerRef.tokenSpans();
     Output.Translations.append(this->nodeTranslation(this->SearchGraphRef.goalNode()));
     return Output;
 }
@@ -96,6 +97,7 @@ stuTranslationOutput clsOutputComposer::nBestTranslations()
     stuTranslationOutput Output;
 
     Output.TaggedSource = this->InputDecomposerRef.normalizedString();
+    Output.SourceTokenSpans = this->InputDecomposerRef.tokenSpans();
 
     NBestPaths::Container_t NBestPaths =
             NBestPaths::retrieve(this->SearchGraphRef, *this);
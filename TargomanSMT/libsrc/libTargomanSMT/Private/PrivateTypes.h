@@ -28,6 +28,7 @@
 #define TARGOMAN_CORE_PRIVATE_TYPES_H
 
 #include <QBitArray>
+#include <QVector>
 #include "Types.h"
 #include <QTextStream>
 
@@ -36,6 +37,48 @@ namespace SMT {
 namespace Private {
 
 typedef QBitArray Coverage_t;
+typedef QVector<stuPos> CoverageGaps_t; /**< Uncovered ranges of a coverage sorted by their position */
+
+/**
+ * @brief Finds all ranges of contiguous uncovered words by scanning the whole coverage
+ */
+inline CoverageGaps_t coverageGaps(const Coverage_t& _coverage)
+{
+    CoverageGaps_t Gaps;
+    int GapStart = -1;
+    for(int i = 0; i < _coverage.size(); ++i)
+        if(_coverage.testBit(i) == false){
+            if(GapStart < 0)
+                GapStart = i;
+        }else if(GapStart >= 0){
+            Gaps.append(stuPos(GapStart, i));
+            GapStart = -1;
+        }
+    if(GapStart >= 0)
+        Gaps.append(stuPos(GapStart, _coverage.size()));
+    return Gaps;
+}
+
+/**
+ * @brief Updates gap list of a coverage when range [_beginPos, _endPos) which lies in one of its gaps is covered.
+ */
+inline CoverageGaps_t coverGapRange(const CoverageGaps_t& _gaps, size_t _beginPos, size_t _endPos)
+{
+    CoverageGaps_t Gaps;
+    Gaps.reserve(_gaps.size() + 1);
+    foreach(const stuPos& Gap, _gaps){
+        if(Gap.end() <= _beginPos || Gap.start() >= _endPos){
+            Gaps.append(Gap);
+            continue;
+        }
+        Q_ASSERT(Gap.start() <= _beginPos && Gap.end() >= _endPos);
+        if(Gap.start() < _beginPos)
+            Gaps.append(stuPos(Gap.first, _beginPos));
+        if(Gap.end() > _endPos)
+            Gaps.append(stuPos(_endPos, Gap.second));
+    }
+    return Gaps;
+}
 
 inline QTextStream& operator << (QTextStream& _outputStream, const Coverage_t& _coverage)
 {
@@ -24,6 +24,7 @@
  */
 
 #include "clsKenLMProxy.h"
+#include "libKenLM/lm/binary_format.hh"
 #include "libTargomanCommon/Configuration/Validators.hpp"
 #include "Private/GlobalConfigs.h"
 
@@ -48,7 +49,14 @@ tmplConfigurable<FilePath_t> clsKenLMProxy::FilePath(
             enuPathAccess::File | enuPathAccess::Readable)
         );
 
-QScopedPointer<lm::ngram::ProbingModel> clsKenLMProxy::LM;
+tmplConfigurable<enuKenLMLoadMethod::Type> clsKenLMProxy::LoadMethod(
+        MAKE_CONFIG_PATH("LoadMethod"),
+        "How binary models are loaded in memory (" + enuKenLMLoadMethod::options().join("|") + "). "
+        "Lazy gives fastest startup at the cost of slower first queries",
+        enuKenLMLoadMethod::toStr(enuKenLMLoadMethod::PopulateOrRead),
+        ReturnTrueCrossValidator());
+
+QScopedPointer<lm::base::Model> clsKenLMProxy::LM;
 
 clsKenLMProxy::clsVocabEnumerator clsKenLMProxy::Vocab;
 
@@ -59,15 +67,69 @@ TARGOMAN_REGISTER_MODULE(clsKenLMProxy);
  */
 clsKenLMProxy::clsKenLMProxy() {
     if(clsKenLMProxy::LM.data())
-        this->State = clsKenLMProxy::LM->BeginSentenceState();
+        this->reset(true);
 }
 
 clsKenLMProxy::~clsKenLMProxy()
 {
 }
 
+/**
+ * @brief Initializes language model based on configuration values (which may come from config file or argument of program).
+ * Type of binary models (probing, trie, quantized and/or array compressed trie) is detected from file header and
+ * ARPA files are loaded as probing models.
+ */
+void clsKenLMProxy::init(bool _justVocab)
+{
+    Q_UNUSED(_justVocab);
+    QByteArray FilePath = clsKenLMProxy::FilePath.value().toUtf8();
+
+    lm::ngram::ModelType ModelType = lm::ngram::PROBING;
+    bool IsBinary = lm::ngram::RecognizeBinary(FilePath.constData(), ModelType);
+
+    lm::ngram::Config Config;
+    switch(clsKenLMProxy::LoadMethod.value()){
+    case enuKenLMLoadMethod::Lazy:              Config.load_method = util::LAZY; break;
+    case enuKenLMLoadMethod::Populate:          Config.load_method = util::POPULATE_OR_LAZY; break;
+    case enuKenLMLoadMethod::Read:              Config.load_method = util::READ; break;
+    case enuKenLMLoadMethod::PopulateOrRead:
+    default:                                    Config.load_method = util::POPULATE_OR_READ; break;
+    }
+    clsKenLMProxy::Vocab.clear();
+    Config.enumerate_vocab = &clsKenLMProxy::Vocab;
+
+    TargomanLogInfo(5,"Initializing KenLM from " + clsKenLMProxy::FilePath.value() +
+                    (IsBinary ? QString(" (binary type %1)").arg((int)ModelType) : QString(" (ARPA)")));
+
+    switch(ModelType){
+    case lm::ngram::PROBING:
+        clsKenLMProxy::LM.reset(new lm::ngram::ProbingModel(FilePath.constData(), Config));
+        break;
+    case lm::ngram::REST_PROBING:
+        clsKenLMProxy::LM.reset(new lm::ngram::RestProbingModel(FilePath.constData(), Config));
+        break;
+    case lm::ngram::TRIE:
+        clsKenLMProxy::LM.reset(new lm::ngram::TrieModel(FilePath.constData(), Config));
+        break;
+    case lm::ngram::QUANT_TRIE:
+        clsKenLMProxy::LM.reset(new lm::ngram::QuantTrieModel(FilePath.constData(), Config));
+        break;
+    case lm::ngram::ARRAY_TRIE:
+        clsKenLMProxy::LM.reset(new lm::ngram::ArrayTrieModel(FilePath.constData(), Config));
+        break;
+    case lm::ngram::QUANT_ARRAY_TRIE:
+        clsKenLMProxy::LM.reset(new lm::ngram::QuantArrayTrieModel(FilePath.constData(), Config));
+        break;
+    default:
+        throw exTargomanCore(QString("Unsupported KenLM binary type: %1").arg((int)ModelType));
+    }
+    this->UnknownWordIndex = clsKenLMProxy::LM->BaseVocabulary().NotFound();
 }
+
 }
 }
 }
 }
+}
+
+ENUM_CONFIGURABLE_IMPL(Targoman::SMT::Private::Proxies::LanguageModel::enuKenLMLoadMethod)
@@ -30,6 +30,7 @@
 
 #include "Private/Proxies/LanguageModel/intfLMSentenceScorer.hpp"
 #include "libTargomanCommon/Configuration/intfConfigurable.hpp"
+#include "libTargomanCommon/Configuration/tmplConfigurable.h"
 #include "libKenLM/lm/model.hh"
 
 namespace Targoman {
@@ -38,28 +39,57 @@ namespace Private {
 namespace Proxies {
 namespace LanguageModel{
 
+/**
+ * @brief How KenLM binary files are loaded in memory. Lazy just maps the file so startup is fast and pages are read
+ * on demand, Populate maps and prefetches the whole file, PopulateOrRead does the same when possible otherwise reads
+ * the file in memory and Read always reads the file in allocated memory.
+ */
+TARGOMAN_DEFINE_ENHANCED_ENUM(enuKenLMLoadMethod,
+                              Lazy,
+                              Populate,
+                              PopulateOrRead,
+                              Read
+                              );
+
 /**
  * @brief This class is a proxy for using sentenceScorer class.
  */
 class clsKenLMProxy : public intfLMSentenceScorer
 {
 private:
+    /**
+     * @brief Stores words of LM vocabulary compactly as UTF-8 in a single buffer so that they can be retrieved by
+     * index. Lookup of index by word is done by vocabulary of the model itself.
+     */
     class clsVocabEnumerator : public lm::EnumerateVocab {
       public:
         virtual ~clsVocabEnumerator() { }
         void Add(lm::WordIndex _index, const StringPiece &_str) {
-            this->DirectVocab.insert(
-                        QString::fromUtf8(_str.data(), _str.length()),
-                        _index
-                        );
-            this->ReverseVocab.insert(
-                        _index,
-                        QString::fromUtf8(_str.data(), _str.length())
-                        );
+            if (_index >= (lm::WordIndex)this->Offsets.size()){
+                this->Offsets.resize(_index + 1);
+                this->Lengths.resize(_index + 1);
+            }
+            this->Offsets[_index] = this->Words.size();
+            this->Lengths[_index] = _str.length();
+            this->Words.append(_str.data(), _str.length());
         }
 
-        QHash<QString, Common::WordIndex_t> DirectVocab;
-        QMap<Common::WordIndex_t, QString> ReverseVocab;
+        void clear(){
+            this->Words.clear();
+            this->Offsets.clear();
+            this->Lengths.clear();
+        }
+
+        inline QString word(Common::WordIndex_t _index) const{
+            if (_index >= (Common::WordIndex_t)this->Offsets.size())
+                return QString();
+            return QString::fromUtf8(this->Words.constData() + this->Offsets.at(_index), this->Lengths.at(_index));
+        }
+
+      private:
+        QByteArray          Words;
+        QVector<quint32>    Offsets;
+        QVector<quint32>    Lengths;
     };
 
 public:
@@ -72,30 +102,12 @@ public:
      */
     inline void reset(bool _withStartOfSentence){
         if(_withStartOfSentence)
-            this->State = clsKenLMProxy::LM->BeginSentenceState();
+            this->State = *static_cast<const lm::ngram::State*>(clsKenLMProxy::LM->BeginSentenceMemory());
         else
-            this->State = clsKenLMProxy::LM->NullContextState();
+            this->State = *static_cast<const lm::ngram::State*>(clsKenLMProxy::LM->NullContextMemory());
     }
 
-    /**
-     * @brief Initializes language model based on configuration values (which may come from config file or argument of program).
-     */
-
-    void init(bool _justVocab){
-        Q_UNUSED(_justVocab);
-        TargomanLogInfo(5,"Initializing KenLM from " + clsKenLMProxy::FilePath.value());
-        lm::ngram::Config Config;
-        clsKenLMProxy::Vocab.DirectVocab.clear();
-        clsKenLMProxy::Vocab.ReverseVocab.clear();
-        Config.enumerate_vocab = &clsKenLMProxy::Vocab;
-        clsKenLMProxy::LM.reset(
-                    new lm::ngram::ProbingModel(
-                            clsKenLMProxy::FilePath.value().toUtf8().constData(),
-                            Config
-                        )
-                    );
-        this->UnknownWordIndex = clsKenLMProxy::LM->GetVocabulary().NotFound();
-    }
+    void init(bool _justVocab);
 
     /**
      * @brief returns probablity of a given word index using previous words.
@@ -105,7 +117,7 @@ public:
 
     inline Common::LogP_t wordProb(const Common::WordIndex_t& _wordIndex) {
         lm::ngram::State Dummy = this->State;
-        return clsKenLMProxy::LM->FullScore(Dummy, _wordIndex, this->State).prob;
+        return clsKenLMProxy::LM->FullScore(&Dummy, _wordIndex, &this->State).prob;
     }
 
     /**
@@ -115,9 +127,9 @@ public:
     inline Common::LogP_t endOfSentenceProb(){
         lm::ngram::State Dummy = this->State;
         return clsKenLMProxy::LM->FullScore(
-                                            Dummy,
-                                            clsKenLMProxy::LM->GetVocabulary().EndSentence(),
-                                            this->State
+                                            &Dummy,
+                                            clsKenLMProxy::LM->BaseVocabulary().EndSentence(),
+                                            &this->State
                                             ).prob;
     }
     /**
@@ -127,7 +139,8 @@ public:
      */
 
     inline Common::WordIndex_t getWordIndex(const QString& _word){
-        return clsKenLMProxy::Vocab.DirectVocab[_word];
+        QByteArray Word = _word.toUtf8();
+        return clsKenLMProxy::LM->BaseVocabulary().Index(StringPiece(Word.constData(), Word.size()));
     }
 
     /**
@@ -136,17 +149,33 @@ public:
      * @return
      */
     inline QString getWordByIndex(Common::WordIndex_t _wordIndex){
-        return clsKenLMProxy::Vocab.ReverseVocab[_wordIndex];
+        return clsKenLMProxy::Vocab.word(_wordIndex);
     }
 
     /**
      * @brief Initializes history of language model with history of input sentence scorer.
      * @param _oldScorer input sentence scorer.
      */
+    inline quint8 order() const{
+        return clsKenLMProxy::LM->Order();
+    }
+
     inline void initHistory(const intfLMSentenceScorer& _oldScorer){
         this->State = dynamic_cast<const clsKenLMProxy&>(_oldScorer).State;
     }
 
+    inline size_t historySize() const{
+        return sizeof(lm::ngram::State);
+    }
+
+    inline void saveHistory(char* _buffer) const{
+        std::memcpy(_buffer, &this->State, sizeof(lm::ngram::State));
+    }
+
+    inline void restoreHistory(const char* _buffer){
+        std::memcpy(&this->State, _buffer, sizeof(lm::ngram::State));
+    }
+
     /**
      * @brief checks wethere our sentence scorer and input scorer have same history list or not.
      * @param _oldScorer input sentence scorer.
@@ -172,9 +201,10 @@ public:
 private:
     lm::ngram::State State;
 
-    static QScopedPointer<lm::ngram::ProbingModel> LM;
+    static QScopedPointer<lm::base::Model> LM;
     static clsVocabEnumerator Vocab;
     static Targoman::Common::Configuration::tmplConfigurable<FilePath_t> FilePath;
+    static Targoman::Common::Configuration::tmplConfigurable<enuKenLMLoadMethod::Type> LoadMethod;
 
     TARGOMAN_DEFINE_MODULE(KenLMProxy);
 };
@@ -185,4 +215,6 @@ private:
 }
 }
 
+ENUM_CONFIGURABLE(SMT::Private::Proxies::LanguageModel::enuKenLMLoadMethod)
+
 #endif // TARGOMAN_CORE_PRIVATE_PROXIES_LANGUAGEMODEL_CLSKENLMProxy_HPP
@@ -100,6 +100,8 @@ public:
      */
     inline QString getWordByIndex(Common::WordIndex_t _wordIndex){return this->LM.getWordByID(_wordIndex);}
 
+    inline quint8 order() const{return clsTargomanLMProxy::LM.order();}
+
     /**
      * @brief Initializes history of language model with history of input sentence scorer.
      * @param _oldScorer input sentence scorer.
@@ -108,6 +110,10 @@ public:
         this->LMSentenceScorer->initHistory(*(dynamic_cast<const clsTargomanLMProxy&>(_oldScorer).LMSentenceScorer));
     }
 
+    inline size_t historySize() const{return this->LMSentenceScorer->historySize();}
+    inline void saveHistory(char* _buffer) const{this->LMSentenceScorer->saveHistory(_buffer);}
+    inline void restoreHistory(const char* _buffer){this->LMSentenceScorer->restoreHistory(_buffer);}
+
     /**
      * @brief checks wethere our sentence scorer and input scorer have same history list or not.
      * @param _oldScorer input sentence scorer.
@@ -61,6 +61,24 @@ public:
     virtual QString getWordByIndex(Common::WordIndex_t _wordIndex) = 0;
     virtual int compareHistoryWith(const intfLMSentenceScorer& _otherScorer) const = 0;
     virtual void updateFutureStateHash(QCryptographicHash& _hash) const = 0;
+    /**
+     * @brief Order of the loaded model. Words of a phrase placed at or after order - 1 are scored independent of the
+     * history before the phrase.
+     */
+    virtual quint8 order() const = 0;
+    /**
+     * @brief Size in bytes of history snapshots written by saveHistory. It is fixed for the loaded model.
+     */
+    virtual size_t historySize() const = 0;
+    /**
+     * @brief Writes a snapshot of history to _buffer which must have room for historySize() bytes, so that history
+     * can be kept without keeping the scorer itself.
+     */
+    virtual void saveHistory(char* _buffer) const = 0;
+    /**
+     * @brief Replaces history with a snapshot written by saveHistory.
+     */
+    virtual void restoreHistory(const char* _buffer) = 0;
 
 protected:
     Common::WordIndex_t UnknownWordIndex;
@@ -26,6 +26,10 @@
 // There is no NER for anything but Statistical Machine Translation!
 #ifndef SMT
 
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <algorithm>
 #include "ZhangMaxEntProxy.h"
 
 namespace Targoman {
@@ -50,21 +54,35 @@ tmplConfigurable<FilePath_t> ZhangMaxEntProxy::RareWordsPath(
         "Path to the file containing rare words. Relative to config file path unless specified as absolute path.",
         ""
         );
-maxent::MaxentModel ZhangMaxEntProxy::Model;
+tmplRangedConfigurable<quint8> ZhangMaxEntProxy::BeamSize(
+        MAKE_CONFIG_PATH("BeamSize"),
+        "Number of tag sequences kept while tagging a sentence. 1 means greedy left to right tagging",
+        1, 32,
+        1
+        );
 bool ZhangMaxEntProxy::ModelLoaded = false;
-QStringList ZhangMaxEntProxy::RareWords;
+QSet<QString> ZhangMaxEntProxy::RareWords;
+QHash<QString, ZhangMaxEntProxy::FeatureID_t> ZhangMaxEntProxy::FeatureIDs;
+QVector<quint32> ZhangMaxEntProxy::ParamOffsets;
+QVector<quint16> ZhangMaxEntProxy::ParamOutcomes;
+QVector<double> ZhangMaxEntProxy::ParamWeights;
+QStringList ZhangMaxEntProxy::Outcomes;
+QVector<ZhangMaxEntProxy::FeatureID_t> ZhangMaxEntProxy::PrevTagFeatures;
+QVector<ZhangMaxEntProxy::FeatureID_t> ZhangMaxEntProxy::PrevTagBigramFeatures;
+
+static const QString BOUNDARY_TAG = "BOUNDARY";
 
 ZhangMaxEntProxy::ZhangMaxEntProxy()
 { }
 
-QStringList readalllines(string _filename)
+QSet<QString> readalllines(string _filename)
 {
-    QStringList AllLines;
+    QSet<QString> AllLines;
     ifstream File(_filename);
 
     string Line;
     while(getline(File, Line))
-        AllLines.append(QString::fromStdString(Line));
+        AllLines.insert(QString::fromStdString(Line));
     return AllLines;
 }
 
@@ -74,112 +92,161 @@ void ZhangMaxEntProxy::init(QSharedPointer<QSettings> _configSettings)
     if(ZhangMaxEntProxy::ModelLoaded)
         throw exTargomanInitialization("Initialization of ZhangMaxEntProxy must be called just once.");
 
-    ZhangMaxEntProxy::Model.load(ZhangMaxEntProxy::FilePath.value().toStdString());
+    maxent::MaxentModelFile ModelFile;
+    ModelFile.load(ZhangMaxEntProxy::FilePath.value().toStdString());
+
+    boost::shared_ptr<maxent::me::PredMapType>    PredMap = ModelFile.pred_map();
+    boost::shared_ptr<maxent::me::OutcomeMapType> OutcomeMap = ModelFile.outcome_map();
+    boost::shared_ptr<maxent::me::ParamsType>     Params;
+    boost::shared_array<double>                   Theta;
+    size_t                                        ThetaCount;
+    ModelFile.params(Params, ThetaCount, Theta);
+
+    if (OutcomeMap->size() >= std::numeric_limits<quint16>::max())
+        throw exTargomanInitialization("Too many outcomes in maxent model: " + QString::number(OutcomeMap->size()));
+
+    ZhangMaxEntProxy::Outcomes.clear();
+    for (size_t OutcomeID = 0; OutcomeID < OutcomeMap->size(); ++OutcomeID)
+        ZhangMaxEntProxy::Outcomes.append(QString::fromStdString((*OutcomeMap)[OutcomeID]));
+
+    ZhangMaxEntProxy::FeatureIDs.reserve(PredMap->size());
+    ZhangMaxEntProxy::ParamOffsets.resize(PredMap->size() + 1);
+    ZhangMaxEntProxy::ParamOutcomes.reserve(ThetaCount);
+    ZhangMaxEntProxy::ParamWeights.reserve(ThetaCount);
+    for (size_t PredID = 0; PredID < PredMap->size(); ++PredID){
+        ZhangMaxEntProxy::FeatureIDs.insert(QString::fromStdString((*PredMap)[PredID]), PredID);
+        ZhangMaxEntProxy::ParamOffsets[PredID] = ZhangMaxEntProxy::ParamOutcomes.size();
+        const std::vector<pair<size_t, size_t> >& PredParams = (*Params)[PredID];
+        for (size_t i = 0; i < PredParams.size(); ++i){
+            ZhangMaxEntProxy::ParamOutcomes.append(PredParams[i].first);
+            ZhangMaxEntProxy::ParamWeights.append(Theta[PredParams[i].second]);
+        }
+    }
+    ZhangMaxEntProxy::ParamOffsets[PredMap->size()] = ZhangMaxEntProxy::ParamOutcomes.size();
+
+    // Tag history features are the only ones depending on previous decisions so they are compiled
+    // for all possible histories. Index Outcomes.size() stands for BOUNDARY.
+    int TagCount = ZhangMaxEntProxy::Outcomes.size() + 1;
+    auto tagName = [TagCount] (int _tagIndex) {
+        return _tagIndex == TagCount - 1 ? BOUNDARY_TAG : ZhangMaxEntProxy::Outcomes.at(_tagIndex);
+    };
+    ZhangMaxEntProxy::PrevTagFeatures.resize(TagCount);
+    ZhangMaxEntProxy::PrevTagBigramFeatures.resize(TagCount * TagCount);
+    for (int Prev1 = 0; Prev1 < TagCount; ++Prev1){
+        ZhangMaxEntProxy::PrevTagFeatures[Prev1] =
+                ZhangMaxEntProxy::FeatureIDs.value("tag-1=" + tagName(Prev1), -1);
+        for (int Prev2 = 0; Prev2 < TagCount; ++Prev2)
+            ZhangMaxEntProxy::PrevTagBigramFeatures[Prev2 * TagCount + Prev1] =
+                    ZhangMaxEntProxy::FeatureIDs.value("tag-1,2=" + tagName(Prev2) + "," + tagName(Prev1), -1);
+    }
+
     ZhangMaxEntProxy::RareWords = readalllines(ZhangMaxEntProxy::RareWordsPath.value().toStdString());
     ZhangMaxEntProxy::ModelLoaded = true;
 }
 
-vector<string> ZhangMaxEntProxy::getMaxEntContext(
-        const QList<InputDecomposer::clsToken::stuInfo>& _sentence,
-        const QStringList &_previousTags,
-        int _index)
+/**
+ * @brief ZhangMaxEntProxy::collectStaticFeatures collects ids of features that do not depend on previous tags.
+ * Feature templates are converted directly from Zhang's maxent implementation example, postagger.py
+ */
+void ZhangMaxEntProxy::collectStaticFeatures(const QList<clsToken::stuInfo> &_sentence,
+                                             int _index,
+                                             QVector<FeatureID_t> &_features) const
 {
-    // Converted directly from Zhang's maxent implementation example, postagger.py
-    // so do not blame me!
-    auto get_prefix_suffix_english =
-            [] (QString w, int length, QStringList& p, QStringList& s) {
-        p.clear();
-        s.clear();
-        int wl = w.size();
-        int l = qMin(wl, length + 1);
-        for(int i = 0; i < l; ++i) {
-            p.append(w.mid(0, i + 1));
-            s.append(w.mid(wl - i - 1, i + 1));
-        }
-    };
-    thread_local static QRegExp re_number = QRegExp("[0-9]");
-    thread_local static QRegExp re_hyphen = QRegExp("-");
-    thread_local static QRegExp re_uppercase = QRegExp("[A-Z]");
-    auto get_context_english = [&] (const QList<InputDecomposer::clsToken::stuInfo>& words, const QStringList& pos, int i, bool rare_word) {
-        QList<QString> context;
-        QString Word = words[i].Str;
-        int n = words.size();
-        if(rare_word) {
-            QStringList prefix, suffix;
-            get_prefix_suffix_english(Word, 4, prefix, suffix);
-            foreach(const QString& p, prefix)
-                context.append("prefix=" + p);
-            foreach(const QString& s, suffix)
-                context.append("suffix=" + s);
-            if(Word.contains(re_number))
-                context.append("numeric");
-            if(Word.contains(re_uppercase))
-                context.append("uppercase");
-            if(Word.contains(re_hyphen))
-                context.append("hyphen");
-        } else {
-            context.append("curword=" + Word);
-        }
+    const QString& Word = _sentence.at(_index).Str;
+    int SentenceSize = _sentence.size();
 
-        if(i > 0) {
-            context.append("word-1=" + words[i - 1].Str);
-            context.append("tag-1=" + pos[i - 1]);
-            if(i > 1) {
-                context.append("word-2=" + words[i - 2].Str);
-                context.append("tag-1,2=" + pos[i - 2] + "," + pos[i - 1]);
-            } else {
-                context.append("word-2=BOUNDARY");
-                context.append("tag-1,2=BOUNDARY," + pos[0]);
-            }
-        } else {
-            context.append("word-1=BOUNDARY");
-            context.append("word-2=BOUNDARY");
-            context.append("tag-1=BOUNDARY");
-            context.append("tag-1,2=BOUNDARY,BOUNDARY");
-        }
+    if(ZhangMaxEntProxy::RareWords.contains(Word)) {
+        int PrefixSuffixLength = qMin(Word.size(), 5);
+        for(int i = 0; i < PrefixSuffixLength; ++i)
+            this->addFeature("prefix=" + Word.left(i + 1), _features);
+        for(int i = 0; i < PrefixSuffixLength; ++i)
+            this->addFeature("suffix=" + Word.right(i + 1), _features);
 
-        if(i + 1 < n) {
-            context.append("word+1=" + words[i + 1].Str);
-            if(i + 2 < n)
-                context.append("word+2=" + words[i + 2].Str);
-            else
-                context.append("word+2=BOUNDARY");
-        } else {
-            context.append("word+1=BOUNDARY");
-            context.append("word+2=BOUNDARY");
+        bool HasNumber = false, HasUpperCase = false, HasHyphen = false;
+        foreach(const QChar& Ch, Word){
+            ushort Unicode = Ch.unicode();
+            HasNumber |= (Unicode >= '0' && Unicode <= '9');
+            HasUpperCase |= (Unicode >= 'A' && Unicode <= 'Z');
+            HasHyphen |= (Unicode == '-');
         }
+        if(HasNumber)
+            this->addFeature("numeric", _features);
+        if(HasUpperCase)
+            this->addFeature("uppercase", _features);
+        if(HasHyphen)
+            this->addFeature("hyphen", _features);
+    } else {
+        this->addFeature("curword=" + Word, _features);
+    }
 
-        vector<string> stdcontext;
-        stdcontext.resize(context.size());
-        for(int i = 0; i < context.size(); ++i)
-            stdcontext[i] = context[i].toStdString();
-
-        return stdcontext;
-    };
-
-    return get_context_english(_sentence, _previousTags,
-                               _index,
-                               ZhangMaxEntProxy::RareWords.contains(
-                                   _sentence[_index].Str
-                                   )
-                               );
+    this->addFeature("word-1=" + (_index > 0 ? _sentence.at(_index - 1).Str : BOUNDARY_TAG), _features);
+    this->addFeature("word-2=" + (_index > 1 ? _sentence.at(_index - 2).Str : BOUNDARY_TAG), _features);
+    this->addFeature("word+1=" + (_index + 1 < SentenceSize ? _sentence.at(_index + 1).Str : BOUNDARY_TAG), _features);
+    this->addFeature("word+2=" + (_index + 2 < SentenceSize ? _sentence.at(_index + 2).Str : BOUNDARY_TAG), _features);
 }
 
 void ZhangMaxEntProxy::tagNamedEntities(QList<InputDecomposer::clsToken::stuInfo>& _sentence)
 {
-    QStringList PreviousTags;
+    if (_sentence.isEmpty())
+        return;
+
+    int OutcomeCount = ZhangMaxEntProxy::Outcomes.size();
+    int Boundary = OutcomeCount;
+    int MaxHypotheses = ZhangMaxEntProxy::BeamSize.value();
+
+    QVector<FeatureID_t> StaticFeatures;
+    QVector<double> StaticScores(OutcomeCount);
+    QVector<double> Scores(OutcomeCount);
+    QVector<stuTaggingHypothesis> Hypotheses(1);
+    QVector<stuTaggingHypothesis> NextHypotheses;
+
     for(int i = 0; i < _sentence.size(); ++i) {
-        vector<string> Context = this->getMaxEntContext(
-                    _sentence,
-                    PreviousTags,
-                    i
-                    );
-        QString CurrentTag = QString::fromStdString(
-                    ZhangMaxEntProxy::Model.predict(Context)
-                    );
-        PreviousTags.append(CurrentTag);
-        _sentence[i].Attrs.insert(NER_TAG_ATTR_KEY, CurrentTag);
+        StaticFeatures.resize(0);
+        this->collectStaticFeatures(_sentence, i, StaticFeatures);
+        StaticScores.fill(0);
+        foreach(FeatureID_t FeatureID, StaticFeatures)
+            this->accumulate(FeatureID, StaticScores);
+
+        NextHypotheses.resize(0);
+        foreach(const stuTaggingHypothesis& Hypothesis, Hypotheses){
+            int Prev1 = i > 0 ? Hypothesis.Tags.at(i - 1) : Boundary;
+            int Prev2 = i > 1 ? Hypothesis.Tags.at(i - 2) : Boundary;
+            Scores = StaticScores;
+            this->accumulate(ZhangMaxEntProxy::PrevTagFeatures.at(Prev1), Scores);
+            this->accumulate(ZhangMaxEntProxy::PrevTagBigramFeatures.at(Prev2 * (OutcomeCount + 1) + Prev1), Scores);
+
+            int BestOutcome = std::max_element(Scores.begin(), Scores.end()) - Scores.begin();
+            if (MaxHypotheses == 1){
+                NextHypotheses.append(Hypothesis);
+                NextHypotheses.last().Tags.append(BestOutcome);
+                continue;
+            }
+
+            // Beam search needs normalized log probabilities to compare different histories
+            double LogNormalizer = 0;
+            foreach(double Score, Scores)
+                LogNormalizer += std::exp(Score - Scores.at(BestOutcome));
+            LogNormalizer = Scores.at(BestOutcome) + std::log(LogNormalizer);
+            for (int Outcome = 0; Outcome < OutcomeCount; ++Outcome){
+                NextHypotheses.append(Hypothesis);
+                NextHypotheses.last().Score += Scores.at(Outcome) - LogNormalizer;
+                NextHypotheses.last().Tags.append(Outcome);
+            }
+        }
+
+        if (NextHypotheses.size() > MaxHypotheses){
+            std::partial_sort(NextHypotheses.begin(), NextHypotheses.begin() + MaxHypotheses, NextHypotheses.end(),
+                              stuTaggingHypothesis::higherScoreFirst);
+            NextHypotheses.resize(MaxHypotheses);
+        }
+        std::swap(Hypotheses, NextHypotheses);
     }
+
+    // First hypothesis in order of higherScoreFirst is the best one
+    const QVector<int>& BestTags = std::min_element(Hypotheses.begin(), Hypotheses.end(),
+                                                    stuTaggingHypothesis::higherScoreFirst)->Tags;
+    for(int i = 0; i < _sentence.size(); ++i)
+        _sentence[i].Attrs.insert(NER_TAG_ATTR_KEY, ZhangMaxEntProxy::Outcomes.at(BestTags.at(i)));
 }
 
 }
@@ -32,7 +32,7 @@
 #include "Private/Proxies/NamedEntityRecognition/intfNamedEntityRecognizer.h"
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wunused-parameter"
-#include "libMaxent/maxentmodel.hpp"
+#include "libMaxent/modelfile.hpp"
 #pragma GCC diagnostic pop
 
 namespace Targoman {
@@ -41,6 +41,13 @@ namespace Private {
 namespace Proxies {
 namespace NamedEntityRecognition {
 
+/**
+ * @brief The ZhangMaxEntProxy class tags named entities using a model trained by Zhang's maxent toolkit.
+ *
+ * Model is compiled at load time: every predicate string is mapped to an integer id, parameters are stored
+ * in flat arrays indexed by those ids and history dependent features (previous tags) are resolved to ids
+ * beforehand, so scoring a token is just accumulation over weight arrays.
+ */
 class ZhangMaxEntProxy : public intfNamedEntityRecognizer
 {
 public:
@@ -52,16 +59,51 @@ public:
     virtual void tagNamedEntities(QList<InputDecomposer::clsToken::stuInfo>& _sentence);
 
 private:
-    vector<string> getMaxEntContext(const QList<InputDecomposer::clsToken::stuInfo> &_sentence,
-                                    const QStringList& _previousTags,
-                                    int index);
+    typedef qint32 FeatureID_t;
+
+    struct stuTaggingHypothesis{
+        double         Score;
+        QVector<int>   Tags;
+        stuTaggingHypothesis() : Score(0) {}
+        static bool higherScoreFirst(const stuTaggingHypothesis& _first, const stuTaggingHypothesis& _second){
+            return _first.Score > _second.Score;
+        }
+    };
+
+    void collectStaticFeatures(const QList<InputDecomposer::clsToken::stuInfo> &_sentence,
+                               int _index,
+                               QVector<FeatureID_t>& _features) const;
+
+    inline void addFeature(const QString& _feature, QVector<FeatureID_t>& _features) const {
+        FeatureID_t FeatureID = ZhangMaxEntProxy::FeatureIDs.value(_feature, -1);
+        if (FeatureID >= 0)
+            _features.append(FeatureID);
+    }
+
+    inline void accumulate(FeatureID_t _featureID, QVector<double>& _scores) const {
+        if (_featureID < 0)
+            return;
+        for(quint32 i = ZhangMaxEntProxy::ParamOffsets.at(_featureID);
+            i < ZhangMaxEntProxy::ParamOffsets.at(_featureID + 1);
+            ++i)
+            _scores[ZhangMaxEntProxy::ParamOutcomes.at(i)] += ZhangMaxEntProxy::ParamWeights.at(i);
+    }
 
 public:
     static Common::Configuration::tmplConfigurable<FilePath_t> FilePath;
     static Common::Configuration::tmplConfigurable<FilePath_t> RareWordsPath;
+    static Common::Configuration::tmplRangedConfigurable<quint8> BeamSize;
     static bool ModelLoaded;
-    static maxent::MaxentModel Model;
-    static QStringList RareWords;
+    static QSet<QString> RareWords;
+
+private:
+    static QHash<QString, FeatureID_t>  FeatureIDs;             /**< Maps each predicate string of the model to its id */
+    static QVector<quint32>             ParamOffsets;           /**< Start of parameters of each predicate in #ParamOutcomes and #ParamWeights */
+    static QVector<quint16>             ParamOutcomes;          /**< Outcome index of each parameter */
+    static QVector<double>              ParamWeights;           /**< Weight of each parameter */
+    static QStringList                  Outcomes;               /**< Outcome (tag) strings, BOUNDARY is indexed as Outcomes.size() */
+    static QVector<FeatureID_t>         PrevTagFeatures;        /**< Feature id of "tag-1=X" for each tag index */
+    static QVector<FeatureID_t>         PrevTagBigramFeatures;  /**< Feature id of "tag-1,2=X,Y" for each pair of tag indices */
 
 private:
     TARGOMAN_DEFINE_SINGLETON_MODULE(ZhangMaxEntProxy);
@@ -47,26 +47,88 @@ namespace Private {
 namespace Proxies {
 namespace Transliteration {
 
+using namespace Common::Configuration;
+
 TARGOMAN_REGISTER_SINGLETON_MODULE(TargomanTransliteratorProxy);
 
+tmplRangedConfigurable<quint32> TargomanTransliteratorProxy::MaxCachedItems(
+        MAKE_CONFIG_PATH("MaxCachedItems"),
+        "Maximum number of transliterated words to be cached. Least recently used words are dropped when it is reached",
+        1,10000000,
+        100000,
+        ReturnTrueCrossValidator());
+
 TargomanTransliteratorProxy::TargomanTransliteratorProxy()
 { }
 
 void TargomanTransliteratorProxy::init(QSharedPointer<QSettings> _configSettings)
 {
     Targoman::SWT::Translator::init(_configSettings);
+    this->CachedTransliterations.setMaxItems(TargomanTransliteratorProxy::MaxCachedItems.value());
 }
 
 QString TargomanTransliteratorProxy::transliterate(QString _word)
 {
-    Q_UNUSED(_word);
-    QString intermediateSource = _word.split("", QString::SkipEmptyParts).join(" ");
-    Targoman::SWT::stuTranslationOutput transliterationOutput =
+    QString Transliteration = this->CachedTransliterations.value(_word);
+    if (Transliteration.isNull()){
+        Transliteration = this->decode(_word);
+        this->CachedTransliterations.insert(_word, Transliteration);
+    }
+    return Transliteration;
+}
+
+/**
+ * @brief TargomanTransliteratorProxy::transliterateBatch transliterates all words of a sentence together.
+ * Cached and repeated words are decoded only once. Remaining words are decoded inline as this is called from
+ * decoder threads which are themselves workers of the global thread pool.
+ */
+QStringList TargomanTransliteratorProxy::transliterateBatch(const QStringList &_words)
+{
+    QHash<QString, QString> Transliterations;
+    QStringList WordsToDecode;
+    foreach(const QString& Word, _words){
+        if (Transliterations.contains(Word))
+            continue;
+        QString Transliteration = this->CachedTransliterations.value(Word);
+        if (Transliteration.isNull())
+            WordsToDecode.append(Word);
+        Transliterations.insert(Word, Transliteration);
+    }
+
+    foreach(const QString& Word, WordsToDecode){
+        QString Decoded = this->decode(Word);
+        Transliterations[Word] = Decoded;
+        this->CachedTransliterations.insert(Word, Decoded);
+    }
+
+    QStringList Result;
+    Result.reserve(_words.size());
+    foreach(const QString& Word, _words)
+        Result.append(Transliterations.value(Word));
+    return Result;
+}
+
+/**
+ * @brief TargomanTransliteratorProxy::decode runs a character level SWT decode on the input word.
+ * @return transliterated word which is never a null string so that it can be distinguished from cache misses.
+ */
+QString TargomanTransliteratorProxy::decode(const QString &_word)
+{
+    QString IntermediateSource;
+    IntermediateSource.reserve(_word.size() * 2);
+    foreach(const QChar& Ch, _word){
+        if (IntermediateSource.size())
+            IntermediateSource.append(' ');
+        IntermediateSource.append(Ch);
+    }
+
+    Targoman::SWT::stuTranslationOutput TransliterationOutput =
             Targoman::SWT::Translator::translate(
-                intermediateSource, Targoman::SWT::enuOutputFormat::JustBestTranslation,
+                IntermediateSource, Targoman::SWT::enuOutputFormat::JustBestTranslation,
                 false);
-    QString intermediateTarget = transliterationOutput.Translations.first();
-    return intermediateTarget.replace(" ", "");
+    QString IntermediateTarget = TransliterationOutput.Translations.first();
+    IntermediateTarget.remove(' ');
+    return IntermediateTarget.isNull() ? QString("") : IntermediateTarget;
 }
 
 }
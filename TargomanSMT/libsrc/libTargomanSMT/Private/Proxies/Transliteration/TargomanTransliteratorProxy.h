@@ -29,6 +29,8 @@
 #ifndef TARGOMAN_CORE_PRIVATE_PROXIES_TRANSLITERATION_TARGOMANTRANSLITERATORPROXY_H
 #define TARGOMAN_CORE_PRIVATE_PROXIES_TRANSLITERATION_TARGOMANTRANSLITERATORPROXY_H
 
+#include "libTargomanCommon/tmplBoundedCache.hpp"
+#include "libTargomanCommon/Configuration/tmplConfigurable.h"
 #include "Private/Proxies/Transliteration/intfTransliterator.h"
 
 namespace Targoman {
@@ -47,8 +49,16 @@ public:
     void init(QSharedPointer<QSettings> _configSettings);
 
     QString transliterate(QString _word);
+    QStringList transliterateBatch(const QStringList& _words);
 
 private:
+    QString decode(const QString& _word);
+
+private:
+    Common::tmplBoundedCache<QHash, QString, QString>   CachedTransliterations; /**< Recently transliterated words keyed by source word */
+
+    static Common::Configuration::tmplRangedConfigurable<quint32> MaxCachedItems;
+
     TARGOMAN_DEFINE_SINGLETON_MODULE(TargomanTransliteratorProxy);
 };
 
@@ -56,6 +56,19 @@ public:
     virtual void init(QSharedPointer<QSettings> _configSettings) = 0;
     virtual QString transliterate(QString _word) = 0;
 
+    /**
+     * @brief transliterateBatch transliterates a list of words at once. Default implementation just
+     * calls transliterate() on each word, derived classes can override it in order to share work
+     * among words of the same sentence.
+     * @return a list of transliterations in the same order as input words.
+     */
+    virtual QStringList transliterateBatch(const QStringList& _words){
+        QStringList Transliterations;
+        foreach(const QString& Word, _words)
+            Transliterations.append(this->transliterate(Word));
+        return Transliterations;
+    }
+
 };
 
 }
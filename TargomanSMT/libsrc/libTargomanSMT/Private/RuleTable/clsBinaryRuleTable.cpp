@@ -92,8 +92,11 @@ void clsBinaryRuleTable::initializeSchema()
         //Load Vocab
         int VocabCount = this->InputStream->read<int>();
         gConfigs.SourceVocab.reserve(VocabCount);
-        for(int i=0; i< VocabCount; ++i)
-            gConfigs.SourceVocab[this->InputStream->read<QString>()] = this->InputStream->read<WordIndex_t>();
+        for(int i=0; i< VocabCount; ++i){
+            QString Word = this->InputStream->read<QString>();
+            gConfigs.SourceVocab.insert(Word, this->InputStream->read<WordIndex_t>());
+        }
+        gConfigs.SourceVocab.squeeze();
 
         //Load TargetRule column names
         int ColumnCount = this->InputStream->read<int>();
@@ -28,7 +28,6 @@
 #include "libTargomanCommon/Logger.h"
 #include "libTargomanCommon/Configuration/Validators.hpp"
 #include "libTargomanCommon/CompressedStream/clsCompressedInputStream.h"
-#include "libTargomanCommon/clsCmdProgressBar.h"
 
 #include "Private/FeatureFunctions/PhraseTable/PhraseTable.h"
 #include "Private/FeatureFunctions/LexicalReordering/LexicalReordering.h"
@@ -144,97 +143,87 @@ void clsJanePlainRuleTable::initializeSchema()
 
 /**
  * @brief clsJanePlainRuleTable::loadTableData Loads phrase table from file and adds each phrase (rule) to pefix tree.
+ * Rules are parsed in parallel.
  */
 void clsJanePlainRuleTable::loadTableData()
 {
     TargomanLogInfo(5, "Loading Jane plain text rule set from: " + this->FilePath.value());
 
     this->PrefixTree.reset(new RulesPrefixTree_t());
-    QStringList ColumnNames = clsJanePlainRuleTable::PhraseCostNames.value().split(",");
-    size_t      PhraseCostsCount = ColumnNames.size();
-
-    clsCmdProgressBar ProgressBar("Loading RuleTable");
+    size_t      PhraseCostsCount = clsJanePlainRuleTable::PhraseCostNames.value().split(",").size();
 
+    clsPlainRuleTableLoader Loader(*this->PrefixTree, "<unknown-word>");
     clsCompressedInputStream InputStream(clsJanePlainRuleTable::FilePath.value().toStdString());
-    size_t RulesRead = 0;
-
-    while (InputStream.peek() >= 0){
-        std::string Line;
-        getline(InputStream, Line);
-        if (Line == "")
-            continue;
-        ++RulesRead;
-        ProgressBar.setValue(RulesRead);
-
-        QStringList Fields = QString::fromUtf8(Line.c_str()).split("#");
-
-        if (Fields.size() < 3)
-            throw exJanePhraseTable(QString("Bad file format in line %1 : %2").arg(RulesRead).arg(Line.c_str()));
-
-        if (Fields[janeFormatLeftHandSidePosition] == "S") // we ignore hierachichal phrases.
-            continue;
 
-        if (Fields[janeFormatCostsPosition].isEmpty()){
-            TargomanWarn(5,"Ignoring phrase with empty target side at line: " + QString::number(RulesRead));
-            continue;
+    Loader.load("Loading RuleTable",
+                [&InputStream] (QVector<std::string>& _lines) {
+        _lines.resize(1);
+        while (InputStream.peek() >= 0){
+            getline(InputStream, _lines[0]);
+            if (_lines[0] != "")
+                return true;
         }
-
-        QStringList PhraseCostsFields = Fields[janeFormatCostsPosition].split(" ", QString::SkipEmptyParts);
-        if ((size_t)PhraseCostsFields.size() < PhraseCostsCount){
-            TargomanWarn(5,"Invalid count of costs at line: " + QString::number(RulesRead));
-            continue;
-        }
-
-        this->addRule(PhraseCostsFields, Fields, this->AcceptedAdditionalFieldsIndexes, RulesRead);
-    }
+        return false;
+    },
+                [this, PhraseCostsCount] (const clsPlainRuleTableLoader::stuRecord& _record) {
+        return this->parseRecord(_record, PhraseCostsCount);
+    });
     TargomanLogInfo(5, "Jane plain text rule set loaded. ");
 }
 
 /**
- * @brief clsJanePlainRuleTable::addRule    Adds phrases to prefix tree.
- * @param _phraseCosts                      Feature values.
- * @param _allFields                        All fields of input rule.
- * @param _acceptedAdditionalFields         Additional accepted fields like lexical reordering model.
- * @param _ruleNumber                       line number of rule table.
+ * @brief clsJanePlainRuleTable::parseRecord    Parses a line of phrase table. It is called by multiple threads so it
+ * must not modify anything but its output.
+ * @param _record                               line of the phrase table
+ * @param _phraseCostsCount                     minimum number of phrase costs
+ * @return                                      parsed rule or error/warning message
  */
-void clsJanePlainRuleTable::addRule(const QStringList& _phraseCosts,
-                                    const QStringList &_allFields,
-                                    const QList<size_t>& _acceptedAdditionalFields,
-                                    size_t _ruleNumber)
+clsPlainRuleTableLoader::stuParsedRule clsJanePlainRuleTable::parseRecord(const clsPlainRuleTableLoader::stuRecord &_record,
+                                                                          size_t _phraseCostsCount) const
 {
-    Q_UNUSED(_ruleNumber)
+    clsPlainRuleTableLoader::stuParsedRule Result;
+    size_t RulesRead = _record.RuleNumber;
+    const std::string& Line = _record.Lines.first();
 
-    QList<Cost_t>      Costs;
-    foreach(const QString& Cost, _phraseCosts)
-        Costs.append(Cost.toDouble());
+    QStringList Fields = QString::fromUtf8(Line.c_str()).split("#");
 
-    QList<WordIndex_t> SourcePhrase;
-    foreach(const QString& Word, _allFields[janeFormatSourcePosition].split(" ", QString::SkipEmptyParts)){
-        WordIndex_t WordIndex = gConfigs.SourceVocab.value(Word, Constants::SrcVocabUnkWordIndex);
-        if (WordIndex == Constants::SrcVocabUnkWordIndex && Word != "<unknown-word>"){
-            WordIndex = gConfigs.SourceVocab.size() + 1;
-            gConfigs.SourceVocab.insert(Word, WordIndex);
-        }
-        SourcePhrase.append(WordIndex);
+    if (Fields.size() < 3){
+        Result.Error = QString("Bad file format in line %1 : %2").arg(RulesRead).arg(Line.c_str());
+        return Result;
     }
 
+    if (Fields[janeFormatLeftHandSidePosition] == "S") // we ignore hierachichal phrases.
+        return Result;
+
+    if (Fields[janeFormatCostsPosition].isEmpty()){
+        Result.Warning = "Ignoring phrase with empty target side at line: " + QString::number(RulesRead);
+        return Result;
+    }
+
+    QStringList PhraseCostsFields = Fields[janeFormatCostsPosition].split(" ", QString::SkipEmptyParts);
+    if ((size_t)PhraseCostsFields.size() < _phraseCostsCount){
+        Result.Warning = "Invalid count of costs at line: " + QString::number(RulesRead);
+        return Result;
+    }
+
+    QList<Cost_t>      Costs;
+    foreach(const QString& Cost, PhraseCostsFields)
+        Costs.append(Cost.toDouble());
 
     QList<WordIndex_t> TargetPhrase;
-    foreach(const QString& Word, _allFields[janeFormatTargetPosition].split(" ", QString::SkipEmptyParts))
+    foreach(const QString& Word, Fields[janeFormatTargetPosition].split(" ", QString::SkipEmptyParts))
         TargetPhrase.append(gConfigs.EmptyLMScorer->getWordIndex(Word));
 
-    foreach(size_t FieldIndex, _acceptedAdditionalFields){
-        const QStringList& FieldCosts = _allFields.at(FieldIndex).split(" ", QString::SkipEmptyParts);
+    foreach(size_t FieldIndex, this->AcceptedAdditionalFieldsIndexes){
+        const QStringList& FieldCosts = Fields.at(FieldIndex).split(" ", QString::SkipEmptyParts);
         for (size_t i = 1; i<(size_t)FieldCosts.size(); ++i)
             Costs.append(FieldCosts.at(i).toDouble());
     }
 
-    clsTargetRule TargetRule(TargetPhrase, Costs);
-
-    clsRuleNode& RuleNode = this->PrefixTree->getOrCreateNode(SourcePhrase)->getData();
-    if(RuleNode.isInvalid())
-        RuleNode.detachInvalidData();
-    RuleNode.targetRules().append(TargetRule);
+    Result.TargetRule = clsTargetRule(TargetPhrase, Costs);
+    intfFeatureFunction::precomputeForAllFeatures(Result.TargetRule);
+    Result.SourceWords = Fields[janeFormatSourcePosition].split(" ", QString::SkipEmptyParts);
+    return Result;
 }
 
 }
@@ -30,6 +30,7 @@
 #include "libTargomanCommon/Configuration/tmplConfigurable.h"
 #include "intfRuleTable.hpp"
 #include "clsRuleNode.h"
+#include "clsPlainRuleTableLoader.h"
 
 namespace Targoman {
 namespace SMT {
@@ -50,10 +51,8 @@ public:
     void loadTableData();
 
 private:
-    void addRule(const QStringList &_phraseFieldValue,
-                 const QStringList &_fields,
-                 const QList<size_t> &_acceptedAdditionalFields,
-                 size_t _ruleNumber);
+    clsPlainRuleTableLoader::stuParsedRule parseRecord(const clsPlainRuleTableLoader::stuRecord& _record,
+                                                       size_t _phraseCostsCount) const;
 private:
     QList<size_t> AcceptedAdditionalFieldsIndexes;
 
@@ -28,7 +28,6 @@
 #include "libTargomanCommon/Logger.h"
 #include "libTargomanCommon/Configuration/Validators.hpp"
 #include "libTargomanCommon/CompressedStream/clsCompressedInputStream.h"
-#include "libTargomanCommon/clsCmdProgressBar.h"
 
 #include "Private/FeatureFunctions/PhraseTable/PhraseTable.h"
 #include "Private/FeatureFunctions/LanguageModel/LanguageModel.h"
@@ -46,6 +45,13 @@ enum {
     mosesFormatScores
 };
 
+enum {
+    mosesPhraseTableFile = 0,
+    mosesReorderingTableFile,
+    mosesAlignmentFile,
+    mosesFileCount
+};
+
 using namespace Common;
 using namespace Common::Configuration;
 using namespace Common::CompressedStream;
@@ -198,6 +204,7 @@ void clsMosesPlainRuleTable::initializeSchema()
 
 /**
  * @brief clsMosesPlainRuleTable::loadTableData Loads phrase table from file and adds each phrase (rule) to pefix tree.
+ * Rules are parsed and scored in parallel and target rules of each rule node are pruned and sorted in parallel too.
  */
 void clsMosesPlainRuleTable::loadTableData()
 {
@@ -209,11 +216,9 @@ void clsMosesPlainRuleTable::loadTableData()
 
     this->PrefixTree.reset(new RulesPrefixTree_t());
 
-    clsCmdProgressBar ProgressBar("Loading MosesRuleTable");
+    clsPlainRuleTableLoader Loader(*this->PrefixTree, "<unk>");
 
-    QList<clsRuleNode> TotalRuleNodes;
-
-    addUnkToUnkRule(TotalRuleNodes);
+    addUnkToUnkRule(Loader);
 
     clsCompressedInputStream PhraseTableInputStream(clsMosesPlainRuleTable::PhraseTableFilePath.value().toStdString());
     clsCompressedInputStream ReorderingTableInputStream;
@@ -221,92 +226,39 @@ void clsMosesPlainRuleTable::loadTableData()
     if(ReorderingFileExists)
         ReorderingTableInputStream.open(clsMosesPlainRuleTable::ReorderingTableFilePath.value().toStdString(), true);
 
-    size_t RulesRead = 0;
-
     clsCompressedInputStream AlignmentInputStream;
     bool AlignmentFileExists = QFile::exists(clsMosesPlainRuleTable::WordAlignmentFilePath.value());
     if(AlignmentFileExists)
         AlignmentInputStream.open(clsMosesPlainRuleTable::WordAlignmentFilePath.value().toStdString(), true);
 
-    while (PhraseTableInputStream.peek() >= 0
-           && (ReorderingFileExists == false || ReorderingTableInputStream.peek() >= 0)
-           && (AlignmentFileExists == false || AlignmentInputStream.peek() >= 0)){
-        std::string PhraseTableLine, ReorderingTableLine, AlignmentFileLine;
-        getline(PhraseTableInputStream, PhraseTableLine);
-        if(ReorderingFileExists)
-            getline(ReorderingTableInputStream, ReorderingTableLine);
-        if(AlignmentFileExists)
-            getline(AlignmentInputStream, AlignmentFileLine);
-
-        if (PhraseTableLine == "" ||
-            (ReorderingFileExists && ReorderingTableLine == "") ||
-            (AlignmentFileExists && AlignmentFileLine == ""))
-            continue;
-
-        ++RulesRead;
-        ProgressBar.setValue(RulesRead);
-
-        QStringList PhraseTableFields = QString::fromUtf8(PhraseTableLine.c_str()).split("|||");
-
-        if (PhraseTableFields.size() < 3)
-            throw exMosesPhraseTable(QString("Bad phrase table file format in line %1 : %2").arg(RulesRead).arg(PhraseTableLine.c_str()));
-
-        QStringList ReorderingTableFields;
-        if(ReorderingFileExists) {
-            ReorderingTableFields = QString::fromUtf8(ReorderingTableLine.c_str()).split("|||");
-
-            if (ReorderingTableFields.size() < 3)
-                throw exMosesPhraseTable(QString("Bad reordering table file format in line %1 : %2").arg(RulesRead).arg(ReorderingTableLine.c_str()));
-
-            if (ReorderingTableFields[mosesFormatSourcePhrase] != PhraseTableFields[mosesFormatSourcePhrase] ||
-                    ReorderingTableFields[mosesFormatTargetPhrase] != PhraseTableFields[mosesFormatTargetPhrase])
-                throw exMosesPhraseTable(QString("Reordering and phrase tables do not match (at line %1) : %2").arg(RulesRead).arg(PhraseTableLine.c_str()));
-        }
-
-        if (PhraseTableFields[mosesFormatTargetPhrase].isEmpty()){
-            TargomanWarn(5,"Ignoring phrase with empty target side at line: " + QString::number(RulesRead));
-            continue;
-        }
-
-        QStringList AlignmentFileFields;
-        if(AlignmentFileExists)
-            AlignmentFileFields = QString::fromUtf8(AlignmentFileLine.c_str()).split("|||");
-
-        QStringList PhraseCostsFields = PhraseTableFields[mosesFormatScores].split(" ", QString::SkipEmptyParts);
-        QStringList ReorderingCostsFields;
-        if(ReorderingFileExists)
-            ReorderingCostsFields = ReorderingTableFields[mosesFormatScores].split(" ", QString::SkipEmptyParts);
-        QStringList WordAlignments;
-        if(AlignmentFileExists)
-            WordAlignments = AlignmentFileFields[mosesFormatScores].split(" ", QString::SkipEmptyParts);
-
-        if(ReorderingFileExists){
-            if (ReorderingCostsFields.size() != 3 && ReorderingCostsFields.size() != 6 )
-                throw exMosesPhraseTable(QString("Invalid count of reordering scores in line %1 : %2").arg(RulesRead).arg(ReorderingTableLine.c_str()));
+    Loader.load("Loading MosesRuleTable",
+                [&] (QVector<std::string>& _lines) {
+        _lines.resize(mosesFileCount);
+        while (PhraseTableInputStream.peek() >= 0
+               && (ReorderingFileExists == false || ReorderingTableInputStream.peek() >= 0)
+               && (AlignmentFileExists == false || AlignmentInputStream.peek() >= 0)){
+            getline(PhraseTableInputStream, _lines[mosesPhraseTableFile]);
+            if(ReorderingFileExists)
+                getline(ReorderingTableInputStream, _lines[mosesReorderingTableFile]);
+            if(AlignmentFileExists)
+                getline(AlignmentInputStream, _lines[mosesAlignmentFile]);
+
+            if (_lines[mosesPhraseTableFile] == "" ||
+                (ReorderingFileExists && _lines[mosesReorderingTableFile] == "") ||
+                (AlignmentFileExists && _lines[mosesAlignmentFile] == ""))
+                continue;
+            return true;
         }
-
-        if (PhraseCostsFields.size() != this->PhraseFeatureCount)
-            throw exMosesPhraseTable(QString("Inconsistent phrase scores in line %1 : %2").arg(RulesRead).arg(PhraseTableLine.c_str()));
-
-        if(ReorderingFileExists){
-            if (ReorderingCostsFields.size() != this->ReorderingFeatureCount)
-                throw exMosesPhraseTable(QString("Inconsistent reordering scores in line %1 : %2").arg(RulesRead).arg(ReorderingTableLine.c_str()));
-        }
-
-        if(ReorderingFileExists){
-            if(this->ReorderingFeatureCount == 6)
-                PhraseCostsFields.append(ReorderingCostsFields.mid(3, 3));
-            PhraseCostsFields.append(ReorderingCostsFields.mid(0, 3));
-        }
-        this->addRule(TotalRuleNodes, PhraseTableFields[mosesFormatSourcePhrase], PhraseTableFields[mosesFormatTargetPhrase], PhraseCostsFields, WordAlignments, RulesRead);
-    }
+        return false;
+    },
+                [this, ReorderingFileExists, AlignmentFileExists] (const clsPlainRuleTableLoader::stuRecord& _record) {
+        return this->parseRecord(_record, ReorderingFileExists, AlignmentFileExists);
+    });
 
     TargomanLogInfo(5, "Sorting rule nodes ...");
 
-    for(int i = 0; i < TotalRuleNodes.size(); ++i) {
-        QList<clsTargetRule>& TargetRuleList = TotalRuleNodes[i].targetRules();
-//        if(TargetRuleList.size())
-//            std::cout << TargetRuleList[0].toStr().toStdString() << std::endl;
+    Loader.finalizeRuleNodes([this] (clsRuleNode& _ruleNode) {
+        QList<clsTargetRule>& TargetRuleList = _ruleNode.targetRules();
         int NumberOfRulesToKeep = qMin(
                     (int)clsMosesPlainRuleTable::MaxRuleNodeTargetRuleCount.value(),
                     TargetRuleList.size()
@@ -334,14 +286,16 @@ void clsMosesPlainRuleTable::loadTableData()
                         _second.precomputedValue(this->PrecomputedValueIndex);
                     }
         );
-    }
+    });
     TargomanLogInfo(5, "Moses plain text rule set loaded. ");
 }
 
 /**
- * @brief getPrematureTargetRuleCost    helper function for clsMosesPlainRuleTable::addRule() that computes a score for target rules forgetting about where they are to be placed
+ * @brief getPrematureTargetRuleCost    helper function for clsMosesPlainRuleTable::parseRecord() that computes a score for target rules forgetting about where they are to be placed
  * @param _targetRule                   input target rule for which the cost is computed
  * @return                              the computed cost
+ * @note                                Rules are loaded once for all weight profiles so premature costs and hence load
+ *                                      time pruning are always based on default weight profile.
  */
 /*inline */Cost_t getPrematureTargetRuleCost(const clsTargetRule& _targetRule)
 {
@@ -355,78 +309,126 @@ void clsMosesPlainRuleTable::loadTableData()
 }
 
 /**
- * @brief clsMosesPlainRuleTable::addRule   adds a new rule to the rule prefix tree
- * @param _sourcePhrase                     source phrase, pointing to the specific prefix tree node
- * @param _targetPhrase                     target phrase for which a target rule will be created
- * @param _costs                            list of cost fields read from the files
- * @note                                    the prefix tree node will be created if it does not exist already
+ * @brief clsMosesPlainRuleTable::parseRecord  parses lines of phrase, reordering and alignment tables and creates a
+ * scored target rule. It is called by multiple threads so it must not modify anything but its output.
+ * @param _record                               lines read from input files
+ * @return                                      parsed rule or error/warning message
  */
-void clsMosesPlainRuleTable::addRule(QList<clsRuleNode>& _ruleNodeList,
-                                     const QList<WordIndex_t> _sourcePhrase,
-                                     const QList<WordIndex_t> _targetPhrase,
-                                     const QList<Cost_t> _costs,
-                                     const QMap<int, int> _alignment)
+clsPlainRuleTableLoader::stuParsedRule clsMosesPlainRuleTable::parseRecord(const clsPlainRuleTableLoader::stuRecord &_record,
+                                                                           bool _reorderingFileExists,
+                                                                           bool _alignmentFileExists) const
 {
-    RuleTable::clsTargetRule TargetRule(_targetPhrase, _costs, _alignment);
+    clsPlainRuleTableLoader::stuParsedRule Result;
+    size_t RulesRead = _record.RuleNumber;
+    const std::string& PhraseTableLine = _record.Lines.at(mosesPhraseTableFile);
+    const std::string& ReorderingTableLine = _record.Lines.at(mosesReorderingTableFile);
+    const std::string& AlignmentFileLine = _record.Lines.at(mosesAlignmentFile);
+
+    QStringList PhraseTableFields = QString::fromUtf8(PhraseTableLine.c_str()).split("|||");
 
-    clsRuleNode& RuleNode = this->PrefixTree->getOrCreateNode(_sourcePhrase)->getData();
-    if (RuleNode.isInvalid()) {
-        RuleNode.detachInvalidData();
-        _ruleNodeList.append(RuleNode);
+    if (PhraseTableFields.size() < 3){
+        Result.Error = QString("Bad phrase table file format in line %1 : %2").arg(RulesRead).arg(PhraseTableLine.c_str());
+        return Result;
     }
-    TargetRule.setPrecomputedValue(
-                this->PrecomputedValueIndex,
-                getPrematureTargetRuleCost(TargetRule)
-                );
-    RuleNode.targetRules().append(TargetRule);
-}
 
-/**
- * @brief clsMosesPlainRuleTable::addRule   creates source phrase and target phrase representations from their string counterparts and adds a rule to prefix tree
- * @param _sourcePhrase                     string representation of the source phrase
- * @param _targetPhrase                     string representation of the target phrase
- * @param _costs                            the list containing string representations of the cost field values
- * @param _ruleNumber                       index of the line read from the input file
- */
-void clsMosesPlainRuleTable::addRule(QList<clsRuleNode>& _ruleNodeList,
-                                     const QString& _sourcePhrase,
-                                     const QString& _targetPhrase,
-                                     const QStringList &_costs,
-                                     const QStringList &_wordAlignments,
-                                     size_t _ruleNumber)
-{
-    Q_UNUSED(_ruleNumber)
+    QStringList ReorderingTableFields;
+    if(_reorderingFileExists) {
+        ReorderingTableFields = QString::fromUtf8(ReorderingTableLine.c_str()).split("|||");
 
-    QList<Cost_t>       Costs;
-    foreach(const QString& Cost, _costs)
-        Costs.append(-log(Cost.toDouble()));
+        if (ReorderingTableFields.size() < 3){
+            Result.Error = QString("Bad reordering table file format in line %1 : %2").arg(RulesRead).arg(ReorderingTableLine.c_str());
+            return Result;
+        }
+
+        if (ReorderingTableFields[mosesFormatSourcePhrase] != PhraseTableFields[mosesFormatSourcePhrase] ||
+                ReorderingTableFields[mosesFormatTargetPhrase] != PhraseTableFields[mosesFormatTargetPhrase]){
+            Result.Error = QString("Reordering and phrase tables do not match (at line %1) : %2").arg(RulesRead).arg(PhraseTableLine.c_str());
+            return Result;
+        }
+    }
+
+    if (PhraseTableFields[mosesFormatTargetPhrase].isEmpty()){
+        Result.Warning = "Ignoring phrase with empty target side at line: " + QString::number(RulesRead);
+        return Result;
+    }
+
+    QStringList AlignmentFileFields;
+    if(_alignmentFileExists)
+        AlignmentFileFields = QString::fromUtf8(AlignmentFileLine.c_str()).split("|||");
+
+    QStringList PhraseCostsFields = PhraseTableFields[mosesFormatScores].split(" ", QString::SkipEmptyParts);
+    QStringList ReorderingCostsFields;
+    if(_reorderingFileExists)
+        ReorderingCostsFields = ReorderingTableFields[mosesFormatScores].split(" ", QString::SkipEmptyParts);
+    QStringList WordAlignments;
+    if(_alignmentFileExists)
+        WordAlignments = AlignmentFileFields[mosesFormatScores].split(" ", QString::SkipEmptyParts);
+
+    if(_reorderingFileExists){
+        if (ReorderingCostsFields.size() != 3 && ReorderingCostsFields.size() != 6 ){
+            Result.Error = QString("Invalid count of reordering scores in line %1 : %2").arg(RulesRead).arg(ReorderingTableLine.c_str());
+            return Result;
+        }
+    }
+
+    if (PhraseCostsFields.size() != this->PhraseFeatureCount){
+        Result.Error = QString("Inconsistent phrase scores in line %1 : %2").arg(RulesRead).arg(PhraseTableLine.c_str());
+        return Result;
+    }
 
-    QList<WordIndex_t> SourcePhrase;
-    foreach(const QString& Word, _sourcePhrase.split(" ", QString::SkipEmptyParts)){
-        WordIndex_t WordIndex = gConfigs.SourceVocab.value(Word, Constants::SrcVocabUnkWordIndex);
-        if (WordIndex == Constants::SrcVocabUnkWordIndex && Word != "<unk>"){
-            WordIndex = gConfigs.SourceVocab.size() + 1;
-            gConfigs.SourceVocab.insert(Word, WordIndex);
+    if(_reorderingFileExists){
+        if (ReorderingCostsFields.size() != this->ReorderingFeatureCount){
+            Result.Error = QString("Inconsistent reordering scores in line %1 : %2").arg(RulesRead).arg(ReorderingTableLine.c_str());
+            return Result;
         }
-        SourcePhrase.append(WordIndex);
     }
 
+    if(_reorderingFileExists){
+        if(this->ReorderingFeatureCount == 6)
+            PhraseCostsFields.append(ReorderingCostsFields.mid(3, 3));
+        PhraseCostsFields.append(ReorderingCostsFields.mid(0, 3));
+    }
+
+    QList<Cost_t>       Costs;
+    foreach(const QString& Cost, PhraseCostsFields)
+        Costs.append(-log(Cost.toDouble()));
+
     QList<WordIndex_t> TargetPhrase;
-    foreach(const QString& Word, _targetPhrase.split(" ", QString::SkipEmptyParts))
+    foreach(const QString& Word, PhraseTableFields[mosesFormatTargetPhrase].split(" ", QString::SkipEmptyParts))
         TargetPhrase.append(gConfigs.EmptyLMScorer->getWordIndex(Word));
 
     QMap<int, int> Alignments;
-    for(QString wordAlignment : _wordAlignments) {
-        QStringList AlignmentParts = wordAlignment.split("-");
+    foreach(const QString& WordAlignment, WordAlignments) {
+        QStringList AlignmentParts = WordAlignment.split("-");
         Alignments.insertMulti(AlignmentParts[1].toInt(), AlignmentParts[0].toInt());
     }
-    this->addRule(_ruleNodeList, SourcePhrase, TargetPhrase, Costs, Alignments);
+
+    Result.TargetRule = this->makeTargetRule(TargetPhrase, Costs, Alignments);
+    Result.SourceWords = PhraseTableFields[mosesFormatSourcePhrase].split(" ", QString::SkipEmptyParts);
+    return Result;
+}
+
+/**
+ * @brief clsMosesPlainRuleTable::makeTargetRule    creates a target rule, precomputes values of all feature
+ * functions on it and stores its premature cost
+ */
+clsTargetRule clsMosesPlainRuleTable::makeTargetRule(const QList<WordIndex_t>& _targetPhrase,
+                                                     const QList<Cost_t>& _costs,
+                                                     const QMap<int, int>& _alignment) const
+{
+    RuleTable::clsTargetRule TargetRule(_targetPhrase, _costs, _alignment);
+    intfFeatureFunction::precomputeForAllFeatures(TargetRule);
+    TargetRule.setPrecomputedValue(
+                this->PrecomputedValueIndex,
+                getPrematureTargetRuleCost(TargetRule)
+                );
+    return TargetRule;
 }
 
 /**
  * @brief clsMosesPlainRuleTable::addUnkToUnkRule   adds the unknown to unkown word translation rule to avoid stucking at unknown words
  */
-void clsMosesPlainRuleTable::addUnkToUnkRule(QList<clsRuleNode>& _ruleNodeList)
+void clsMosesPlainRuleTable::addUnkToUnkRule(clsPlainRuleTableLoader& _loader)
 {
     QList<Cost_t> Costs;
     for(int i = 0; i < this->PhraseFeatureCount + this->ReorderingFeatureCount; ++i)
@@ -437,7 +439,7 @@ void clsMosesPlainRuleTable::addUnkToUnkRule(QList<clsRuleNode>& _ruleNodeList)
     TgtUnk.append(gConfigs.EmptyLMScorer->unknownWordIndex());
     QMap<int, int> Alignment;
     Alignment.insert(0, 0);
-    addRule(_ruleNodeList, SrcUnk, TgtUnk, Costs, Alignment);
+    _loader.addRule(SrcUnk, this->makeTargetRule(TgtUnk, Costs, Alignment));
 }
 
 }
@@ -30,6 +30,7 @@
 #include "libTargomanCommon/Configuration/tmplConfigurable.h"
 #include "intfRuleTable.hpp"
 #include "clsRuleNode.h"
+#include "clsPlainRuleTableLoader.h"
 
 namespace Targoman {
 namespace SMT {
@@ -51,17 +52,13 @@ public:
     void loadTableData();
 
 private:
-    void addRule(QList<clsRuleNode>& _ruleNodeList,
-                 const QList<Common::WordIndex_t> _sourcePhrase,
-                 const QList<Common::WordIndex_t> _targetPhrase,
-                 const QList<Targoman::Common::Cost_t> _costs, const QMap<int, int> _alignment);
-    void addRule(QList<clsRuleNode>& _ruleNodeList,
-                 const QString& _sourcePhrase,
-                 const QString& _targetPhrase,
-                 const QStringList &_costs,
-                 const QStringList &_wordAlignments,
-                 size_t _ruleNumber);
-    void addUnkToUnkRule(QList<clsRuleNode>& _ruleNodeList);
+    clsTargetRule makeTargetRule(const QList<Common::WordIndex_t>& _targetPhrase,
+                                 const QList<Targoman::Common::Cost_t>& _costs,
+                                 const QMap<int, int>& _alignment) const;
+    clsPlainRuleTableLoader::stuParsedRule parseRecord(const clsPlainRuleTableLoader::stuRecord& _record,
+                                                       bool _reorderingFileExists,
+                                                       bool _alignmentFileExists) const;
+    void addUnkToUnkRule(clsPlainRuleTableLoader& _loader);
 
 private:
     int PhraseFeatureCount = 0;
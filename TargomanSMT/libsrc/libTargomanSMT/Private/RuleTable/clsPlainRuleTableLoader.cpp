@@ -0,0 +1,141 @@
+/******************************************************************************
+ * Targoman: A robust Statistical Machine Translation framework               *
+ *                                                                            *
+ * Copyright 2014-2015 by ITRC <http://itrc.ac.ir>                            *
+ *                                                                            *
+ * This file is part of Targoman.                                             *
+ *                                                                            *
+ * Targoman is free software: you can redistribute it and/or modify           *
+ * it under the terms of the GNU Lesser General Public License as published   *
+ * by the Free Software Foundation, either version 3 of the License, or       *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * Targoman is distributed in the hope that it will be useful,                *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * GNU Lesser General Public License for more details.                        *
+ * You should have received a copy of the GNU Lesser General Public License   *
+ * along with Targoman. If not, see <http://www.gnu.org/licenses/>.           *
+ *                                                                            *
+ ******************************************************************************/
+/**
+ * @author S. Mohammad M. Ziabary <ziabary@targoman.com>
+ * @author Behrooz Vedadian <vedadian@targoman.com>
+ * @author Saeed Torabzadeh <saeed.torabzadeh@targoman.com>
+ */
+
+#include <QtConcurrent/QtConcurrent>
+#include "clsPlainRuleTableLoader.h"
+#include "libTargomanCommon/Logger.h"
+#include "libTargomanCommon/clsCmdProgressBar.h"
+
+namespace Targoman {
+namespace SMT {
+namespace Private {
+namespace RuleTable {
+
+using namespace Common;
+
+/// Number of records parsed together. Large enough to keep all cores busy and small enough to bound memory usage
+static const int PLAIN_RULE_TABLE_CHUNK_SIZE = 50000;
+
+clsPlainRuleTableLoader::clsPlainRuleTableLoader(RulesPrefixTree_t &_prefixTree, const QString &_sourceUnknownWord) :
+    PrefixTree(_prefixTree),
+    SourceUnknownWord(_sourceUnknownWord)
+{ }
+
+/**
+ * @brief clsPlainRuleTableLoader::addRule  adds a target rule to the prefix tree node of the source phrase
+ * @note                                    the prefix tree node will be created if it does not exist already
+ */
+void clsPlainRuleTableLoader::addRule(const QList<WordIndex_t> &_sourcePhrase, const clsTargetRule &_targetRule)
+{
+    clsRuleNode& RuleNode = this->PrefixTree.getOrCreateNode(_sourcePhrase)->getData();
+    if (RuleNode.isInvalid()) {
+        RuleNode.detachInvalidData();
+        this->RuleNodes.append(RuleNode);
+    }
+    RuleNode.targetRules().append(_targetRule);
+}
+
+/**
+ * @brief clsPlainRuleTableLoader::load     reads all records using _reader, parses them in parallel using _parser and
+ * adds parsed rules to the prefix tree in the order they were read.
+ * @param _title                            title of the progress bar
+ * @exception throws exRuleTable if parsing any of the records fails
+ */
+void clsPlainRuleTableLoader::load(const QString& _title, RecordReader_t _reader, RecordParser_t _parser)
+{
+    clsCmdProgressBar ProgressBar(_title);
+    size_t RecordsRead = 0;
+
+    QVector<stuRecord> Chunk;
+    this->readChunk(_reader, RecordsRead, Chunk);
+    while (Chunk.size()) {
+        // Parse current chunk on the global thread pool while next chunk is read from input files
+        QFuture<stuParsedRule> ParsedRules = QtConcurrent::mapped(Chunk, _parser);
+        QVector<stuRecord> NextChunk;
+        this->readChunk(_reader, RecordsRead, NextChunk);
+        ParsedRules.waitForFinished();
+
+        for (int i = 0; i < Chunk.size(); ++i) {
+            const stuParsedRule& Rule = ParsedRules.resultAt(i);
+            if (Rule.Error.size())
+                throw exRuleTable(Rule.Error);
+            if (Rule.Warning.size())
+                TargomanWarn(5, Rule.Warning);
+            if (Rule.SourceWords.isEmpty())
+                continue;
+            this->addRule(this->sourcePhrase(Rule.SourceWords), Rule.TargetRule);
+        }
+        ProgressBar.setValue(Chunk.last().RuleNumber);
+        Chunk = NextChunk;
+    }
+    gConfigs.SourceVocab.squeeze();
+}
+
+/**
+ * @brief clsPlainRuleTableLoader::finalizeRuleNodes    calls _finalizer on all of the rule nodes created by this
+ * loader in parallel.
+ */
+void clsPlainRuleTableLoader::finalizeRuleNodes(RuleNodeFinalizer_t _finalizer)
+{
+    QtConcurrent::blockingMap(this->RuleNodes, _finalizer);
+}
+
+/**
+ * @brief clsPlainRuleTableLoader::readChunk    reads at most PLAIN_RULE_TABLE_CHUNK_SIZE records
+ * @return                                      number of records read
+ */
+int clsPlainRuleTableLoader::readChunk(RecordReader_t _reader, size_t& _recordsRead, QVector<stuRecord>& _chunk)
+{
+    _chunk.reserve(PLAIN_RULE_TABLE_CHUNK_SIZE);
+    stuRecord Record;
+    while (_chunk.size() < PLAIN_RULE_TABLE_CHUNK_SIZE && _reader(Record.Lines)) {
+        Record.RuleNumber = ++_recordsRead;
+        _chunk.append(Record);
+    }
+    return _chunk.size();
+}
+
+/**
+ * @brief clsPlainRuleTableLoader::sourcePhrase converts source words to word indexes adding new words to source vocab
+ */
+QList<WordIndex_t> clsPlainRuleTableLoader::sourcePhrase(const QStringList &_words)
+{
+    QList<WordIndex_t> SourcePhrase;
+    foreach(const QString& Word, _words){
+        WordIndex_t WordIndex = gConfigs.SourceVocab.value(Word, Constants::SrcVocabUnkWordIndex);
+        if (WordIndex == Constants::SrcVocabUnkWordIndex && Word != this->SourceUnknownWord){
+            WordIndex = gConfigs.SourceVocab.size() + 1;
+            gConfigs.SourceVocab.insert(Word, WordIndex);
+        }
+        SourcePhrase.append(WordIndex);
+    }
+    return SourcePhrase;
+}
+
+}
+}
+}
+}
@@ -0,0 +1,99 @@
+/******************************************************************************
+ * Targoman: A robust Statistical Machine Translation framework               *
+ *                                                                            *
+ * Copyright 2014-2015 by ITRC <http://itrc.ac.ir>                            *
+ *                                                                            *
+ * This file is part of Targoman.                                             *
+ *                                                                            *
+ * Targoman is free software: you can redistribute it and/or modify           *
+ * it under the terms of the GNU Lesser General Public License as published   *
+ * by the Free Software Foundation, either version 3 of the License, or       *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * Targoman is distributed in the hope that it will be useful,                *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * GNU Lesser General Public License for more details.                        *
+ * You should have received a copy of the GNU Lesser General Public License   *
+ * along with Targoman. If not, see <http://www.gnu.org/licenses/>.           *
+ *                                                                            *
+ ******************************************************************************/
+/**
+ * @author S. Mohammad M. Ziabary <ziabary@targoman.com>
+ * @author Behrooz Vedadian <vedadian@targoman.com>
+ * @author Saeed Torabzadeh <saeed.torabzadeh@targoman.com>
+ */
+
+#ifndef TARGOMAN_CORE_PRIVATE_RULETABLE_CLSPLAINRULETABLELOADER_H
+#define TARGOMAN_CORE_PRIVATE_RULETABLE_CLSPLAINRULETABLELOADER_H
+
+#include <functional>
+#include <string>
+#include <QVector>
+#include "intfRuleTable.hpp"
+#include "clsRuleNode.h"
+
+namespace Targoman {
+namespace SMT {
+namespace Private {
+namespace RuleTable {
+
+/**
+ * @brief The clsPlainRuleTableLoader class loads plain text rule tables in two phases.
+ *
+ * In the first phase records are read in chunks. Each chunk is parsed and scored by all cores while the next chunk is
+ * being read, then parsed rules are added to the prefix tree in their original order as source vocabulary and prefix
+ * tree are not thread safe. In the second phase rule nodes are finalized (e.g. pruned and sorted) in parallel.
+ */
+class clsPlainRuleTableLoader
+{
+public:
+    /**
+     * @brief The stuRecord struct holds one line of each input file (e.g. phrase, reordering and alignment tables)
+     */
+    struct stuRecord{
+        size_t                      RuleNumber;
+        QVector<std::string>        Lines;
+    };
+
+    /**
+     * @brief The stuParsedRule struct is the result of parsing a record. Rule is ignored if #SourceWords is empty.
+     */
+    struct stuParsedRule{
+        QStringList                 SourceWords;
+        clsTargetRule               TargetRule;
+        QString                     Warning;        /**< Rule is ignored and this message is logged */
+        QString                     Error;          /**< Loading fails with this message */
+    };
+
+    /// Reads next non-empty record from the input files, returns false at the end of inputs
+    typedef std::function<bool(QVector<std::string>& _lines)>           RecordReader_t;
+    /// Parses a record. Must be thread safe
+    typedef std::function<stuParsedRule(const stuRecord& _record)>      RecordParser_t;
+    /// Finalizes target rules of a rule node. Must be thread safe
+    typedef std::function<void(clsRuleNode& _ruleNode)>                 RuleNodeFinalizer_t;
+
+public:
+    clsPlainRuleTableLoader(RulesPrefixTree_t& _prefixTree, const QString& _sourceUnknownWord);
+
+    void addRule(const QList<Common::WordIndex_t>& _sourcePhrase, const clsTargetRule& _targetRule);
+    void load(const QString& _title, RecordReader_t _reader, RecordParser_t _parser);
+    void finalizeRuleNodes(RuleNodeFinalizer_t _finalizer);
+
+    static QString moduleName() { return "PlainRuleTableLoader"; }
+
+private:
+    int readChunk(RecordReader_t _reader, size_t& _recordsRead, QVector<stuRecord>& _chunk);
+    QList<Common::WordIndex_t> sourcePhrase(const QStringList& _words);
+
+private:
+    RulesPrefixTree_t&      PrefixTree;
+    QString                 SourceUnknownWord;
+    QList<clsRuleNode>      RuleNodes;              /**< All of the rule nodes created by this loader */
+};
+
+}
+}
+}
+}
+#endif // TARGOMAN_CORE_PRIVATE_RULETABLE_CLSPLAINRULETABLELOADER_H
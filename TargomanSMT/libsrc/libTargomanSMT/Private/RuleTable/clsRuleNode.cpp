@@ -26,6 +26,7 @@
 
 #include "clsRuleNode.h"
 #include "libTargomanCommon/FStreamExtended.h"
+#include "Private/FeatureFunctions/intfFeatureFunction.hpp"
 
 namespace Targoman {
 namespace SMT {
@@ -78,6 +79,9 @@ void clsRuleNode::readBinary(std::istream &_input)
         TargetRule.readBinary(InStream);
         this->Data->TargetRules.append(TargetRule);
     }
+    // Rule nodes are read either at startup or when first visited in on-demand modes, in both cases before they
+    // are handed to decoders.
+    FeatureFunction::intfFeatureFunction::precomputeForAllFeatures(this->Data->TargetRules);
 }
 
 void clsRuleNode::writeBinary(std::ostream &_output) const
@@ -38,6 +38,7 @@ using namespace Common;
 
 QStringList  clsTargetRule::ColumnNames;
 size_t clsTargetRule::PrecomputedValuesSize = 0;
+size_t clsTargetRule::CachesSize = 0;
 
 bool clsTargetRule::AlignmentDataAvailable;
 bool clsTargetRule::LexicalReorderingAvailable;
@@ -61,7 +62,8 @@ clsTargetRule::clsTargetRule():
  * @param _fields   fields of different feature functions for this translation phrase.
  */
 clsTargetRule::clsTargetRule(const QList<WordIndex_t> &_targetPhrase, const QList<Cost_t> &_fields, const QMap<int, int> &_alignments, bool _hasNoRuleTableRecord):
-    Data(new clsTargetRuleData(_targetPhrase, _fields, _alignments, clsTargetRule::PrecomputedValuesSize, _hasNoRuleTableRecord))
+    Data(new clsTargetRuleData(_targetPhrase, _fields, _alignments, clsTargetRule::PrecomputedValuesSize,
+                                clsTargetRule::CachesSize, _hasNoRuleTableRecord))
 {
     if(_targetPhrase.size() == 1 && _targetPhrase.at(0) == gConfigs.EmptyLMScorer->unknownWordIndex())
         this->Data->IsUnknownWord = true;
@@ -82,6 +84,7 @@ void clsTargetRule::readBinary(clsIFStreamExtended &_input)
     for(Cost_t& Cost : this->Data->Fields)
         Cost = _input.read<Cost_t>();
     this->Data->PrecomputedValues.fill(-INFINITY, clsTargetRule::PrecomputedValuesSize);
+    this->Data->clearCaches(clsTargetRule::CachesSize);
 
     int AlignmentSize = _input.read<int>();
     for(int i = 0; i < AlignmentSize; i++){
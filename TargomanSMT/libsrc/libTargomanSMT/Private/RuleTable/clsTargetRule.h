@@ -28,6 +28,7 @@
 #define TARGOMAN_CORE_PRIVATE_RULETABLE_CLSTARGETRULE_H
 
 #include <QList>
+#include <QAtomicPointer>
 #include "libTargomanCommon/Types.h"
 #include "libTargomanSMT/Types.h"
 #include "libTargomanCommon/FStreamExtended.h"
@@ -48,6 +49,17 @@ class intfRuleTable;
 
 extern clsTargetRuleData* InvalidTargetRuleData;
 
+/**
+ * @brief Base class of per rule data that feature functions cache on a target rule when a single cost in
+ * PrecomputedValues is not enough (e.g. language model state after the target phrase). Each feature function owns
+ * one slot of these caches, allocated by clsTargetRule::allocateCache.
+ */
+class intfTargetRuleCache
+{
+public:
+    virtual ~intfTargetRuleCache(){}
+};
+
 
 /**
  * @brief The clsTargetRule class is used to store translation and feature values for target language phrase.
@@ -103,6 +115,8 @@ public:
     inline Common::Cost_t precomputedValue(size_t _index) const;
     inline void setCosts(const QList<Common::Cost_t>& _costs);
     inline void setPrecomputedValue(size_t _index, Common::Cost_t _value);
+    inline const intfTargetRuleCache* cache(size_t _index) const;
+    inline const intfTargetRuleCache* setCache(size_t _index, intfTargetRuleCache* _cache) const;
     /**
      * @brief getColumnIndex    returns index of column by its name.
      * @param[in] _columnName   name of column.
@@ -142,6 +156,15 @@ public:
 
     }
 
+    /**
+     * @return returns #CachesSize and increases its size.
+     */
+    static size_t allocateCache(){
+        size_t AllocatedIndex = clsTargetRule::CachesSize;
+        ++clsTargetRule::CachesSize;
+        return AllocatedIndex;
+    }
+
     void detachInvalidData(){
         Q_ASSERT(this->isInvalid());
         this->Data.detach();
@@ -179,6 +202,7 @@ private:
     QExplicitlySharedDataPointer<clsTargetRuleData>     Data;                   /**< Data member of this class is stored in a seperate class. A shared pointer of this seperate class is stored here */
     static  QStringList                                 ColumnNames;            /** A List of Names of Fields of feature values */
     static  size_t                                      PrecomputedValuesSize;
+    static  size_t                                      CachesSize;
     static  bool                                        AlignmentDataAvailable;
     static  bool                                        LexicalReorderingAvailable;
 
@@ -201,12 +225,14 @@ public:
                       const QList<Common::Cost_t>& _fields,
                       const QMap<int, int>& _alignment,
                       size_t _precomputedValueSize,
+                      size_t _cachesSize,
                       bool _hasNoRuleTableRecord):
         TargetPhrase(_targetPhrase),
         Fields(_fields),
         Alignment(_alignment),
         PrecomputedValues(_precomputedValueSize,-INFINITY),
-        IsUnknownWord(_hasNoRuleTableRecord)
+        IsUnknownWord(_hasNoRuleTableRecord),
+        Caches(_cachesSize)
     {}
 
     /**
@@ -233,9 +259,24 @@ public:
         TargetPhrase(_other.TargetPhrase),
         Fields(_other.Fields),
         PrecomputedValues(_other.PrecomputedValues),
-        IsUnknownWord(_other.IsUnknownWord)
+        IsUnknownWord(_other.IsUnknownWord),
+        Caches(_other.Caches.size())
     {}
-    ~clsTargetRuleData() {}
+    ~clsTargetRuleData() {
+        this->clearCaches(0);
+    }
+
+    /**
+     * @brief Deletes all of the cached data and resizes #Caches to _size empty slots.
+     */
+    void clearCaches(size_t _size) {
+        for(int i = 0; i < this->Caches.size(); ++i)
+            delete this->Caches[i].load();
+        this->Caches = QVector<QAtomicPointer<intfTargetRuleCache>>(_size);
+    }
+
+private:
+    clsTargetRuleData& operator = (const clsTargetRuleData&);
 
 public:
     QList<Common::WordIndex_t>                      TargetPhrase;            /**< Translation (target language phrase) */
@@ -243,6 +284,7 @@ public:
     QMap<int, int>                                  Alignment;               /**< word level alignment */
     QVector<Common::Cost_t>                         PrecomputedValues;       /**< It is used for caching */
     bool                                            IsUnknownWord;
+    QVector<QAtomicPointer<intfTargetRuleCache>>    Caches;                  /**< Per feature function cached data, filled on first use */
 };
 
 /***********************************************************/
@@ -329,6 +371,30 @@ inline void clsTargetRule::setPrecomputedValue(size_t _index, Common::Cost_t _va
     this->Data->PrecomputedValues[_index] = _value;
 }
 
+/**
+ * @param[in] _index    Index of cache slot.
+ * @return              Returns data cached in _index-th slot of this rule or NULL if not yet computed.
+ */
+inline const intfTargetRuleCache* clsTargetRule::cache(size_t _index) const{
+    Q_ASSERT(_index < (size_t)this->Data->Caches.size());
+    return this->Data->Caches.at(_index).loadAcquire();
+}
+
+/**
+ * @brief Stores _cache in _index-th cache slot of this rule if it has not been stored yet. Ownership of _cache is
+ * taken. As target rules are shared between translation threads, when another thread has stored its cache first
+ * _cache is deleted and the already stored one is returned.
+ * @return Returns the cache stored on the rule.
+ */
+inline const intfTargetRuleCache* clsTargetRule::setCache(size_t _index, intfTargetRuleCache* _cache) const{
+    Q_ASSERT(_index < (size_t)this->Data->Caches.size());
+    QAtomicPointer<intfTargetRuleCache>& Slot = this->Data->Caches[_index];
+    if (Slot.testAndSetOrdered(NULL, _cache))
+        return _cache;
+    delete _cache;
+    return Slot.loadAcquire();
+}
+
 inline bool clsTargetRule::isInvalid() const{
     return this->Data.data() == InvalidTargetRuleData;
 }
@@ -24,6 +24,8 @@
  * @author Saeed Torabzadeh <saeed.torabzadeh@targoman.com>
  */
 
+#include <queue>
+#include <functional>
 #include "clsCardinality.h"
 #include "clsSearchGraph.h"
 #include <iostream>
@@ -56,7 +58,6 @@ tmplRangedConfigurable<double> clsCardinalityHypothesisContainer::SearchBeamWidt
         5
         );
 
-size_t clsCardinalityHypothesisContainer::MaxCardinalitySizeLazyPruning = 0;
 
 clsCardinalityHypothesisContainer::clsCardinalityHypothesisContainer() :
     Data(new clsCardinalityHypothesisContainerData)
@@ -65,12 +66,13 @@ clsCardinalityHypothesisContainer::clsCardinalityHypothesisContainer() :
 void clsCardinalityHypothesisContainer::setLexicalHypothesis(const Coverage_t &_coverage)
 {
     this->Data->SelectedCoverage = _coverage;
-    this->Data->SelectedLexicalHypothesis = &this->Data->LexicalHypothesisContainer[_coverage];
+    this->Data->SelectedLexicalHypothesis = &(*this)[_coverage];
 }
 
 void clsCardinalityHypothesisContainer::removeSelectedLexicalHypothesisIfEmpty()
 {
     if(this->Data->SelectedLexicalHypothesis->nodes().isEmpty()) {
+        this->Data->LexicalHypothesisIndex.remove(this->Data->SelectedCoverage);
         this->Data->LexicalHypothesisContainer.remove(this->Data->SelectedCoverage);
         this->Data->SelectedLexicalHypothesis = NULL;
     }
@@ -79,11 +81,11 @@ void clsCardinalityHypothesisContainer::removeSelectedLexicalHypothesisIfEmpty()
 bool clsCardinalityHypothesisContainer::insertNewHypothesis(clsSearchGraphNode &_node)
 {
     if(_node.getTotalCost() -
-            log(clsCardinalityHypothesisContainer::SearchBeamWidth.value()) <
+            DecoderSettings::current().LogSearchBeamWidth <
             this->Data->CostLimit)
     {
         this->Data->CostLimit = _node.getTotalCost() -
-                log(clsCardinalityHypothesisContainer::SearchBeamWidth.value());
+                DecoderSettings::current().LogSearchBeamWidth;
     }
 
     // To speed up things, the lexical hypothesis is preselected by another function
@@ -109,7 +111,7 @@ bool clsCardinalityHypothesisContainer::insertNewHypothesis(clsSearchGraphNode &
     this->Data->TotalSearchGraphNodeCount += ((qint64)Container.nodes().size() - (qint64)OldContainerSize);
 
     if(this->Data->TotalSearchGraphNodeCount >
-            clsCardinalityHypothesisContainer::MaxCardinalitySizeLazyPruning)
+            DecoderSettings::current().MaxCardinalitySizeLazyPruning)
         this->prune();
 
     return InsertionDone;
@@ -217,75 +219,105 @@ void clsCardinalityHypothesisContainer::localUpdateBestAndWorstNodes(const Cover
 
 void clsCardinalityHypothesisContainer::prune()
 {
-    if(this->Data->TotalSearchGraphNodeCount <= this->MaxCardinalityContainerSize.value()) {
+    if(this->Data->TotalSearchGraphNodeCount <= DecoderSettings::current().MaxCardinalityContainerSize) {
         updateBestAndWorstNodes();
         return;
     }
 
-    QHash<Coverage_t, int> PickedHypothesisCount;
+    // Lexical hypothesis containers are addressed by their index in this list to avoid looking coverages up. The list
+    // follows order of coverages so ties between equal cost nodes are always broken the same way.
+    QVector<CoverageLexicalHypothesisMap_t::Iterator> Containers;
+    Containers.reserve(this->Data->LexicalHypothesisContainer.size());
+    for(auto LexHypoContainerIter = this->Data->LexicalHypothesisContainer.begin();
+        LexHypoContainerIter != this->Data->LexicalHypothesisContainer.end();
+        ++LexHypoContainerIter)
+        Containers.append(LexHypoContainerIter);
+
+    QVector<int> PickedHypothesisCount(Containers.size(), 0);
     int TotalSearchGraphNodeCount = 0;
-    // First perform pruning respecting the primal share of each coverage if needed
-    if(clsCardinalityHypothesisContainer::PrimaryCoverageShare.value() != 0) {
-        for(auto LexHypoContainerIter = this->Data->LexicalHypothesisContainer.begin();
-            LexHypoContainerIter != this->Data->LexicalHypothesisContainer.end();
-            ++LexHypoContainerIter) {
+    // First perform pruning respecting the primal share of each coverage if needed.
+    // Without primal share, nodes of the lexical hypothesis containers will be
+    // chosen only based on their costs, so initially we do not choose any nodes
+    // from any of these containers
+    if(DecoderSettings::current().PrimaryCoverageShare != 0) {
+        for(int Index = 0; Index < Containers.size(); ++Index) {
             int PickedFromThisCoverage = qMin(
-                        (int)clsCardinalityHypothesisContainer::PrimaryCoverageShare.value(),
-                        LexHypoContainerIter->nodes().size()
+                        (int)DecoderSettings::current().PrimaryCoverageShare,
+                        Containers.at(Index)->nodes().size()
                         );
-            PickedHypothesisCount[LexHypoContainerIter.key()] = PickedFromThisCoverage;
+            PickedHypothesisCount[Index] = PickedFromThisCoverage;
             TotalSearchGraphNodeCount += PickedFromThisCoverage;
         }
-    } else {
-        // Without primal share, nodes of the lexical hypothesis containers will be
-        // chosen only based on their costs, so initially we do not choose any nodes
-        // from any of these containers
-        for(auto LexHypoContainerIter = this->Data->LexicalHypothesisContainer.begin();
-            LexHypoContainerIter != this->Data->LexicalHypothesisContainer.end();
-            ++LexHypoContainerIter)
-            PickedHypothesisCount[LexHypoContainerIter.key()] = 0;
     }
-    // Fill up vacant places if there are any
+
+    // Fill up vacant places if there are any. Nodes of each container are sorted so a heap of the next candidate
+    // node of each container is enough to pick the cheapest remaining nodes.
+    Cost_t CostThreshold =
+            this->Data->BestLexicalHypothesis->getBestCost() -
+            DecoderSettings::current().LogSearchBeamWidth;
+    typedef QPair<Cost_t, int> CostIndex_t;
+    std::priority_queue<CostIndex_t, std::vector<CostIndex_t>, std::greater<CostIndex_t>> NextNodes;
+    auto pushNextNode = [&] (int _index) {
+        int NextCoverageNodeIndex = PickedHypothesisCount.at(_index);
+        if(NextCoverageNodeIndex >= Containers.at(_index)->nodes().size())
+            return;
+        Cost_t Cost = Containers.at(_index)->nodes().at(NextCoverageNodeIndex).getTotalCost();
+        if(Cost < CostThreshold)
+            NextNodes.push(qMakePair(Cost, _index));
+    };
+
+    if(TotalSearchGraphNodeCount < DecoderSettings::current().MaxCardinalityContainerSize)
+        for(int Index = 0; Index < Containers.size(); ++Index)
+            pushNextNode(Index);
+
     while(TotalSearchGraphNodeCount <
-            clsCardinalityHypothesisContainer::MaxCardinalityContainerSize.value()) {
-        Coverage_t ChosenCoverage;
-        Cost_t ChosenNodeTotalCost =
-                this->Data->BestLexicalHypothesis->getBestCost() -
-                log(clsCardinalityHypothesisContainer::SearchBeamWidth.value());
-        for(auto HypoContainerIter = this->Data->LexicalHypothesisContainer.begin();
-            HypoContainerIter != this->Data->LexicalHypothesisContainer.end();
-            ++HypoContainerIter) {
-            int NextCoverageNodeIndex = PickedHypothesisCount[HypoContainerIter.key()];
-            if(NextCoverageNodeIndex >= HypoContainerIter->nodes().size())
-                continue;
-            const clsSearchGraphNode& Node = HypoContainerIter->nodes().at(NextCoverageNodeIndex);
-            if(Node.getTotalCost() < ChosenNodeTotalCost) {
-                ChosenCoverage = HypoContainerIter.key();
-                ChosenNodeTotalCost = Node.getTotalCost();
-            }
-        }
-        if(ChosenCoverage.count(true) == 0)
-            break;
-        PickedHypothesisCount[ChosenCoverage]++;
+            DecoderSettings::current().MaxCardinalityContainerSize &&
+          NextNodes.empty() == false) {
+        int ChosenIndex = NextNodes.top().second;
+        NextNodes.pop();
+        PickedHypothesisCount[ChosenIndex]++;
         TotalSearchGraphNodeCount++;
+        pushNextNode(ChosenIndex);
     }
-    // Remove empty containers
-    for(auto CoverageIter = PickedHypothesisCount.begin();
-        CoverageIter != PickedHypothesisCount.end();
-        ++CoverageIter) {
-        if(*CoverageIter == 0) {
+
+    // Remove empty containers and find best and worst remaining containers in the same scan
+    QList<Coverage_t> EmptyCoverages;
+    int BestIndex = -1, WorstIndex = -1;
+    Cost_t BestCost = INFINITY, WorstCost = -INFINITY;
+    for(int Index = 0; Index < Containers.size(); ++Index) {
+        clsLexicalHypothesisContainer& Container = *Containers.at(Index);
+        if(PickedHypothesisCount.at(Index) == 0) {
             // Avoid deleting the selected coverage
-            if(this->Data->SelectedLexicalHypothesis != &this->Data->LexicalHypothesisContainer[CoverageIter.key()])
-                this->Data->LexicalHypothesisContainer.remove(CoverageIter.key());
+            if(this->Data->SelectedLexicalHypothesis != &Container){
+                EmptyCoverages.append(Containers.at(Index).key());
+                continue;
+            }
         }
-        else if (*CoverageIter < this->Data->LexicalHypothesisContainer[CoverageIter.key()].nodes().size()){
-            clsLexicalHypoNodeSet& Nodes =  this->Data->LexicalHypothesisContainer[CoverageIter.key()].nodes();
-            Nodes.erase(Nodes.begin() + *CoverageIter, Nodes.end());
+        else if (PickedHypothesisCount.at(Index) < Container.nodes().size()){
+            clsLexicalHypoNodeSet& Nodes = Container.nodes();
+            Nodes.erase(Nodes.begin() + PickedHypothesisCount.at(Index), Nodes.end());
+        }
+        if (Container.nodes().isEmpty())
+            continue;
+        if (BestCost > Container.getBestCost()){
+            BestCost = Container.getBestCost();
+            BestIndex = Index;
+        }
+        if (WorstCost < Container.getWorstCost()){
+            WorstCost = Container.getWorstCost();
+            WorstIndex = Index;
         }
     }
     // Update best and worst placeholders and the total node count
+    this->Data->BestLexicalHypothesis = BestIndex < 0 ? NULL : &(*Containers.at(BestIndex));
+    this->Data->BestCoverage = BestIndex < 0 ? Coverage_t() : Containers.at(BestIndex).key();
+    this->Data->WorstLexicalHypothesis = WorstIndex < 0 ? NULL : &(*Containers.at(WorstIndex));
+    this->Data->WorstCoverage = WorstIndex < 0 ? Coverage_t() : Containers.at(WorstIndex).key();
+    foreach(const Coverage_t& Coverage, EmptyCoverages){
+        this->Data->LexicalHypothesisIndex.remove(Coverage);
+        this->Data->LexicalHypothesisContainer.remove(Coverage);
+    }
     this->Data->TotalSearchGraphNodeCount = TotalSearchGraphNodeCount;
-    updateBestAndWorstNodes();
     if(this->Data->TotalSearchGraphNodeCount > 0)
         this->Data->CostLimit = this->Data->WorstLexicalHypothesis->getWorstCost();
 }
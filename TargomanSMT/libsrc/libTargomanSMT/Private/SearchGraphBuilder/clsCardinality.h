@@ -27,6 +27,7 @@
 #ifndef TARGOMAN_CORE_PRIVATE_SEARCHGRAPHBUILDER_CLSCARDINALITY_H
 #define TARGOMAN_CORE_PRIVATE_SEARCHGRAPHBUILDER_CLSCARDINALITY_H
 
+#include <QMap>
 #include <QHash>
 #include <QBitArray>
 #include "clsLexicalHypothesis.h"
@@ -38,10 +39,25 @@ namespace Private{
 namespace SearchGraphBuilder {
 
 /**
- * @brief CoverageLexicalHypothesisMap_t    used to make the source code more readable
+ * @brief CoverageLexicalHypothesisMap_t    used to make the source code more readable. Lexical hypothesis containers
+ * are stored in map nodes so pointers to them remain valid until they are removed and they are always iterated in
+ * order of their coverage, which keeps expansion and pruning independent of hash seeds.
  */
 typedef QMap<Coverage_t, clsLexicalHypothesisContainer> CoverageLexicalHypothesisMap_t;
 
+/**
+ * @brief The stuCoverageRestCost struct    rest cost information which depends just on coverage
+ */
+struct stuCoverageRestCost{
+    CoverageGaps_t  Gaps;           /**< Uncovered ranges of coverage */
+    Common::Cost_t  StaticCost;     /**< Sum of rest cost of uncovered ranges */
+
+    stuCoverageRestCost(const CoverageGaps_t& _gaps = CoverageGaps_t(), Common::Cost_t _staticCost = 0) :
+        Gaps(_gaps),
+        StaticCost(_staticCost)
+    {}
+};
+
 /**
  * @brief The clsCardinalityHypothesisContainerData class   placeholder for the cardinality hypothesis holder data
  */
@@ -67,13 +83,20 @@ public:
         BestLexicalHypothesis(_other.BestLexicalHypothesis),
         WorstCoverage(_other.WorstCoverage),
         WorstLexicalHypothesis(_other.WorstLexicalHypothesis),
-        CostLimit(_other.CostLimit)
-    {}
+        CostLimit(_other.CostLimit),
+        CoverageRestCosts(_other.CoverageRestCosts)
+    {
+        for(auto LexHypoContainerIter = this->LexicalHypothesisContainer.begin();
+            LexHypoContainerIter != this->LexicalHypothesisContainer.end();
+            ++LexHypoContainerIter)
+            this->LexicalHypothesisIndex.insert(LexHypoContainerIter.key(), &LexHypoContainerIter.value());
+    }
 
     ~clsCardinalityHypothesisContainerData(){}
 
 public:
     CoverageLexicalHypothesisMap_t  LexicalHypothesisContainer;
+    QHash<Coverage_t, clsLexicalHypothesisContainer*> LexicalHypothesisIndex;   /**< Hashed index of #LexicalHypothesisContainer used for lookups */
     Coverage_t                      SelectedCoverage;
     clsLexicalHypothesisContainer*  SelectedLexicalHypothesis;
     size_t                          TotalSearchGraphNodeCount;
@@ -82,6 +105,7 @@ public:
     Coverage_t                      WorstCoverage;
     clsLexicalHypothesisContainer*  WorstLexicalHypothesis;
     Common::Cost_t                  CostLimit;
+    QHash<Coverage_t, stuCoverageRestCost> CoverageRestCosts;
 
     friend class UnitTestNameSpace::clsUnitTest;
 };
@@ -107,7 +131,12 @@ public:
         /*if(this->Data->LexicalHypothesisContainer.contains(_coverage) == false){
             TargomanDebug(1,"Creating new LexHypo for coverage = " + bitArray2Str(_coverage));
         }*/
-        return this->Data->LexicalHypothesisContainer[_coverage];
+        clsLexicalHypothesisContainer* Container = this->Data->LexicalHypothesisIndex.value(_coverage, NULL);
+        if (Container == NULL){
+            Container = &this->Data->LexicalHypothesisContainer[_coverage];
+            this->Data->LexicalHypothesisIndex.insert(_coverage, Container);
+        }
+        return *Container;
     }
 
     /**
@@ -126,6 +155,22 @@ public:
         return this->Data->LexicalHypothesisContainer;
     }
 
+    /**
+     * @brief coverageRestCost  returns memoised rest cost information of the given coverage
+     * @return                  pointer to rest cost information or NULL if it has not been stored yet
+     */
+    inline const stuCoverageRestCost* coverageRestCost(const Coverage_t& _coverage) const{
+        QHash<Coverage_t, stuCoverageRestCost>::ConstIterator Iter = this->Data->CoverageRestCosts.constFind(_coverage);
+        return Iter == this->Data->CoverageRestCosts.constEnd() ? NULL : &Iter.value();
+    }
+
+    /**
+     * @brief storeCoverageRestCost stores rest cost information of the given coverage to be reused by other expansions
+     */
+    inline const stuCoverageRestCost& storeCoverageRestCost(const Coverage_t& _coverage, const stuCoverageRestCost& _restCost){
+        return *this->Data->CoverageRestCosts.insert(_coverage, _restCost);
+    }
+
     /**
      * @brief rootCardinalityHypothesisContainer    instantiates the root container for root translation node which represents no source word translation (empty node)
      * @param _emptyCoverage                        this parameter is used to avoid creation of multiple instances of empty coverage
@@ -133,8 +178,7 @@ public:
      */
     inline static clsCardinalityHypothesisContainer rootCardinalityHypothesisContainer(Coverage_t _emptyCoverage){
         clsCardinalityHypothesisContainer CoverageContainer;
-        CoverageContainer.Data->LexicalHypothesisContainer.insert(_emptyCoverage,
-                                                            clsLexicalHypothesisContainer::rootLexicalHypothesis());
+        CoverageContainer[_emptyCoverage] = clsLexicalHypothesisContainer::rootLexicalHypothesis();
         return CoverageContainer;
     }
 
@@ -143,6 +187,7 @@ public:
      * @param _coverage     input coverage corresponding to which the lexical hypothesis container will be removed from the list
      */
     void remove(Coverage_t _coverage){
+        this->Data->LexicalHypothesisIndex.remove(_coverage);
         this->Data->LexicalHypothesisContainer.remove(_coverage);
         if (this->Data->WorstLexicalHypothesis != NULL && this->Data->WorstCoverage == _coverage){
             this->updateWorstNode();
@@ -226,19 +271,10 @@ private:
 
 
 
-private:
-    static size_t MaxCardinalitySizeLazyPruning;
-
 public:
     double getCostLimit(){
         return this->Data->CostLimit;
     }
-    static void setHardReorderingJumpLimit(int _hardReorderingJumpLimit) {
-        clsCardinalityHypothesisContainer::MaxCardinalitySizeLazyPruning = 2 * clsCardinalityHypothesisContainer::MaxCardinalityContainerSize.value() - 1;
-        if(clsCardinalityHypothesisContainer::PrimaryCoverageShare.value() != 0)
-            clsCardinalityHypothesisContainer::MaxCardinalitySizeLazyPruning +=
-                clsCardinalityHypothesisContainer::PrimaryCoverageShare.value() << _hardReorderingJumpLimit;
-    }
 
 private:
     QExplicitlySharedDataPointer<clsCardinalityHypothesisContainerData> Data;
@@ -247,6 +283,7 @@ private:
     static Common::Configuration::tmplRangedConfigurable<double>  SearchBeamWidth; /**< Beam width for the beam search */
 
     friend class UnitTestNameSpace::clsUnitTest;
+    friend class Targoman::SMT::Private::DecoderSettings;
 
 };
 
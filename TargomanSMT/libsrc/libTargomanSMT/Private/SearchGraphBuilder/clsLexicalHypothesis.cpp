@@ -80,7 +80,7 @@ Cost_t clsLexicalHypothesisContainer::getWorstCost() const
  */
 bool clsLexicalHypothesisContainer::insertHypothesis(clsSearchGraphNode& _node)
 {
-    bool InsertionResult = this->Data->Nodes.insert(_node, clsLexicalHypothesisContainer::KeepRecombined.value());
+    bool InsertionResult = this->Data->Nodes.insert(_node, DecoderSettings::current().KeepRecombined);
     return InsertionResult;
 //    if(InsertionResult.second == false) {
 //        if(clsLexicalHypothesisContainer::KeepRecombined.value())
@@ -99,7 +99,7 @@ bool clsLexicalHypothesisContainer::insertHypothesis(clsSearchGraphNode& _node)
  */
 void clsLexicalHypothesisContainer::finalizeRecombination()
 {
-    if(clsLexicalHypothesisContainer::KeepRecombined.value() == false)
+    if(DecoderSettings::current().KeepRecombined == false)
         return;
 
     clsLexicalHypoNodeSet::iterator BestNodeIter = this->Data->Nodes.begin();
@@ -31,6 +31,7 @@
 #include "clsSearchGraphNode.h"
 #include "libTargomanCommon/Types.h"
 #include "libTargomanCommon/Configuration/tmplConfigurable.h"
+#include "Private/DecoderSettings.h"
 #include <set>
 #include <iostream>
 
@@ -308,7 +309,7 @@ public:
 
     inline static clsLexicalHypothesisContainer rootLexicalHypothesis(){
         clsLexicalHypothesisContainer LexicalHypothesis;
-        LexicalHypothesis.Data->Nodes.insert(*pInvalidSearchGraphNode, clsLexicalHypothesisContainer::KeepRecombined.value());
+        LexicalHypothesis.Data->Nodes.insert(*pInvalidSearchGraphNode, DecoderSettings::current().KeepRecombined);
         return LexicalHypothesis;
     }
 
@@ -336,6 +337,7 @@ private:
 
     friend class clsLexicalHypoNodeSet;
     friend class UnitTestNameSpace::clsUnitTest;
+    friend class Targoman::SMT::Private::DecoderSettings;
 
 };
 
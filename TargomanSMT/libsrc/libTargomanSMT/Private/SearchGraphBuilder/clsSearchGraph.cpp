@@ -24,6 +24,8 @@
  * @author Saeed Torabzadeh <saeed.torabzadeh@targoman.com>
  */
 #include <functional>
+#include <queue>
+#include <algorithm>
 
 #include "clsSearchGraph.h"
 #include "../GlobalConfigs.h"
@@ -67,13 +69,7 @@ tmplRangedConfigurable<quint8> clsSearchGraph::HardReorderingJumpLimit(
         MAKE_CONFIG_PATH("HardReorderingJumpLimit"),
         "Maximum jump width limit. Hard constrain.",
         1,64,
-        6,
-        [] (const intfConfigurable& _item, QString&) {
-            clsCardinalityHypothesisContainer::setHardReorderingJumpLimit(
-                    _item.toVariant().Int
-            );
-            return true;
-        });
+        6);
 
 tmplRangedConfigurable<quint8> clsSearchGraph::ReorderingConstraintMaximumRuns(
         MAKE_CONFIG_PATH("ReorderingConstraintMaximumRuns"),
@@ -97,15 +93,30 @@ tmplConfigurable<bool>   clsSearchGraph::DoPrunePreInsertion(
         "Prune hypotheses before insertion(default) or not",
         true);
 
+tmplConfigurable<enuSearchMode::Type> clsSearchGraph::SearchMode(
+        MAKE_CONFIG_PATH("SearchMode"),
+        "Search strategy can be (" + enuSearchMode::options().join("|") + ")",
+        enuSearchMode::toStr(enuSearchMode::Exhaustive),
+        ReturnTrueCrossValidator());
+
+tmplRangedConfigurable<quint32> clsSearchGraph::CubePruningPopLimit(
+        MAKE_CONFIG_PATH("CubePruningPopLimit"),
+        "Maximum number of hypotheses generated for each cardinality in CubePruning search mode",
+        1,1000000,
+        1000);
+
 FeatureFunction::intfFeatureFunction*  clsSearchGraph::pPhraseTable = NULL;
 RuleTable::intfRuleTable*              clsSearchGraph::pRuleTable = NULL;
 RuleTable::clsRuleNode*                clsSearchGraph::UnknownWordRuleNode;
 
 /**********************************************************************************/
-clsSearchGraph::clsSearchGraph(const Sentence_t& _sentence):
+clsSearchGraph::clsSearchGraph(const Sentence_t& _sentence,
+                               clsPhraseCandidateCache* _sharedCandidates,
+                               const stuTranslationDeadline& _deadline):
     Data(new clsSearchGraphData(_sentence))
 {
-    this->collectPhraseCandidates();
+    this->Data->Deadline = _deadline;
+    this->collectPhraseCandidates(_sharedCandidates);
     this->decode();
 }
 /**
@@ -145,7 +156,7 @@ void clsSearchGraph::init(QSharedPointer<QSettings> _configSettings)
 
     TargomanLogInfo(7, "Checking Source Vocab");
     try{
-        QList<QHash<QString, Common::WordIndex_t>::iterator> ItersToRemove;
+        QList<clsSourceVocab::const_iterator> ItersToRemove;
         /// @note As a result of aligning some words to NULL by general word aligners, we need to take care of
         ///       tokens that have a word index but only contribute to multi-word phrases. These will cause
         ///       malfunction of OOV handler module as it will assume these words have translations by themselves
@@ -206,16 +217,49 @@ void clsSearchGraph::extendSourcePhrase(const QList<WordIndex_t>& _wordIndexes,
     _prevNodes = NextNodes;
 }
 
+/**
+ * @brief Creates phrase candidate collection of a source phrase or reuses the one already created for an identical
+ * phrase when a shared cache is provided.
+ * @param _key  key of the source phrase in the shared cache. Empty keys are not shared.
+ */
+clsPhraseCandidateCollection clsSearchGraph::makePhraseCandidateCollection(size_t _beginPos,
+                                                                           size_t _endPos,
+                                                                           const QList<clsRuleNode>& _ruleNodes,
+                                                                           const QString& _key,
+                                                                           clsPhraseCandidateCache* _sharedCandidates)
+{
+    if (_sharedCandidates == NULL || _key.isEmpty())
+        return clsPhraseCandidateCollection(_beginPos, _endPos, this->Data->Sentence, _ruleNodes);
+
+    clsPhraseCandidateCollection Collection;
+    if (_sharedCandidates->value(_key, Collection))
+        return Collection;
+
+    Collection = clsPhraseCandidateCollection(_beginPos, _endPos, this->Data->Sentence, _ruleNodes);
+    _sharedCandidates->insert(_key, Collection);
+    return Collection;
+}
+
 /**
  * @brief Looks up prefix tree for all phrases that matches with some parts of input sentence and stores them in the
  * PhraseCandidateCollections of #Data. This function also calculates maximum length of matching source phrase with phrase table.
+ * @param _sharedCandidates Phrase candidates shared with other sentences of a batch. Can be NULL.
  */
-void clsSearchGraph::collectPhraseCandidates()
+void clsSearchGraph::collectPhraseCandidates(clsPhraseCandidateCache* _sharedCandidates)
 {
     // TODO: When looking for phrases containing IXML tags, search both for the tagged version
     // and surface form version, e.g. "I ate <num>3</num>" => search for "I ate <num/>" and "I ate 3"
     this->Data->MaxMatchingSourcePhraseCardinality = 0;
+
+    QStringList TokenKeys;
+    if (_sharedCandidates)
+        foreach(const clsToken& Token, this->Data->Sentence)
+            TokenKeys.append(clsPhraseCandidateCache::tokenKey(Token));
+
     for (size_t FirstPosition = 0; FirstPosition < (size_t)this->Data->Sentence.size(); ++FirstPosition) {
+        QString PhraseKey = TokenKeys.value(FirstPosition);
+        // Temporary rule nodes are sentence specific and are used just on 1-grams
+        bool IsSharable = this->Data->Sentence.at(FirstPosition).temporaryRuleNode().isInvalid();
         this->Data->PhraseCandidateCollections.append(QVector<clsPhraseCandidateCollection>(this->Data->Sentence.size() - FirstPosition));
         QList<RulesPrefixTree_t::pNode_t> PrevNodes =
                 QList<RulesPrefixTree_t::pNode_t>() << this->pRuleTable->prefixTree().rootNode();
@@ -240,7 +284,9 @@ void clsSearchGraph::collectPhraseCandidates()
 
             this->Data->MaxMatchingSourcePhraseCardinality = qMax(this->Data->MaxMatchingSourcePhraseCardinality, 1);
 
-            this->Data->PhraseCandidateCollections[FirstPosition][0] = clsPhraseCandidateCollection(FirstPosition, FirstPosition + 1, this->Data->Sentence, RuleNodes);
+            this->Data->PhraseCandidateCollections[FirstPosition][0] =
+                    this->makePhraseCandidateCollection(FirstPosition, FirstPosition + 1, RuleNodes,
+                                                        IsSharable ? PhraseKey : QString(), _sharedCandidates);
 
 
         }
@@ -268,7 +314,11 @@ void clsSearchGraph::collectPhraseCandidates()
             if (RuleNodes.isEmpty())
                 break; // Appending next word breaks phrase lookup
 
-            this->Data->PhraseCandidateCollections[FirstPosition][LastPosition - FirstPosition] = clsPhraseCandidateCollection(FirstPosition, LastPosition + 1, this->Data->Sentence, RuleNodes);
+            if (_sharedCandidates)
+                PhraseKey.append(QChar(0x1E)).append(TokenKeys.at(LastPosition));
+
+            this->Data->PhraseCandidateCollections[FirstPosition][LastPosition - FirstPosition] =
+                    this->makePhraseCandidateCollection(FirstPosition, LastPosition + 1, RuleNodes, PhraseKey, _sharedCandidates);
             this->Data->MaxMatchingSourcePhraseCardinality = qMax(this->Data->MaxMatchingSourcePhraseCardinality,
                                                                       (int)(LastPosition - FirstPosition + 1));
         }
@@ -289,7 +339,7 @@ bool clsSearchGraph::conformsIBM1Constraint(const Coverage_t& _newCoverage)
     for(int i=_newCoverage.size() - 1; i>=0; --i)
         if(_newCoverage.testBit(i)){
             size_t CountOfPrevZeros = _newCoverage.count(false) + i - _newCoverage.size() + 1;
-            return (CountOfPrevZeros <= this->ReorderingConstraintMaximumRuns.value());
+            return (CountOfPrevZeros <= DecoderSettings::current().ReorderingConstraintMaximumRuns);
         }
     return true;
 }
@@ -302,13 +352,13 @@ bool clsSearchGraph::conformsHardReorderingJumpLimit(const Coverage_t& _prevCove
         // No need to check _startPos as it must be less than or equal to _endPos
 //        if(_startPos > clsSearchGraph::HardReorderingJumpLimit.value())
 //            return false;
-        if(_endPos > clsSearchGraph::HardReorderingJumpLimit.value())
+        if(_endPos > DecoderSettings::current().HardReorderingJumpLimit)
             return false;
         return true;
     }
 
     int JumpWidth = abs(_prevEnd - _startPos);
-    if(JumpWidth > clsSearchGraph::HardReorderingJumpLimit.value())
+    if(JumpWidth > DecoderSettings::current().HardReorderingJumpLimit)
         return false;
 
     int FirstEmptyPosition = _prevCoverage.size();
@@ -319,7 +369,7 @@ bool clsSearchGraph::conformsHardReorderingJumpLimit(const Coverage_t& _prevCove
         }
 
     JumpWidth = qAbs((int)_endPos - FirstEmptyPosition);
-    return JumpWidth <= clsSearchGraph::HardReorderingJumpLimit.value();
+    return JumpWidth <= DecoderSettings::current().HardReorderingJumpLimit;
 }
 
 #ifdef TARGOMAN_SHOW_DEBUG
@@ -381,6 +431,9 @@ bool clsSearchGraph::decode()
     this->initializeRestCostsMatrix();
 
     int PrunedByHardReorderingJumpLimit = 0;
+    bool CheckDeadline = this->Data->Deadline.isSet();
+    bool UseCubePruning = DecoderSettings::current().UseCubePruning;
+    this->Data->Degraded = false;
 
     for (int NewCardinality = 1; NewCardinality <= this->Data->Sentence.size(); ++NewCardinality){
 
@@ -394,8 +447,11 @@ bool clsSearchGraph::decode()
         clsCardinalityHypothesisContainer& CurrCardHypoContainer =
                 this->Data->HypothesisHolder[NewCardinality];
 
+        if (UseCubePruning)
+            this->expandByCubePruning(NewCardinality, CheckDeadline);
+
         for (int PrevCardinality = MinPrevCardinality;
-             PrevCardinality < NewCardinality; ++PrevCardinality) {
+             UseCubePruning == false && PrevCardinality < NewCardinality; ++PrevCardinality) {
 
             unsigned short NewPhraseCardinality = NewCardinality - PrevCardinality;
 
@@ -412,9 +468,14 @@ bool clsSearchGraph::decode()
                 PrevCoverageIter != PrevCardHypoContainer.lexicalHypotheses().end();
                 ++PrevCoverageIter){
 
+                if (CheckDeadline && this->Data->Deadline.isExpired()){
+                    this->Data->Degraded = true;
+                    break;
+                }
 
                 const Coverage_t& PrevCoverage = PrevCoverageIter.key();
                 clsLexicalHypothesisContainer& PrevLexHypoContainer = PrevCoverageIter.value();
+                const stuCoverageRestCost* PrevRestCost = PrevCardHypoContainer.coverageRestCost(PrevCoverage);
 
                 Q_ASSERT(PrevCoverage.count(true) == PrevCardinality);
                 Q_ASSERT(PrevLexHypoContainer.nodes().size());
@@ -466,7 +527,11 @@ bool clsSearchGraph::decode()
                     if (PhraseCandidates.isInvalid()){
                         continue; //TODO If there are no more places to fill after this startpos break
                     }
-                    Cost_t RestCost =  this->calculateRestCost(NewCoverage, NewPhraseBeginPos, NewPhraseEndPos);
+                    Cost_t RestCost =  this->calculateRestCost(CurrCardHypoContainer,
+                                                               NewCoverage,
+                                                               PrevRestCost,
+                                                               NewPhraseBeginPos,
+                                                               NewPhraseEndPos);
 
                     CurrCardHypoContainer.setLexicalHypothesis(NewCoverage);
 
@@ -503,7 +568,7 @@ bool clsSearchGraph::decode()
 #ifdef TARGOMAN_SHOW_DEBUG
 //                            printNode(NewHypoNode, NewCardinality, CurrCardHypoContainer.getCostLimit());
 #endif
-                            if (clsSearchGraph::DoPrunePreInsertion.value() &&
+                            if (DecoderSettings::current().DoPrunePreInsertion &&
                                 CurrCardHypoContainer.mustBePruned(NewHypoNode.getTotalCost())){
                                 ++PrunedPreInsertion;
                                 continue;
@@ -520,8 +585,12 @@ bool clsSearchGraph::decode()
 
                 }//for NewPhraseBeginPos
             }//for PrevCoverageIter
+            if (this->Data->Degraded)
+                break;
         }//for PrevCardinality
         CurrCardHypoContainer.finlizePruningAndcleanUp();
+        if (this->Data->Degraded)
+            break;
 
 //#ifdef TARGOMAN_SHOW_DEBUG
         // Vedadian
@@ -583,6 +652,9 @@ bool clsSearchGraph::decode()
 //#endif
     }//for NewCardinality
 
+    if (this->Data->Degraded)
+        this->completeBestPartialHypothesis();
+
     Coverage_t FullCoverage;
     FullCoverage.fill(1, this->Data->Sentence.size());
 
@@ -601,14 +673,276 @@ bool clsSearchGraph::decode()
     }
 }
 
+/**
+ * @brief Cube of new hypotheses made by extending hypotheses of a previous coverage with candidates of a source span.
+ * Both dimensions are sorted by cost so cube can be explored best first.
+ */
+struct stuCube{
+    QVector<const clsSearchGraphNode*>      PrevNodes;          /**< Previous nodes conforming to reordering limit.*/
+    const clsPhraseCandidateCollection*     PhraseCandidates;
+    Coverage_t                              NewCoverage;
+    size_t                                  BeginPos;
+    size_t                                  EndPos;
+    Cost_t                                  RestCost;
+};
+
+struct stuCubeItem{
+    int                 CubeIndex;
+    int                 PrevNodeIndex;
+    int                 CandidateIndex;
+    clsSearchGraphNode  Node;
+
+    stuCubeItem(int _cubeIndex, int _prevNodeIndex, int _candidateIndex, const clsSearchGraphNode& _node) :
+        CubeIndex(_cubeIndex),
+        PrevNodeIndex(_prevNodeIndex),
+        CandidateIndex(_candidateIndex),
+        Node(_node)
+    {}
+
+    bool operator < (const stuCubeItem& _other) const {
+        // std::priority_queue pops the largest item so the cheapest must be the largest
+        return this->Node.getTotalCost() > _other.Node.getTotalCost();
+    }
+};
+
+/**
+ * @brief Fills cardinality container of _newCardinality using cube pruning.
+ *
+ * Instead of scoring all combinations of previous hypotheses and phrase candidates, a cube is made for each
+ * (previous coverage, new source span) pair. Best item of all cubes are scored and put in a priority queue, then
+ * the cheapest item is popped, inserted in the container and its neighbours in its cube are scored and queued.
+ * This continues until #CubePruningPopLimit items has been popped or remaining items are out of beam.
+ * @param _newCardinality cardinality to be filled
+ * @param _checkDeadline whether deadline must be checked or not
+ */
+void clsSearchGraph::expandByCubePruning(int _newCardinality, bool _checkDeadline)
+{
+    bool IsFinal = (_newCardinality == this->Data->Sentence.size());
+    int MinPrevCardinality = qMax(_newCardinality - this->Data->MaxMatchingSourcePhraseCardinality, 0);
+
+    clsCardinalityHypothesisContainer& CurrCardHypoContainer = this->Data->HypothesisHolder[_newCardinality];
+
+    QVector<stuCube> Cubes;
+    for (int PrevCardinality = MinPrevCardinality; PrevCardinality < _newCardinality; ++PrevCardinality) {
+        unsigned short NewPhraseCardinality = _newCardinality - PrevCardinality;
+        clsCardinalityHypothesisContainer& PrevCardHypoContainer = this->Data->HypothesisHolder[PrevCardinality];
+
+        if(PrevCardHypoContainer.isEmpty()) {
+            TargomanLogWarn(1, "Previous cardinality is empty. (PrevCard: " << PrevCardinality << ", CurrentCard: " << _newCardinality << ")");
+            continue;
+        }
+
+        for(CoverageLexicalHypothesisMap_t::Iterator PrevCoverageIter = PrevCardHypoContainer.lexicalHypotheses().begin();
+            PrevCoverageIter != PrevCardHypoContainer.lexicalHypotheses().end();
+            ++PrevCoverageIter){
+
+            if (_checkDeadline && this->Data->Deadline.isExpired()){
+                this->Data->Degraded = true;
+                return;
+            }
+
+            const Coverage_t& PrevCoverage = PrevCoverageIter.key();
+            const clsLexicalHypoNodeSet& PrevNodes = PrevCoverageIter.value().nodes();
+            if (PrevNodes.isEmpty())
+                continue;
+            const stuCoverageRestCost* PrevRestCost = PrevCardHypoContainer.coverageRestCost(PrevCoverage);
+
+            for (size_t NewPhraseBeginPos = 0;
+                 NewPhraseBeginPos <= (size_t)this->Data->Sentence.size() - NewPhraseCardinality;
+                 ++NewPhraseBeginPos){
+                size_t NewPhraseEndPos = NewPhraseBeginPos + NewPhraseCardinality;
+
+                bool SkipStep = false;
+                for (size_t i= NewPhraseBeginPos; i<NewPhraseEndPos; ++i)
+                    if (PrevCoverage.testBit(i)){
+                        SkipStep = true;
+                        break;
+                    }
+                if (SkipStep)
+                    continue;
+
+                const clsPhraseCandidateCollection& PhraseCandidates =
+                        this->Data->PhraseCandidateCollections[NewPhraseBeginPos][NewPhraseCardinality - 1];
+                if (PhraseCandidates.isInvalid() || PhraseCandidates.usableTargetRuleCount() == 0)
+                    continue;
+
+                stuCube Cube;
+                for (int i = 0; i < PrevNodes.size(); ++i){
+                    const clsSearchGraphNode& PrevNode = PrevNodes.at(i);
+                    if (this->conformsHardReorderingJumpLimit(PrevNode.coverage(),
+                                                              PrevNode.sourceRangeBegin(),
+                                                              PrevNode.sourceRangeEnd(),
+                                                              NewPhraseBeginPos,
+                                                              NewPhraseEndPos))
+                        Cube.PrevNodes.append(&PrevNode);
+                }
+                if (Cube.PrevNodes.isEmpty())
+                    continue;
+
+                Cube.PhraseCandidates = &PhraseCandidates;
+                Cube.NewCoverage = PrevCoverage;
+                for (size_t i=NewPhraseBeginPos; i<NewPhraseEndPos; ++i)
+                    Cube.NewCoverage.setBit(i);
+                Cube.BeginPos = NewPhraseBeginPos;
+                Cube.EndPos = NewPhraseEndPos;
+                Cube.RestCost = this->calculateRestCost(CurrCardHypoContainer,
+                                                        Cube.NewCoverage,
+                                                        PrevRestCost,
+                                                        NewPhraseBeginPos,
+                                                        NewPhraseEndPos);
+                Cubes.append(Cube);
+            }
+        }
+    }
+
+    std::priority_queue<stuCubeItem> Candidates;
+    auto makeItem = [this, &Cubes, IsFinal] (int _cubeIndex, int _prevNodeIndex, int _candidateIndex) {
+        const stuCube& Cube = Cubes.at(_cubeIndex);
+        return stuCubeItem(_cubeIndex, _prevNodeIndex, _candidateIndex,
+                           clsSearchGraphNode(this->Data->Sentence,
+                                              *Cube.PrevNodes.at(_prevNodeIndex),
+                                              Cube.BeginPos,
+                                              Cube.EndPos,
+                                              Cube.NewCoverage,
+                                              Cube.PhraseCandidates->targetRules().at(_candidateIndex),
+                                              IsFinal,
+                                              Cube.RestCost));
+    };
+
+    for (int CubeIndex = 0; CubeIndex < Cubes.size(); ++CubeIndex)
+        Candidates.push(makeItem(CubeIndex, 0, 0));
+
+    quint32 PopLimit = DecoderSettings::current().CubePruningPopLimit;
+    for (quint32 Popped = 0; Popped < PopLimit && Candidates.empty() == false; ++Popped){
+        if (_checkDeadline && this->Data->Deadline.isExpired()){
+            this->Data->Degraded = true;
+            break;
+        }
+
+        stuCubeItem Item = Candidates.top();
+        Candidates.pop();
+
+        // Items are popped cheapest first so the rest are out of beam too
+        if (DecoderSettings::current().DoPrunePreInsertion &&
+            CurrCardHypoContainer.mustBePruned(Item.Node.getTotalCost()))
+            break;
+
+        CurrCardHypoContainer.setLexicalHypothesis(Cubes.at(Item.CubeIndex).NewCoverage);
+        CurrCardHypoContainer.insertNewHypothesis(Item.Node);
+        CurrCardHypoContainer.removeSelectedLexicalHypothesisIfEmpty();
+
+        // Each cell is queued just once: moving along previous nodes is only done on the first candidate column
+        const stuCube& Cube = Cubes.at(Item.CubeIndex);
+        if (Item.CandidateIndex == 0 && Item.PrevNodeIndex + 1 < Cube.PrevNodes.size())
+            Candidates.push(makeItem(Item.CubeIndex, Item.PrevNodeIndex + 1, 0));
+        if (Item.CandidateIndex + 1 < Cube.PhraseCandidates->usableTargetRuleCount())
+            Candidates.push(makeItem(Item.CubeIndex, Item.PrevNodeIndex, Item.CandidateIndex + 1));
+    }
+}
+
+/**
+ * @brief Completes search after deadline has been reached.
+ *
+ * Best lexical hypothesis of the highest filled cardinality is extended monotonically: at each step the longest
+ * translatable phrase starting at the first uncovered position is appended using all of its usable candidates and
+ * the best resulting node is extended further until the whole sentence is covered. Reordering limits are not
+ * checked here as the goal is to produce a complete translation as fast as possible.
+ */
+void clsSearchGraph::completeBestPartialHypothesis()
+{
+    int Cardinality = this->Data->Sentence.size();
+    while (Cardinality > 0 && this->Data->HypothesisHolder[Cardinality].isEmpty())
+        --Cardinality;
+
+    TargomanLogWarn(1, "Deadline reached after cardinality " << Cardinality << " of " << this->Data->Sentence.size()
+                    << ". Completing best partial hypothesis monotonically.");
+
+    while (Cardinality < this->Data->Sentence.size()) {
+        clsCardinalityHypothesisContainer& PrevCardHypoContainer = this->Data->HypothesisHolder[Cardinality];
+        CoverageLexicalHypothesisMap_t::Iterator BestLexIter = PrevCardHypoContainer.lexicalHypotheses().end();
+        for(CoverageLexicalHypothesisMap_t::Iterator LexIter = PrevCardHypoContainer.lexicalHypotheses().begin();
+            LexIter != PrevCardHypoContainer.lexicalHypotheses().end();
+            ++LexIter)
+            if (LexIter->nodes().isEmpty() == false &&
+                (BestLexIter == PrevCardHypoContainer.lexicalHypotheses().end() ||
+                 LexIter->getBestCost() < BestLexIter->getBestCost()))
+                BestLexIter = LexIter;
+
+        if (BestLexIter == PrevCardHypoContainer.lexicalHypotheses().end()){
+            TargomanLogWarn(1, "Unable to complete partial hypothesis of cardinality " << Cardinality);
+            return;
+        }
+
+        const Coverage_t& PrevCoverage = BestLexIter.key();
+        const clsSearchGraphNode& PrevNode = BestLexIter->nodes().bestNode();
+
+        size_t BeginPos = 0;
+        while (PrevCoverage.testBit(BeginPos))
+            ++BeginPos;
+
+        size_t MaxLength = qMin((size_t)this->Data->Sentence.size() - BeginPos,
+                                (size_t)this->Data->MaxMatchingSourcePhraseCardinality);
+        size_t Length = 0;
+        while (Length < MaxLength && PrevCoverage.testBit(BeginPos + Length) == false)
+            ++Length;
+        while (Length > 0 && this->Data->PhraseCandidateCollections[BeginPos][Length - 1].isInvalid())
+            --Length;
+
+        if (Length == 0){
+            TargomanLogWarn(1, "No translation option to complete partial hypothesis at position " << BeginPos);
+            return;
+        }
+
+        size_t EndPos = BeginPos + Length;
+        Coverage_t NewCoverage(PrevCoverage);
+        for (size_t i = BeginPos; i < EndPos; ++i)
+            NewCoverage.setBit(i);
+
+        int NewCardinality = Cardinality + (int)Length;
+        bool IsFinal = (NewCardinality == this->Data->Sentence.size());
+        clsCardinalityHypothesisContainer& CurrCardHypoContainer = this->Data->HypothesisHolder[NewCardinality];
+        const clsPhraseCandidateCollection& PhraseCandidates = this->Data->PhraseCandidateCollections[BeginPos][Length - 1];
+
+        Cost_t RestCost = this->calculateRestCost(CurrCardHypoContainer,
+                                                  NewCoverage,
+                                                  PrevCardHypoContainer.coverageRestCost(PrevCoverage),
+                                                  BeginPos,
+                                                  EndPos);
+
+        CurrCardHypoContainer.setLexicalHypothesis(NewCoverage);
+        for (int i = 0; i < PhraseCandidates.usableTargetRuleCount(); ++i){
+            clsSearchGraphNode NewHypoNode(this->Data->Sentence,
+                                           PrevNode,
+                                           BeginPos,
+                                           EndPos,
+                                           NewCoverage,
+                                           PhraseCandidates.targetRules().at(i),
+                                           IsFinal,
+                                           RestCost);
+            CurrCardHypoContainer.insertNewHypothesis(NewHypoNode);
+        }
+        CurrCardHypoContainer.removeSelectedLexicalHypothesisIfEmpty();
+        CurrCardHypoContainer.finlizePruningAndcleanUp();
+
+        Cardinality = NewCardinality;
+    }
+}
+
 /**
  * @brief Initializes rest cost matrix
  *
  * For every possible range of words of input sentence, finds approximate cost of every feature fucntions, then
  * tries to reduce that computed rest cost if sum of rest cost of splited phrase is less than whole phrase rest cost.
+ * Feature functions which compute position specific rest costs are also collected here.
  */
 void clsSearchGraph::initializeRestCostsMatrix()
 {
+    this->Data->PositionSpecificRestCostFFs.clear();
+    if(DecoderSettings::current().DoComputePositionSpecificRestCosts)
+        foreach(FeatureFunction::intfFeatureFunction* FF, gConfigs.ActiveFeatureFunctions)
+            if(FF->canComputePositionSpecificRestCost())
+                this->Data->PositionSpecificRestCostFFs.append(FF);
+
     this->Data->RestCostMatrix.resize(this->Data->Sentence.size());
     for (int SentenceStartPos=0; SentenceStartPos<this->Data->Sentence.size(); ++SentenceStartPos)
         this->Data->RestCostMatrix[SentenceStartPos].fill(
@@ -637,38 +971,38 @@ void clsSearchGraph::initializeRestCostsMatrix()
 
 /**
  * @brief This function approximates rest cost of translation for every feature function.
- * This approximation is based on covered word of transltion and begin and end position of source sentence words.
+ * The part which depends just on coverage (sum of rest costs of uncovered ranges) is memoised per coverage in the
+ * cardinality container. Uncovered ranges of a new coverage are derived from those of previous coverage by splitting
+ * the range containing the new phrase, and position specific rest costs are computed using them.
+ * @param _container cardinality container of the new coverage
  * @param _coverage Covered word for translation.
+ * @param _prevRestCost memoised rest cost information of previous coverage or NULL if not available
  * @param _beginPos start postion of source sentence.
  * @param _endPos end position of source sentence
  * @note _beginPos and _endPos helps us to infer previous node coverage.
  * @return returns approximate cost of rest cost.
  */
 
-Cost_t clsSearchGraph::calculateRestCost(const Coverage_t& _coverage, size_t _beginPos, size_t _endPos) const
+Cost_t clsSearchGraph::calculateRestCost(clsCardinalityHypothesisContainer& _container,
+                                         const Coverage_t& _coverage,
+                                         const stuCoverageRestCost* _prevRestCost,
+                                         size_t _beginPos,
+                                         size_t _endPos) const
 {
-    Cost_t RestCosts = 0.0;
-    size_t StartPosition = 0;
-    size_t Length = 0;
-
-    for(size_t i=0; i < (size_t)_coverage.size(); ++i)
-        if(_coverage.testBit(i) == false){ // start of contiguous zero bits.
-            if(Length == 0)
-                StartPosition = i;
-            ++Length;
-        }else if(Length){ // end of contiguous zero bits.
-            RestCosts += this->Data->RestCostMatrix[StartPosition][Length-1];
-            Length = 0;
-        }
-    if(Length)
-        RestCosts += this->Data->RestCostMatrix[StartPosition][Length-1];
-
-    if(clsSearchGraph::DoComputePositionSpecificRestCosts.value()) {
-        foreach(FeatureFunction::intfFeatureFunction* FF, gConfigs.ActiveFeatureFunctions.values()) {
-            if(FF->canComputePositionSpecificRestCost())
-                RestCosts += FF->getRestCostForPosition(_coverage, _beginPos, _endPos);
-        }
+    const stuCoverageRestCost* CoverageRestCost = _container.coverageRestCost(_coverage);
+    if(CoverageRestCost == NULL){
+        CoverageGaps_t Gaps = _prevRestCost ?
+                    coverGapRange(_prevRestCost->Gaps, _beginPos, _endPos) :
+                    coverageGaps(_coverage);
+        Cost_t StaticCost = 0.0;
+        foreach(const stuPos& Gap, Gaps)
+            StaticCost += this->Data->RestCostMatrix[Gap.first][Gap.second - Gap.first - 1];
+        CoverageRestCost = &_container.storeCoverageRestCost(_coverage, stuCoverageRestCost(Gaps, StaticCost));
     }
+
+    Cost_t RestCosts = CoverageRestCost->StaticCost;
+    foreach(FeatureFunction::intfFeatureFunction* FF, this->Data->PositionSpecificRestCostFFs)
+        RestCosts += FF->getRestCostForPositionWithGaps(_coverage, CoverageRestCost->Gaps, _beginPos, _endPos);
     return RestCosts;
 }
 
@@ -678,12 +1012,13 @@ clsPhraseCandidateCollectionData::clsPhraseCandidateCollectionData(size_t _begin
         this->TargetRules.append(RuleNode.targetRules());
 
     this->UsableTargetRuleCount = qMin(
-                (int)clsPhraseCandidateCollectionData::MaxTargetPhraseCount.value(),
+                (int)DecoderSettings::current().MaxTargetPhraseCount,
                 this->TargetRules.size()
                 );
 
-    // TODO: Maybe sorting can be added here
     this->BestApproximateCost = INFINITY;
+    QVector<QPair<Cost_t, int>> ApproximateCosts;
+    ApproximateCosts.reserve(this->UsableTargetRuleCount);
     // _observationHistogramSize must be taken care of to not exceed this->TargetRules.size()
     for(int Count = 0; Count < this->UsableTargetRuleCount; ++Count) {
         clsTargetRule& TargetRule = this->TargetRules[Count];
@@ -695,7 +1030,25 @@ clsPhraseCandidateCollectionData::clsPhraseCandidateCollectionData(size_t _begin
                 ApproximateCost += Cost;
             }
         this->BestApproximateCost = qMin(this->BestApproximateCost, ApproximateCost);
+        ApproximateCosts.append(qMakePair(ApproximateCost, Count));
     }
+
+    // Cube pruning explores candidates best first so it needs usable target rules sorted by their approximate cost.
+    // Exhaustive search keeps the original order as it decides ties and pruning of equal cost hypotheses.
+    if (DecoderSettings::current().UseCubePruning == false)
+        return;
+
+    std::stable_sort(ApproximateCosts.begin(), ApproximateCosts.end(),
+                     [] (const QPair<Cost_t, int>& _first, const QPair<Cost_t, int>& _second) {
+        return _first.first < _second.first;
+    });
+    QList<clsTargetRule> SortedTargetRules;
+    SortedTargetRules.reserve(this->TargetRules.size());
+    for(int Count = 0; Count < ApproximateCosts.size(); ++Count)
+        SortedTargetRules.append(this->TargetRules.at(ApproximateCosts.at(Count).second));
+    for(int Count = this->UsableTargetRuleCount; Count < this->TargetRules.size(); ++Count)
+        SortedTargetRules.append(this->TargetRules.at(Count));
+    this->TargetRules = SortedTargetRules;
 }
 
 QString clsPhraseCandidateCollectionData::moduleName()
@@ -703,11 +1056,23 @@ QString clsPhraseCandidateCollectionData::moduleName()
     return clsSearchGraph::moduleName();
 }
 
+QString clsPhraseCandidateCache::tokenKey(const clsToken &_token)
+{
+    // Source strings and tags are part of the key as some feature functions (e.g. OSM) depend on them
+    QString Key = _token.tagStr() + QChar(0x1F) + _token.string();
+    foreach(WordIndex_t WordIndex, _token.wordIndexes())
+        Key.append(QChar(0x1F)).append(QString::number(WordIndex));
+    return Key;
+}
+
 }
 }
 }
 }
 
+ENUM_CONFIGURABLE_IMPL(Targoman::SMT::Private::SearchGraphBuilder::enuSearchMode)
+
+
 
 
 
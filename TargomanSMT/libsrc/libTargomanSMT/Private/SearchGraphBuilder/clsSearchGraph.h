@@ -27,18 +27,25 @@
 #ifndef TARGOMAN_CORE_PRIVATE_SEARCHGRAPHBUILDER_CLSSEARCHGRAPHBUILDER_H
 #define TARGOMAN_CORE_PRIVATE_SEARCHGRAPHBUILDER_CLSSEARCHGRAPHBUILDER_H
 
+#include <QReadWriteLock>
 #include "Private/RuleTable/intfRuleTable.hpp"
 #include "libTargomanCommon/Configuration/tmplConfigurable.h"
 #include "Private/InputDecomposer/clsInput.h"
 #include "clsHypothesisHolder.hpp"
 #include "clsSearchGraphNode.h"
 #include "Private/FeatureFunctions/intfFeatureFunction.hpp"
+#include "Private/DecoderSettings.h"
 
 namespace Targoman{
 namespace SMT {
 namespace Private{
 namespace SearchGraphBuilder {
 
+TARGOMAN_DEFINE_ENHANCED_ENUM(enuSearchMode,
+                              Exhaustive,
+                              CubePruning
+                              );
+
 /**
  * @brief The clsPhraseCandidateCollectionData class container for the clsPhraseCandidateCollection data
  */
@@ -82,6 +89,7 @@ private:
     static Common::Configuration::tmplRangedConfigurable<quint8> MaxTargetPhraseCount;
 
     friend class UnitTestNameSpace::clsUnitTest;
+    friend class Targoman::SMT::Private::DecoderSettings;
 };
 
 /**
@@ -156,6 +164,37 @@ private:
     friend class UnitTestNameSpace::clsUnitTest;
 };
 
+/**
+ * @brief The clsPhraseCandidateCache class shares phrase candidate collections between sentences of a batch, so
+ * target rules of a source phrase are collected and their approximate costs are computed just once. Collections
+ * are keyed on the content of the source phrase tokens (see tokenKey()).
+ */
+class clsPhraseCandidateCache {
+public:
+    /**
+     * @brief tokenKey  key of a single token. Phrase keys are built by joining keys of their tokens.
+     */
+    static QString tokenKey(const InputDecomposer::clsToken& _token);
+
+    inline bool value(const QString& _key, clsPhraseCandidateCollection& _collection) {
+        QReadLocker Locker(&this->Lock);
+        auto Iter = this->Collections.constFind(_key);
+        if (Iter == this->Collections.constEnd())
+            return false;
+        _collection = Iter.value();
+        return true;
+    }
+
+    inline void insert(const QString& _key, const clsPhraseCandidateCollection& _collection) {
+        QWriteLocker Locker(&this->Lock);
+        this->Collections.insert(_key, _collection);
+    }
+
+private:
+    QHash<QString, clsPhraseCandidateCollection>    Collections;
+    QReadWriteLock                                  Lock;
+};
+
 /**
  * @brief The clsSearchGraphBuilderData class stores data members of clsSearchGraphBuilder class
  * and it is the top most container. #HypothesisHolder stores a list clsCardinalityHypothesisContainer instances
@@ -173,7 +212,8 @@ public:
         HypothesisHolder(_sentence.size()),
         GoalNode(NULL),
         MaxMatchingSourcePhraseCardinality(0),
-        Sentence(_sentence)
+        Sentence(_sentence),
+        Degraded(false)
     {}
     /**
      * @brief This is a copy constructor for this class
@@ -185,7 +225,10 @@ public:
         GoalNode(_other.GoalNode),
         MaxMatchingSourcePhraseCardinality(_other.MaxMatchingSourcePhraseCardinality),
         Sentence(_other.Sentence),
-        RestCostMatrix(_other.RestCostMatrix)
+        RestCostMatrix(_other.RestCostMatrix),
+        PositionSpecificRestCostFFs(_other.PositionSpecificRestCostFFs),
+        Deadline(_other.Deadline),
+        Degraded(_other.Degraded)
     {}
     ~clsSearchGraphData(){}
 
@@ -196,6 +239,9 @@ public:
     int                                                 MaxMatchingSourcePhraseCardinality;     /**< Max length of source phrases loaded from phrase table.*/
     const InputDecomposer::Sentence_t&                  Sentence;                               /**< Input sentence.*/
     RestCostMatrix_t                                    RestCostMatrix;                         /**< A 2D container to store approximate rest cost of translation dim one correspond to begin pos of sentence and dim two correspond to end pos of sentence.*/
+    QList<FeatureFunction::intfFeatureFunction*>        PositionSpecificRestCostFFs;            /**< Feature functions which must be asked for position specific rest costs.*/
+    stuTranslationDeadline                              Deadline;                               /**< Time budget of decoding this sentence.*/
+    bool                                                Degraded;                               /**< Whether deadline was reached and search has been cut short.*/
 
     friend class UnitTestNameSpace::clsUnitTest;
 };
@@ -206,7 +252,9 @@ public:
 class clsSearchGraph
 {
 public:
-    explicit clsSearchGraph(const InputDecomposer::Sentence_t& _sentence);
+    explicit clsSearchGraph(const InputDecomposer::Sentence_t& _sentence,
+                            clsPhraseCandidateCache* _sharedCandidates = NULL,
+                            const stuTranslationDeadline& _deadline = stuTranslationDeadline());
 
     static void init(QSharedPointer<QSettings> _configSettings);
 
@@ -226,6 +274,21 @@ public:
         return this->Data->HypothesisHolder[_coverage.count(true)].lexicalHypotheses().value(_coverage).nodes();
     }
 
+    /**
+     * @brief Returns time budget of this search graph. Consumers of the graph (e.g. N-Best finder) must respect it too.
+     */
+    inline const stuTranslationDeadline& deadline() const{
+        return this->Data->Deadline;
+    }
+
+    /**
+     * @brief Returns true if deadline was reached before search was completed so the goal node is result of
+     * monotone completion of the best partial hypothesis.
+     */
+    inline bool isDegraded() const{
+        return this->Data->Degraded;
+    }
+
     static inline void saveBinaryRuleTable(const QString& _filePath){
         Q_ASSERT(clsSearchGraph::pRuleTable != NULL);
         clsSearchGraph::pRuleTable->saveBinaryRuleTable(_filePath);
@@ -244,8 +307,15 @@ private:
     void extendSourcePhrase(const QList<Common::WordIndex_t>& _wordIndexes,
                             INOUT QList<RuleTable::RulesPrefixTree_t::pNode_t>& _prevNodes,
                             QList<RuleTable::clsRuleNode>& _ruleNodes);
-    void collectPhraseCandidates();
+    void collectPhraseCandidates(clsPhraseCandidateCache* _sharedCandidates);
+    clsPhraseCandidateCollection makePhraseCandidateCollection(size_t _beginPos,
+                                                               size_t _endPos,
+                                                               const QList<RuleTable::clsRuleNode>& _ruleNodes,
+                                                               const QString& _key,
+                                                               clsPhraseCandidateCache* _sharedCandidates);
     bool decode();
+    void expandByCubePruning(int _newCardinality, bool _checkDeadline);
+    void completeBestPartialHypothesis();
     Common::Cost_t computeReorderingJumpCost(size_t JumpWidth) const;
     Common::Cost_t calculateRestCost(const Coverage_t& _coverage, quint16 _lastPos) const;
     Common::Cost_t computePhraseRestCosts(const Coverage_t& _coverage) const;
@@ -253,7 +323,11 @@ private:
     void initializeRestCostsMatrix();
     bool conformsIBM1Constraint(const Coverage_t& _newCoverage);
     bool conformsHardReorderingJumpLimit(const Coverage_t &_prevCoverage, size_t _prevStart, size_t _prevEnd, size_t _startPos, size_t _endPos);
-    Common::Cost_t calculateRestCost(const Coverage_t &_coverage, size_t _beginPos, size_t _endPos) const;
+    Common::Cost_t calculateRestCost(clsCardinalityHypothesisContainer& _container,
+                                     const Coverage_t &_coverage,
+                                     const stuCoverageRestCost* _prevRestCost,
+                                     size_t _beginPos,
+                                     size_t _endPos) const;
 
 private:
     QExplicitlySharedDataPointer<clsSearchGraphData>        Data;                               /**< A pointer to clsSearchGraphBuilderData class which manages data member of this class*/
@@ -265,8 +339,11 @@ private:
     static Common::Configuration::tmplRangedConfigurable<quint8>  ReorderingConstraintMaximumRuns;     /**< A threshold that will be used in IBM1 constrains.*/
     static Common::Configuration::tmplConfigurable<bool>    DoComputePositionSpecificRestCosts;
     static Common::Configuration::tmplConfigurable<bool>    DoPrunePreInsertion;
+    static Common::Configuration::tmplConfigurable<enuSearchMode::Type>  SearchMode;
+    static Common::Configuration::tmplRangedConfigurable<quint32>  CubePruningPopLimit;  /**< Maximum hypotheses popped from cubes for each cardinality.*/
 
     friend class UnitTestNameSpace::clsUnitTest;
+    friend class Targoman::SMT::Private::DecoderSettings;
 };
 
 }
@@ -274,4 +351,6 @@ private:
 }
 }
 
+ENUM_CONFIGURABLE(SMT::Private::SearchGraphBuilder::enuSearchMode)
+
 #endif // TARGOMAN_CORE_PRIVATE_SEARCHGRAPHBUILDER_CLSSEARCHGRAPHBUILDER_H
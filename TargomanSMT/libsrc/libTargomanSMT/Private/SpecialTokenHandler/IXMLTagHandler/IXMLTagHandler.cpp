@@ -25,6 +25,7 @@
  */
 #include "IXMLTagHandler.h"
 #include "intfIXMLTagHandlerModule.hpp"
+#include "Private/FeatureFunctions/intfFeatureFunction.hpp"
 
 namespace Targoman{
 namespace SMT {
@@ -138,6 +139,7 @@ QList<Common::WordIndex_t> IXMLTagHandler::process(const QString& _tagStr,
         clsRuleNode RuleNode;
         RuleNode.detachInvalidData();
         RuleNode.targetRules().append(_targetRules);
+        FeatureFunction::intfFeatureFunction::precomputeForAllFeatures(RuleNode.targetRules());
         QList<WordIndex_t> WordIndexes;
         WordIndex_t TokenWordIndex;
 
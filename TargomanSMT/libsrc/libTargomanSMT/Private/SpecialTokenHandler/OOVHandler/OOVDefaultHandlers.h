@@ -64,6 +64,8 @@ public:
         return clsTargetRule();
     }
 
+    enuOOVResultValidity::Type resultValidity(){return enuOOVResultValidity::TokenAndAttributes;}
+
 private:
     TARGOMAN_DEFINE_SINGLETON_MODULE(RemoveOnTarget);
 };
@@ -93,6 +95,8 @@ public:
         return clsTargetRule();
     }
 
+    enuOOVResultValidity::Type resultValidity(){return enuOOVResultValidity::TokenAndAttributes;}
+
 private:
 
     TARGOMAN_DEFINE_SINGLETON_MODULE(RemoveDecoding);
@@ -124,6 +128,8 @@ public:
         return clsTargetRule::createZeroCostTargetRule(TargetPhrase, true);
     }
 
+    enuOOVResultValidity::Type resultValidity(){return enuOOVResultValidity::TokenAndAttributes;}
+
 private:
 
     TARGOMAN_DEFINE_SINGLETON_MODULE(KeepSource);
@@ -26,6 +26,8 @@
 
 #include "OOVHandler.h"
 #include "intfOOVHandlerModule.hpp"
+#include "Private/FeatureFunctions/intfFeatureFunction.hpp"
+#include <QDataStream>
 #include <iostream>
 
 namespace Targoman{
@@ -48,16 +50,110 @@ tmplConfigurable<bool> OOVHandler::CheckDifferentLetterCases(
         "Check upper, lower and Pascal forms of unknown words",
         false);
 
+tmplRangedConfigurable<quint32> OOVHandler::MaxCachedTemporaryResults(
+        MAKE_CONFIG_PATH("MaxCachedTemporaryResults"),
+        "Maximum number of tokens whose non-reusable OOV handler results are cached. Least recently used results are "
+        "dropped when it is reached. 0 disables cache",
+        0, 10000000,
+        10000);
+
 TARGOMAN_REGISTER_SINGLETON_MODULE(OOVHandler);
 
-// TODO: Update following comments
+static inline QString toPascalCase(const QString& _lowerCased){
+    QString Result = _lowerCased;
+    Result[0] = Result[0].toUpper();
+    return Result;
+}
+
 /**
- * @brief OOVHandler::initialize Sets #ActivesOOVHandlers from #OOVHandlerModules and checks whethere they are available handlers or not.
- * @exception throws exception if name of special OOV handler is not in #AvailableOOVHandlers.
+ * @brief OOVHandler::initialize must be called after rule table is loaded. It decides whether results of
+ * non-reusable handlers can be cached and indexes letter case forms of source vocab words when
+ * #CheckDifferentLetterCases is set.
  */
-
 void OOVHandler::initialize()
 {
+    this->TemporaryResultsCacheable = OOVHandler::MaxCachedTemporaryResults.value() > 0;
+    foreach(intfOOVHandlerModule* pOOVHandler, this->ActiveOOVHandlers)
+        if (pOOVHandler->isReusable() == false &&
+                pOOVHandler->resultValidity() != enuOOVResultValidity::TokenAndAttributes)
+            this->TemporaryResultsCacheable = false;
+    // Cached rule nodes refer to word indexes of previously loaded rule table, so they are dropped on each initialization
+    this->TemporaryResults.reset(OOVHandler::MaxCachedTemporaryResults.value());
+
+    this->LetterCaseForms.clear();
+    if (OOVHandler::CheckDifferentLetterCases.value() == false)
+        return;
+
+    for (auto VocabIter = gConfigs.SourceVocab.constBegin(); VocabIter != gConfigs.SourceVocab.constEnd(); ++VocabIter){
+        const QString& Word = VocabIter.key();
+        if (Word.isEmpty())
+            continue;
+        QString LowerCased = Word.toLower();
+        bool IsLower  = (Word == LowerCased);
+        bool IsUpper  = (Word == LowerCased.toUpper());
+        bool IsPascal = (Word == toPascalCase(LowerCased));
+        if (IsLower == false && IsUpper == false && IsPascal == false)
+            continue;
+        stuLetterCaseForms& Forms = this->LetterCaseForms[LowerCased];
+        if (IsLower)  Forms.Lower  = VocabIter.value();
+        if (IsUpper)  Forms.Upper  = VocabIter.value();
+        if (IsPascal) Forms.Pascal = VocabIter.value();
+    }
+    TargomanLogInfo(5, "Indexed letter case forms of " << this->LetterCaseForms.size() << " source words");
+}
+
+/**
+ * @brief OOVHandler::prepareForSentence gives active OOV handlers the chance to process all tokens of a
+ * sentence together before they are asked for each unknown token separately.
+ * @param _sentence tokens of input sentence.
+ */
+void OOVHandler::prepareForSentence(const QList<InputDecomposer::clsToken::stuInfo> &_sentence)
+{
+    foreach(intfOOVHandlerModule* pOOVHandler, this->ActiveOOVHandlers)
+        pOOVHandler->prepare(_sentence);
+}
+
+/**
+ * @brief OOVHandler::isPendingOOV checks whether reusable OOV handlers will be asked to process _token by
+ * getWordIndexOptions(), that is token is out of vocabulary and has not been handled before.
+ */
+bool OOVHandler::isPendingOOV(const QString &_token)
+{
+    if (OOVHandler::isOOV(_token, gConfigs.SourceVocab.value(_token, Constants::SrcVocabUnkWordIndex)) == false)
+        return false;
+    return SpecialTokensRegistry::instance().getExpirableSpecialToken(_token).Data->NotSet;
+}
+
+/**
+ * @brief OOVHandler::getTemporaryRuleNode builds rule node of non-reusable OOV handlers for an unknown token. When all
+ * of them depend just on token and its attributes, results are cached so repeated tokens skip the handlers.
+ * @param[in] _token            input OOV word string.
+ * @param[in,out] _attrs        token attributes which will be updated by OOV handlers.
+ * @return                      an invalid rule node if no handler has produced a target rule.
+ */
+clsRuleNode OOVHandler::getTemporaryRuleNode(const QString &_token, QVariantMap &_attrs)
+{
+    QByteArray CacheKey;
+    if (this->TemporaryResultsCacheable){
+        QDataStream KeyStream(&CacheKey, QIODevice::WriteOnly);
+        KeyStream<<_token<<_attrs;
+        stuTemporaryResult CachedResult = this->TemporaryResults.value(CacheKey);
+        if (CachedResult.NotSet == false){
+            _attrs = CachedResult.Attributes;
+            return CachedResult.RuleNode;
+        }
+    }
+
+    clsRuleNode RuleNode;
+    TargetRulesContainer_t TargetRules = this->gatherTargetRules(_token, _attrs, false);
+    if (TargetRules.size()){
+        RuleNode.detachInvalidData();
+        RuleNode.targetRules().append(TargetRules);
+    }
+
+    if (this->TemporaryResultsCacheable)
+        this->TemporaryResults.insert(CacheKey, stuTemporaryResult(RuleNode, _attrs));
+    return RuleNode;
 }
 
 TargetRulesContainer_t OOVHandler::gatherTargetRules(const QString &_token, QVariantMap &_attrs, bool _reusable)
@@ -66,8 +162,9 @@ TargetRulesContainer_t OOVHandler::gatherTargetRules(const QString &_token, QVar
     foreach(intfOOVHandlerModule* pOOVHandler, this->ActiveOOVHandlers){
         if (pOOVHandler->isReusable() != _reusable)
             continue;
-        const clsTargetRule OOVHandlerTargetRule = pOOVHandler->process(_token, _attrs);
+        clsTargetRule OOVHandlerTargetRule = pOOVHandler->process(_token, _attrs);
         if (OOVHandlerTargetRule.isInvalid() == false){
+            FeatureFunction::intfFeatureFunction::precomputeForAllFeatures(OOVHandlerTargetRule);
             TargetRules.append(OOVHandlerTargetRule);
         }
     }
@@ -83,30 +180,17 @@ TargetRulesContainer_t OOVHandler::gatherTargetRules(const QString &_token, QVar
 QList<WordIndex_t> OOVHandler::getWordIndexOptions(const QString &_token, QVariantMap &_attrs)
 {
     if(OOVHandler::CheckDifferentLetterCases.value()) {
-        auto toPascalCase = [] (const QString& _token) {
-            QString Result = _token.toLower();
-            Result[0] = Result[0].toUpper();
-            return Result;
-        };
-
-        QList<WordIndex_t> TrivialWordIndexes = {
-            gConfigs.SourceVocab.value(_token.toLower(), Constants::SrcVocabUnkWordIndex),
-            gConfigs.SourceVocab.value(_token.toUpper(), Constants::SrcVocabUnkWordIndex),
-            gConfigs.SourceVocab.value(toPascalCase(_token), Constants::SrcVocabUnkWordIndex)
-        };
-
-//        QList<QString> TrivialWords = {
-//            _token.toLower(),
-//            _token.toUpper(),
-//            toPascalCase(_token)
-//        };
-        for(int i = TrivialWordIndexes.size() - 1; i >= 0; --i) {
-            if(TrivialWordIndexes.at(i) == Constants::SrcVocabUnkWordIndex)
-                TrivialWordIndexes.removeAt(i);
-        }
-
-        if(TrivialWordIndexes.size() != 0)
+        auto FormsIter = this->LetterCaseForms.constFind(_token.toLower());
+        if (FormsIter != this->LetterCaseForms.constEnd()){
+            QList<WordIndex_t> TrivialWordIndexes;
+            if (FormsIter->Lower != Constants::SrcVocabUnkWordIndex)
+                TrivialWordIndexes.append(FormsIter->Lower);
+            if (FormsIter->Upper != Constants::SrcVocabUnkWordIndex)
+                TrivialWordIndexes.append(FormsIter->Upper);
+            if (FormsIter->Pascal != Constants::SrcVocabUnkWordIndex)
+                TrivialWordIndexes.append(FormsIter->Pascal);
             return TrivialWordIndexes;
+        }
     }
 
     SpecialTokensRegistry::clsExpirableSpecialToken ExpirableSpecialToken =
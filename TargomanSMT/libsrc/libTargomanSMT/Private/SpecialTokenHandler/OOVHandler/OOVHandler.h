@@ -30,6 +30,7 @@
 #include "libTargomanCommon/tmplBoundedCache.hpp"
 #include "libTargomanCommon/Configuration/tmplConfigurable.h"
 #include "Private/RuleTable/clsRuleNode.h"
+#include "Private/InputDecomposer/clsToken.h"
 #include "Private/GlobalConfigs.h"
 #include "Private/Proxies/LanguageModel/intfLMSentenceScorer.hpp"
 #include "libTargomanCommon/Constants.h"
@@ -57,28 +58,71 @@ TARGOMAN_ADD_EXCEPTION_HANDLER(exOOVHandler, exTargomanCore);
 class OOVHandler : public Targoman::Common::Configuration::intfModule
 {
 public:
-    OOVHandler(){}
+    OOVHandler() :
+        TemporaryResultsCacheable(false)
+    {}
     QList<WordIndex_t> getWordIndexOptions(const QString& _token, QVariantMap& _attrs);
     //RuleTable::TargetRulesContainer_t generateTargetRules(const QString& _token);
     void initialize();
+    void prepareForSentence(const QList<InputDecomposer::clsToken::stuInfo>& _sentence);
+    bool isPendingOOV(const QString& _token);
 
-public:
-    inline RuleTable::TargetRulesContainer_t gatherTemporaryTargetRules(const QString& _token, QVariantMap& _attrs){
-        return this->gatherTargetRules(_token, _attrs, false);
+    /**
+     * @brief isOOV checks whether a token which is found in source vocab with _wordIndex must be passed to OOV handlers.
+     */
+    static inline bool isOOV(const QString& _token, WordIndex_t _wordIndex){
+        return _wordIndex == Constants::SrcVocabUnkWordIndex || gConfigs.VocabWithoutSingleWordRule.contains(_token);
     }
 
+public:
+    RuleTable::clsRuleNode getTemporaryRuleNode(const QString& _token, QVariantMap& _attrs);
+
 private:
     RuleTable::TargetRulesContainer_t gatherTargetRules(const QString& _token, QVariantMap& _attrs, bool _reusable);
 
 private:
     TARGOMAN_DEFINE_SINGLETON_MODULE(OOVHandler);
 
+private:
+    /**
+     * @brief Rule node built by non-reusable OOV handlers for a token along with attributes they have set.
+     */
+    struct stuTemporaryResult{
+        bool                    NotSet;
+        RuleTable::clsRuleNode  RuleNode;
+        QVariantMap             Attributes;
+
+        stuTemporaryResult() : NotSet(true) {}
+        stuTemporaryResult(const RuleTable::clsRuleNode& _ruleNode, const QVariantMap& _attrs) :
+            NotSet(false), RuleNode(_ruleNode), Attributes(_attrs)
+        {}
+    };
+
+    /**
+     * @brief Source vocab word indexes of lower, upper and Pascal case forms of a lower cased word.
+     */
+    struct stuLetterCaseForms{
+        WordIndex_t Lower;
+        WordIndex_t Upper;
+        WordIndex_t Pascal;
+
+        stuLetterCaseForms() :
+            Lower(Constants::SrcVocabUnkWordIndex),
+            Upper(Constants::SrcVocabUnkWordIndex),
+            Pascal(Constants::SrcVocabUnkWordIndex)
+        {}
+    };
+
 private:
     QList<intfOOVHandlerModule*>                                        ActiveOOVHandlers;        /**< List of active special OOV handlers.*/
+    Common::tmplBoundedCache<QHash, QByteArray, stuTemporaryResult>     TemporaryResults;         /**< Results of non-reusable handlers keyed by serialized token and attributes.*/
+    bool                                                                TemporaryResultsCacheable;/**< True when all non-reusable handlers depend just on token and attributes.*/
+    QHash<QString, stuLetterCaseForms>                                  LetterCaseForms;          /**< Letter case forms of source vocab words keyed by their lower case form.*/
 
 private:
     static Targoman::Common::Configuration::tmplAddinConfig<intfOOVHandlerModule>   OOVHandlerModules;
     static Targoman::Common::Configuration::tmplConfigurable<bool>                  CheckDifferentLetterCases;
+    static Targoman::Common::Configuration::tmplRangedConfigurable<quint32>         MaxCachedTemporaryResults;
     friend class intfOOVHandlerModule;
 };
 
@@ -62,8 +62,7 @@ public:
      */
 
     RuleTable::clsTargetRule process(const QString &_token, QVariantMap& _attrs){
-        if(_attrs.contains(NER_TAG_ATTR_KEY) == false ||
-           _attrs.value(NER_TAG_ATTR_KEY) == NER_TAG_OTHER)
+        if(this->isNamedEntity(_attrs) == false)
             return *RuleTable::pInvalidTargetRule;
 
         QString TargetWord = this->refTransliterator.transliterate(_token);
@@ -75,8 +74,30 @@ public:
         return RuleTable::clsTargetRule::createZeroCostTargetRule(TargetPhrase, true);
     }
 
+    /**
+     * @brief prepare transliterates all unknown named entities of the sentence in one batch so that
+     * subsequent calls to process() are served from transliterator cache.
+     */
+    void prepare(const QList<InputDecomposer::clsToken::stuInfo>& _sentence){
+        QStringList NamedEntities;
+        foreach(const InputDecomposer::clsToken::stuInfo& TokenInfo, _sentence){
+            if (TokenInfo.TagStr.isEmpty() &&
+                    this->isNamedEntity(TokenInfo.Attrs) &&
+                    OOVHandler::instance().isPendingOOV(TokenInfo.Str))
+                NamedEntities.append(TokenInfo.Str);
+        }
+        if (NamedEntities.size())
+            this->refTransliterator.transliterateBatch(NamedEntities);
+    }
+
     bool isReusable() {return true;}
 
+private:
+    inline bool isNamedEntity(const QVariantMap& _attrs){
+        return _attrs.contains(NER_TAG_ATTR_KEY) &&
+                _attrs.value(NER_TAG_ATTR_KEY) != NER_TAG_OTHER;
+    }
+
 private:
     Proxies::Transliteration::intfTransliterator& refTransliterator;
     TARGOMAN_DEFINE_SINGLETON_MODULE(TransliterateNamedEntities);
@@ -38,6 +38,17 @@ namespace SpecialTokenHandler {
 namespace OOV{
 
 TARGOMAN_ADD_EXCEPTION_HANDLER(exOOVHandlerModule, exOOVHandler);
+
+/**
+ * @brief Declares what the output of a non-reusable OOV handler depends on, so OOVHandler knows whether it can be
+ * cached across sentences. Sentence: output depends on sentence context (e.g. data gathered in prepare()).
+ * TokenAndAttributes: output depends just on token string and its attributes.
+ */
+TARGOMAN_DEFINE_ENHANCED_ENUM(enuOOVResultValidity,
+                              Sentence,
+                              TokenAndAttributes
+                              );
+
 /**
  * @brief The intfOOVHandlerModule class is an interface class that every other Special OOV Handlers like clsOOVRemoveOnTarget or clsOOVKeepSource can be derive from this interface class.
  */
@@ -53,6 +64,17 @@ public:
 
     virtual bool isReusable(){return false;}
 
+    /**
+     * @brief resultValidity is checked just for non-reusable handlers. Default is the safe choice of not caching.
+     */
+    virtual enuOOVResultValidity::Type resultValidity(){return enuOOVResultValidity::Sentence;}
+
+    /**
+     * @brief prepare will be called with all tokens of a sentence before calling process() on each unknown
+     * token, so handlers can batch their work. Default implementation does nothing.
+     */
+    virtual void prepare(const QList<InputDecomposer::clsToken::stuInfo>& _sentence){Q_UNUSED(_sentence);}
+
     virtual RuleTable::clsTargetRule process(const QString& _token, QVariantMap& _currAttrs) = 0;
 };
 
@@ -128,7 +128,7 @@ public:
         if (this->AvailableWordIndexes.size())
             WordIndex = this->AvailableWordIndexes.takeFirst();
         else
-            WordIndex = this->WordIndexOffset + this->SpecialTokens.keys().size();
+            WordIndex = this->WordIndexOffset + this->SpecialTokens.size();
         Locker.unlock();
         return WordIndex;
     }
@@ -0,0 +1,301 @@
+/******************************************************************************
+ * Targoman: A robust Statistical Machine Translation framework               *
+ *                                                                            *
+ * Copyright 2014-2015 by ITRC <http://itrc.ac.ir>                            *
+ *                                                                            *
+ * This file is part of Targoman.                                             *
+ *                                                                            *
+ * Targoman is free software: you can redistribute it and/or modify           *
+ * it under the terms of the GNU Lesser General Public License as published   *
+ * by the Free Software Foundation, either version 3 of the License, or       *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * Targoman is distributed in the hope that it will be useful,                *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * GNU Lesser General Public License for more details.                        *
+ * You should have received a copy of the GNU Lesser General Public License   *
+ * along with Targoman. If not, see <http://www.gnu.org/licenses/>.           *
+ *                                                                            *
+ ******************************************************************************/
+/**
+ * @author S. Mohammad M. Ziabary <ziabary@targoman.com>
+ * @author Behrooz Vedadian <vedadian@targoman.com>
+ * @author Saeed Torabzadeh <saeed.torabzadeh@targoman.com>
+ */
+
+#include <cstring>
+#include "clsSourceVocab.h"
+
+namespace Targoman {
+namespace SMT {
+namespace Private {
+
+using namespace Common;
+
+namespace {
+
+const quint64 FNV_OFFSET_BASIS = 14695981039346656037ULL;
+const quint64 FNV_PRIME = 1099511628211ULL;
+const int MIN_SLOTS = 16;
+
+inline quint64 hashStep(quint64 _hash, char _byte)
+{
+    return (_hash ^ static_cast<quint8>(_byte)) * FNV_PRIME;
+}
+
+/// Final mixing of FNV-1a so that low bits (used as slot) and high bits (used as tag) both depend on all bytes
+inline quint64 hashFinalize(quint64 _hash)
+{
+    _hash ^= _hash >> 33;
+    _hash *= 0xff51afd7ed558ccdULL;
+    _hash ^= _hash >> 33;
+    return _hash;
+}
+
+/**
+ * @brief forEachUTF8Byte calls _visitor on each byte of the UTF-8 encoding of a UTF-16 string without converting it.
+ * @return false as soon as _visitor returns false or an unpaired surrogate is reached, true otherwise
+ */
+template <class Visitor_t>
+inline bool forEachUTF8Byte(const QChar* _word, int _size, Visitor_t _visitor)
+{
+    for (int i = 0; i < _size; ++i) {
+        uint CodePoint = _word[i].unicode();
+        if (CodePoint < 0x80) {
+            if (_visitor(static_cast<char>(CodePoint)) == false)
+                return false;
+        } else if (CodePoint < 0x800) {
+            if (_visitor(static_cast<char>(0xC0 | (CodePoint >> 6))) == false ||
+                _visitor(static_cast<char>(0x80 | (CodePoint & 0x3F))) == false)
+                return false;
+        } else if (QChar::isSurrogate(CodePoint)) {
+            if (QChar::isHighSurrogate(CodePoint) && i + 1 < _size && _word[i + 1].isLowSurrogate()) {
+                CodePoint = QChar::surrogateToUcs4(static_cast<ushort>(CodePoint), _word[++i].unicode());
+                if (_visitor(static_cast<char>(0xF0 | (CodePoint >> 18))) == false ||
+                    _visitor(static_cast<char>(0x80 | ((CodePoint >> 12) & 0x3F))) == false ||
+                    _visitor(static_cast<char>(0x80 | ((CodePoint >> 6) & 0x3F))) == false ||
+                    _visitor(static_cast<char>(0x80 | (CodePoint & 0x3F))) == false)
+                    return false;
+            } else
+                return false;
+        } else {
+            if (_visitor(static_cast<char>(0xE0 | (CodePoint >> 12))) == false ||
+                _visitor(static_cast<char>(0x80 | ((CodePoint >> 6) & 0x3F))) == false ||
+                _visitor(static_cast<char>(0x80 | (CodePoint & 0x3F))) == false)
+                return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @return false if _word can not be encoded as UTF-8
+ */
+inline bool hashOf(const QChar* _word, int _size, quint64& _hash)
+{
+    quint64 Hash = FNV_OFFSET_BASIS;
+    if (forEachUTF8Byte(_word, _size, [&Hash](char _byte) { Hash = hashStep(Hash, _byte); return true; }) == false)
+        return false;
+    _hash = hashFinalize(Hash);
+    return true;
+}
+
+inline quint64 hashOf(const char* _utf8, int _size)
+{
+    quint64 Hash = FNV_OFFSET_BASIS;
+    for (int i = 0; i < _size; ++i)
+        Hash = hashStep(Hash, _utf8[i]);
+    return hashFinalize(Hash);
+}
+
+}
+
+clsSourceVocab::clsSourceVocab()
+{
+    this->clear();
+}
+
+void clsSourceVocab::clear()
+{
+    this->Words.clear();
+    this->WordOffsets.clear();
+    this->WordOffsets.append(0);
+    this->WordIndexes.clear();
+    this->Slots.clear();
+    this->EntryByWordIndex.clear();
+}
+
+/**
+ * @brief clsSourceVocab::reserve prepares storage for _size words so that hash table is not grown while loading
+ */
+void clsSourceVocab::reserve(int _size)
+{
+    this->WordOffsets.reserve(_size + 1);
+    this->WordIndexes.reserve(_size);
+    this->EntryByWordIndex.reserve(_size + 1);
+    int Capacity = MIN_SLOTS;
+    while (Capacity < 2 * _size)
+        Capacity *= 2;
+    if (Capacity > this->Slots.size())
+        this->rehash(Capacity);
+}
+
+/**
+ * @brief clsSourceVocab::insert adds _word with _wordIndex or changes word index of _word if it already exists.
+ * @exception throws exSourceVocab if _word contains unpaired surrogates
+ * @note Not thread safe. Must not be called while vocabulary is being read by other threads.
+ */
+void clsSourceVocab::insert(const QString &_word, WordIndex_t _wordIndex)
+{
+    quint64 Hash;
+    if (hashOf(_word.constData(), _word.size(), Hash) == false)
+        throw exSourceVocab("Invalid source word with unpaired surrogate: " + _word);
+
+    int Entry = this->findEntry(_word.constData(), _word.size());
+    if (Entry < 0) {
+        if (2 * (this->size() + 1) > this->Slots.size())
+            this->rehash(qMax(MIN_SLOTS, 2 * this->Slots.size()));
+        Entry = this->size();
+        forEachUTF8Byte(_word.constData(), _word.size(), [this](char _byte) {
+            this->Words.append(_byte);
+            return true;
+        });
+        this->WordOffsets.append(static_cast<quint32>(this->Words.size()));
+        this->WordIndexes.append(_wordIndex);
+        this->insertEntry(Entry, Hash);
+    } else {
+        WordIndex_t OldWordIndex = this->WordIndexes.at(Entry);
+        if (this->EntryByWordIndex.value(static_cast<int>(OldWordIndex)) == static_cast<quint32>(Entry + 1))
+            this->EntryByWordIndex[static_cast<int>(OldWordIndex)] = 0;
+        this->WordIndexes[Entry] = _wordIndex;
+    }
+
+    if (static_cast<int>(_wordIndex) >= this->EntryByWordIndex.size())
+        this->EntryByWordIndex.resize(static_cast<int>(_wordIndex) + 1);
+    this->EntryByWordIndex[static_cast<int>(_wordIndex)] = static_cast<quint32>(Entry + 1);
+}
+
+/**
+ * @brief clsSourceVocab::squeeze releases unused capacity once all of the words are inserted
+ */
+void clsSourceVocab::squeeze()
+{
+    this->Words.squeeze();
+    this->WordOffsets.squeeze();
+    this->WordIndexes.squeeze();
+    this->EntryByWordIndex.squeeze();
+}
+
+WordIndex_t clsSourceVocab::value(const QString &_word, WordIndex_t _default) const
+{
+    int Entry = this->findEntry(_word.constData(), _word.size());
+    return Entry < 0 ? _default : this->WordIndexes.at(Entry);
+}
+
+WordIndex_t clsSourceVocab::value(const QStringRef &_word, WordIndex_t _default) const
+{
+    int Entry = this->findEntry(_word.constData(), _word.size());
+    return Entry < 0 ? _default : this->WordIndexes.at(Entry);
+}
+
+WordIndex_t clsSourceVocab::value(const char *_utf8, int _size, WordIndex_t _default) const
+{
+    int Entry = this->findEntry(_utf8, _size);
+    return Entry < 0 ? _default : this->WordIndexes.at(Entry);
+}
+
+/**
+ * @brief clsSourceVocab::word finds the word which has _wordIndex
+ * @return an empty string if _wordIndex is not in vocabulary
+ */
+QString clsSourceVocab::word(WordIndex_t _wordIndex) const
+{
+    quint32 Entry = this->EntryByWordIndex.value(static_cast<int>(_wordIndex));
+    return Entry ? this->wordAt(static_cast<int>(Entry) - 1) : QString();
+}
+
+int clsSourceVocab::findEntry(const QChar *_word, int _size) const
+{
+    if (this->Slots.isEmpty())
+        return -1;
+
+    quint64 Hash;
+    if (hashOf(_word, _size, Hash) == false)
+        return -1;
+    quint32 HashTag = static_cast<quint32>(Hash >> 32);
+    quint32 Mask = static_cast<quint32>(this->Slots.size() - 1);
+    for (quint32 Position = static_cast<quint32>(Hash) & Mask; ; Position = (Position + 1) & Mask) {
+        const stuSlot& Slot = this->Slots.at(static_cast<int>(Position));
+        if (Slot.Entry == 0)
+            return -1;
+        if (Slot.HashTag != HashTag)
+            continue;
+
+        int Entry = static_cast<int>(Slot.Entry) - 1;
+        const char* Stored = this->Words.constData() + this->WordOffsets.at(Entry);
+        int StoredSize = static_cast<int>(this->WordOffsets.at(Entry + 1) - this->WordOffsets.at(Entry));
+        int Matched = 0;
+        if (forEachUTF8Byte(_word, _size, [Stored, StoredSize, &Matched](char _byte) {
+                return Matched < StoredSize && Stored[Matched++] == _byte;
+            }) && Matched == StoredSize)
+            return Entry;
+    }
+}
+
+int clsSourceVocab::findEntry(const char *_utf8, int _size) const
+{
+    if (this->Slots.isEmpty())
+        return -1;
+
+    quint64 Hash = hashOf(_utf8, _size);
+    quint32 HashTag = static_cast<quint32>(Hash >> 32);
+    quint32 Mask = static_cast<quint32>(this->Slots.size() - 1);
+    for (quint32 Position = static_cast<quint32>(Hash) & Mask; ; Position = (Position + 1) & Mask) {
+        const stuSlot& Slot = this->Slots.at(static_cast<int>(Position));
+        if (Slot.Entry == 0)
+            return -1;
+        if (Slot.HashTag != HashTag)
+            continue;
+
+        int Entry = static_cast<int>(Slot.Entry) - 1;
+        int StoredSize = static_cast<int>(this->WordOffsets.at(Entry + 1) - this->WordOffsets.at(Entry));
+        if (StoredSize == _size &&
+                memcmp(this->Words.constData() + this->WordOffsets.at(Entry), _utf8, static_cast<size_t>(_size)) == 0)
+            return Entry;
+    }
+}
+
+void clsSourceVocab::insertEntry(int _entry, quint64 _hash)
+{
+    quint32 Mask = static_cast<quint32>(this->Slots.size() - 1);
+    quint32 Position = static_cast<quint32>(_hash) & Mask;
+    while (this->Slots.at(static_cast<int>(Position)).Entry)
+        Position = (Position + 1) & Mask;
+    stuSlot& Slot = this->Slots[static_cast<int>(Position)];
+    Slot.Entry = static_cast<quint32>(_entry + 1);
+    Slot.HashTag = static_cast<quint32>(_hash >> 32);
+}
+
+/**
+ * @brief clsSourceVocab::rehash rebuilds hash table with _capacity slots. _capacity must be a power of two.
+ */
+void clsSourceVocab::rehash(int _capacity)
+{
+    stuSlot Empty = {0, 0};
+    this->Slots.fill(Empty, _capacity);
+    for (int Entry = 0; Entry < this->size(); ++Entry)
+        this->insertEntry(Entry, hashOf(
+                              this->Words.constData() + this->WordOffsets.at(Entry),
+                              static_cast<int>(this->WordOffsets.at(Entry + 1) - this->WordOffsets.at(Entry))));
+}
+
+QString clsSourceVocab::wordAt(int _entry) const
+{
+    return QString::fromUtf8(this->Words.constData() + this->WordOffsets.at(_entry),
+                             static_cast<int>(this->WordOffsets.at(_entry + 1) - this->WordOffsets.at(_entry)));
+}
+
+}
+}
+}
@@ -0,0 +1,129 @@
+/******************************************************************************
+ * Targoman: A robust Statistical Machine Translation framework               *
+ *                                                                            *
+ * Copyright 2014-2015 by ITRC <http://itrc.ac.ir>                            *
+ *                                                                            *
+ * This file is part of Targoman.                                             *
+ *                                                                            *
+ * Targoman is free software: you can redistribute it and/or modify           *
+ * it under the terms of the GNU Lesser General Public License as published   *
+ * by the Free Software Foundation, either version 3 of the License, or       *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * Targoman is distributed in the hope that it will be useful,                *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * GNU Lesser General Public License for more details.                        *
+ * You should have received a copy of the GNU Lesser General Public License   *
+ * along with Targoman. If not, see <http://www.gnu.org/licenses/>.           *
+ *                                                                            *
+ ******************************************************************************/
+/**
+ * @author S. Mohammad M. Ziabary <ziabary@targoman.com>
+ * @author Behrooz Vedadian <vedadian@targoman.com>
+ * @author Saeed Torabzadeh <saeed.torabzadeh@targoman.com>
+ */
+
+#ifndef TARGOMAN_CORE_PRIVATE_CLSSOURCEVOCAB_H
+#define TARGOMAN_CORE_PRIVATE_CLSSOURCEVOCAB_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+#include "libTargomanCommon/Types.h"
+#include "libTargomanSMT/Types.h"
+
+namespace Targoman {
+namespace SMT {
+namespace Private {
+
+TARGOMAN_ADD_EXCEPTION_HANDLER(exSourceVocab, exTargomanCore);
+
+/**
+ * @brief The clsSourceVocab class maps source words to their word indexes.
+ *
+ * All words are interned as UTF-8 in a single buffer and found through an open addressing hash table with linear
+ * probing, whose slots keep part of the hash so that most probes are rejected without touching the words. Words can be
+ * looked up from QString, QStringRef or UTF-8 without any allocation and word indexes can be mapped back to their
+ * words in constant time. Words containing unpaired surrogates have no UTF-8 encoding, so they are rejected on insert
+ * and never found.
+ *
+ * Words are inserted while rule tables are loaded. Afterwards the vocabulary is only read, so it can be shared by all
+ * translation threads without locking.
+ */
+class clsSourceVocab
+{
+public:
+    class const_iterator{
+    public:
+        QString key() const {return this->Vocab->wordAt(this->Entry);}
+        Common::WordIndex_t value() const {return this->Vocab->WordIndexes.at(this->Entry);}
+
+        const_iterator& operator ++ () {++this->Entry; return *this;}
+        bool operator == (const const_iterator& _other) const {return this->Entry == _other.Entry;}
+        bool operator != (const const_iterator& _other) const {return this->Entry != _other.Entry;}
+
+    private:
+        const_iterator(const clsSourceVocab* _vocab, int _entry) : Vocab(_vocab), Entry(_entry) {}
+
+    private:
+        const clsSourceVocab* Vocab;
+        int                   Entry;
+
+        friend class clsSourceVocab;
+    };
+
+public:
+    clsSourceVocab();
+
+    void clear();
+    void reserve(int _size);
+    void insert(const QString& _word, Common::WordIndex_t _wordIndex);
+    void squeeze();
+
+    Common::WordIndex_t value(const QString& _word, Common::WordIndex_t _default = 0) const;
+    Common::WordIndex_t value(const QStringRef& _word, Common::WordIndex_t _default = 0) const;
+    Common::WordIndex_t value(const char* _utf8, int _size, Common::WordIndex_t _default = 0) const;
+
+    inline bool contains(const QString& _word) const {
+        return this->findEntry(_word.constData(), _word.size()) >= 0;
+    }
+    inline bool contains(const QStringRef& _word) const {
+        return this->findEntry(_word.constData(), _word.size()) >= 0;
+    }
+
+    QString word(Common::WordIndex_t _wordIndex) const;
+
+    inline int size() const {return this->WordIndexes.size();}
+    inline bool isEmpty() const {return this->WordIndexes.isEmpty();}
+
+    inline const_iterator begin() const {return const_iterator(this, 0);}
+    inline const_iterator end() const {return const_iterator(this, this->size());}
+    inline const_iterator constBegin() const {return this->begin();}
+    inline const_iterator constEnd() const {return this->end();}
+
+private:
+    /// Slot of the hash table. Entry is index of word plus one, zero marks an empty slot
+    struct stuSlot{
+        quint32 Entry;
+        quint32 HashTag;
+    };
+
+    int findEntry(const QChar* _word, int _size) const;
+    int findEntry(const char* _utf8, int _size) const;
+    void insertEntry(int _entry, quint64 _hash);
+    void rehash(int _capacity);
+    QString wordAt(int _entry) const;
+
+private:
+    QByteArray                          Words;              /**< UTF-8 of all words one after another */
+    QVector<quint32>                    WordOffsets;        /**< Start of each word in #Words plus the end offset */
+    QVector<Common::WordIndex_t>        WordIndexes;        /**< Word index of each word */
+    QVector<stuSlot>                    Slots;
+    QVector<quint32>                    EntryByWordIndex;   /**< Entry plus one of each word index, zero if not used */
+};
+
+}
+}
+}
+#endif // TARGOMAN_CORE_PRIVATE_CLSSOURCEVOCAB_H
@@ -24,6 +24,7 @@
  * @author Saeed Torabzadeh <saeed.torabzadeh@targoman.com>
  */
 
+#include <QtConcurrent/QtConcurrent>
 #include "Translator.h"
 
 #include "libTargomanTextProcessor/TextProcessor.h"
@@ -36,6 +37,8 @@
 #include "Private/Proxies/Transliteration/intfTransliterator.h"
 #include "Private/Proxies/NamedEntityRecognition/intfNamedEntityRecognizer.h"
 #include "Private/N-BestFinder/NBestPaths.h"
+#include "Private/FeatureFunctions/WeightProfiles.h"
+#include "Private/DecoderSettings.h"
 
 namespace Targoman{
 /**
@@ -62,31 +65,40 @@ void Translator::init(QSharedPointer<QSettings> _configSettings)
     gConfigs.EmptyLMScorer.reset(gConfigs.LM.getInstance<Proxies::LanguageModel::intfLMSentenceScorer>());
     gConfigs.EmptyLMScorer->init(false);
 
-    OOVHandler::instance().initialize();
     IXMLTagHandler::instance().initialize();
+    // Feature functions resolve their weights against profiles while being initialized
+    FeatureFunction::WeightProfiles::init(_configSettings);
     SearchGraphBuilder::clsSearchGraph::init(_configSettings);
+    // OOVHandler indexes source vocab so it must be initialized after rule table is loaded
+    OOVHandler::instance().initialize();
 
     TranslatorInitialized = true;
     TargomanLogHappy(5, "Translator Initialized successfully");
 }
 
-stuTranslationOutput Translator::translate(const QString &_inputStr,
+/**
+ * @brief translates a single input. Phrase candidates are shared with other inputs when _sharedCandidates is provided.
+ */
+static stuTranslationOutput translateInput(const QString &_inputStr,
                                            enuOutputFormat::Type _outputFormat,
-                                           bool _isIXML)
+                                           bool _isIXML,
+                                           clsPhraseCandidateCache* _sharedCandidates,
+                                           const stuTranslationDeadline& _deadline,
+                                           quint16 _weightProfile)
 {
-    if (TranslatorInitialized == false)
-        throw exTargomanCore("Translator is not initialized");
-
+    FeatureFunction::clsWeightProfileScope WeightProfileScope(_weightProfile);
+    clsDecoderSettingsScope DecoderSettingsScope;
     QTime start = QTime::currentTime();
     SearchGraphBuilder::TotalNodeNumber = 1;
     InputDecomposer::clsInput Input(_inputStr, _isIXML);
-    SearchGraphBuilder::clsSearchGraph  SearchGraph(Input.tokens());
+    SearchGraphBuilder::clsSearchGraph  SearchGraph(Input.tokens(), _sharedCandidates, _deadline);
     OutputComposer::clsOutputComposer   OutputComposer(Input, SearchGraph);
 
     stuTranslationOutput Output = OutputComposer.getTranslationOutput(_outputFormat);
+    Output.Degraded = SearchGraph.isDegraded();
     int Elapsed = start.elapsed();
 #ifndef SMT
-    TargomanLogInfo(7, "Translation [" << Elapsed / 1000.0 << "s]"<<
+    TargomanLogInfo(7, "Translation [" << Elapsed / 1000.0 << "s" << (SearchGraph.isDegraded() ? ", degraded" : "") << "]"<<
                      _inputStr << " => " << Output.Translations.first());
 #else
     QString InputWord = _inputStr;
@@ -100,6 +112,66 @@ stuTranslationOutput Translator::translate(const QString &_inputStr,
     return Output;
 }
 
+clsTranslationBatch::clsTranslationBatch() :
+    pSharedCandidates(new clsPhraseCandidateCache)
+{ }
+
+clsTranslationBatch::~clsTranslationBatch()
+{ }
+
+/**
+ * @param _batch when provided, phrase candidates are shared with other inputs translated using the same batch.
+ */
+stuTranslationOutput Translator::translate(const QString &_inputStr,
+                                           enuOutputFormat::Type _outputFormat,
+                                           bool _isIXML,
+                                           const stuTranslationDeadline& _deadline,
+                                           const QString& _weightProfile,
+                                           clsTranslationBatch* _batch)
+{
+    if (TranslatorInitialized == false)
+        throw exTargomanCore("Translator is not initialized");
+
+    return translateInput(_inputStr, _outputFormat, _isIXML, _batch ? _batch->pSharedCandidates.data() : NULL,
+                          _deadline, FeatureFunction::WeightProfiles::indexOf(_weightProfile));
+}
+
+/**
+ * @brief Translates a batch of inputs in parallel. Phrase candidates of source phrases repeated among inputs of the
+ * batch are collected and scored just once.
+ * @return translations in the same order as inputs
+ */
+QList<stuTranslationOutput> Translator::translateBatch(const QStringList &_inputs,
+                                                       enuOutputFormat::Type _outputFormat,
+                                                       bool _isIXML,
+                                                       const stuTranslationDeadline& _deadline,
+                                                       const QString& _weightProfile)
+{
+    if (TranslatorInitialized == false)
+        throw exTargomanCore("Translator is not initialized");
+
+    quint16 WeightProfile = FeatureFunction::WeightProfiles::indexOf(_weightProfile);
+    if (_inputs.size() == 1)
+        return QList<stuTranslationOutput>() << translateInput(_inputs.first(), _outputFormat, _isIXML, NULL, _deadline,
+                                                               WeightProfile);
+
+    clsPhraseCandidateCache SharedCandidates;
+    std::function<stuTranslationOutput(const QString&)> TranslateOne =
+            [&SharedCandidates, _outputFormat, _isIXML, _deadline, WeightProfile] (const QString& _inputStr) {
+        return translateInput(_inputStr, _outputFormat, _isIXML, &SharedCandidates, _deadline, WeightProfile);
+    };
+
+    return QtConcurrent::blockingMapped<QList<stuTranslationOutput>>(_inputs, TranslateOne);
+}
+
+/**
+ * @return names of weight profiles which can be used on translation requests besides the default profile.
+ */
+QStringList Translator::weightProfiles()
+{
+    return FeatureFunction::WeightProfiles::names();
+}
+
 void Translator::saveBinaryRuleTable(const QString &_filePath)
 {
     if (TranslatorInitialized == false)
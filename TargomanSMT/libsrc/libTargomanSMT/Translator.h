@@ -30,11 +30,35 @@
 #include <QMap>
 #include <QStringList>
 #include <QSettings>
+#include <QScopedPointer>
 #include "libTargomanSMT/Types.h"
 
 namespace Targoman{
 namespace SMT {
 
+namespace Private {
+namespace SearchGraphBuilder {
+class clsPhraseCandidateCache;
+}
+}
+
+/**
+ * @brief The clsTranslationBatch class keeps phrase candidates shared between sentences of a batch which are
+ * translated by separate calls to Translator::translate(), possibly on different threads.
+ */
+class clsTranslationBatch
+{
+public:
+    clsTranslationBatch();
+    ~clsTranslationBatch();
+
+private:
+    QScopedPointer<Private::SearchGraphBuilder::clsPhraseCandidateCache> pSharedCandidates;
+
+    Q_DISABLE_COPY(clsTranslationBatch)
+    friend class Translator;
+};
+
 class Translator
 {
 public:
@@ -43,7 +67,16 @@ public:
     static void saveBinaryRuleTable(const QString& _filePath);
     static stuTranslationOutput translate(const QString& _inputStr,
                                           enuOutputFormat::Type _outputFormat = enuOutputFormat::JustBestTranslation,
-                                          bool _isIXML = false);
+                                          bool _isIXML = false,
+                                          const stuTranslationDeadline& _deadline = stuTranslationDeadline(),
+                                          const QString& _weightProfile = QString(),
+                                          clsTranslationBatch* _batch = NULL);
+    static QList<stuTranslationOutput> translateBatch(const QStringList& _inputs,
+                                                      enuOutputFormat::Type _outputFormat = enuOutputFormat::JustBestTranslation,
+                                                      bool _isIXML = false,
+                                                      const stuTranslationDeadline& _deadline = stuTranslationDeadline(),
+                                                      const QString& _weightProfile = QString());
+    static QStringList weightProfiles();
 };
 
 }
@@ -30,6 +30,8 @@
 #include "libTargomanCommon/exTargomanBase.h"
 #include "libTargomanCommon/Types.h"
 #include <QPair>
+#include <QDateTime>
+#include <QAtomicInt>
 
 namespace UnitTestNameSpace {
 class clsUnitTest;
@@ -84,13 +86,42 @@ struct stuTranslationOutput{
     QStringList                     Translations;
     QString                         TaggedSource;
     QString                         OriginalSource;
+    QList<stuPos>                   SourceTokenSpans;   /**< Character span of each source token in original source if known */
     bool                            SpellCorrected;
+    bool                            Degraded;           /**< Deadline was reached and translation is result of a cut short search */
     QList<stuPhraseAlternatives>    BestTranslationPhraseAlternatives;
     QList<stuCostElements>           TranslationsCostElements;
 };
 
 typedef stuTranslationOutput::stuPhraseAlternatives               PhraseAlternatives_t;
 
+/**
+ * @brief Time budget of a translation request. Decoder checks it cooperatively and when it is expired or cancelled,
+ * stops exploring new hypotheses and completes the best partial hypothesis found so far.
+ */
+struct stuTranslationDeadline{
+    qint64              ExpiresAt;   /**< Milliseconds since epoch. Zero means no deadline */
+    const QAtomicInt*   Cancelled;   /**< Optional flag set by owner of the request to abandon it */
+
+    stuTranslationDeadline(qint64 _expiresAt = 0, const QAtomicInt* _cancelled = NULL) :
+        ExpiresAt(_expiresAt),
+        Cancelled(_cancelled)
+    { }
+
+    static stuTranslationDeadline fromTimeout(qint64 _timeoutMSecs, const QAtomicInt* _cancelled = NULL){
+        return stuTranslationDeadline(_timeoutMSecs > 0 ? QDateTime::currentMSecsSinceEpoch() + _timeoutMSecs : 0,
+                                      _cancelled);
+    }
+
+    bool isSet() const { return this->ExpiresAt > 0 || this->Cancelled != NULL; }
+
+    bool isExpired() const {
+        if (this->Cancelled && this->Cancelled->load())
+            return true;
+        return this->ExpiresAt > 0 && QDateTime::currentMSecsSinceEpoch() >= this->ExpiresAt;
+    }
+};
+
 }
 }
 #endif // TARGOMAN_CORE_TYPES_H
@@ -25,6 +25,8 @@ HEADERS += \
     libTargomanSMT/Private/InputDecomposer/clsInput.h \
     libTargomanSMT/Private/InputDecomposer/clsToken.h \
     libTargomanSMT/Private/GlobalConfigs.h \
+    libTargomanSMT/Private/clsSourceVocab.h \
+    libTargomanSMT/Private/DecoderSettings.h \
     libTargomanSMT/Private/OutputComposer/clsOutputComposer.h \
     libTargomanSMT/Private/SearchGraphBuilder/clsLexicalHypothesis.h \
     libTargomanSMT/Private/SearchGraphBuilder/clsSearchGraphNode.h \
@@ -33,6 +35,7 @@ HEADERS += \
     libTargomanSMT/Private/SearchGraphBuilder/clsSearchGraph.h \
     libTargomanSMT/Private/Proxies/LanguageModel/clsTargomanLMProxy.h \
     libTargomanSMT/Private/FeatureFunctions/intfFeatureFunction.hpp \
+    libTargomanSMT/Private/FeatureFunctions/WeightProfiles.h \
     libTargomanSMT/Private/FeatureFunctions/LexicalReordering/LexicalReordering.h \
     libTargomanSMT/Private/RuleTable/clsRuleNode.h \
     libTargomanSMT/Private/RuleTable/clsTargetRule.h \
@@ -43,6 +46,7 @@ HEADERS += \
     libTargomanSMT/Private/SpecialTokenHandler/OOVHandler/intfOOVHandlerModule.hpp \
     libTargomanSMT/Private/SpecialTokenHandler/OOVHandler/OOVDefaultHandlers.h \
     libTargomanSMT/Private/RuleTable/clsMosesPlainRuleTable.h \
+    libTargomanSMT/Private/RuleTable/clsPlainRuleTableLoader.h \
     libTargomanSMT/Private/FeatureFunctions/LanguageModel/LanguageModel.h \
     libTargomanSMT/Private/FeatureFunctions/OperationSequenceModel/OperationSequenceModel.h \
     libTargomanSMT/Private/FeatureFunctions/OperationSequenceModel/OSMState.h \
@@ -81,11 +85,14 @@ HEADERS += \
 SOURCES += libID.cpp \
     libTargomanSMT/Private/InputDecomposer/clsInput.cpp \
     libTargomanSMT/Private/GlobalConfigs.cpp \
+    libTargomanSMT/Private/clsSourceVocab.cpp \
+    libTargomanSMT/Private/DecoderSettings.cpp \
     libTargomanSMT/Private/OutputComposer/clsOutputComposer.cpp \
     libTargomanSMT/Private/SearchGraphBuilder/clsLexicalHypothesis.cpp \
     libTargomanSMT/Private/SearchGraphBuilder/clsSearchGraphNode.cpp \
     libTargomanSMT/Private/SearchGraphBuilder/clsCardinality.cpp \
     libTargomanSMT/Private/SearchGraphBuilder/clsSearchGraph.cpp \
+    libTargomanSMT/Private/FeatureFunctions/WeightProfiles.cpp \
     libTargomanSMT/Private/FeatureFunctions/LexicalReordering/LexicalReordering.cpp \
     libTargomanSMT/Private/RuleTable/clsRuleNode.cpp \
     libTargomanSMT/Private/RuleTable/clsTargetRule.cpp \
@@ -94,6 +101,7 @@ SOURCES += libID.cpp \
     libTargomanSMT/Private/SpecialTokenHandler/OOVHandler/OOVHandler.cpp \
     libTargomanSMT/Private/SpecialTokenHandler/OOVHandler/OOVDefaultHandlers.cpp \
     libTargomanSMT/Private/RuleTable/clsMosesPlainRuleTable.cpp \
+    libTargomanSMT/Private/RuleTable/clsPlainRuleTableLoader.cpp \
     libTargomanSMT/Private/FeatureFunctions/LanguageModel/LanguageModel.cpp \
     libTargomanSMT/Private/FeatureFunctions/OperationSequenceModel/OperationSequenceModel.cpp \
     libTargomanSMT/Private/FeatureFunctions/OperationSequenceModel/OSMState.cpp \
@@ -103,6 +103,7 @@ private slots:
     void test_ReorderingJump_getRestCostForPosition();
     void test_clsLexicalHypothesisContainer_insertHypothesis();
     void test_clsNBestFinder_fillBestOptions();
+    void test_clsSourceVocab_lookup();
 };
 }
 #endif // UNITTEST_H
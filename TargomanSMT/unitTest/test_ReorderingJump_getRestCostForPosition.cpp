@@ -32,6 +32,7 @@ using namespace InputDecomposer;
 void clsUnitTest::test_ReorderingJump_getRestCostForPosition()
 {
     ReorderingJump::ScalingFactor.setFromVariant(0.6);
+    DecoderSettings::invalidate();
     ReorderingJump reordeingJump;
 
     /*
@@ -81,6 +81,7 @@ TARGOMAN_REGISTER_SINGLETON_MODULE(DummyFeatureFunctionForInsertion);
 void clsUnitTest::test_clsLexicalHypothesisContainer_insertHypothesis()
 {
     clsLexicalHypothesisContainer::KeepRecombined.setFromVariant(false);
+    DecoderSettings::invalidate();
     clsLexicalHypothesisContainer HypoContainer;
 
     gConfigs.ActiveFeatureFunctions.clear();
@@ -151,6 +152,7 @@ void clsUnitTest::test_clsLexicalHypothesisContainer_insertHypothesis()
     */
 
     clsLexicalHypothesisContainer::KeepRecombined.setFromVariant(true);
+    DecoderSettings::invalidate();
 
     HypoContainer.Data->Nodes.clear();
 
@@ -166,6 +166,7 @@ void clsUnitTest::test_clsNBestFinder_fillBestOptions()
     SearchGraph.Data->HypothesisHolder[5][makeCoverageByString("11111")] = lexicalHypoContainer;
 
     NBestFinder::NBestSuggestions::MaxSuggestions.setFromVariant(3);
+    DecoderSettings::invalidate();
 
     NBestSuggestions::Container_t NBest;
 
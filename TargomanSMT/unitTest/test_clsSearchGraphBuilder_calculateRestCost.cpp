@@ -39,6 +39,7 @@ void clsUnitTest::test_clsSearchGraphBuilder_calculateRestCost()
              << clsToken("word5", 5, "", QVariantMap());
 
     clsSearchGraph::DoComputePositionSpecificRestCosts.setFromVariant(false);
+    DecoderSettings::invalidate();
     clsSearchGraph Builder(false, Sentence);
 
     Builder.Data->RestCostMatrix.resize(Sentence.size());
@@ -50,18 +51,41 @@ void clsUnitTest::test_clsSearchGraphBuilder_calculateRestCost()
         for(int length = 0; length < Sentence.size() - SentenceStartPos; ++length)
             Builder.Data->RestCostMatrix[SentenceStartPos][length] = PredictableRandom();
 
-    QVERIFY( qFuzzyCompare(Builder.calculateRestCost(makeCoverageByString("01001"), 1, 2), 1.28471041407369) );
-    QVERIFY( qFuzzyCompare(Builder.calculateRestCost(makeCoverageByString("00011"), 3, 5), 0.0917703813655545) );
-    QVERIFY( qFuzzyCompare(Builder.calculateRestCost(makeCoverageByString("10011"), 3, 5), 0.196123931831307) );
-    QVERIFY( qFuzzyCompare(Builder.calculateRestCost(makeCoverageByString("10001"), 0, 1), 0.35054010570189) );
-    QVERIFY( qFuzzyCompare(Builder.calculateRestCost(makeCoverageByString("11000"), 0, 2), 0.755917653166079) );
+    clsCardinalityHypothesisContainer Container;
+    QVERIFY( qFuzzyCompare(Builder.calculateRestCost(Container, makeCoverageByString("01001"), NULL, 1, 2), 1.28471041407369) );
+    QVERIFY( qFuzzyCompare(Builder.calculateRestCost(Container, makeCoverageByString("00011"), NULL, 3, 5), 0.0917703813655545) );
+    QVERIFY( qFuzzyCompare(Builder.calculateRestCost(Container, makeCoverageByString("10011"), NULL, 3, 5), 0.196123931831307) );
+    QVERIFY( qFuzzyCompare(Builder.calculateRestCost(Container, makeCoverageByString("10001"), NULL, 0, 1), 0.35054010570189) );
+    QVERIFY( qFuzzyCompare(Builder.calculateRestCost(Container, makeCoverageByString("11000"), NULL, 0, 2), 0.755917653166079) );
 
+    // Rest cost information of each coverage must have been memoised
+    const stuCoverageRestCost* RestCost = Container.coverageRestCost(makeCoverageByString("01001"));
+    QVERIFY(RestCost != NULL);
+    QVERIFY(RestCost->Gaps == coverageGaps(makeCoverageByString("01001")));
+    QVERIFY( qFuzzyCompare(RestCost->StaticCost, 1.28471041407369) );
+    RestCost = Container.coverageRestCost(makeCoverageByString("11000"));
+    QVERIFY(RestCost != NULL);
+    QVERIFY(RestCost->Gaps == coverageGaps(makeCoverageByString("11000")));
+    QVERIFY( qFuzzyCompare(RestCost->StaticCost, 0.755917653166079) );
+    QVERIFY(Container.coverageRestCost(makeCoverageByString("01101")) == NULL);
 
-//    PRINT_QVERIFY_DOUBLE_PRECISIONS(Builder.calculateRestCost(makeCoverageByString("01001"), 1, 2));
-//    PRINT_QVERIFY_DOUBLE_PRECISIONS(Builder.calculateRestCost(makeCoverageByString("00011"), 3, 5));
-//    PRINT_QVERIFY_DOUBLE_PRECISIONS(Builder.calculateRestCost(makeCoverageByString("10011"), 3, 5));
-//    PRINT_QVERIFY_DOUBLE_PRECISIONS(Builder.calculateRestCost(makeCoverageByString("10001"), 0, 1));
-//    PRINT_QVERIFY_DOUBLE_PRECISIONS(Builder.calculateRestCost(makeCoverageByString("11000"), 0, 2));
+    // Gaps derived from previous coverage must be the same as those computed from scratch
+    clsCardinalityHypothesisContainer NextContainer;
+    Cost_t DerivedCost = Builder.calculateRestCost(NextContainer,
+                                                   makeCoverageByString("01101"),
+                                                   Container.coverageRestCost(makeCoverageByString("01001")),
+                                                   2, 3);
+    QVERIFY(NextContainer.coverageRestCost(makeCoverageByString("01101"))->Gaps ==
+            coverageGaps(makeCoverageByString("01101")));
+    clsCardinalityHypothesisContainer ScratchContainer;
+    QVERIFY( qFuzzyCompare(Builder.calculateRestCost(ScratchContainer, makeCoverageByString("01101"), NULL, 2, 3),
+                           DerivedCost) );
+
+    // Memoised values must be reused instead of being recomputed
+    for (int SentenceStartPos=0; SentenceStartPos<Builder.Data->Sentence.size(); ++SentenceStartPos)
+        Builder.Data->RestCostMatrix[SentenceStartPos].fill(0, Sentence.size() - SentenceStartPos);
+    QVERIFY( qFuzzyCompare(Builder.calculateRestCost(Container, makeCoverageByString("01001"), NULL, 1, 2), 1.28471041407369) );
+    QVERIFY( qFuzzyCompare(Builder.calculateRestCost(NextContainer, makeCoverageByString("01101"), NULL, 2, 3), DerivedCost) );
 
 
 }
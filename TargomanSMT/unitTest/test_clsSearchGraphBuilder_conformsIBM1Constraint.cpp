@@ -32,13 +32,16 @@ void clsUnitTest::test_clsSearchGraphBuilder_conformsIBM1Constraint()
      clsSearchGraph SearchGraphBuilder(false,InputDecomposer::Sentence_t());
 
      clsSearchGraph::ReorderingConstraintMaximumRuns.setFromVariant(4);
+     DecoderSettings::invalidate();
      TestConverage = makeCoverageByString("110000111000");
      QVERIFY(SearchGraphBuilder.conformsIBM1Constraint(TestConverage) == true);
 
      clsSearchGraph::ReorderingConstraintMaximumRuns.setFromVariant(3);
+     DecoderSettings::invalidate();
      QVERIFY(SearchGraphBuilder.conformsIBM1Constraint(TestConverage) == false);
 
      clsSearchGraph::ReorderingConstraintMaximumRuns.setFromVariant(4);
+     DecoderSettings::invalidate();
      TestConverage = makeCoverageByString("110000");
      QVERIFY(SearchGraphBuilder.conformsIBM1Constraint(TestConverage) == true);
 
@@ -40,6 +40,10 @@ public:
     virtual QString getWordByIndex(WordIndex_t _wordIndex) {Q_UNUSED(_wordIndex); return ""; }
     virtual int compareHistoryWith(const intfLMSentenceScorer& _otherScorer) const {Q_UNUSED(_otherScorer); return 0;}
     virtual void updateFutureStateHash(QCryptographicHash& _hash) const { Q_UNUSED(_hash); }
+    virtual quint8 order() const { return 1; }
+    virtual size_t historySize() const { return 0; }
+    virtual void saveHistory(char* _buffer) const { Q_UNUSED(_buffer); }
+    virtual void restoreHistory(const char* _buffer) { Q_UNUSED(_buffer); }
 
 <<<<<<< .mine
     clsDummyScorerProxyForRestCost(int x) : Proxies::LanguageModel::intfLMSentenceScorer(this->moduleName(), x) { }
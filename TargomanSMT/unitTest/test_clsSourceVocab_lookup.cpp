@@ -0,0 +1,88 @@
+/******************************************************************************
+ * Targoman: A robust Statistical Machine Translation framework               *
+ *                                                                            *
+ * Copyright 2014-2015 by ITRC <http://itrc.ac.ir>                            *
+ *                                                                            *
+ * This file is part of Targoman.                                             *
+ *                                                                            *
+ * Targoman is free software: you can redistribute it and/or modify           *
+ * it under the terms of the GNU Lesser General Public License as published   *
+ * by the Free Software Foundation, either version 3 of the License, or       *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * Targoman is distributed in the hope that it will be useful,                *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * GNU Lesser General Public License for more details.                        *
+ * You should have received a copy of the GNU Lesser General Public License   *
+ * along with Targoman. If not, see <http://www.gnu.org/licenses/>.           *
+ *                                                                            *
+ ******************************************************************************/
+/**
+ * @author S. Mohammad M. Ziabary <ziabary@targoman.com>
+ * @author Behrooz Vedadian <vedadian@targoman.com>
+ * @author Saeed Torabzadeh <saeed.torabzadeh@targoman.com>
+ */
+
+#include "UnitTest.h"
+#include "libTargomanSMT/Private/clsSourceVocab.h"
+
+using namespace UnitTestNameSpace;
+using namespace Targoman::Common;
+
+void clsUnitTest::test_clsSourceVocab_lookup()
+{
+    clsSourceVocab Vocab;
+    QVERIFY( Vocab.value(QString("word"), 7) == 7 );
+    QVERIFY( Vocab.contains(QString("word")) == false );
+
+    // Words are inserted without reserve so that hash table is rehashed several times
+    QStringList Words;
+    Words << "word" << QString::fromUtf8("سلام") << QString::fromUtf8("𝄞") << QString::fromUtf8("a😀b");
+    for (int i = 0; i < 1000; ++i)
+        Words.append(QString("w%1").arg(i));
+    for (int i = 0; i < Words.size(); ++i)
+        Vocab.insert(Words.at(i), i + 1);
+    QVERIFY( Vocab.size() == Words.size() );
+
+    for (int i = 0; i < Words.size(); ++i){
+        const QString& Word = Words.at(i);
+        QString Padded = "<" + Word + ">";
+        QByteArray UTF8 = Word.toUtf8();
+        QVERIFY( Vocab.value(Word) == (WordIndex_t)i + 1 );
+        QVERIFY( Vocab.value(Padded.midRef(1, Word.size())) == (WordIndex_t)i + 1 );
+        QVERIFY( Vocab.value(UTF8.constData(), UTF8.size()) == (WordIndex_t)i + 1 );
+        QVERIFY( Vocab.word(i + 1) == Word );
+    }
+    QVERIFY( Vocab.value(QString("w1000"), 7) == 7 );
+    QVERIFY( Vocab.value("wor", 3, 7) == 7 );
+    QVERIFY( Vocab.word(Words.size() + 1).isEmpty() );
+
+    int Iterated = 0;
+    for (auto Iter = Vocab.constBegin(); Iter != Vocab.constEnd(); ++Iter, ++Iterated)
+        QVERIFY( Vocab.value(Iter.key()) == Iter.value() );
+    QVERIFY( Iterated == Vocab.size() );
+
+    // Re-inserting a word moves it to the new word index
+    Vocab.insert("word", 5000);
+    QVERIFY( Vocab.size() == Words.size() );
+    QVERIFY( Vocab.value(QString("word")) == 5000 );
+    QVERIFY( Vocab.word(5000) == "word" );
+    QVERIFY( Vocab.word(1).isEmpty() );
+
+    // Words with unpaired surrogates are rejected and never match other words
+    Vocab.insert("a?", 6000);
+    QString HighSurrogate = QString("a") + QChar(0xD800);
+    QString LowSurrogate = QString("a") + QChar(0xDC00);
+    QVERIFY_EXCEPTION_THROWN(Vocab.insert(HighSurrogate, 6001), exSourceVocab);
+    QVERIFY_EXCEPTION_THROWN(Vocab.insert(LowSurrogate, 6002), exSourceVocab);
+    QVERIFY( Vocab.contains(HighSurrogate) == false );
+    QVERIFY( Vocab.value(LowSurrogate, 7) == 7 );
+    QVERIFY( Vocab.value(QString("a?")) == 6000 );
+    QVERIFY( Vocab.word(6001).isEmpty() );
+    QVERIFY( Vocab.size() == Words.size() + 1 );
+
+    Vocab.clear();
+    QVERIFY( Vocab.isEmpty() );
+    QVERIFY( Vocab.contains(QString("word")) == false );
+}
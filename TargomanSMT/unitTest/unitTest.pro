@@ -36,7 +36,8 @@ SOURCES += \
     test_clsSearchGraphBuilder_calculateRestCost.cpp \
     test_ReorderingJump_getRestCostForPosition.cpp \
     test_clsLexicalHypothesisContainer_insertHypothesis.cpp \
-    test_clsNBestFinder_fillBestOptions.cpp
+    test_clsNBestFinder_fillBestOptions.cpp \
+    test_clsSourceVocab_lookup.cpp
 
 
 ################################################################################